@@ -0,0 +1,118 @@
+// c-api-examples/vad-offline-recognizer-c-api.c
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+//
+// This file demonstrates how to use SherpaOnnxVadOfflineRecognizer with
+// sherpa-onnx's C API. Speech segments from the VAD are decoded in batches
+// with SenseVoice by 2 worker threads.
+// clang-format off
+//
+// wget https://github.com/k2-fsa/sherpa-onnx/releases/download/asr-models/silero_vad.onnx
+// wget https://github.com/k2-fsa/sherpa-onnx/releases/download/asr-models/lei-jun-test.wav
+//
+// wget https://github.com/k2-fsa/sherpa-onnx/releases/download/asr-models/sherpa-onnx-sense-voice-zh-en-ja-ko-yue-2024-07-17.tar.bz2
+// tar xvf sherpa-onnx-sense-voice-zh-en-ja-ko-yue-2024-07-17.tar.bz2
+// rm sherpa-onnx-sense-voice-zh-en-ja-ko-yue-2024-07-17.tar.bz2
+//
+// clang-format on
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sherpa-onnx/c-api/c-api.h"
+
+static void PrintResults(const SherpaOnnxVadOfflineRecognizer *recognizer) {
+  while (!SherpaOnnxVadOfflineRecognizerEmpty(recognizer)) {
+    const SherpaOnnxVadOfflineRecognizerResult *r =
+        SherpaOnnxVadOfflineRecognizerFront(recognizer);
+
+    fprintf(stderr, "%.3f -- %.3f: %s\n", r->start, r->start + r->duration,
+            r->result->text);
+
+    SherpaOnnxDestroyVadOfflineRecognizerResult(r);
+    SherpaOnnxVadOfflineRecognizerPop(recognizer);
+  }
+}
+
+int32_t main() {
+  const char *wav_filename = "./lei-jun-test.wav";
+  const char *vad_filename = "./silero_vad.onnx";
+  const char *model_filename =
+      "./sherpa-onnx-sense-voice-zh-en-ja-ko-yue-2024-07-17/model.int8.onnx";
+  const char *tokens_filename =
+      "./sherpa-onnx-sense-voice-zh-en-ja-ko-yue-2024-07-17/tokens.txt";
+
+  if (!SherpaOnnxFileExists(wav_filename)) {
+    fprintf(stderr, "Please download %s\n", wav_filename);
+    return -1;
+  }
+
+  if (!SherpaOnnxFileExists(vad_filename)) {
+    fprintf(stderr, "Please download %s\n", vad_filename);
+    return -1;
+  }
+
+  const SherpaOnnxWave *wave = SherpaOnnxReadWave(wav_filename);
+  if (wave == NULL) {
+    fprintf(stderr, "Failed to read %s\n", wav_filename);
+    return -1;
+  }
+
+  if (wave->sample_rate != 16000) {
+    fprintf(stderr, "Expect the sample rate to be 16000. Given: %d\n",
+            wave->sample_rate);
+    SherpaOnnxFreeWave(wave);
+    return -1;
+  }
+
+  SherpaOnnxVadOfflineRecognizerConfig config;
+  memset(&config, 0, sizeof(config));
+
+  config.vad.silero_vad.model = vad_filename;
+  config.vad.silero_vad.threshold = 0.25;
+  config.vad.silero_vad.min_silence_duration = 0.5;
+  config.vad.silero_vad.min_speech_duration = 0.5;
+  config.vad.silero_vad.max_speech_duration = 10;
+  config.vad.silero_vad.window_size = 512;
+  config.vad.sample_rate = 16000;
+  config.vad.num_threads = 1;
+
+  config.recognizer.model_config.sense_voice.model = model_filename;
+  config.recognizer.model_config.sense_voice.language = "auto";
+  config.recognizer.model_config.sense_voice.use_itn = 1;
+  config.recognizer.model_config.tokens = tokens_filename;
+  config.recognizer.model_config.num_threads = 1;
+  config.recognizer.model_config.provider = "cpu";
+  config.recognizer.decoding_method = "greedy_search";
+
+  config.batch_size = 4;
+  config.num_workers = 2;
+
+  const SherpaOnnxVadOfflineRecognizer *recognizer =
+      SherpaOnnxCreateVadOfflineRecognizer(&config);
+
+  if (recognizer == NULL) {
+    fprintf(stderr, "Please check your config!\n");
+    SherpaOnnxFreeWave(wave);
+    return -1;
+  }
+
+  // 0.1 second per call
+  int32_t n = wave->sample_rate / 10;
+  for (int32_t i = 0; i < wave->num_samples; i += n) {
+    int32_t k = i + n < wave->num_samples ? n : wave->num_samples - i;
+    SherpaOnnxVadOfflineRecognizerAcceptWaveform(recognizer,
+                                                 wave->samples + i, k);
+    PrintResults(recognizer);
+  }
+
+  SherpaOnnxVadOfflineRecognizerFlush(recognizer);
+  PrintResults(recognizer);
+
+  SherpaOnnxDestroyVadOfflineRecognizer(recognizer);
+  SherpaOnnxFreeWave(wave);
+
+  return 0;
+}
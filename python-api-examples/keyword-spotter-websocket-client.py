@@ -0,0 +1,203 @@
+#!/usr/bin/env python3
+#
+# Copyright (c)  2025  Xiaomi Corporation
+
+"""
+A websocket client for sherpa-onnx-keyword-spotter-websocket-server
+
+Usage:
+    ./keyword-spotter-websocket-client.py \
+      --server-addr localhost \
+      --server-port 6006 \
+      --seconds-per-message 0.1 \
+      --samples-per-message 1600 \
+      --keywords "▁HE LL O ▁WORLD/▁HI ▁GO O G LE" \
+      --num-connections 1 \
+      /path/to/foo.wav
+
+(Note: You have to first start the server before starting the client)
+
+If --keywords is empty, the server uses the keywords from its
+--keywords-file.
+
+Use --num-connections to simulate many devices sending the same file at
+the same time.
+
+You can find the c++ server at
+https://github.com/k2-fsa/sherpa-onnx/blob/master/sherpa-onnx/csrc/keyword-spotter-websocket-server.cc
+"""
+
+import argparse
+import asyncio
+import json
+import logging
+import wave
+
+try:
+    import websockets
+except ImportError:
+    print("please run:")
+    print("")
+    print("  pip install websockets")
+    print("")
+    print("before you run this script")
+    print("")
+
+import numpy as np
+
+
+def read_wave(wave_filename: str) -> np.ndarray:
+    """
+    Args:
+      wave_filename:
+        Path to a wave file. Its sampling rate has to be 16000.
+        It should be single channel and each sample should be 16-bit.
+    Returns:
+      Return a 1-D float32 tensor.
+    """
+
+    with wave.open(wave_filename) as f:
+        assert f.getframerate() == 16000, f.getframerate()
+        assert f.getnchannels() == 1, f.getnchannels()
+        assert f.getsampwidth() == 2, f.getsampwidth()  # it is in bytes
+        num_samples = f.getnframes()
+        samples = f.readframes(num_samples)
+        samples_int16 = np.frombuffer(samples, dtype=np.int16)
+        samples_float32 = samples_int16.astype(np.float32)
+
+        samples_float32 = samples_float32 / 32768
+        return samples_float32
+
+
+def get_args():
+    parser = argparse.ArgumentParser(
+        formatter_class=argparse.ArgumentDefaultsHelpFormatter
+    )
+
+    parser.add_argument(
+        "--server-addr",
+        type=str,
+        default="localhost",
+        help="Address of the server",
+    )
+
+    parser.add_argument(
+        "--server-port",
+        type=int,
+        default=6006,
+        help="Port of the server",
+    )
+
+    parser.add_argument(
+        "--samples-per-message",
+        type=int,
+        default=1600,
+        help="Number of samples per message",
+    )
+
+    parser.add_argument(
+        "--seconds-per-message",
+        type=float,
+        default=0.1,
+        help="We will simulate that the duration of two messages is of this value",
+    )
+
+    parser.add_argument(
+        "--keywords",
+        type=str,
+        default="",
+        help="""Keywords for this connection. Keywords are separated by /.
+        Tokens of a keyword are separated by spaces. If empty, the server
+        uses its default keywords.
+        """,
+    )
+
+    parser.add_argument(
+        "--num-connections",
+        type=int,
+        default=1,
+        help="Number of connections sending the same file concurrently",
+    )
+
+    parser.add_argument(
+        "sound_file",
+        type=str,
+        help="The input sound file. Must be wave with a single channel, 16kHz "
+        "sampling rate, 16-bit of each sample.",
+    )
+
+    return parser.parse_args()
+
+
+async def receive_results(socket: websockets.WebSocketServerProtocol, i: int):
+    async for message in socket:
+        if message == "Done!":
+            break
+        logging.info(f"Connection {i}: {json.loads(message)}")
+
+
+async def run(
+    server_addr: str,
+    server_port: int,
+    data: np.ndarray,
+    samples_per_message: int,
+    seconds_per_message: float,
+    keywords: str,
+    i: int,
+):
+    async with websockets.connect(
+        f"ws://{server_addr}:{server_port}"
+    ) as websocket:  # noqa
+        receive_task = asyncio.create_task(receive_results(websocket, i))
+
+        if keywords:
+            # It must be sent before any audio
+            await websocket.send(keywords)
+
+        start = 0
+        while start < data.shape[0]:
+            end = start + samples_per_message
+            end = min(end, data.shape[0])
+            d = data.data[start:end].tobytes()
+
+            await websocket.send(d)
+
+            # Simulate streaming. You can remove the sleep if you want
+            await asyncio.sleep(seconds_per_message)  # in seconds
+
+            start += samples_per_message
+
+        # to signal that the client has sent all the data
+        await websocket.send("Done")
+
+        await receive_task
+
+
+async def main():
+    args = get_args()
+    logging.info(vars(args))
+
+    data = read_wave(args.sound_file)
+
+    await asyncio.gather(
+        *[
+            run(
+                server_addr=args.server_addr,
+                server_port=args.server_port,
+                data=data,
+                samples_per_message=args.samples_per_message,
+                seconds_per_message=args.seconds_per_message,
+                keywords=args.keywords,
+                i=i,
+            )
+            for i in range(args.num_connections)
+        ]
+    )
+
+
+if __name__ == "__main__":
+    formatter = (
+        "%(asctime)s %(levelname)s [%(filename)s:%(lineno)d] %(message)s"  # noqa
+    )
+    logging.basicConfig(format=formatter, level=logging.INFO)
+    asyncio.run(main())
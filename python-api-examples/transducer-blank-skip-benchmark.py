@@ -0,0 +1,362 @@
+#!/usr/bin/env python3
+#
+# Copyright (c)  2025  Xiaomi Corporation
+
+"""
+This file benchmarks blank skipping of transducer models, i.e.,
+--blank-skip-threshold. For each given threshold and decoding method, it
+decodes all the given files and reports the real time factor (RTF) and the
+error rate.
+
+If the blank probability of a frame is not less than the threshold, the next
+frame is treated as blank without running the joiner. Audio with long
+silences benefits most from it. A threshold of 0 disables it.
+
+(1) Non-streaming transducer models
+
+./python-api-examples/transducer-blank-skip-benchmark.py \
+  --tokens=/path/to/tokens.txt \
+  --encoder=/path/to/encoder.onnx \
+  --decoder=/path/to/decoder.onnx \
+  --joiner=/path/to/joiner.onnx \
+  --thresholds=0,0.9,0.95,0.99 \
+  --decoding-methods=greedy_search,modified_beam_search \
+  --text=/path/to/text \
+  /path/to/0.wav \
+  /path/to/1.wav
+
+(2) Streaming transducer models
+
+./python-api-examples/transducer-blank-skip-benchmark.py \
+  --streaming=1 \
+  --tokens=/path/to/tokens.txt \
+  --encoder=/path/to/encoder.onnx \
+  --decoder=/path/to/decoder.onnx \
+  --joiner=/path/to/joiner.onnx \
+  --text=/path/to/text \
+  /path/to/0.wav \
+  /path/to/1.wav
+
+The file given by --text is optional. Each line contains the reference
+transcript of a wave file, in the format
+
+  <wave name without the suffix .wav> <transcript>
+
+If --text is not given, the results with threshold 0 are used as references,
+so the reported error rate is the difference caused by blank skipping.
+
+Please refer to
+https://k2-fsa.github.io/sherpa/onnx/pretrained_models/index.html
+to download pre-trained models.
+"""
+import argparse
+import time
+import wave
+from pathlib import Path
+from typing import Dict, List, Tuple
+
+import numpy as np
+import sherpa_onnx
+
+
+def get_args():
+    parser = argparse.ArgumentParser(
+        formatter_class=argparse.ArgumentDefaultsHelpFormatter
+    )
+
+    parser.add_argument(
+        "--tokens",
+        type=str,
+        required=True,
+        help="Path to tokens.txt",
+    )
+
+    parser.add_argument(
+        "--encoder",
+        type=str,
+        required=True,
+        help="Path to the encoder model",
+    )
+
+    parser.add_argument(
+        "--decoder",
+        type=str,
+        required=True,
+        help="Path to the decoder model",
+    )
+
+    parser.add_argument(
+        "--joiner",
+        type=str,
+        required=True,
+        help="Path to the joiner model",
+    )
+
+    parser.add_argument(
+        "--streaming",
+        type=int,
+        default=0,
+        help="1 if the model is a streaming model. 0 otherwise.",
+    )
+
+    parser.add_argument(
+        "--thresholds",
+        type=str,
+        default="0,0.9,0.95,0.99",
+        help="Comma separated values of --blank-skip-threshold to benchmark",
+    )
+
+    parser.add_argument(
+        "--decoding-methods",
+        type=str,
+        default="greedy_search,modified_beam_search",
+        help="Comma separated decoding methods to benchmark",
+    )
+
+    parser.add_argument(
+        "--max-active-paths",
+        type=int,
+        default=4,
+        help="Used only with modified_beam_search",
+    )
+
+    parser.add_argument(
+        "--num-threads",
+        type=int,
+        default=1,
+        help="Number of threads for neural network computation",
+    )
+
+    parser.add_argument(
+        "--provider",
+        type=str,
+        default="cpu",
+        help="Valid values: cpu, cuda, coreml",
+    )
+
+    parser.add_argument(
+        "--text",
+        type=str,
+        default="",
+        help="Optional. Reference transcripts. See the help of this file",
+    )
+
+    parser.add_argument(
+        "--use-cer",
+        type=int,
+        default=0,
+        help="1 to compute the character error rate, e.g., for Chinese. "
+        "0 to compute the word error rate.",
+    )
+
+    parser.add_argument(
+        "sound_files",
+        type=str,
+        nargs="+",
+        help="The input sound file(s) to decode. Each file must be of WAVE "
+        "format with a single channel, and each sample has 16-bit, "
+        "i.e., int16_t. The sample rate of the file can be arbitrary "
+        "and does not need to be 16 kHz",
+    )
+
+    return parser.parse_args()
+
+
+def assert_file_exists(filename: str):
+    assert Path(filename).is_file(), (
+        f"{filename} does not exist!\n"
+        "Please refer to "
+        "https://k2-fsa.github.io/sherpa/onnx/pretrained_models/index.html to download it"
+    )
+
+
+def read_wave(wave_filename: str) -> Tuple[np.ndarray, int]:
+    """
+    Args:
+      wave_filename:
+        Path to a wave file. It should be single channel and each sample should
+        be 16-bit. Its sample rate does not need to be 16kHz.
+    Returns:
+      Return a tuple containing:
+       - A 1-D array of dtype np.float32 containing the samples, which are
+       normalized to the range [-1, 1].
+       - sample rate of the wave file
+    """
+
+    with wave.open(wave_filename) as f:
+        assert f.getnchannels() == 1, f.getnchannels()
+        assert f.getsampwidth() == 2, f.getsampwidth()  # it is in bytes
+        num_samples = f.getnframes()
+        samples = f.readframes(num_samples)
+        samples_int16 = np.frombuffer(samples, dtype=np.int16)
+        samples_float32 = samples_int16.astype(np.float32)
+
+        samples_float32 = samples_float32 / 32768
+        return samples_float32, f.getframerate()
+
+
+def read_text(filename: str) -> Dict[str, str]:
+    """Read a file in which each line is <wave name> <transcript>."""
+    ans = dict()
+    with open(filename, encoding="utf-8") as f:
+        for line in f:
+            fields = line.strip().split(maxsplit=1)
+            if not fields:
+                continue
+            ans[fields[0]] = fields[1] if len(fields) > 1 else ""
+    return ans
+
+
+def edit_distance(ref: List[str], hyp: List[str]) -> int:
+    prev = list(range(len(hyp) + 1))
+    for i in range(1, len(ref) + 1):
+        cur = [i] + [0] * len(hyp)
+        for j in range(1, len(hyp) + 1):
+            cur[j] = min(
+                prev[j] + 1,
+                cur[j - 1] + 1,
+                prev[j - 1] + (ref[i - 1] != hyp[j - 1]),
+            )
+        prev = cur
+    return prev[-1]
+
+
+def split(text: str, use_cer: bool) -> List[str]:
+    if use_cer:
+        return [c for c in text if not c.isspace()]
+    return text.upper().split()
+
+
+def create_recognizer(args, decoding_method: str, threshold: float):
+    kwargs = dict(
+        tokens=args.tokens,
+        encoder=args.encoder,
+        decoder=args.decoder,
+        joiner=args.joiner,
+        num_threads=args.num_threads,
+        provider=args.provider,
+        decoding_method=decoding_method,
+        max_active_paths=args.max_active_paths,
+        blank_skip_threshold=threshold,
+    )
+
+    if args.streaming:
+        return sherpa_onnx.OnlineRecognizer.from_transducer(**kwargs)
+    else:
+        return sherpa_onnx.OfflineRecognizer.from_transducer(**kwargs)
+
+
+def decode(
+    args, recognizer, waves: List[Tuple[np.ndarray, int]]
+) -> Tuple[List[str], float]:
+    """Decode all waves and return the results and the elapsed seconds."""
+    start_time = time.time()
+
+    streams = []
+    for samples, sample_rate in waves:
+        s = recognizer.create_stream()
+        s.accept_waveform(sample_rate, samples)
+
+        if args.streaming:
+            tail_paddings = np.zeros(int(0.66 * sample_rate), dtype=np.float32)
+            s.accept_waveform(sample_rate, tail_paddings)
+            s.input_finished()
+
+        streams.append(s)
+
+    if args.streaming:
+        while True:
+            ready_list = [s for s in streams if recognizer.is_ready(s)]
+            if not ready_list:
+                break
+            recognizer.decode_streams(ready_list)
+        results = [recognizer.get_result(s) for s in streams]
+    else:
+        recognizer.decode_streams(streams)
+        results = [s.result.text for s in streams]
+
+    return results, time.time() - start_time
+
+
+def main():
+    args = get_args()
+    assert_file_exists(args.tokens)
+    assert_file_exists(args.encoder)
+    assert_file_exists(args.decoder)
+    assert_file_exists(args.joiner)
+
+    waves = []
+    total_duration = 0
+    for wave_filename in args.sound_files:
+        assert_file_exists(wave_filename)
+        samples, sample_rate = read_wave(wave_filename)
+        total_duration += len(samples) / sample_rate
+        waves.append((samples, sample_rate))
+
+    refs = None
+    if args.text:
+        assert_file_exists(args.text)
+        text = read_text(args.text)
+        refs = []
+        for wave_filename in args.sound_files:
+            name = Path(wave_filename).stem
+            assert name in text, f"No transcript for {name} in {args.text}"
+            refs.append(text[name])
+
+    thresholds = [float(t) for t in args.thresholds.split(",")]
+    if 0 not in thresholds:
+        # Results without blank skipping are needed as references
+        thresholds.insert(0, 0)
+    thresholds.sort()
+
+    decoding_methods = args.decoding_methods.split(",")
+
+    rows = []
+    for decoding_method in decoding_methods:
+        baseline = None
+        for threshold in thresholds:
+            recognizer = create_recognizer(args, decoding_method, threshold)
+
+            # Warm up so that the first run is not penalized
+            decode(args, recognizer, waves[:1])
+
+            results, elapsed_seconds = decode(args, recognizer, waves)
+            if threshold == 0:
+                baseline = results
+
+            references = refs if refs is not None else baseline
+
+            num_errors = 0
+            num_words = 0
+            for ref, hyp in zip(references, results):
+                ref = split(ref, args.use_cer)
+                hyp = split(hyp, args.use_cer)
+                num_errors += edit_distance(ref, hyp)
+                num_words += len(ref)
+
+            error_rate = 100 * num_errors / max(num_words, 1)
+            rtf = elapsed_seconds / total_duration
+
+            rows.append((decoding_method, threshold, rtf, error_rate))
+            print(
+                f"{decoding_method}, threshold {threshold}: "
+                f"RTF {rtf:.4f}, error rate {error_rate:.2f}%"
+            )
+
+    name = "CER" if args.use_cer else "WER"
+    if refs is None:
+        name = f"{name} vs threshold 0"
+
+    print()
+    print(f"Wave duration: {total_duration:.3f} s")
+    print(f"num_threads: {args.num_threads}")
+    print(f"{'decoding method':<22} {'threshold':>9} {'RTF':>8} {name:>20}")
+    for decoding_method, threshold, rtf, error_rate in rows:
+        print(
+            f"{decoding_method:<22} {threshold:>9} {rtf:>8.4f} "
+            f"{error_rate:>19.2f}%"
+        )
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,180 @@
+#!/usr/bin/env python3
+
+"""
+This file shows how to use sherpa_onnx.VadOfflineRecognizer to recognize
+a long file. Speech segments from the VAD are sorted by duration and decoded
+in batches by --num-workers threads. Results are printed in the order of the
+segments in the file.
+
+Usage
+
+python3 ./python-api-examples/vad-with-non-streaming-asr-batched.py \
+  --silero-vad-model=./silero_vad.onnx \
+  --sense-voice=./sherpa-onnx-sense-voice-zh-en-ja-ko-yue-2024-07-17/model.int8.onnx \
+  --tokens=./sherpa-onnx-sense-voice-zh-en-ja-ko-yue-2024-07-17/tokens.txt \
+  --batch-size=8 \
+  --num-workers=2 \
+  ./lei-jun-test.wav
+
+Please visit
+https://github.com/k2-fsa/sherpa-onnx/releases/download/asr-models/silero_vad.onnx
+to download silero_vad.onnx and
+https://k2-fsa.github.io/sherpa/onnx/sense-voice/index.html
+to download SenseVoice models.
+"""
+
+import argparse
+import time
+from pathlib import Path
+from typing import Tuple
+
+import numpy as np
+import sherpa_onnx
+import soundfile as sf
+
+
+def assert_file_exists(filename: str):
+    assert Path(filename).is_file(), (
+        f"{filename} does not exist!\n"
+        "Please refer to "
+        "https://k2-fsa.github.io/sherpa/onnx/pretrained_models/index.html to download it"
+    )
+
+
+def get_args():
+    parser = argparse.ArgumentParser(
+        formatter_class=argparse.ArgumentDefaultsHelpFormatter
+    )
+
+    parser.add_argument(
+        "--silero-vad-model",
+        type=str,
+        required=True,
+        help="Path to silero_vad.onnx",
+    )
+
+    parser.add_argument(
+        "--sense-voice",
+        type=str,
+        required=True,
+        help="Path to the SenseVoice model",
+    )
+
+    parser.add_argument(
+        "--tokens",
+        type=str,
+        required=True,
+        help="Path to tokens.txt",
+    )
+
+    parser.add_argument(
+        "--num-threads",
+        type=int,
+        default=1,
+        help="Number of threads used by each worker",
+    )
+
+    parser.add_argument(
+        "--batch-size",
+        type=int,
+        default=8,
+        help="Maximum number of speech segments in a batch",
+    )
+
+    parser.add_argument(
+        "--num-workers",
+        type=int,
+        default=2,
+        help="Number of batches to decode in parallel",
+    )
+
+    parser.add_argument(
+        "sound_file",
+        type=str,
+        help="The input sound file. It can be of any sample rate",
+    )
+
+    return parser.parse_args()
+
+
+def load_audio(filename: str) -> Tuple[np.ndarray, int]:
+    data, sample_rate = sf.read(
+        filename,
+        always_2d=True,
+        dtype="float32",
+    )
+    data = data[:, 0]  # use only the first channel
+    samples = np.ascontiguousarray(data)
+    return samples, sample_rate
+
+
+def print_results(recognizer: sherpa_onnx.VadOfflineRecognizer):
+    while not recognizer.empty():
+        r = recognizer.front
+        if r.result.text:
+            print(f"{r.start:.3f} -- {r.start + r.duration:.3f}: {r.result.text}")
+        recognizer.pop()
+
+
+def main():
+    args = get_args()
+    assert_file_exists(args.silero_vad_model)
+    assert_file_exists(args.sense_voice)
+    assert_file_exists(args.tokens)
+
+    vad_config = sherpa_onnx.VadModelConfig()
+    vad_config.silero_vad.model = args.silero_vad_model
+    vad_config.silero_vad.min_silence_duration = 0.25
+    vad_config.sample_rate = 16000
+
+    model_config = sherpa_onnx.OfflineModelConfig(
+        sense_voice=sherpa_onnx.OfflineSenseVoiceModelConfig(
+            model=args.sense_voice,
+            language="auto",
+            use_itn=True,
+        ),
+        tokens=args.tokens,
+        num_threads=args.num_threads,
+    )
+
+    config = sherpa_onnx.VadOfflineRecognizerConfig(
+        vad=vad_config,
+        recognizer=sherpa_onnx.OfflineRecognizerConfig(model_config=model_config),
+        batch_size=args.batch_size,
+        num_workers=args.num_workers,
+    )
+
+    if not config.validate():
+        raise ValueError("Errors in config. Please check previous error logs")
+
+    recognizer = sherpa_onnx.VadOfflineRecognizer(config)
+
+    samples, sample_rate = load_audio(args.sound_file)
+    if sample_rate != vad_config.sample_rate:
+        import librosa
+
+        samples = librosa.resample(
+            samples, orig_sr=sample_rate, target_sr=vad_config.sample_rate
+        )
+        sample_rate = vad_config.sample_rate
+
+    start_time = time.time()
+
+    # 1 second per call
+    for i in range(0, len(samples), sample_rate):
+        recognizer.accept_waveform(samples[i : i + sample_rate])
+        print_results(recognizer)
+
+    recognizer.flush()
+    print_results(recognizer)
+
+    elapsed_seconds = time.time() - start_time
+    duration = len(samples) / sample_rate
+    print(f"Duration: {duration:.3f} s")
+    print(f"Elapsed seconds: {elapsed_seconds:.3f} s")
+    rtf = elapsed_seconds / duration
+    print(f"RTF: {elapsed_seconds:.3f} / {duration:.3f} = {rtf:.3f}")
+
+
+if __name__ == "__main__":
+    main()
@@ -32,6 +32,7 @@
 #include "sherpa-onnx/csrc/speaker-embedding-manager.h"
 #include "sherpa-onnx/csrc/spoken-language-identification.h"
 #include "sherpa-onnx/csrc/text-utils.h"
+#include "sherpa-onnx/csrc/vad-offline-recognizer.h"
 #include "sherpa-onnx/csrc/version.h"
 #include "sherpa-onnx/csrc/voice-activity-detector.h"
 #include "sherpa-onnx/csrc/wave-reader.h"
@@ -621,10 +622,9 @@ void SherpaOnnxDecodeMultipleOfflineStreams(
   recognizer->impl->DecodeStreams(ss.data(), n);
 }
 
-const SherpaOnnxOfflineRecognizerResult *SherpaOnnxGetOfflineStreamResult(
-    const SherpaOnnxOfflineStream *stream) {
-  const sherpa_onnx::OfflineRecognitionResult &result =
-      stream->impl->GetResult();
+static const SherpaOnnxOfflineRecognizerResult *
+ConvertOfflineRecognitionResult(
+    const sherpa_onnx::OfflineRecognitionResult &result) {
   const auto &text = result.text;
 
   auto r = new SherpaOnnxOfflineRecognizerResult;
@@ -711,6 +711,11 @@ const SherpaOnnxOfflineRecognizerResult *SherpaOnnxGetOfflineStreamResult(
   return r;
 }
 
+const SherpaOnnxOfflineRecognizerResult *SherpaOnnxGetOfflineStreamResult(
+    const SherpaOnnxOfflineStream *stream) {
+  return ConvertOfflineRecognitionResult(stream->impl->GetResult());
+}
+
 void SherpaOnnxDestroyOfflineRecognizerResult(
     const SherpaOnnxOfflineRecognizerResult *r) {
   if (r) {
@@ -1159,6 +1164,78 @@ void SherpaOnnxVoiceActivityDetectorFlush(
   p->impl->Flush();
 }
 
+struct SherpaOnnxVadOfflineRecognizer {
+  std::unique_ptr<sherpa_onnx::VadOfflineRecognizer> impl;
+};
+
+const SherpaOnnxVadOfflineRecognizer *SherpaOnnxCreateVadOfflineRecognizer(
+    const SherpaOnnxVadOfflineRecognizerConfig *config) {
+  sherpa_onnx::VadOfflineRecognizerConfig c;
+  c.vad = GetVadModelConfig(&config->vad);
+  c.recognizer = GetOfflineRecognizerConfig(&config->recognizer);
+  c.min_segment_duration = SHERPA_ONNX_OR(config->min_segment_duration, 0.1);
+  c.batch_size = SHERPA_ONNX_OR(config->batch_size, 8);
+  c.max_batch_duration = config->max_batch_duration;
+  c.sort_window = config->sort_window;
+  c.num_workers = SHERPA_ONNX_OR(config->num_workers, 1);
+
+  if (!c.Validate()) {
+    SHERPA_ONNX_LOGE("Errors in config");
+    return nullptr;
+  }
+
+  SherpaOnnxVadOfflineRecognizer *p = new SherpaOnnxVadOfflineRecognizer;
+  p->impl = std::make_unique<sherpa_onnx::VadOfflineRecognizer>(c);
+
+  return p;
+}
+
+void SherpaOnnxDestroyVadOfflineRecognizer(
+    const SherpaOnnxVadOfflineRecognizer *p) {
+  delete p;
+}
+
+void SherpaOnnxVadOfflineRecognizerAcceptWaveform(
+    const SherpaOnnxVadOfflineRecognizer *p, const float *samples, int32_t n) {
+  p->impl->AcceptWaveform(samples, n);
+}
+
+void SherpaOnnxVadOfflineRecognizerFlush(
+    const SherpaOnnxVadOfflineRecognizer *p) {
+  p->impl->Flush();
+}
+
+int32_t SherpaOnnxVadOfflineRecognizerEmpty(
+    const SherpaOnnxVadOfflineRecognizer *p) {
+  return p->impl->Empty();
+}
+
+const SherpaOnnxVadOfflineRecognizerResult *
+SherpaOnnxVadOfflineRecognizerFront(const SherpaOnnxVadOfflineRecognizer *p) {
+  const sherpa_onnx::VadOfflineRecognizerResult &r = p->impl->Front();
+
+  SherpaOnnxVadOfflineRecognizerResult *ans =
+      new SherpaOnnxVadOfflineRecognizerResult;
+  ans->start = r.start;
+  ans->duration = r.duration;
+  ans->result = ConvertOfflineRecognitionResult(r.result);
+
+  return ans;
+}
+
+void SherpaOnnxDestroyVadOfflineRecognizerResult(
+    const SherpaOnnxVadOfflineRecognizerResult *r) {
+  if (r) {
+    SherpaOnnxDestroyOfflineRecognizerResult(r->result);
+    delete r;
+  }
+}
+
+void SherpaOnnxVadOfflineRecognizerPop(
+    const SherpaOnnxVadOfflineRecognizer *p) {
+  p->impl->Pop();
+}
+
 #if SHERPA_ONNX_ENABLE_TTS == 1
 struct SherpaOnnxOfflineTts {
   std::unique_ptr<sherpa_onnx::OfflineTts> impl;
@@ -1008,6 +1008,84 @@ SHERPA_ONNX_API void SherpaOnnxVoiceActivityDetectorReset(
 SHERPA_ONNX_API void SherpaOnnxVoiceActivityDetectorFlush(
     const SherpaOnnxVoiceActivityDetector *p);
 
+// ============================================================
+// For VAD + non-streaming speech recognition of long audio
+// ============================================================
+SHERPA_ONNX_API typedef struct SherpaOnnxVadOfflineRecognizerConfig {
+  SherpaOnnxVadModelConfig vad;
+  SherpaOnnxOfflineRecognizerConfig recognizer;
+
+  // Speech segments shorter than this value in seconds are discarded.
+  // Defaults to 0.1
+  float min_segment_duration;
+
+  // Maximum number of speech segments in a batch. Defaults to 8
+  int32_t batch_size;
+
+  // If positive, limit batch_size * (duration of the longest segment in a
+  // batch) in seconds
+  float max_batch_duration;
+
+  // Number of segments to collect before sorting them by duration. If it is
+  // 0, 4 * batch_size is used
+  int32_t sort_window;
+
+  // Number of batches to decode in parallel. Defaults to 1
+  int32_t num_workers;
+} SherpaOnnxVadOfflineRecognizerConfig;
+
+SHERPA_ONNX_API typedef struct SherpaOnnxVadOfflineRecognizerResult {
+  // Start time of the speech segment in seconds
+  float start;
+
+  // Duration of the speech segment in seconds
+  float duration;
+
+  // Timestamps in it are relative to the start of the segment
+  const SherpaOnnxOfflineRecognizerResult *result;
+} SherpaOnnxVadOfflineRecognizerResult;
+
+// Speech segments from the VAD are sorted by duration and decoded in
+// batches by num_workers threads. Results are returned in the order of the
+// segments in the input audio.
+typedef struct SherpaOnnxVadOfflineRecognizer SherpaOnnxVadOfflineRecognizer;
+
+// The user has to use SherpaOnnxDestroyVadOfflineRecognizer() to free
+// the returned pointer to avoid memory leak.
+SHERPA_ONNX_API const SherpaOnnxVadOfflineRecognizer *
+SherpaOnnxCreateVadOfflineRecognizer(
+    const SherpaOnnxVadOfflineRecognizerConfig *config);
+
+SHERPA_ONNX_API void SherpaOnnxDestroyVadOfflineRecognizer(
+    const SherpaOnnxVadOfflineRecognizer *p);
+
+// samples are expected to be sampled at config->vad.sample_rate.
+// It blocks while all workers are busy.
+SHERPA_ONNX_API void SherpaOnnxVadOfflineRecognizerAcceptWaveform(
+    const SherpaOnnxVadOfflineRecognizer *p, const float *samples, int32_t n);
+
+// Call it at the end of the input. It returns after all pending segments
+// are decoded.
+SHERPA_ONNX_API void SherpaOnnxVadOfflineRecognizerFlush(
+    const SherpaOnnxVadOfflineRecognizer *p);
+
+// Return 1 if no result is available. Return 0 otherwise.
+SHERPA_ONNX_API int32_t
+SherpaOnnxVadOfflineRecognizerEmpty(const SherpaOnnxVadOfflineRecognizer *p);
+
+// Return the first result.
+// The user has to use SherpaOnnxDestroyVadOfflineRecognizerResult() to free
+// the returned pointer to avoid memory leak.
+SHERPA_ONNX_API const SherpaOnnxVadOfflineRecognizerResult *
+SherpaOnnxVadOfflineRecognizerFront(const SherpaOnnxVadOfflineRecognizer *p);
+
+SHERPA_ONNX_API void SherpaOnnxDestroyVadOfflineRecognizerResult(
+    const SherpaOnnxVadOfflineRecognizerResult *r);
+
+// Remove the first result.
+SHERPA_ONNX_API void SherpaOnnxVadOfflineRecognizerPop(
+    const SherpaOnnxVadOfflineRecognizer *p);
+
 // ============================================================
 // For offline Text-to-Speech (i.e., non-streaming TTS)
 // ============================================================
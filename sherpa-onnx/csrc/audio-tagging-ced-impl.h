@@ -6,6 +6,8 @@
 
 #include <assert.h>
 
+#include <algorithm>
+#include <array>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -18,6 +20,7 @@
 #include "sherpa-onnx/csrc/audio-tagging-impl.h"
 #include "sherpa-onnx/csrc/audio-tagging-label-file.h"
 #include "sherpa-onnx/csrc/audio-tagging.h"
+#include "sherpa-onnx/csrc/batch-by-duration.h"
 #include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/math.h"
 #include "sherpa-onnx/csrc/offline-ced-model.h"
@@ -53,8 +56,8 @@ class AudioTaggingCEDImpl : public AudioTaggingImpl {
     return std::make_unique<OfflineStream>(CEDTag{});
   }
 
-  std::vector<AudioEvent> Compute(OfflineStream *s,
-                                  int32_t top_k = -1) const override {
+  std::vector<std::vector<AudioEvent>> Compute(
+      OfflineStream **ss, int32_t n, int32_t top_k = -1) const override {
     if (top_k < 0) {
       top_k = config_.top_k;
     }
@@ -70,20 +73,73 @@ class AudioTaggingCEDImpl : public AudioTaggingImpl {
 
     // WARNING(fangjun): It is fixed to 64 for CED models
     int32_t feat_dim = 64;
-    std::vector<float> f = s->GetFrames();
 
-    int32_t num_frames = f.size() / feat_dim;
-    assert(feat_dim * num_frames == static_cast<int32_t>(f.size()));
+    std::vector<std::vector<float>> features(n);
+    for (int32_t i = 0; i != n; ++i) {
+      features[i] = ss[i]->GetFrames();
+      assert(features[i].size() % feat_dim == 0);
+    }
+
+    // The model does not accept the number of frames of each utterance, so
+    // padding changes the result. We put only streams whose numbers of
+    // frames differ by at most max_batch_padding into a batch.
+    std::vector<int32_t> num_frames(n);
+    for (int32_t i = 0; i != n; ++i) {
+      num_frames[i] = features[i].size() / feat_dim;
+    }
+
+    std::vector<std::vector<int32_t>> groups =
+        GroupByLength(num_frames, config_.max_batch_padding);
+
+    if (config_.model.debug) {
+      SHERPA_ONNX_LOGE("%d streams in %d batches", n,
+                       static_cast<int32_t>(groups.size()));
+    }
+
+    std::vector<std::vector<AudioEvent>> ans(n);
+
+    for (const auto &g : groups) {
+      int32_t batch_size = g.size();
+      int32_t size = features[g.back()].size();
+      int32_t max_num_frames = size / feat_dim;
+
+      std::vector<float> f(batch_size * size);
+      for (int32_t i = 0; i != batch_size; ++i) {
+        const auto &src = features[g[i]];
+        auto dst = f.begin() + i * size;
+        std::copy(src.begin(), src.end(), dst);
 
-    std::array<int64_t, 3> shape = {1, num_frames, feat_dim};
+        // Features are in dB. Pad with the value of the quietest bin
+        // of the stream.
+        if (static_cast<int32_t>(src.size()) < size) {
+          float min_value = src.empty()
+                                ? 0
+                                : *std::min_element(src.begin(), src.end());
+          std::fill(dst + src.size(), dst + size, min_value);
+        }
+      }
 
-    Ort::Value x = Ort::Value::CreateTensor(memory_info, f.data(), f.size(),
-                                            shape.data(), shape.size());
+      std::array<int64_t, 3> shape = {batch_size, max_num_frames, feat_dim};
 
-    Ort::Value probs = model_.Forward(std::move(x));
+      Ort::Value x = Ort::Value::CreateTensor(memory_info, f.data(), f.size(),
+                                              shape.data(), shape.size());
 
-    const float *p = probs.GetTensorData<float>();
+      Ort::Value probs = model_.Forward(std::move(x));
 
+      const float *p = probs.GetTensorData<float>();
+
+      for (int32_t i = 0; i != batch_size; ++i, p += num_event_classes) {
+        ans[g[i]] = GetTopKEvents(p, num_event_classes, top_k);
+      }
+    }
+
+    return ans;
+  }
+
+ private:
+  std::vector<AudioEvent> GetTopKEvents(const float *p,
+                                        int32_t num_event_classes,
+                                        int32_t top_k) const {
     std::vector<int32_t> top_k_indexes = TopkIndex(p, num_event_classes, top_k);
 
     std::vector<AudioEvent> ans(top_k);
@@ -100,7 +156,6 @@ class AudioTaggingCEDImpl : public AudioTaggingImpl {
     return ans;
   }
 
- private:
   AudioTaggingConfig config_;
   OfflineCEDModel model_;
   AudioTaggingLabels labels_;
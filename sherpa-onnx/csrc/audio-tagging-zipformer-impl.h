@@ -6,6 +6,7 @@
 
 #include <assert.h>
 
+#include <array>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -21,6 +22,7 @@
 #include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/math.h"
 #include "sherpa-onnx/csrc/offline-zipformer-audio-tagging-model.h"
+#include "sherpa-onnx/csrc/pad-sequence.h"
 
 namespace sherpa_onnx {
 
@@ -53,8 +55,12 @@ class AudioTaggingZipformerImpl : public AudioTaggingImpl {
     return std::make_unique<OfflineStream>();
   }
 
-  std::vector<AudioEvent> Compute(OfflineStream *s,
-                                  int32_t top_k = -1) const override {
+  std::vector<std::vector<AudioEvent>> Compute(
+      OfflineStream **ss, int32_t n, int32_t top_k = -1) const override {
+    if (n == 0) {
+      return {};
+    }
+
     if (top_k < 0) {
       top_k = config_.top_k;
     }
@@ -70,27 +76,59 @@ class AudioTaggingZipformerImpl : public AudioTaggingImpl {
 
     // WARNING(fangjun): It is fixed to 80 for all models from icefall
     int32_t feat_dim = 80;
-    std::vector<float> f = s->GetFrames();
 
-    int32_t num_frames = f.size() / feat_dim;
+    std::vector<Ort::Value> features;
+    features.reserve(n);
+
+    std::vector<std::vector<float>> features_vec(n);
+    std::vector<int64_t> features_length_vec(n);
+    for (int32_t i = 0; i != n; ++i) {
+      std::vector<float> f = ss[i]->GetFrames();
+
+      int32_t num_frames = f.size() / feat_dim;
+      assert(feat_dim * num_frames == static_cast<int32_t>(f.size()));
 
-    assert(feat_dim * num_frames == static_cast<int32_t>(f.size()));
+      features_length_vec[i] = num_frames;
+      features_vec[i] = std::move(f);
 
-    std::array<int64_t, 3> shape = {1, num_frames, feat_dim};
+      std::array<int64_t, 2> shape = {num_frames, feat_dim};
+
+      Ort::Value x = Ort::Value::CreateTensor(
+          memory_info, features_vec[i].data(), features_vec[i].size(),
+          shape.data(), shape.size());
+      features.push_back(std::move(x));
+    }
+
+    std::vector<const Ort::Value *> features_pointer(n);
+    for (int32_t i = 0; i != n; ++i) {
+      features_pointer[i] = &features[i];
+    }
 
-    Ort::Value x = Ort::Value::CreateTensor(memory_info, f.data(), f.size(),
-                                            shape.data(), shape.size());
+    std::array<int64_t, 1> x_length_shape = {n};
+    Ort::Value x_length = Ort::Value::CreateTensor(
+        memory_info, features_length_vec.data(), n, x_length_shape.data(),
+        x_length_shape.size());
 
-    int64_t x_length_scalar = num_frames;
-    std::array<int64_t, 1> x_length_shape = {1};
-    Ort::Value x_length =
-        Ort::Value::CreateTensor(memory_info, &x_length_scalar, 1,
-                                 x_length_shape.data(), x_length_shape.size());
+    // Padded frames are excluded from the model output using x_length
+    Ort::Value x = PadSequence(model_.Allocator(), features_pointer,
+                               -23.025850929940457f);
 
     Ort::Value probs = model_.Forward(std::move(x), std::move(x_length));
 
     const float *p = probs.GetTensorData<float>();
 
+    std::vector<std::vector<AudioEvent>> ans(n);
+    for (int32_t i = 0; i != n; ++i, p += num_event_classes) {
+      ans[i] = GetTopKEvents(p, num_event_classes, top_k);
+    }
+
+    return ans;
+  }
+
+ private:
+  std::vector<AudioEvent> GetTopKEvents(const float *p,
+                                        int32_t num_event_classes,
+                                        int32_t top_k) const {
     std::vector<int32_t> top_k_indexes = TopkIndex(p, num_event_classes, top_k);
 
     std::vector<AudioEvent> ans(top_k);
@@ -107,7 +145,6 @@ class AudioTaggingZipformerImpl : public AudioTaggingImpl {
     return ans;
   }
 
- private:
   AudioTaggingConfig config_;
   OfflineZipformerAudioTaggingModel model_;
   AudioTaggingLabels labels_;
@@ -30,6 +30,10 @@ void AudioTaggingConfig::Register(ParseOptions *po) {
   model.Register(po);
   po->Register("labels", &labels, "Event label file");
   po->Register("top-k", &top_k, "Top k events to return in the result");
+  po->Register("max-batch-padding", &max_batch_padding,
+               "Used only by CED models. Streams whose numbers of frames "
+               "differ by at most this value are computed in the same batch. "
+               "0 batches only streams of the same length.");
 }
 
 bool AudioTaggingConfig::Validate() const {
@@ -42,6 +46,12 @@ bool AudioTaggingConfig::Validate() const {
     return false;
   }
 
+  if (max_batch_padding < 0) {
+    SHERPA_ONNX_LOGE("--max-batch-padding should be >= 0. Given: %d",
+                     max_batch_padding);
+    return false;
+  }
+
   if (labels.empty()) {
     SHERPA_ONNX_LOGE("Please provide --labels");
     return false;
@@ -60,7 +70,8 @@ std::string AudioTaggingConfig::ToString() const {
   os << "AudioTaggingConfig(";
   os << "model=" << model.ToString() << ", ";
   os << "labels=\"" << labels << "\", ";
-  os << "top_k=" << top_k << ")";
+  os << "top_k=" << top_k << ", ";
+  os << "max_batch_padding=" << max_batch_padding << ")";
 
   return os.str();
 }
@@ -81,7 +92,12 @@ std::unique_ptr<OfflineStream> AudioTagging::CreateStream() const {
 
 std::vector<AudioEvent> AudioTagging::Compute(OfflineStream *s,
                                               int32_t top_k /*= -1*/) const {
-  return impl_->Compute(s, top_k);
+  return impl_->Compute(&s, 1, top_k)[0];
+}
+
+std::vector<std::vector<AudioEvent>> AudioTagging::Compute(
+    OfflineStream **ss, int32_t n, int32_t top_k /*= -1*/) const {
+  return impl_->Compute(ss, n, top_k);
 }
 
 }  // namespace sherpa_onnx
@@ -25,11 +25,23 @@ struct AudioTaggingConfig {
 
   int32_t top_k = 5;
 
+  // Used only by CED models, which have no input for the number of frames
+  // of each stream. When a batch of streams is computed, streams whose
+  // numbers of frames differ by at most this value are put into the same
+  // batch and shorter streams are padded with their quietest frame value.
+  // Padding changes the result slightly, so it is 0 by default, which
+  // batches only streams of the same length.
+  int32_t max_batch_padding = 0;
+
   AudioTaggingConfig() = default;
 
   AudioTaggingConfig(const AudioTaggingModelConfig &model,
-                     const std::string &labels, int32_t top_k)
-      : model(model), labels(labels), top_k(top_k) {}
+                     const std::string &labels, int32_t top_k,
+                     int32_t max_batch_padding = 0)
+      : model(model),
+        labels(labels),
+        top_k(top_k),
+        max_batch_padding(max_batch_padding) {}
 
   void Register(ParseOptions *po);
   bool Validate() const;
@@ -65,6 +77,11 @@ class AudioTagging {
   // Return top_k AudioEvent. ans[0].prob is the largest of all returned events.
   std::vector<AudioEvent> Compute(OfflineStream *s, int32_t top_k = -1) const;
 
+  // Compute n streams in a batch. ans[i] is the result of ss[i] and
+  // it is the same as Compute(ss[i], top_k).
+  std::vector<std::vector<AudioEvent>> Compute(OfflineStream **ss, int32_t n,
+                                               int32_t top_k = -1) const;
+
  private:
   std::unique_ptr<AudioTaggingImpl> impl_;
 };
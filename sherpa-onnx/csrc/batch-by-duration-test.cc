@@ -0,0 +1,169 @@
+// sherpa-onnx/csrc/batch-by-duration-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/batch-by-duration.h"
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+struct Item {
+  int32_t index;  // position in the input
+  float duration;
+};
+
+static std::vector<std::vector<Item>> Split(std::vector<Item> items,
+                                            int32_t batch_size,
+                                            float max_batch_duration) {
+  std::vector<std::vector<Item>> batches;
+  BatchByDuration(
+      &items, batch_size, max_batch_duration,
+      [](const Item &i) { return i.duration; },
+      [&batches](std::vector<Item> batch) {
+        batches.push_back(std::move(batch));
+      });
+
+  EXPECT_TRUE(items.empty());
+
+  return batches;
+}
+
+TEST(BatchByDuration, Limits) {
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<float> dist(0.5, 20);
+
+  for (float max_batch_duration : {0.0f, 30.0f, 60.0f}) {
+    for (int32_t batch_size : {1, 3, 8}) {
+      std::vector<Item> items;
+      for (int32_t i = 0; i != 50; ++i) {
+        items.push_back({i, dist(gen)});
+      }
+
+      auto batches = Split(items, batch_size, max_batch_duration);
+
+      int32_t num_items = 0;
+      float prev = 0;
+      for (const auto &batch : batches) {
+        ASSERT_FALSE(batch.empty());
+        EXPECT_LE(static_cast<int32_t>(batch.size()), batch_size);
+
+        // Batches are sorted by duration
+        for (const auto &i : batch) {
+          EXPECT_LE(prev, i.duration);
+          prev = i.duration;
+        }
+
+        if (max_batch_duration > 0 && batch.size() > 1) {
+          EXPECT_LE(batch.size() * batch.back().duration, max_batch_duration);
+        }
+
+        num_items += batch.size();
+      }
+
+      EXPECT_EQ(num_items, static_cast<int32_t>(items.size()));
+    }
+  }
+}
+
+// An item longer than max_batch_duration is in a batch of its own
+TEST(BatchByDuration, LongItem) {
+  std::vector<Item> items = {{0, 1}, {1, 50}, {2, 2}};
+
+  auto batches = Split(items, 8, 10);
+  ASSERT_EQ(batches.size(), 2);
+  EXPECT_EQ(batches[0].size(), 2);
+  ASSERT_EQ(batches[1].size(), 1);
+  EXPECT_EQ(batches[1][0].index, 1);
+}
+
+// Results can be put back in input order with the index of each item, like
+// VadOfflineRecognizer does.
+TEST(BatchByDuration, InputOrder) {
+  std::vector<Item> items;
+  for (int32_t i = 0; i != 20; ++i) {
+    // Items of the same duration keep their order
+    items.push_back({i, static_cast<float>((i * 7) % 5)});
+  }
+
+  auto batches = Split(items, 3, 0);
+
+  std::vector<int32_t> results(items.size(), -1);
+  int32_t prev_index = -1;
+  float prev_duration = -1;
+  for (const auto &batch : batches) {
+    for (const auto &i : batch) {
+      if (i.duration == prev_duration) {
+        EXPECT_LT(prev_index, i.index);
+      }
+      prev_index = i.index;
+      prev_duration = i.duration;
+
+      EXPECT_EQ(results[i.index], -1);
+      results[i.index] = i.index;
+    }
+  }
+
+  for (int32_t i = 0; i != static_cast<int32_t>(results.size()); ++i) {
+    EXPECT_EQ(results[i], i);
+  }
+}
+
+TEST(GroupByLength, Basic) {
+  std::vector<int32_t> lengths = {30, 10, 12, 30, 25, 11, 40};
+
+  auto groups = GroupByLength(lengths, 0);
+  std::vector<std::vector<int32_t>> expected = {{1}, {5}, {2}, {4},
+                                                {0, 3}, {6}};
+  EXPECT_EQ(groups, expected);
+
+  groups = GroupByLength(lengths, 5);
+  expected = {{1, 5, 2}, {4, 0, 3}, {6}};
+  EXPECT_EQ(groups, expected);
+
+  groups = GroupByLength(lengths, 100);
+  expected = {{1, 5, 2, 4, 0, 3, 6}};
+  EXPECT_EQ(groups, expected);
+
+  EXPECT_TRUE(GroupByLength({}, 10).empty());
+}
+
+TEST(GroupByLength, MaxPadding) {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int32_t> dist(100, 3000);
+
+  std::vector<int32_t> lengths(200);
+  for (auto &i : lengths) {
+    i = dist(gen);
+  }
+
+  for (int32_t max_padding : {0, 10, 100, 1000}) {
+    auto groups = GroupByLength(lengths, max_padding);
+
+    std::vector<bool> seen(lengths.size(), false);
+    int32_t prev = 0;
+    for (const auto &g : groups) {
+      ASSERT_FALSE(g.empty());
+      EXPECT_LE(lengths[g.back()] - lengths[g.front()], max_padding);
+
+      // Groups do not overlap
+      EXPECT_LT(prev, lengths[g.front()]);
+
+      for (int32_t i : g) {
+        EXPECT_FALSE(seen[i]);
+        seen[i] = true;
+        EXPECT_LE(prev, lengths[i]);
+        prev = lengths[i];
+      }
+    }
+
+    EXPECT_EQ(std::count(seen.begin(), seen.end(), true), lengths.size());
+  }
+}
+
+}  // namespace sherpa_onnx
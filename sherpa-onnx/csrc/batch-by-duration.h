@@ -0,0 +1,92 @@
+// sherpa-onnx/csrc/batch-by-duration.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_BATCH_BY_DURATION_H_
+#define SHERPA_ONNX_CSRC_BATCH_BY_DURATION_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace sherpa_onnx {
+
+// Sort items by duration and split them into batches. Since items in a
+// batch have similar durations, little computation is spent on padding.
+//
+// A batch contains at most batch_size items. If max_batch_duration is
+// positive, (number of items in the batch) * (duration of the longest item
+// in the batch) does not exceed it unless the batch contains a single item.
+//
+// The sort is stable, so items of the same duration keep their order.
+// Callers that need results in input order must keep the index of each
+// item and reorder the results themselves.
+//
+// get_duration(item) returns the duration of an item in seconds.
+// emit(std::move(batch)) is called for each batch in increasing order of
+// duration. items is empty on return.
+template <typename T, typename GetDuration, typename Emit>
+void BatchByDuration(std::vector<T> *items, int32_t batch_size,
+                     float max_batch_duration, const GetDuration &get_duration,
+                     const Emit &emit) {
+  std::stable_sort(items->begin(), items->end(),
+                   [&get_duration](const T &a, const T &b) {
+                     return get_duration(a) < get_duration(b);
+                   });
+
+  std::vector<T> batch;
+  for (auto &item : *items) {
+    int32_t n = static_cast<int32_t>(batch.size()) + 1;
+    if (!batch.empty() && max_batch_duration > 0 &&
+        n * get_duration(item) > max_batch_duration) {
+      emit(std::move(batch));
+      batch.clear();
+    }
+
+    batch.push_back(std::move(item));
+
+    if (static_cast<int32_t>(batch.size()) == batch_size) {
+      emit(std::move(batch));
+      batch.clear();
+    }
+  }
+
+  if (!batch.empty()) {
+    emit(std::move(batch));
+  }
+
+  items->clear();
+}
+
+// Group the indexes of lengths so that a group can be padded to its longest
+// item with at most max_padding padding per item, i.e., the difference
+// between the longest and the shortest length in a group is at most
+// max_padding. If max_padding is 0, only items of equal length are grouped.
+//
+// Groups are sorted by length, and so are the indexes in each group. It
+// returns the smallest number of such groups.
+inline std::vector<std::vector<int32_t>> GroupByLength(
+    const std::vector<int32_t> &lengths, int32_t max_padding) {
+  std::vector<int32_t> indexes(lengths.size());
+  std::iota(indexes.begin(), indexes.end(), 0);
+  std::stable_sort(indexes.begin(), indexes.end(),
+                   [&lengths](int32_t a, int32_t b) {
+                     return lengths[a] < lengths[b];
+                   });
+
+  std::vector<std::vector<int32_t>> ans;
+  for (int32_t i : indexes) {
+    if (ans.empty() || lengths[i] - lengths[ans.back()[0]] > max_padding) {
+      ans.emplace_back();
+    }
+    ans.back().push_back(i);
+  }
+
+  return ans;
+}
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_BATCH_BY_DURATION_H_
@@ -0,0 +1,101 @@
+// sherpa-onnx/csrc/bounded-queue-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/bounded-queue.h"
+
+#include <atomic>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+TEST(BoundedQueue, Fifo) {
+  BoundedQueue<int32_t> q(3);
+
+  EXPECT_TRUE(q.Push(1));
+  EXPECT_TRUE(q.Push(2));
+  EXPECT_TRUE(q.Push(3));
+  EXPECT_EQ(q.Size(), 3);
+
+  int32_t v = 0;
+  EXPECT_TRUE(q.Pop(&v));
+  EXPECT_EQ(v, 1);
+
+  std::vector<int32_t> batch;
+  EXPECT_TRUE(q.PopBatch(10, &batch));
+  EXPECT_EQ(batch, (std::vector<int32_t>{2, 3}));
+  EXPECT_EQ(q.Size(), 0);
+}
+
+TEST(BoundedQueue, Close) {
+  BoundedQueue<int32_t> q(2);
+  EXPECT_TRUE(q.Push(1));
+  q.Close();
+
+  EXPECT_FALSE(q.Push(2));
+
+  // Remaining items can still be popped after Close()
+  int32_t v = 0;
+  EXPECT_TRUE(q.Pop(&v));
+  EXPECT_EQ(v, 1);
+
+  EXPECT_FALSE(q.Pop(&v));
+
+  std::vector<int32_t> batch;
+  EXPECT_FALSE(q.PopBatch(2, &batch));
+  EXPECT_TRUE(batch.empty());
+}
+
+TEST(BoundedQueue, MultipleThreads) {
+  int32_t capacity = 4;
+  BoundedQueue<int32_t> q(capacity);
+
+  int32_t num_producers = 3;
+  int32_t num_consumers = 3;
+  int32_t n = 10000;
+
+  std::atomic<int64_t> sum{0};
+  std::atomic<int32_t> max_size{0};
+
+  std::vector<std::thread> producers;
+  for (int32_t p = 0; p != num_producers; ++p) {
+    producers.emplace_back([&]() {
+      for (int32_t i = 1; i <= n; ++i) {
+        EXPECT_TRUE(q.Push(i));
+
+        int32_t size = q.Size();
+        if (size > max_size) {
+          max_size = size;
+        }
+      }
+    });
+  }
+
+  std::vector<std::thread> consumers;
+  for (int32_t c = 0; c != num_consumers; ++c) {
+    consumers.emplace_back([&]() {
+      int32_t v = 0;
+      while (q.Pop(&v)) {
+        sum += v;
+      }
+    });
+  }
+
+  for (auto &t : producers) {
+    t.join();
+  }
+
+  q.Close();
+
+  for (auto &t : consumers) {
+    t.join();
+  }
+
+  EXPECT_EQ(sum, static_cast<int64_t>(num_producers) * n * (n + 1) / 2);
+  EXPECT_LE(max_size, capacity);
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,116 @@
+// sherpa-onnx/csrc/bounded-queue.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_BOUNDED_QUEUE_H_
+#define SHERPA_ONNX_CSRC_BOUNDED_QUEUE_H_
+
+#include <algorithm>
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <deque>
+#include <mutex>  // NOLINT
+#include <utility>
+#include <vector>
+
+namespace sherpa_onnx {
+
+// A FIFO queue with a maximum size that can be used by multiple producer
+// and consumer threads.
+//
+// Push() blocks while the queue is full, so a fast producer is slowed down
+// to the speed of its consumers and the memory used by the queued items
+// stays bounded.
+//
+// After Close() is called, Push() fails and Pop() returns the remaining
+// items and then fails, which tells the consumers to exit.
+template <typename T>
+class BoundedQueue {
+ public:
+  explicit BoundedQueue(int32_t capacity) : capacity_(std::max(capacity, 1)) {}
+
+  // Return false if the queue is closed. v is not added in that case.
+  bool Push(T v) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_full_.wait(lock, [this]() {
+      return closed_ || static_cast<int32_t>(queue_.size()) < capacity_;
+    });
+
+    if (closed_) {
+      return false;
+    }
+
+    queue_.push_back(std::move(v));
+    lock.unlock();
+
+    not_empty_.notify_one();
+    return true;
+  }
+
+  // Wait until an item is available. Return false if the queue is closed
+  // and empty.
+  bool Pop(T *v) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_empty_.wait(lock, [this]() { return closed_ || !queue_.empty(); });
+
+    if (queue_.empty()) {
+      return false;
+    }
+
+    *v = std::move(queue_.front());
+    queue_.pop_front();
+    lock.unlock();
+
+    not_full_.notify_one();
+    return true;
+  }
+
+  // Wait until at least one item is available and move up to max_n items
+  // into out. Return false if the queue is closed and empty.
+  bool PopBatch(int32_t max_n, std::vector<T> *out) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_empty_.wait(lock, [this]() { return closed_ || !queue_.empty(); });
+
+    if (queue_.empty()) {
+      return false;
+    }
+
+    int32_t n = std::min<int32_t>(max_n, queue_.size());
+    for (int32_t i = 0; i != n; ++i) {
+      out->push_back(std::move(queue_.front()));
+      queue_.pop_front();
+    }
+    lock.unlock();
+
+    not_full_.notify_all();
+    return true;
+  }
+
+  void Close() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      closed_ = true;
+    }
+    not_full_.notify_all();
+    not_empty_.notify_all();
+  }
+
+  int32_t Size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size();
+  }
+
+ private:
+  int32_t capacity_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable not_full_;
+  std::condition_variable not_empty_;
+
+  std::deque<T> queue_;
+  bool closed_ = false;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_BOUNDED_QUEUE_H_
@@ -7,8 +7,10 @@
 #include <chrono>  // NOLINT
 #include <cmath>
 #include <map>
+#include <memory>
 #include <random>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -74,6 +76,111 @@ TEST(ContextGraph, TestCustomizeNonStrict) {
   TestHelper(queries, 5, false);
 }
 
+TEST(ContextGraph, TestPhrase) {
+  std::vector<std::string> contexts_str({"HE", "SHE", "HIS", "HERS"});
+  std::vector<std::vector<int32_t>> contexts;
+  std::vector<std::string> phrases;
+  for (const auto &c : contexts_str) {
+    contexts.emplace_back(c.begin(), c.end());
+    phrases.push_back("<" + c + ">");
+  }
+  auto context_graph = ContextGraph(contexts, 1, 0.5, {}, phrases);
+  EXPECT_EQ(context_graph.Phrase(context_graph.Root()), "");
+
+  // query, phrase matched after each token
+  std::vector<std::pair<std::string, std::vector<std::string>>> queries = {
+      {"USHERS", {"", "", "", "<SHE>", "", "<HERS>"}},
+      {"HISHE", {"", "", "<HIS>", "", "<SHE>"}},
+  };
+
+  for (const auto &q : queries) {
+    auto state = context_graph.Root();
+    for (int32_t i = 0; i != static_cast<int32_t>(q.first.size()); ++i) {
+      state = std::get<1>(context_graph.ForwardOneStep(state, q.first[i]));
+      auto matched = context_graph.IsMatched(state);
+      EXPECT_EQ(matched.first, !q.second[i].empty());
+      if (matched.first) {
+        EXPECT_EQ(context_graph.Phrase(matched.second), q.second[i]);
+        EXPECT_EQ(matched.second->ac_threshold, 0.5);
+      }
+    }
+  }
+}
+
+static std::vector<std::vector<int32_t>> ToTokens(
+    const std::vector<std::string> &contexts_str) {
+  std::vector<std::vector<int32_t>> contexts;
+  for (const auto &c : contexts_str) {
+    contexts.emplace_back(c.begin(), c.end());
+  }
+  return contexts;
+}
+
+static void TestBaseHelper(const std::vector<std::string> &base_str,
+                           const std::vector<float> &base_scores,
+                           const std::vector<std::string> &overlay_str,
+                           const std::vector<float> &overlay_scores,
+                           const std::vector<std::string> &queries,
+                           bool strict_mode) {
+  auto base =
+      std::make_shared<ContextGraph>(ToTokens(base_str), 1, base_scores);
+  auto layered =
+      ContextGraph(ToTokens(overlay_str), 1, overlay_scores, base);
+
+  // A single graph with the phrases of the base graph first
+  std::vector<std::string> all_str = base_str;
+  all_str.insert(all_str.end(), overlay_str.begin(), overlay_str.end());
+  std::vector<float> all_scores = base_scores;
+  all_scores.insert(all_scores.end(), overlay_scores.begin(),
+                    overlay_scores.end());
+  auto all = ContextGraph(ToTokens(all_str), 1, all_scores);
+
+  EXPECT_LE(layered.NumStates(), all.NumStates());
+
+  for (const auto &q : queries) {
+    auto state = all.Root();
+    auto layered_state = layered.Root();
+    auto base_state = layered.BaseRoot();
+    for (int32_t i = 0; i != static_cast<int32_t>(q.size()); ++i) {
+      auto res = all.ForwardOneStep(state, q[i], strict_mode);
+      state = std::get<1>(res);
+
+      float score = layered.ForwardOneStep(&layered_state, &base_state, q[i],
+                                           strict_mode);
+      EXPECT_NEAR(score, std::get<0>(res), 1e-5) << q << " " << i;
+    }
+
+    float score = layered.Finalize(&layered_state, &base_state);
+    EXPECT_NEAR(score, all.Finalize(state).first, 1e-5) << q;
+
+    EXPECT_EQ(layered_state, layered.Root());
+    EXPECT_EQ(base_state, base->Root());
+  }
+}
+
+TEST(ContextGraph, TestBase) {
+  std::vector<std::string> queries = {
+      "HEHERSHE", "HERSHE", "HISHE", "SHED",      "SHELF",     "HELL",
+      "HELLO",    "DHRHISQ", "THEN", "THISHELLO", "SHELLHERS", "USHERS"};
+
+  for (bool strict_mode : {true, false}) {
+    // A prefix of a phrase in one graph is a phrase in the other one
+    TestBaseHelper({"HE"}, {}, {"HELLO"}, {}, queries, strict_mode);
+    TestBaseHelper({"HELLO"}, {}, {"HE"}, {}, queries, strict_mode);
+
+    // SHE is in both graphs
+    TestBaseHelper({"S", "HE", "SHE", "SHELL", "HIS"}, {},
+                   {"HERS", "HELLO", "THIS", "THEM", "SHE"}, {}, queries,
+                   strict_mode);
+
+    // Phrases in the overlay graph raise the scores of prefixes in the
+    // base graph and the other way round
+    TestBaseHelper({"S", "HE", "SHE", "SHELL", "HIS"}, {1, 2, 1, 1, 3},
+                   {"HERS", "HELLO", "THIS", "THEM", "SHE"}, {2, 1, 1, 1, 3},
+                   queries, strict_mode);
+  }
+}
+
 TEST(ContextGraph, Benchmark) {
   std::random_device rd;
   std::mt19937 mt(rd());
@@ -99,4 +206,73 @@ TEST(ContextGraph, Benchmark) {
   }
 }
 
+// Decode random token sequences that contain the phrases with several
+// active states per step, as the modified beam search does.
+TEST(ContextGraph, BenchmarkForwardOneStep) {
+  std::mt19937 mt(20250101);
+  int32_t vocab_size = 500;
+  std::uniform_int_distribution<int32_t> token_dist(0, vocab_size - 1);
+  std::uniform_int_distribution<int32_t> len_dist(2, 8);
+
+  for (int32_t num = 1000; num <= 100000; num *= 10) {
+    std::vector<std::vector<int32_t>> contexts;
+    std::vector<std::string> phrases;
+    for (int32_t i = 0; i < num; ++i) {
+      std::vector<int32_t> tmp;
+      int32_t word_len = len_dist(mt);
+      for (int32_t j = 0; j < word_len; ++j) {
+        tmp.push_back(token_dist(mt));
+      }
+      contexts.push_back(std::move(tmp));
+      phrases.push_back("phrase-" + std::to_string(i));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto context_graph = ContextGraph(contexts, 1, 0, {}, phrases);
+    auto stop = std::chrono::steady_clock::now();
+    float build_ms = std::chrono::duration<float>(stop - start).count() * 1000;
+
+    // Half of the input consists of phrases, the other half of random tokens
+    std::vector<int32_t> input;
+    std::uniform_int_distribution<int32_t> phrase_dist(0, num - 1);
+    while (input.size() < 100000) {
+      const auto &c = contexts[phrase_dist(mt)];
+      input.insert(input.end(), c.begin(), c.end());
+      for (int32_t i = 0; i != static_cast<int32_t>(c.size()); ++i) {
+        input.push_back(token_dist(mt));
+      }
+    }
+
+    int32_t num_states = 4;
+    std::vector<const ContextState *> states(num_states, context_graph.Root());
+
+    int64_t num_steps = 0;
+    float total_score = 0;
+    start = std::chrono::steady_clock::now();
+    for (int32_t k = 0; k != 5; ++k) {
+      for (int32_t i = 0; i != static_cast<int32_t>(input.size()); ++i) {
+        for (int32_t s = 0; s != num_states; ++s) {
+          // Each active state sees a slightly different token, like
+          // the hypotheses of a beam search
+          int32_t token = s == 0 ? input[i] : (input[i] + s) % vocab_size;
+          auto res = context_graph.ForwardOneStep(states[s], token);
+          total_score += std::get<0>(res);
+          states[s] = std::get<1>(res);
+          ++num_steps;
+        }
+      }
+    }
+    stop = std::chrono::steady_clock::now();
+    float seconds = std::chrono::duration<float>(stop - start).count();
+    EXPECT_NE(total_score, 0);
+
+    SHERPA_ONNX_LOGE(
+        "%d phrases: %d states, %.2f MB, build %.1f ms, ForwardOneStep %.1f "
+        "ns per call, %.1f M calls/s",
+        num, context_graph.NumStates(),
+        context_graph.NumBytes() / 1024.0 / 1024, build_ms,
+        seconds * 1e9 / num_steps, num_steps / seconds / 1e6);
+  }
+}
+
 }  // namespace sherpa_onnx
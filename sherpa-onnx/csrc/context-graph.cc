@@ -6,18 +6,114 @@
 
 #include <algorithm>
 #include <cassert>
+#include <memory>
 #include <queue>
 #include <string>
 #include <tuple>
+#include <unordered_map>
 #include <utility>
 
 #include "sherpa-onnx/csrc/macros.h"
 
 namespace sherpa_onnx {
+
+namespace {
+
+// A node of the trie used while building the graph. It is converted to
+// the compact ContextState array once the fail and output arcs are filled.
+struct TrieNode {
+  int32_t token;
+  float token_score;
+  float node_score;
+  float output_score;
+  int32_t level;
+  float ac_threshold;
+  bool is_end;
+  std::string phrase;
+  std::unordered_map<int32_t, std::unique_ptr<TrieNode>> next;
+  const TrieNode *fail = nullptr;
+  const TrieNode *output = nullptr;
+
+  // id of the corresponding ContextState
+  int32_t id = 0;
+
+  // id of the state with the same tokens in the base graph, or -1
+  int32_t base_id = -1;
+
+  TrieNode(int32_t token, float token_score, float node_score,
+           float output_score, int32_t level = 0, float ac_threshold = 0.0f,
+           bool is_end = false, const std::string &phrase = {})
+      : token(token),
+        token_score(token_score),
+        node_score(node_score),
+        output_score(output_score),
+        level(level),
+        ac_threshold(ac_threshold),
+        is_end(is_end),
+        phrase(phrase) {}
+};
+
+}  // namespace
+
+static void FillFailOutput(TrieNode *root) {
+  std::queue<TrieNode *> node_queue;
+  for (auto &kv : root->next) {
+    kv.second->fail = root;
+    node_queue.push(kv.second.get());
+  }
+  while (!node_queue.empty()) {
+    auto current_node = node_queue.front();
+    node_queue.pop();
+    for (auto &kv : current_node->next) {
+      auto fail = current_node->fail;
+      if (1 == fail->next.count(kv.first)) {
+        fail = fail->next.at(kv.first).get();
+      } else {
+        fail = fail->fail;
+        while (0 == fail->next.count(kv.first)) {
+          fail = fail->fail;
+          if (-1 == fail->token) break;
+        }
+        if (1 == fail->next.count(kv.first))
+          fail = fail->next.at(kv.first).get();
+      }
+      kv.second->fail = fail;
+      // fill the output arc
+      auto output = fail;
+      while (!output->is_end) {
+        output = output->fail;
+        if (-1 == output->token) {
+          output = nullptr;
+          break;
+        }
+      }
+      kv.second->output = output;
+      kv.second->output_score += output == nullptr ? 0 : output->output_score;
+      node_queue.push(kv.second.get());
+    }
+  }
+}
+
+ContextGraph::ContextGraph(const std::vector<std::vector<int32_t>> &token_ids,
+                           float context_score,
+                           const std::vector<float> &scores,
+                           ContextGraphPtr base)
+    : context_score_(context_score), base_(std::move(base)) {
+  if (!scores.empty()) {
+    SHERPA_ONNX_CHECK_EQ(token_ids.size(), scores.size());
+  }
+
+  if (base_) {
+    SHERPA_ONNX_CHECK(base_->base_ == nullptr);
+  }
+
+  Build(token_ids, scores, {}, {});
+}
+
 void ContextGraph::Build(const std::vector<std::vector<int32_t>> &token_ids,
                          const std::vector<float> &scores,
                          const std::vector<std::string> &phrases,
-                         const std::vector<float> &ac_thresholds) const {
+                         const std::vector<float> &ac_thresholds) {
   if (!scores.empty()) {
     SHERPA_ONNX_CHECK_EQ(token_ids.size(), scores.size());
   }
@@ -27,8 +123,15 @@ void ContextGraph::Build(const std::vector<std::vector<int32_t>> &token_ids,
   if (!ac_thresholds.empty()) {
     SHERPA_ONNX_CHECK_EQ(token_ids.size(), ac_thresholds.size());
   }
+
+  auto root = std::make_unique<TrieNode>(-1, 0, 0, 0);
+  root->fail = root.get();
+  root->base_id = base_ ? 0 : -1;
+
+  int32_t num_nodes = 1;
+
   for (int32_t i = 0; i < static_cast<int32_t>(token_ids.size()); ++i) {
-    auto node = root_.get();
+    auto node = root.get();
     float score = scores.empty() ? 0.0f : scores[i];
     score = score == 0.0f ? context_score_ : score;
     float ac_threshold = ac_thresholds.empty() ? 0.0f : ac_thresholds[i];
@@ -37,13 +140,29 @@ void ContextGraph::Build(const std::vector<std::vector<int32_t>> &token_ids,
 
     for (int32_t j = 0; j < static_cast<int32_t>(token_ids[i].size()); ++j) {
       int32_t token = token_ids[i][j];
+      if (0 == node->next.count(token) && node->base_id != -1) {
+        // Start from the state in the base graph, as if the phrases of the
+        // base graph were added before token_ids
+        int32_t b = base_->Next(base_->states_[node->base_id], token);
+        if (b != -1) {
+          const ContextState &bs = base_->states_[b];
+          node->next[token] = std::make_unique<TrieNode>(
+              token, bs.token_score, bs.node_score,
+              bs.is_end ? bs.node_score : 0, bs.level, bs.ac_threshold,
+              bs.is_end, base_->Phrase(&bs));
+          node->next[token]->base_id = b;
+          ++num_nodes;
+        }
+      }
+
       if (0 == node->next.count(token)) {
         bool is_end = j == (static_cast<int32_t>(token_ids[i].size()) - 1);
-        node->next[token] = std::make_unique<ContextState>(
+        node->next[token] = std::make_unique<TrieNode>(
             token, score, node->node_score + score,
             is_end ? node->node_score + score : 0, j + 1,
             is_end ? ac_threshold : 0.0f, is_end,
             is_end ? phrase : std::string());
+        ++num_nodes;
       } else {
         float token_score = std::max(score, node->next[token]->token_score);
         node->next[token]->token_score = token_score;
@@ -61,53 +180,228 @@ void ContextGraph::Build(const std::vector<std::vector<int32_t>> &token_ids,
       node = node->next[token].get();
     }
   }
-  FillFailOutput();
-}
+  FillFailOutput(root.get());
 
-std::tuple<float, const ContextState *, const ContextState *>
-ContextGraph::ForwardOneStep(const ContextState *state, int32_t token,
-                             bool strict_mode /*= true*/) const {
-  const ContextState *node = nullptr;
-  float score = 0;
-  if (1 == state->next.count(token)) {
-    node = state->next.at(token).get();
-    score = node->token_score;
-  } else {
-    node = state->fail;
-    while (0 == node->next.count(token)) {
-      node = node->fail;
-      if (-1 == node->token) break;  // root
+  // Number the nodes in breadth-first order with the children of each node
+  // sorted by token, so that the children of a node get consecutive ids
+  std::vector<TrieNode *> nodes;
+  nodes.reserve(num_nodes);
+  nodes.push_back(root.get());
+
+  states_.resize(num_nodes);
+  tokens_.resize(num_nodes);
+
+  std::vector<TrieNode *> children;
+  for (int32_t i = 0; i != static_cast<int32_t>(nodes.size()); ++i) {
+    TrieNode *node = nodes[i];
+
+    children.clear();
+    for (auto &kv : node->next) {
+      children.push_back(kv.second.get());
+    }
+    std::sort(children.begin(), children.end(),
+              [](const TrieNode *a, const TrieNode *b) {
+                return a->token < b->token;
+              });
+
+    ContextState &s = states_[i];
+    s.next_begin = nodes.size();
+    for (auto c : children) {
+      c->id = nodes.size();
+      nodes.push_back(c);
+    }
+    s.next_end = nodes.size();
+  }
+
+  for (int32_t i = 0; i != num_nodes; ++i) {
+    const TrieNode *node = nodes[i];
+    ContextState &s = states_[i];
+
+    s.token = node->token;
+    s.token_score = node->token_score;
+    s.node_score = node->node_score;
+    s.output_score = node->output_score;
+    s.level = node->level;
+    s.ac_threshold = node->ac_threshold;
+    s.is_end = node->is_end;
+    s.fail = node->fail->id;
+    s.output = node->output != nullptr ? node->output->id : -1;
+
+    if (!node->phrase.empty()) {
+      s.phrase_id = phrases_.size();
+      phrases_.push_back(node->phrase);
+    }
+
+    tokens_[i] = node->token;
+  }
+
+  if (base_) {
+    // Outputs are visited in breadth-first order, so s.output < i
+    duplicated_output_scores_.resize(num_nodes);
+    for (int32_t i = 0; i != num_nodes; ++i) {
+      const ContextState &s = states_[i];
+      int32_t b = nodes[i]->base_id;
+
+      float score = 0;
+      if (b != -1 && base_->states_[b].is_end) {
+        score = base_->states_[b].node_score;
+      }
+
+      if (s.output != -1) {
+        score += duplicated_output_scores_[s.output];
+      }
+
+      duplicated_output_scores_[i] = score;
     }
-    if (1 == node->next.count(token)) {
-      node = node->next.at(token).get();
+  }
+
+  const ContextState &r = states_[0];
+  int32_t max_token = -1;
+  for (int32_t i = r.next_begin; i != r.next_end; ++i) {
+    max_token = std::max(max_token, tokens_[i]);
+  }
+
+  root_next_.resize(max_token + 1, -1);
+  for (int32_t i = r.next_begin; i != r.next_end; ++i) {
+    if (tokens_[i] >= 0) {
+      root_next_[tokens_[i]] = i;
     }
-    score = node->node_score - state->node_score;
+  }
+}
+
+int32_t ContextGraph::Next(const ContextState &state, int32_t token) const {
+  if (&state == states_.data() && token >= 0 &&
+      token < static_cast<int32_t>(root_next_.size())) {
+    return root_next_[token];
+  }
+
+  auto begin = tokens_.begin() + state.next_begin;
+  auto end = tokens_.begin() + state.next_end;
+  auto it = std::lower_bound(begin, end, token);
+  if (it != end && *it == token) {
+    return it - tokens_.begin();
+  }
+
+  return -1;
+}
+
+const ContextState *ContextGraph::NextState(const ContextState *state,
+                                            int32_t token) const {
+  int32_t next = Next(*state, token);
+  if (next != -1) {
+    return &states_[next];
   }
 
-  if (!node) {
-    SHERPA_ONNX_LOGE("Some bad things happened.");
-    exit(-1);
+  const ContextState *node = &states_[state->fail];
+  while (true) {
+    next = Next(*node, token);
+    if (next != -1 || -1 == node->token) break;  // found or root
+    node = &states_[node->fail];
+  }
+
+  return next != -1 ? &states_[next] : node;
+}
+
+const ContextState *ContextGraph::MatchedState(
+    const ContextState *state) const {
+  if (state->is_end) {
+    return state;
   }
 
-  const ContextState *matched_node =
-      node->is_end ? node : (node->output != nullptr ? node->output : nullptr);
+  return state->output != -1 ? &states_[state->output] : nullptr;
+}
+
+// Return the state with the larger level. For states of the base graph and
+// the graph on top of it, it is the state of the combined graph.
+static const ContextState *Longer(const ContextState *a,
+                                  const ContextState *b) {
+  if (a == nullptr) return b;
+  if (b == nullptr) return a;
+  return a->level >= b->level ? a : b;
+}
+
+std::tuple<float, const ContextState *, const ContextState *>
+ContextGraph::ForwardOneStep(const ContextState *state, int32_t token,
+                             bool strict_mode /*= true*/) const {
+  const ContextState *node = NextState(state, token);
+  float score = node->level == state->level + 1
+                    ? node->token_score
+                    : node->node_score - state->node_score;
+
+  const ContextState *output =
+      node->output != -1 ? &states_[node->output] : nullptr;
+
+  const ContextState *matched_node = node->is_end ? node : output;
 
   if (!strict_mode && node->output_score != 0) {
     SHERPA_ONNX_CHECK(nullptr != matched_node);
     float output_score =
         node->is_end ? node->node_score
-                     : (node->output != nullptr ? node->output->node_score
-                                                : node->node_score);
-    return std::make_tuple(score + output_score - node->node_score, root_.get(),
+                     : (output != nullptr ? output->node_score
+                                          : node->node_score);
+    return std::make_tuple(score + output_score - node->node_score, Root(),
                            matched_node);
   }
   return std::make_tuple(score + node->output_score, node, matched_node);
 }
 
+float ContextGraph::ForwardOneStep(const ContextState **state,
+                                   const ContextState **base_state,
+                                   int32_t token_id,
+                                   bool strict_mode /*= true*/) const {
+  if (!base_) {
+    auto res = ForwardOneStep(*state, token_id, strict_mode);
+    *state = std::get<1>(res);
+    return std::get<0>(res);
+  }
+
+  // Each graph keeps the longest suffix of the input that is a prefix of
+  // its own phrases. The longer one is the state of the combined graph.
+  const ContextState *prev = Longer(*state, *base_state);
+
+  const ContextState *s = NextState(*state, token_id);
+  const ContextState *b = base_->NextState(*base_state, token_id);
+  const ContextState *node = Longer(s, b);
+
+  float score = node->level == prev->level + 1
+                    ? node->token_score
+                    : node->node_score - prev->node_score;
+
+  // Phrases in both graphs are matched by both of them
+  float output_score = s->output_score + b->output_score -
+                       duplicated_output_scores_[s - states_.data()];
+
+  if (!strict_mode && output_score != 0) {
+    const ContextState *matched =
+        Longer(MatchedState(s), base_->MatchedState(b));
+    SHERPA_ONNX_CHECK(nullptr != matched);
+
+    *state = Root();
+    *base_state = base_->Root();
+    return score + matched->node_score - node->node_score;
+  }
+
+  *state = s;
+  *base_state = b;
+  return score + output_score;
+}
+
 std::pair<float, const ContextState *> ContextGraph::Finalize(
     const ContextState *state) const {
   float score = -state->node_score;
-  return std::make_pair(score, root_.get());
+  return std::make_pair(score, Root());
+}
+
+float ContextGraph::Finalize(const ContextState **state,
+                             const ContextState **base_state) const {
+  float score = -Longer(*state, base_ ? *base_state : nullptr)->node_score;
+
+  *state = Root();
+  if (base_) {
+    *base_state = base_->Root();
+  }
+
+  return score;
 }
 
 std::pair<bool, const ContextState *> ContextGraph::IsMatched(
@@ -118,50 +412,35 @@ std::pair<bool, const ContextState *> ContextGraph::IsMatched(
     status = true;
     node = state;
   } else {
-    if (state->output != nullptr) {
+    if (state->output != -1) {
       status = true;
-      node = state->output;
+      node = &states_[state->output];
     }
   }
   return std::make_pair(status, node);
 }
 
-void ContextGraph::FillFailOutput() const {
-  std::queue<const ContextState *> node_queue;
-  for (auto &kv : root_->next) {
-    kv.second->fail = root_.get();
-    node_queue.push(kv.second.get());
+const std::string &ContextGraph::Phrase(const ContextState *state) const {
+  static const std::string kEmpty;
+  if (state->phrase_id == -1) {
+    return kEmpty;
   }
-  while (!node_queue.empty()) {
-    auto current_node = node_queue.front();
-    node_queue.pop();
-    for (auto &kv : current_node->next) {
-      auto fail = current_node->fail;
-      if (1 == fail->next.count(kv.first)) {
-        fail = fail->next.at(kv.first).get();
-      } else {
-        fail = fail->fail;
-        while (0 == fail->next.count(kv.first)) {
-          fail = fail->fail;
-          if (-1 == fail->token) break;
-        }
-        if (1 == fail->next.count(kv.first))
-          fail = fail->next.at(kv.first).get();
-      }
-      kv.second->fail = fail;
-      // fill the output arc
-      auto output = fail;
-      while (!output->is_end) {
-        output = output->fail;
-        if (-1 == output->token) {
-          output = nullptr;
-          break;
-        }
-      }
-      kv.second->output = output;
-      kv.second->output_score += output == nullptr ? 0 : output->output_score;
-      node_queue.push(kv.second.get());
+  return phrases_[state->phrase_id];
+}
+
+int64_t ContextGraph::NumBytes() const {
+  int64_t ans = sizeof(*this);
+  ans += states_.capacity() * sizeof(ContextState);
+  ans += tokens_.capacity() * sizeof(int32_t);
+  ans += root_next_.capacity() * sizeof(int32_t);
+  ans += phrases_.capacity() * sizeof(std::string);
+  ans += duplicated_output_scores_.capacity() * sizeof(float);
+  for (const auto &p : phrases_) {
+    if (p.capacity() > std::string().capacity()) {
+      ans += p.capacity() + 1;
     }
   }
+  return ans;
 }
+
 }  // namespace sherpa_onnx
@@ -8,7 +8,6 @@
 #include <memory>
 #include <string>
 #include <tuple>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -19,31 +18,33 @@ namespace sherpa_onnx {
 class ContextGraph;
 using ContextGraphPtr = std::shared_ptr<ContextGraph>;
 
+// A state of the context graph.
+//
+// After construction, all states of a graph are stored in one array in
+// breadth-first order, so the children of a state have consecutive ids and
+// are sorted by token. A state refers to other states by id instead of by
+// pointer and has no per-state containers.
 struct ContextState {
-  int32_t token;
-  float token_score;
-  float node_score;
-  float output_score;
-  int32_t level;
-  float ac_threshold;
-  bool is_end;
-  std::string phrase;
-  std::unordered_map<int32_t, std::unique_ptr<ContextState>> next;
-  const ContextState *fail = nullptr;
-  const ContextState *output = nullptr;
-
-  ContextState() = default;
-  ContextState(int32_t token, float token_score, float node_score,
-               float output_score, int32_t level = 0, float ac_threshold = 0.0f,
-               bool is_end = false, const std::string &phrase = {})
-      : token(token),
-        token_score(token_score),
-        node_score(node_score),
-        output_score(output_score),
-        level(level),
-        ac_threshold(ac_threshold),
-        is_end(is_end),
-        phrase(phrase) {}
+  int32_t token = -1;
+  float token_score = 0;
+  float node_score = 0;
+  float output_score = 0;
+  int32_t level = 0;
+  float ac_threshold = 0;
+  bool is_end = false;
+
+  // Index into the phrases of the graph. -1 if the state has no phrase.
+  // Use ContextGraph::Phrase() to get it.
+  int32_t phrase_id = -1;
+
+  // Children of this state are states [next_begin, next_end)
+  int32_t next_begin = 0;
+  int32_t next_end = 0;
+
+  int32_t fail = 0;
+
+  // -1 if there is no output state
+  int32_t output = -1;
 };
 
 class ContextGraph {
@@ -55,8 +56,6 @@ class ContextGraph {
                const std::vector<std::string> &phrases = {},
                const std::vector<float> &ac_thresholds = {})
       : context_score_(context_score), ac_threshold_(ac_threshold) {
-    root_ = std::make_unique<ContextState>(-1, 0, 0, 0);
-    root_->fail = root_.get();
     Build(token_ids, scores, phrases, ac_thresholds);
   }
 
@@ -65,27 +64,101 @@ class ContextGraph {
       : ContextGraph(token_ids, context_score, 0.0f, scores,
                      std::vector<std::string>(), std::vector<float>()) {}
 
+  // Build a graph for token_ids on top of a shared base graph, e.g., the
+  // hotwords of a stream on top of the hotwords of the recognizer. The base
+  // graph is not copied, so the time and memory to build the graph depend
+  // only on token_ids.
+  //
+  // Decode with the ForwardOneStep() and Finalize() overloads that take
+  // a state of both graphs. They return the same scores as a single graph
+  // built from the phrases of the base graph followed by token_ids.
+  ContextGraph(const std::vector<std::vector<int32_t>> &token_ids,
+               float context_score, const std::vector<float> &scores,
+               ContextGraphPtr base);
+
   std::tuple<float, const ContextState *, const ContextState *> ForwardOneStep(
       const ContextState *state, int32_t token_id,
       bool strict_mode = true) const;
 
+  // Advance *state, a state of this graph, and *base_state, a state of the
+  // base graph, by one token and return the score of the combined graph.
+  //
+  // base_state is not used if the graph has no base graph.
+  float ForwardOneStep(const ContextState **state,
+                       const ContextState **base_state, int32_t token_id,
+                       bool strict_mode = true) const;
+
   std::pair<bool, const ContextState *> IsMatched(
       const ContextState *state) const;
 
   std::pair<float, const ContextState *> Finalize(
       const ContextState *state) const;
 
-  const ContextState *Root() const { return root_.get(); }
+  // Like Finalize() above, but for a state of this graph and a state
+  // of the base graph. Both are reset to the root.
+  float Finalize(const ContextState **state,
+                 const ContextState **base_state) const;
+
+  const ContextState *Root() const {
+    return states_.empty() ? nullptr : states_.data();
+  }
+
+  // Return nullptr if the graph has no base graph
+  const ContextState *BaseRoot() const {
+    return base_ ? base_->Root() : nullptr;
+  }
+
+  // Return the phrase of a matched state, or an empty string if it has none
+  const std::string &Phrase(const ContextState *state) const;
+
+  int32_t NumStates() const { return states_.size(); }
+
+  // Number of bytes used by the graph, not including the base graph
+  int64_t NumBytes() const;
 
  private:
-  float context_score_;
-  float ac_threshold_;
-  std::unique_ptr<ContextState> root_;
   void Build(const std::vector<std::vector<int32_t>> &token_ids,
              const std::vector<float> &scores,
              const std::vector<std::string> &phrases,
-             const std::vector<float> &ac_thresholds) const;
-  void FillFailOutput() const;
+             const std::vector<float> &ac_thresholds);
+
+  // Return the id of the child of the given state with the given token,
+  // or -1 if there is no such child
+  int32_t Next(const ContextState &state, int32_t token) const;
+
+  // Return the state reached from the given state with the given token,
+  // following fail arcs if needed
+  const ContextState *NextState(const ContextState *state,
+                                int32_t token) const;
+
+  // Return the longest phrase that is a suffix of the given state, or
+  // nullptr if there is none
+  const ContextState *MatchedState(const ContextState *state) const;
+
+  float context_score_ = 0;
+  float ac_threshold_ = 0;
+
+  // states_[0] is the root
+  std::vector<ContextState> states_;
+
+  // tokens_[i] == states_[i].token. Children are looked up with a binary
+  // search in this array, which is more cache friendly than searching
+  // states_.
+  std::vector<int32_t> tokens_;
+
+  // root_next_[token] is the id of the child of the root with the given
+  // token, or -1. Every failed match ends at the root, so it is looked up
+  // much more often than other states.
+  std::vector<int32_t> root_next_;
+
+  std::vector<std::string> phrases_;
+
+  ContextGraphPtr base_;
+
+  // Only for a graph with a base graph. duplicated_output_scores_[i] is the
+  // part of the output score of base_ that is also in states_[i].output_score
+  // since the phrase is in both graphs.
+  std::vector<float> duplicated_output_scores_;
 };
 
 }  // namespace sherpa_onnx
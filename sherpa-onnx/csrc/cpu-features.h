@@ -0,0 +1,51 @@
+// sherpa-onnx/csrc/cpu-features.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_CPU_FEATURES_H_
+#define SHERPA_ONNX_CSRC_CPU_FEATURES_H_
+
+// Support for AVX2 kernels on x86.
+//
+// If SHERPA_ONNX_ENABLE_AVX2_KERNELS is 1, functions marked with
+// SHERPA_ONNX_TARGET_AVX2 can use AVX2 and FMA intrinsics from
+// <immintrin.h>. They must be called only if CpuSupportsAvx2Fma() returns
+// true.
+//
+// With GCC and clang, such functions are compiled for AVX2 and FMA even if
+// the rest of the code is not, e.g., with the default -march, and they are
+// selected at runtime. If the code is compiled with -mavx2 -mfma, no
+// runtime check is needed.
+
+#if defined(__AVX2__) && defined(__FMA__)
+
+#define SHERPA_ONNX_ENABLE_AVX2_KERNELS 1
+#define SHERPA_ONNX_TARGET_AVX2
+
+namespace sherpa_onnx {
+inline bool CpuSupportsAvx2Fma() { return true; }
+}  // namespace sherpa_onnx
+
+#elif (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+
+#define SHERPA_ONNX_ENABLE_AVX2_KERNELS 1
+#define SHERPA_ONNX_TARGET_AVX2 __attribute__((target("avx2,fma")))
+
+namespace sherpa_onnx {
+inline bool CpuSupportsAvx2Fma() {
+  static const bool ans = []() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  }();
+  return ans;
+}
+}  // namespace sherpa_onnx
+
+#else
+
+#define SHERPA_ONNX_ENABLE_AVX2_KERNELS 0
+
+#endif
+
+#endif  // SHERPA_ONNX_CSRC_CPU_FEATURES_H_
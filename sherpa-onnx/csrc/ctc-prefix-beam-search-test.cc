@@ -0,0 +1,276 @@
+// sherpa-onnx/csrc/ctc-prefix-beam-search-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/ctc-prefix-beam-search.h"
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cmath>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/math.h"
+
+namespace sherpa_onnx {
+
+// Return log probs of shape (num_frames, vocab_size). Blank is 0.
+// If peaky is true, most frames are dominated by blank, like the output
+// of a real CTC model.
+static std::vector<float> RandomLogProbs(int32_t num_frames,
+                                         int32_t vocab_size, bool peaky,
+                                         std::mt19937 *gen) {
+  std::uniform_real_distribution<float> dist(-3, 3);
+  std::uniform_int_distribution<int32_t> token(1, vocab_size - 1);
+  std::uniform_real_distribution<float> prob(0, 1);
+
+  std::vector<float> ans(num_frames * vocab_size);
+  for (int32_t t = 0; t != num_frames; ++t) {
+    float *p = ans.data() + t * vocab_size;
+    for (int32_t i = 0; i != vocab_size; ++i) {
+      p[i] = dist(*gen);
+    }
+
+    if (peaky) {
+      if (prob(*gen) < 0.7) {
+        p[0] += 15;
+      } else {
+        p[token(*gen)] += 10;
+      }
+    }
+
+    LogSoftmax(p, vocab_size);
+  }
+
+  return ans;
+}
+
+static std::vector<int64_t> GreedySearch(const std::vector<float> &log_probs,
+                                         int32_t vocab_size) {
+  std::vector<int64_t> ans;
+  int32_t num_frames = log_probs.size() / vocab_size;
+  int64_t prev = -1;
+  for (int32_t t = 0; t != num_frames; ++t) {
+    const float *p = log_probs.data() + t * vocab_size;
+    int64_t y = std::distance(p, std::max_element(p, p + vocab_size));
+    if (y != 0 && y != prev) {
+      ans.push_back(y);
+    }
+    prev = y;
+  }
+  return ans;
+}
+
+TEST(CtcPrefixBeamSearch, Exact) {
+  // Without pruning, the score of a prefix is the total probability of all
+  // alignments that collapse to it.
+  int32_t vocab_size = 4;
+  int32_t num_frames = 6;
+
+  std::mt19937 gen(20250101);
+  auto log_probs = RandomLogProbs(num_frames, vocab_size, false, &gen);
+
+  std::map<std::vector<int64_t>, double> expected;
+
+  int32_t num_paths = 1;
+  for (int32_t t = 0; t != num_frames; ++t) {
+    num_paths *= vocab_size;
+  }
+
+  for (int32_t path = 0; path != num_paths; ++path) {
+    std::vector<int64_t> prefix;
+    double log_prob = 0;
+    int32_t prev = -1;
+    for (int32_t t = 0, k = path; t != num_frames; ++t, k /= vocab_size) {
+      int32_t y = k % vocab_size;
+      log_prob += log_probs[t * vocab_size + y];
+      if (y != 0 && y != prev) {
+        prefix.push_back(y);
+      }
+      prev = y;
+    }
+
+    auto it = expected.find(prefix);
+    if (it == expected.end()) {
+      expected[prefix] = log_prob;
+    } else {
+      it->second = LogAdd<double>()(it->second, log_prob);
+    }
+  }
+
+  CtcPrefixBeamSearch search(0, 100000, 0);
+  search.Decode(log_probs.data(), num_frames, vocab_size);
+
+  auto hyps = search.GetHypotheses(true);
+  EXPECT_EQ(hyps.size(), expected.size());
+
+  for (const auto &h : hyps) {
+    ASSERT_TRUE(expected.count(h.ys));
+    EXPECT_NEAR(h.log_prob, expected[h.ys], 1e-3);
+  }
+
+  auto best = std::max_element(
+      expected.begin(), expected.end(),
+      [](const auto &a, const auto &b) { return a.second < b.second; });
+  EXPECT_EQ(hyps[0].ys, best->first);
+}
+
+TEST(CtcPrefixBeamSearch, Streaming) {
+  int32_t vocab_size = 50;
+  int32_t num_frames = 200;
+
+  std::mt19937 gen(20250102);
+  auto log_probs = RandomLogProbs(num_frames, vocab_size, true, &gen);
+
+  CtcPrefixBeamSearch search(0, 4, 0);
+  search.Decode(log_probs.data(), num_frames, vocab_size);
+
+  std::vector<int64_t> tokens;
+  std::vector<int32_t> timestamps;
+  search.GetBest(&tokens, &timestamps);
+  EXPECT_EQ(tokens.size(), timestamps.size());
+
+  // On peaky outputs, prefix beam search should agree with greedy search
+  EXPECT_EQ(tokens, GreedySearch(log_probs, vocab_size));
+
+  CtcPrefixBeamSearch chunked(0, 4, 0);
+  int32_t chunk_size = 16;
+  for (int32_t t = 0; t < num_frames; t += chunk_size) {
+    int32_t n = std::min(chunk_size, num_frames - t);
+    chunked.Decode(log_probs.data() + t * vocab_size, n, vocab_size);
+  }
+
+  std::vector<int64_t> tokens2;
+  std::vector<int32_t> timestamps2;
+  chunked.GetBest(&tokens2, &timestamps2);
+  EXPECT_EQ(tokens, tokens2);
+  EXPECT_EQ(timestamps, timestamps2);
+  EXPECT_EQ(chunked.NumFrames(), num_frames);
+}
+
+TEST(CtcPrefixBeamSearch, Hotwords) {
+  int32_t vocab_size = 4;
+  // Token 2 and token 3 are almost equally likely on frame 2.
+  // Greedy search prefers 3, i.e., 1 3, while the hotword is 1 2.
+  std::vector<float> probs = {
+      0.1, 0.8, 0.05, 0.05,  //
+      0.9, 0.05, 0.02, 0.03,  //
+      0.1, 0.02, 0.42, 0.46,  //
+      0.9, 0.04, 0.03, 0.03,  //
+  };
+
+  int32_t num_frames = probs.size() / vocab_size;
+  std::vector<float> log_probs(probs.size());
+  std::transform(probs.begin(), probs.end(), log_probs.begin(),
+                 [](float p) { return std::log(p); });
+
+  EXPECT_EQ(GreedySearch(log_probs, vocab_size),
+            (std::vector<int64_t>{1, 3}));
+
+  CtcPrefixBeamSearch search(0, 4, 0);
+  search.Decode(log_probs.data(), num_frames, vocab_size);
+  auto hyps = search.GetHypotheses(true);
+  EXPECT_EQ(hyps[0].ys, (std::vector<int64_t>{1, 3}));
+
+  auto graph = std::make_shared<ContextGraph>(
+      std::vector<std::vector<int32_t>>{{1, 2}}, 1.0);
+
+  CtcPrefixBeamSearch biased(0, 4, 0, graph);
+  biased.Decode(log_probs.data(), num_frames, vocab_size);
+  hyps = biased.GetHypotheses(true);
+  EXPECT_EQ(hyps[0].ys, (std::vector<int64_t>{1, 2}));
+
+  // A partially matched hotword gets no bonus after finalization
+  auto graph2 = std::make_shared<ContextGraph>(
+      std::vector<std::vector<int32_t>>{{1, 2, 1}}, 1.0);
+
+  CtcPrefixBeamSearch partial(0, 4, 0, graph2);
+  partial.Decode(log_probs.data(), num_frames, vocab_size);
+  hyps = partial.GetHypotheses(true);
+  EXPECT_EQ(hyps[0].ys, (std::vector<int64_t>{1, 3}));
+}
+
+TEST(CtcPrefixBeamSearch, BlankSkip) {
+  int32_t vocab_size = 50;
+  int32_t num_frames = 500;
+
+  std::mt19937 gen(20250103);
+  auto log_probs = RandomLogProbs(num_frames, vocab_size, true, &gen);
+
+  CtcPrefixBeamSearch search(0, 4, 0);
+  search.Decode(log_probs.data(), num_frames, vocab_size);
+  EXPECT_EQ(search.NumSkippedFrames(), 0);
+
+  CtcPrefixBeamSearch skipped(0, 4, 0.95);
+  skipped.Decode(log_probs.data(), num_frames, vocab_size);
+  EXPECT_GT(skipped.NumSkippedFrames(), num_frames / 2);
+
+  std::vector<int64_t> tokens;
+  std::vector<int64_t> tokens2;
+  std::vector<int32_t> timestamps;
+  std::vector<int32_t> timestamps2;
+  search.GetBest(&tokens, &timestamps);
+  skipped.GetBest(&tokens2, &timestamps2);
+
+  EXPECT_EQ(tokens, tokens2);
+  EXPECT_EQ(timestamps, timestamps2);
+}
+
+TEST(CtcPrefixBeamSearch, Benchmark) {
+  // About 40 seconds of audio with 40 ms per output frame
+  int32_t num_frames = 1000;
+  int32_t vocab_size = 500;
+  int32_t num_repeats = 5;
+
+  std::mt19937 gen(20250104);
+  auto log_probs = RandomLogProbs(num_frames, vocab_size, true, &gen);
+
+  std::vector<std::vector<int32_t>> phrases(1000);
+  std::uniform_int_distribution<int32_t> token(1, vocab_size - 1);
+  for (auto &p : phrases) {
+    p.resize(4);
+    for (auto &i : p) {
+      i = token(gen);
+    }
+  }
+  auto graph = std::make_shared<ContextGraph>(phrases, 1.5);
+
+  auto run = [&](const char *name, auto f) {
+    auto start = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i != num_repeats; ++i) {
+      f();
+    }
+    auto end = std::chrono::steady_clock::now();
+    float ms =
+        std::chrono::duration_cast<std::chrono::microseconds>(end - start)
+            .count() /
+        1000.f / num_repeats;
+    SHERPA_ONNX_LOGE("%s: %.3f ms for %d frames", name, ms, num_frames);
+  };
+
+  run("greedy search", [&]() { GreedySearch(log_probs, vocab_size); });
+
+  for (int32_t beam : {4, 10}) {
+    SHERPA_ONNX_LOGE("beam: %d", beam);
+
+    run("  prefix beam search", [&]() {
+      CtcPrefixBeamSearch search(0, beam, 0);
+      search.Decode(log_probs.data(), num_frames, vocab_size);
+    });
+
+    run("  prefix beam search, blank skip 0.95", [&]() {
+      CtcPrefixBeamSearch search(0, beam, 0.95);
+      search.Decode(log_probs.data(), num_frames, vocab_size);
+    });
+
+    run("  prefix beam search, 1000 hotwords", [&]() {
+      CtcPrefixBeamSearch search(0, beam, 0, graph);
+      search.Decode(log_probs.data(), num_frames, vocab_size);
+    });
+  }
+}
+
+}  // namespace sherpa_onnx
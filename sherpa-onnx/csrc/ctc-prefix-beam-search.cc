@@ -0,0 +1,387 @@
+// sherpa-onnx/csrc/ctc-prefix-beam-search.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/ctc-prefix-beam-search.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "sherpa-onnx/csrc/math.h"
+
+namespace sherpa_onnx {
+
+static constexpr float kNegInf = -std::numeric_limits<float>::infinity();
+
+// Compact() is not called before the number of nodes reaches it
+static constexpr int32_t kMinNumNodesToCompact = 4096;
+
+CtcPrefixBeamSearch::CtcPrefixBeamSearch(int32_t blank_id,
+                                         int32_t max_active_paths,
+                                         float blank_skip_threshold,
+                                         ContextGraphPtr context_graph,
+                                         OnlineLM *lm, float lm_scale)
+    : blank_id_(blank_id),
+      max_active_paths_(std::max(max_active_paths, 1)),
+      log_blank_skip_threshold_(blank_skip_threshold > 0
+                                    ? std::log(blank_skip_threshold)
+                                    : std::numeric_limits<float>::infinity()),
+      context_graph_(std::move(context_graph)),
+      lm_(lm),
+      lm_scale_(lm_scale),
+      max_num_nodes_(kMinNumNodesToCompact) {
+  Node root;
+  if (context_graph_) {
+    root.context_state = context_graph_->Root();
+    root.base_context_state = context_graph_->BaseRoot();
+  }
+
+  if (lm_) {
+    // The LM states are initialized when the first token is scored. Only
+    // the LM scores of the first token are needed by the root.
+    root.lm_state = std::make_unique<Hypothesis>();
+    root.lm_state->nn_lm_scores.value = lm_->GetInitStatesSF().first;
+  }
+
+  nodes_.push_back(std::move(root));
+
+  prefixes_.push_back({0, 0, kNegInf});
+}
+
+float CtcPrefixBeamSearch::Score(const Prefix &p) const {
+  const auto &node = nodes_[p.node];
+  return LogAdd<float>()(p.pb, p.pnb) + node.context_score + node.lm_log_prob;
+}
+
+int32_t CtcPrefixBeamSearch::GetChild(int32_t node, int32_t token) {
+  uint64_t key = (static_cast<uint64_t>(node) << 32) |
+                 static_cast<uint32_t>(token);
+
+  auto it = children_.find(key);
+  if (it != children_.end()) {
+    return it->second;
+  }
+
+  const auto &parent = nodes_[node];
+
+  Node child;
+  child.parent = node;
+  child.token = token;
+  child.context_state = parent.context_state;
+  child.base_context_state = parent.base_context_state;
+  child.context_score = parent.context_score;
+  child.lm_log_prob = parent.lm_log_prob;
+
+  if (context_graph_) {
+    child.context_score += context_graph_->ForwardOneStep(
+        &child.context_state, &child.base_context_state, token);
+  }
+
+  if (lm_) {
+    // Running the LM for the child is deferred until it survives the
+    // pruning, but the LM score of its token is already known from the
+    // output of the LM for the parent. Every active prefix has been scored,
+    // so parent.lm_state is not nullptr.
+    const float *lm_scores =
+        parent.lm_state->nn_lm_scores.value.GetTensorData<float>();
+    child.lm_log_prob += lm_scores[token] * lm_scale_;
+  }
+
+  int32_t ans = static_cast<int32_t>(nodes_.size());
+  nodes_.push_back(std::move(child));
+  children_.emplace(key, ans);
+
+  return ans;
+}
+
+void CtcPrefixBeamSearch::ScoreLM(int32_t node) {
+  int32_t parent = nodes_[node].parent;
+  if (!nodes_[parent].lm_state) {
+    ScoreLM(parent);
+  }
+
+  // Copy the LM states of the parent and feed the token of this node
+  auto state = std::make_unique<Hypothesis>(*nodes_[parent].lm_state);
+  state->ys = {nodes_[node].token};
+  state->lm_log_prob = 0;
+
+  lm_->ComputeLMScoreSF(lm_scale_, state.get());
+
+  nodes_[node].lm_log_prob = nodes_[parent].lm_log_prob + state->lm_log_prob;
+  nodes_[node].lm_state = std::move(state);
+}
+
+void CtcPrefixBeamSearch::SelectCandidates(const float *p, int32_t vocab_size,
+                                           int32_t num_candidates) {
+  candidates_.clear();
+
+  if (num_candidates > 16) {
+    for (int32_t i = 0; i != vocab_size; ++i) {
+      if (i != blank_id_) {
+        candidates_.push_back(i);
+      }
+    }
+
+    std::nth_element(
+        candidates_.begin(), candidates_.begin() + num_candidates,
+        candidates_.end(),
+        [p](int32_t a, int32_t b) -> bool { return p[a] > p[b]; });
+    candidates_.resize(num_candidates);
+    return;
+  }
+
+  // For a small beam, a single pass that keeps the current top tokens
+  // sorted is much faster than sorting the whole vocabulary.
+  float min_log_prob = kNegInf;
+  for (int32_t i = 0; i != vocab_size; ++i) {
+    if (i == blank_id_ || p[i] <= min_log_prob) {
+      continue;
+    }
+
+    if (static_cast<int32_t>(candidates_.size()) == num_candidates) {
+      candidates_.pop_back();
+    }
+
+    auto it = std::upper_bound(
+        candidates_.begin(), candidates_.end(), i,
+        [p](int32_t a, int32_t b) -> bool { return p[a] > p[b]; });
+    candidates_.insert(it, i);
+
+    if (static_cast<int32_t>(candidates_.size()) == num_candidates) {
+      min_log_prob = p[candidates_.back()];
+    }
+  }
+}
+
+void CtcPrefixBeamSearch::Decode(const float *log_probs, int32_t num_frames,
+                                 int32_t vocab_size) {
+  LogAdd<float> log_add;
+
+  int32_t num_candidates = std::min(max_active_paths_, vocab_size - 1);
+
+  for (int32_t t = 0; t != num_frames; ++t, log_probs += vocab_size) {
+    const float *p = log_probs;
+    int32_t frame = num_frames_++;
+
+    int32_t best_token = static_cast<int32_t>(
+        std::distance(p, std::max_element(p, p + vocab_size)));
+
+    if (best_token == blank_id_) {
+      num_trailing_blanks_ += 1;
+    } else {
+      num_trailing_blanks_ = 0;
+    }
+
+    float blank_log_prob = p[blank_id_];
+
+    if (blank_log_prob >= log_blank_skip_threshold_) {
+      // Treat it as a pure blank frame. It does not change the order of
+      // the prefixes, so no pruning is needed.
+      for (auto &x : prefixes_) {
+        x.pb = log_add(x.pb, x.pnb) + blank_log_prob;
+        x.pnb = kNegInf;
+      }
+      ++num_skipped_frames_;
+      continue;
+    }
+
+    // Only the top non-blank tokens of this frame are expanded
+    SelectCandidates(p, vocab_size, num_candidates);
+
+    next_.clear();
+
+    auto add = [this, &log_add](int32_t node, float pb, float pnb) {
+      if (node >= static_cast<int32_t>(node_to_next_.size())) {
+        node_to_next_.resize(nodes_.size(), -1);
+      }
+
+      int32_t &i = node_to_next_[node];
+      if (i == -1) {
+        i = static_cast<int32_t>(next_.size());
+        next_.push_back({node, kNegInf, kNegInf});
+      }
+
+      auto &x = next_[i];
+      x.pb = log_add(x.pb, pb);
+      x.pnb = log_add(x.pnb, pnb);
+    };
+
+    auto update_frame = [this, frame](int32_t node, float log_prob) {
+      auto &n = nodes_[node];
+      if (log_prob > n.token_log_prob) {
+        n.token_log_prob = log_prob;
+        n.frame = frame;
+      }
+    };
+
+    for (const auto &x : prefixes_) {
+      float total = log_add(x.pb, x.pnb);
+
+      add(x.node, total + blank_log_prob, kNegInf);
+
+      int32_t last_token = nodes_[x.node].token;
+
+      for (int32_t k = 0; k != num_candidates; ++k) {
+        int32_t c = candidates_[k];
+        float log_prob = p[c];
+
+        if (c == last_token) {
+          // Repeated tokens without a blank between them are merged
+          if (x.pnb != kNegInf) {
+            add(x.node, kNegInf, x.pnb + log_prob);
+            update_frame(x.node, log_prob);
+          }
+
+          // A blank is required between two identical tokens
+          if (x.pb != kNegInf) {
+            int32_t child = GetChild(x.node, c);
+            add(child, kNegInf, x.pb + log_prob);
+            update_frame(child, log_prob);
+          }
+        } else {
+          int32_t child = GetChild(x.node, c);
+          add(child, kNegInf, total + log_prob);
+          update_frame(child, log_prob);
+        }
+      }
+    }
+
+    for (const auto &x : next_) {
+      node_to_next_[x.node] = -1;
+    }
+
+    auto greater = [this](const Prefix &a, const Prefix &b) -> bool {
+      return Score(a) > Score(b);
+    };
+
+    if (static_cast<int32_t>(next_.size()) > max_active_paths_) {
+      std::nth_element(next_.begin(), next_.begin() + max_active_paths_,
+                       next_.end(), greater);
+      next_.resize(max_active_paths_);
+    }
+
+    if (lm_) {
+      // The LM is run only for prefixes that survive the pruning. It also
+      // adds the LODR score, if any, which is not included above.
+      for (const auto &x : next_) {
+        if (!nodes_[x.node].lm_state) {
+          ScoreLM(x.node);
+        }
+      }
+    }
+
+    std::sort(next_.begin(), next_.end(), greater);
+
+    prefixes_.swap(next_);
+  }
+
+  if (static_cast<int32_t>(nodes_.size()) > max_num_nodes_) {
+    Compact();
+    max_num_nodes_ = std::max<int32_t>(kMinNumNodesToCompact,
+                                       2 * static_cast<int32_t>(nodes_.size()));
+  }
+}
+
+void CtcPrefixBeamSearch::Compact() {
+  int32_t num_nodes = static_cast<int32_t>(nodes_.size());
+  std::vector<bool> keep(num_nodes, false);
+  keep[0] = true;
+
+  for (const auto &x : prefixes_) {
+    for (int32_t n = x.node; n != -1 && !keep[n]; n = nodes_[n].parent) {
+      keep[n] = true;
+    }
+  }
+
+  // A parent is always created before its children, so keeping the
+  // relative order of the nodes keeps parents before children
+  std::vector<int32_t> new_index(num_nodes, -1);
+  std::vector<Node> nodes;
+  for (int32_t i = 0; i != num_nodes; ++i) {
+    if (!keep[i]) {
+      continue;
+    }
+
+    new_index[i] = static_cast<int32_t>(nodes.size());
+
+    Node node = std::move(nodes_[i]);
+    if (node.parent != -1) {
+      node.parent = new_index[node.parent];
+    }
+
+    nodes.push_back(std::move(node));
+  }
+
+  nodes_ = std::move(nodes);
+
+  children_.clear();
+  for (int32_t i = 1; i != static_cast<int32_t>(nodes_.size()); ++i) {
+    uint64_t key = (static_cast<uint64_t>(nodes_[i].parent) << 32) |
+                   static_cast<uint32_t>(nodes_[i].token);
+    children_.emplace(key, i);
+  }
+
+  for (auto &x : prefixes_) {
+    x.node = new_index[x.node];
+  }
+
+  node_to_next_.assign(nodes_.size(), -1);
+}
+
+std::vector<Hypothesis> CtcPrefixBeamSearch::GetHypotheses(
+    bool finalize) const {
+  std::vector<Hypothesis> ans;
+  ans.reserve(prefixes_.size());
+
+  for (const auto &x : prefixes_) {
+    const auto &node = nodes_[x.node];
+
+    Hypothesis hyp;
+    for (int32_t n = x.node; n != 0; n = nodes_[n].parent) {
+      hyp.ys.push_back(nodes_[n].token);
+      hyp.timestamps.push_back(nodes_[n].frame);
+    }
+    std::reverse(hyp.ys.begin(), hyp.ys.end());
+    std::reverse(hyp.timestamps.begin(), hyp.timestamps.end());
+
+    hyp.log_prob = LogAdd<float>()(x.pb, x.pnb) + node.context_score;
+    hyp.lm_log_prob = node.lm_log_prob;
+
+    hyp.context_state = node.context_state;
+    hyp.base_context_state = node.base_context_state;
+
+    if (finalize && context_graph_) {
+      hyp.log_prob += context_graph_->Finalize(&hyp.context_state,
+                                               &hyp.base_context_state);
+    }
+
+    ans.push_back(std::move(hyp));
+  }
+
+  std::stable_sort(ans.begin(), ans.end(),
+                   [](const Hypothesis &a, const Hypothesis &b) -> bool {
+                     return a.TotalLogProb() > b.TotalLogProb();
+                   });
+
+  return ans;
+}
+
+void CtcPrefixBeamSearch::GetBest(std::vector<int64_t> *tokens,
+                                  std::vector<int32_t> *timestamps) const {
+  tokens->clear();
+  timestamps->clear();
+
+  // prefixes_ is sorted by score in descending order
+  for (int32_t n = prefixes_[0].node; n != 0; n = nodes_[n].parent) {
+    tokens->push_back(nodes_[n].token);
+    timestamps->push_back(nodes_[n].frame);
+  }
+
+  std::reverse(tokens->begin(), tokens->end());
+  std::reverse(timestamps->begin(), timestamps->end());
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,166 @@
+// sherpa-onnx/csrc/ctc-prefix-beam-search.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_CTC_PREFIX_BEAM_SEARCH_H_
+#define SHERPA_ONNX_CSRC_CTC_PREFIX_BEAM_SEARCH_H_
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "sherpa-onnx/csrc/context-graph.h"
+#include "sherpa-onnx/csrc/hypothesis.h"
+#include "sherpa-onnx/csrc/online-lm.h"
+
+namespace sherpa_onnx {
+
+/** CTC prefix beam search of a single utterance.
+ *
+ * Frames can be given chunk by chunk, so it is shared by the offline and
+ * the streaming CTC decoders.
+ *
+ * Prefixes are kept in a prefix tree. Extending a prefix by a token is a
+ * hash lookup, and the same prefix reached from different paths is merged
+ * by its node index instead of by comparing token sequences.
+ *
+ * Optionally, it supports
+ *  - hotwords biasing with a ContextGraph
+ *  - shallow fusion with an OnlineLM
+ *  - treating frames whose blank probability is large enough as pure blank
+ *    frames, which skips the expansion of non-blank tokens
+ */
+class CtcPrefixBeamSearch {
+ public:
+  /**
+   * @param blank_id ID of the blank token.
+   * @param max_active_paths Number of prefixes to keep after each frame.
+   * @param blank_skip_threshold If the blank probability of a frame is not
+   *                             less than it, only blank is expanded on this
+   *                             frame. 0 to disable it.
+   * @param context_graph Optional. If not nullptr, it is used for hotwords.
+   * @param lm Optional. Not owned. If not nullptr, it is used for shallow
+   *           fusion.
+   * @param lm_scale Scale for the LM scores.
+   */
+  CtcPrefixBeamSearch(int32_t blank_id, int32_t max_active_paths,
+                      float blank_skip_threshold,
+                      ContextGraphPtr context_graph = nullptr,
+                      OnlineLM *lm = nullptr, float lm_scale = 0);
+
+  /** Decode the given frames. It can be called multiple times.
+   *
+   * @param log_probs A 2-D array of shape (num_frames, vocab_size) in row
+   *                  major.
+   */
+  void Decode(const float *log_probs, int32_t num_frames, int32_t vocab_size);
+
+  // Number of frames decoded so far
+  int32_t NumFrames() const { return num_frames_; }
+
+  // Number of frames that are treated as pure blank frames
+  int32_t NumSkippedFrames() const { return num_skipped_frames_; }
+
+  // Number of trailing frames whose most probable token is blank
+  int32_t NumTrailingBlanks() const { return num_trailing_blanks_; }
+
+  /** Return the active prefixes sorted by score in descending order.
+   *
+   * hyp.ys contains the tokens of the prefix, hyp.log_prob the CTC score
+   * plus the context graph score, and hyp.lm_log_prob the LM score.
+   *
+   * @param finalize If true, the bonus of partially matched hotwords is
+   *                 cancelled. See ContextGraph::Finalize().
+   */
+  std::vector<Hypothesis> GetHypotheses(bool finalize) const;
+
+  // Return the tokens and timestamps of the best prefix
+  void GetBest(std::vector<int64_t> *tokens,
+               std::vector<int32_t> *timestamps) const;
+
+ private:
+  struct Node {
+    int32_t parent = -1;
+    int32_t token = -1;
+
+    // Frame index where the token has the largest probability among the
+    // frames on which it is emitted
+    int32_t frame = 0;
+
+    // log prob of the token on `frame`
+    float token_log_prob = -std::numeric_limits<float>::infinity();
+
+    const ContextState *context_state = nullptr;
+    const ContextState *base_context_state = nullptr;
+
+    // Accumulated hotwords bonus of the tokens from the root to this node
+    float context_score = 0;
+
+    // Accumulated LM score. If lm_state is nullptr, the score of `token`
+    // is taken from the LM output of the parent and does not include the
+    // LODR score.
+    double lm_log_prob = 0;
+
+    // LM states after seeing `token`. nullptr if the LM is not used or
+    // if this node has not been scored yet.
+    std::unique_ptr<Hypothesis> lm_state;
+  };
+
+  struct Prefix {
+    int32_t node;
+
+    // log prob of the paths ending in blank and in non-blank
+    float pb;
+    float pnb;
+  };
+
+  float Score(const Prefix &p) const;
+
+  // Return the child of node with the given token. Create it if it does
+  // not exist.
+  int32_t GetChild(int32_t node, int32_t token);
+
+  // Select the top non-blank tokens of a frame and save them in
+  // candidates_
+  void SelectCandidates(const float *p, int32_t vocab_size,
+                        int32_t num_candidates);
+
+  void ScoreLM(int32_t node);
+
+  // Remove nodes that are not reachable from any active prefix
+  void Compact();
+
+ private:
+  int32_t blank_id_;
+  int32_t max_active_paths_;
+  float log_blank_skip_threshold_;
+  ContextGraphPtr context_graph_;
+  OnlineLM *lm_;  // not owned
+  float lm_scale_;
+
+  // nodes_[0] is the root, i.e., the empty prefix
+  std::vector<Node> nodes_;
+
+  // (parent << 32 | token) -> child
+  std::unordered_map<uint64_t, int32_t> children_;
+
+  std::vector<Prefix> prefixes_;
+
+  // Buffers reused across frames
+  std::vector<Prefix> next_;
+  std::vector<int32_t> node_to_next_;
+  std::vector<int32_t> candidates_;
+
+  int32_t num_frames_ = 0;
+  int32_t num_skipped_frames_ = 0;
+  int32_t num_trailing_blanks_ = 0;
+
+  // Compact() is called when the number of nodes exceeds it
+  int32_t max_num_nodes_;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_CTC_PREFIX_BEAM_SEARCH_H_
@@ -15,7 +15,8 @@ std::string FastClusteringConfig::ToString() const {
 
   os << "FastClusteringConfig(";
   os << "num_clusters=" << num_clusters << ", ";
-  os << "threshold=" << threshold << ")";
+  os << "threshold=" << threshold << ", ";
+  os << "chunk_size=" << chunk_size << ")";
 
   return os.str();
 }
@@ -31,6 +32,13 @@ void FastClusteringConfig::Register(ParseOptions *po) {
                "If num_clusters is not specified, then it specifies the "
                "distance threshold for clustering. smaller value -> more "
                "clusters. larger value -> fewer clusters");
+
+  po->Register("cluster-chunk-size", &chunk_size,
+               "If positive and there are more embeddings than this value, "
+               "embeddings are clustered chunk by chunk first and then the "
+               "chunk-level centroids are clustered. It bounds the memory "
+               "usage for long recordings, but the result is approximate. "
+               "0 disables it.");
 }
 
 bool FastClusteringConfig::Validate() const {
@@ -39,6 +47,12 @@ bool FastClusteringConfig::Validate() const {
     return false;
   }
 
+  if (chunk_size == 1) {
+    SHERPA_ONNX_LOGE("chunk_size should be 0 or larger than 1. Given: %d",
+                     chunk_size);
+    return false;
+  }
+
   return true;
 }
 
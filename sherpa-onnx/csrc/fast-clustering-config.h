@@ -24,10 +24,23 @@ struct FastClusteringConfig {
   // The larger, the fewer clusters it will generate.
   float threshold = 0.5;
 
+  // If positive and there are more than chunk_size embeddings, a two-stage
+  // clustering is used: embeddings are first clustered chunk by chunk into
+  // many small clusters and then the centroids of these small clusters
+  // are clustered. Memory usage is O(chunk_size^2) instead of O(n^2).
+  //
+  // The result is an approximation of clustering all embeddings at once,
+  // so it is disabled by default. 2000 is a reasonable value for long
+  // recordings.
+  int32_t chunk_size = 0;
+
   FastClusteringConfig() = default;
 
-  FastClusteringConfig(int32_t num_clusters, float threshold)
-      : num_clusters(num_clusters), threshold(threshold) {}
+  FastClusteringConfig(int32_t num_clusters, float threshold,
+                       int32_t chunk_size = 0)
+      : num_clusters(num_clusters),
+        threshold(threshold),
+        chunk_size(chunk_size) {}
 
   std::string ToString() const;
 
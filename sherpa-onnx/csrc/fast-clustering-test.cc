@@ -4,9 +4,12 @@
 
 #include "sherpa-onnx/csrc/fast-clustering.h"
 
+#include <chrono>  // NOLINT
+#include <random>
 #include <vector>
 
 #include "gtest/gtest.h"
+#include "sherpa-onnx/csrc/macros.h"
 
 namespace sherpa_onnx {
 
@@ -66,4 +69,109 @@ TEST(FastClustering, TestClusteringWithThreshold) {
   }
 }
 
+// Generate num_rows points around num_clusters random centers.
+// The label of row i is i % num_clusters
+static std::vector<float> GenerateEmbeddings(int32_t num_rows, int32_t dim,
+                                             int32_t num_clusters,
+                                             float noise_scale = 0.05) {
+  std::mt19937 mt(20250101);
+  std::normal_distribution<float> dist;
+
+  std::vector<float> centers(num_clusters * dim);
+  for (auto &f : centers) {
+    f = dist(mt);
+  }
+
+  std::vector<float> ans(num_rows * dim);
+  for (int32_t i = 0; i != num_rows; ++i) {
+    const float *c = &centers[(i % num_clusters) * dim];
+    for (int32_t k = 0; k != dim; ++k) {
+      ans[i * dim + k] = c[k] + noise_scale * dist(mt);
+    }
+  }
+
+  return ans;
+}
+
+static void CheckLabels(const std::vector<int32_t> &labels,
+                        int32_t num_clusters) {
+  // rows from the same center should have the same label and
+  // rows from different centers should have different labels
+  for (int32_t i = 0; i != static_cast<int32_t>(labels.size()); ++i) {
+    EXPECT_EQ(labels[i], labels[i % num_clusters]);
+    if (i < num_clusters) {
+      for (int32_t j = 0; j != i; ++j) {
+        EXPECT_NE(labels[i], labels[j]);
+      }
+    }
+  }
+}
+
+TEST(FastClustering, TestChunkedWithNumClusters) {
+  int32_t num_rows = 1000;
+  int32_t dim = 16;
+  int32_t num_clusters = 5;
+  auto features = GenerateEmbeddings(num_rows, dim, num_clusters);
+
+  FastClusteringConfig config;
+  config.num_clusters = num_clusters;
+  config.chunk_size = 100;
+
+  FastClustering clustering(config);
+  auto labels = clustering.Cluster(features.data(), num_rows, dim);
+  ASSERT_EQ(labels.size(), num_rows);
+  CheckLabels(labels, num_clusters);
+}
+
+TEST(FastClustering, TestChunkedWithThreshold) {
+  int32_t num_rows = 1000;
+  int32_t dim = 16;
+  int32_t num_clusters = 4;
+  auto features = GenerateEmbeddings(num_rows, dim, num_clusters);
+
+  FastClusteringConfig config;
+  config.threshold = 0.5;
+  config.chunk_size = 100;
+
+  FastClustering clustering(config);
+  auto labels = clustering.Cluster(features.data(), num_rows, dim);
+  ASSERT_EQ(labels.size(), num_rows);
+  CheckLabels(labels, num_clusters);
+}
+
+// It takes a long time, so it is not run by default. Use
+// --gtest_also_run_disabled_tests to run it.
+TEST(FastClustering, DISABLED_Benchmark) {
+  int32_t dim = 192;
+  int32_t num_clusters = 10;
+
+  FastClusteringConfig config;
+  config.threshold = 0.5;
+  config.chunk_size = 2000;
+
+  for (int32_t num_rows = 1000; num_rows <= 100000; num_rows *= 10) {
+    auto features =
+        GenerateEmbeddings(num_rows, dim, num_clusters, /*noise_scale*/ 0.3);
+
+    FastClustering clustering(config);
+
+    auto start = std::chrono::steady_clock::now();
+    auto labels = clustering.Cluster(features.data(), num_rows, dim);
+    auto stop = std::chrono::steady_clock::now();
+
+    auto duration =
+        std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
+
+    int32_t n = std::min(num_rows, config.chunk_size);
+    float distance_mb = static_cast<float>(n) * (n - 1) / 2 * 8 / 1024 / 1024;
+
+    SHERPA_ONNX_LOGE(
+        "Clustering %d embeddings of dim %d takes %d ms. Peak distance matrix "
+        "size: %.2f MB",
+        num_rows, dim, static_cast<int32_t>(duration.count()), distance_mb);
+
+    EXPECT_EQ(labels.size(), num_rows);
+  }
+}
+
 }  // namespace sherpa_onnx
@@ -4,6 +4,7 @@
 
 #include "sherpa-onnx/csrc/fast-clustering.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "Eigen/Dense"
@@ -11,6 +12,9 @@
 
 namespace sherpa_onnx {
 
+using FloatMatrix =
+    Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
 class FastClustering::Impl {
  public:
   explicit Impl(const FastClusteringConfig &config) : config_(config) {}
@@ -25,29 +29,31 @@ class FastClustering::Impl {
       return {0};
     }
 
-    Eigen::Map<
-        Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>
-        m(features, num_rows, num_cols);
+    Eigen::Map<FloatMatrix> m(features, num_rows, num_cols);
     m.rowwise().normalize();
 
-    std::vector<double> distance((num_rows * (num_rows - 1)) / 2);
-
-    int32_t k = 0;
-    for (int32_t i = 0; i != num_rows; ++i) {
-      auto v = m.row(i);
-      for (int32_t j = i + 1; j != num_rows; ++j) {
-        double cosine_similarity = v.dot(m.row(j));
-        double consine_dissimilarity = 1 - cosine_similarity;
+    if (config_.chunk_size > 1 && num_rows > config_.chunk_size) {
+      return ClusterInChunks(m);
+    }
 
-        if (consine_dissimilarity < 0) {
-          consine_dissimilarity = 0;
-        }
+    return ClusterNormalized(m, config_.num_clusters);
+  }
 
-        distance[k] = consine_dissimilarity;
-        ++k;
-      }
+ private:
+  // Each chunk is reduced to about chunk_size / kReductionFactor clusters
+  // in the first stage of ClusterInChunks().
+  static constexpr int32_t kReductionFactor = 10;
+
+  // Rows of m are normalized
+  std::vector<int32_t> ClusterNormalized(const Eigen::Ref<const FloatMatrix> &m,
+                                         int32_t num_clusters) const {
+    int32_t num_rows = m.rows();
+    if (num_rows == 1) {
+      return {0};
     }
 
+    std::vector<double> distance = ComputeDistance(m);
+
     std::vector<int32_t> merge(2 * (num_rows - 1));
     std::vector<double> height(num_rows - 1);
 
@@ -56,8 +62,9 @@ class FastClustering::Impl {
                                 merge.data(), height.data());
 
     std::vector<int32_t> labels(num_rows);
-    if (config_.num_clusters > 0) {
-      fastclustercpp::cutree_k(num_rows, merge.data(), config_.num_clusters,
+    if (num_clusters > 0) {
+      fastclustercpp::cutree_k(num_rows, merge.data(),
+                               std::min(num_clusters, num_rows),
                                labels.data());
     } else {
       fastclustercpp::cutree_cdist(num_rows, merge.data(), height.data(),
@@ -67,6 +74,111 @@ class FastClustering::Impl {
     return labels;
   }
 
+  // Return the condensed cosine dissimilarity matrix, i.e.,
+  // 1 - (cosine similarity), of the normalized rows of m.
+  //
+  // Similarities are computed block by block with matrix multiplications
+  // so that Eigen can use SIMD, while the extra memory is bounded by
+  // the block size.
+  static std::vector<double> ComputeDistance(
+      const Eigen::Ref<const FloatMatrix> &m) {
+    constexpr int32_t kBlockSize = 64;
+
+    int32_t num_rows = m.rows();
+    std::vector<double> distance((static_cast<int64_t>(num_rows) *
+                                  (num_rows - 1)) /
+                                 2);
+
+    FloatMatrix block;
+
+    int64_t k = 0;
+    for (int32_t start = 0; start < num_rows; start += kBlockSize) {
+      int32_t n = std::min(kBlockSize, num_rows - start);
+      block.noalias() =
+          m.middleRows(start, n) * m.bottomRows(num_rows - start).transpose();
+
+      for (int32_t i = 0; i != n; ++i) {
+        // block(i, j) is the similarity between row start + i and
+        // row start + j
+        for (int32_t j = i + 1; j != num_rows - start; ++j) {
+          double cosine_dissimilarity = 1 - block(i, j);
+
+          if (cosine_dissimilarity < 0) {
+            cosine_dissimilarity = 0;
+          }
+
+          distance[k] = cosine_dissimilarity;
+          ++k;
+        }
+      }
+    }
+
+    return distance;
+  }
+
+  // Two-stage clustering:
+  //  (1) Cluster each chunk of chunk_size rows into many small clusters
+  //  (2) Cluster the normalized centroids of all small clusters. It is
+  //      applied recursively if there are still too many centroids.
+  std::vector<int32_t> ClusterInChunks(
+      const Eigen::Ref<const FloatMatrix> &m) const {
+    int32_t num_rows = m.rows();
+    int32_t num_cols = m.cols();
+    int32_t chunk_size = config_.chunk_size;
+
+    // centroid_index[i] is the index of the centroid for row i
+    std::vector<int32_t> centroid_index(num_rows);
+    std::vector<float> centroids;
+
+    int32_t num_centroids = 0;
+    for (int32_t start = 0; start < num_rows; start += chunk_size) {
+      int32_t n = std::min(chunk_size, num_rows - start);
+      auto chunk = m.middleRows(start, n);
+
+      int32_t k = std::max(n / kReductionFactor,
+                           std::min(n, std::max(config_.num_clusters, 1)));
+      std::vector<int32_t> labels = ClusterNormalized(chunk, k);
+
+      // labels may not be contiguous, so we renumber them
+      std::vector<int32_t> label2centroid(n, -1);
+      FloatMatrix c = FloatMatrix::Zero(n, num_cols);
+      int32_t num_local = 0;
+
+      for (int32_t i = 0; i != n; ++i) {
+        int32_t &local = label2centroid[labels[i]];
+        if (local == -1) {
+          local = num_local;
+          ++num_local;
+        }
+
+        c.row(local) += chunk.row(i);
+        centroid_index[start + i] = num_centroids + local;
+      }
+
+      c.topRows(num_local).rowwise().normalize();
+
+      centroids.insert(centroids.end(), &c(0, 0),
+                       &c(0, 0) + num_local * num_cols);
+      num_centroids += num_local;
+    }
+
+    std::vector<int32_t> centroid_labels;
+    if (num_centroids < num_rows) {
+      // Note: It is recursive if num_centroids > chunk_size
+      centroid_labels = Cluster(centroids.data(), num_centroids, num_cols);
+    } else {
+      // Too many clusters are requested for chunking to help
+      return ClusterNormalized(m, config_.num_clusters);
+    }
+
+    std::vector<int32_t> ans(num_rows);
+    for (int32_t i = 0; i != num_rows; ++i) {
+      ans[i] = centroid_labels[centroid_index[i]];
+    }
+
+    return ans;
+  }
+
  private:
   FastClusteringConfig config_;
 };
@@ -8,20 +8,12 @@
 
 namespace sherpa_onnx {
 
-// This function is copied from kaldi.
-//
-// @param filename Path to a StdVectorFst or StdConstFst graph
-// @return The caller should free the returned pointer using `delete` to
-//         avoid memory leak.
-fst::Fst<fst::StdArc> *ReadGraph(const std::string &filename) {
-  // read decoding network FST
-  std::ifstream is(filename, std::ios::binary);
-  if (!is.good()) {
-    SHERPA_ONNX_LOGE("Could not open decoding-graph FST %s", filename.c_str());
-  }
-
+// @param source If not empty, it is the file from which `is` is opened.
+//               An aligned StdConstFst from it is memory-mapped.
+static fst::Fst<fst::StdArc> *ReadGraphImpl(std::istream &is,
+                                            const std::string &source) {
   fst::FstHeader hdr;
-  if (!hdr.Read(is, "<unknown>")) {
+  if (!hdr.Read(is, source.empty() ? "<unknown>" : source)) {
     SHERPA_ONNX_LOGE("Reading FST: error reading FST header.");
   }
 
@@ -29,7 +21,17 @@ fst::Fst<fst::StdArc> *ReadGraph(const std::string &filename) {
     SHERPA_ONNX_LOGE("FST with arc type %s not supported",
                      hdr.ArcType().c_str());
   }
-  fst::FstReadOptions ropts("<unspecified>", &hdr);
+  fst::FstReadOptions ropts(source.empty() ? "<unspecified>" : source, &hdr);
+
+  if (!source.empty() && hdr.FstType() == "const" &&
+      (hdr.GetFlags() & fst::FstHeader::IS_ALIGNED)) {
+    // The states and arcs of a ConstFst are then mapped from the file
+    // instead of being copied into memory. It loads faster and the pages
+    // are shared by all processes using the same graph.
+    //
+    // OpenFst falls back to reading if the file cannot be mapped.
+    ropts.mode = fst::FstReadOptions::MAP;
+  }
 
   fst::Fst<fst::StdArc> *decode_fst = nullptr;
 
@@ -50,4 +52,23 @@ fst::Fst<fst::StdArc> *ReadGraph(const std::string &filename) {
   }
 }
 
+// This function is copied from kaldi.
+//
+// @param filename Path to a StdVectorFst or StdConstFst graph
+// @return The caller should free the returned pointer using `delete` to
+//         avoid memory leak.
+fst::Fst<fst::StdArc> *ReadGraph(const std::string &filename) {
+  // read decoding network FST
+  std::ifstream is(filename, std::ios::binary);
+  if (!is.good()) {
+    SHERPA_ONNX_LOGE("Could not open decoding-graph FST %s", filename.c_str());
+  }
+
+  return ReadGraphImpl(is, filename);
+}
+
+fst::Fst<fst::StdArc> *ReadGraph(std::istream &is) {
+  return ReadGraphImpl(is, "");
+}
+
 }  // namespace sherpa_onnx
@@ -5,14 +5,22 @@
 #ifndef SHERPA_ONNX_CSRC_FST_UTILS_H_
 #define SHERPA_ONNX_CSRC_FST_UTILS_H_
 
+#include <istream>
 #include <string>
 
 #include "fst/fstlib.h"
 
 namespace sherpa_onnx {
 
+// Read a StdVectorFst or a StdConstFst.
+//
+// A StdConstFst written with --fst_align is memory-mapped.
 fst::Fst<fst::StdArc> *ReadGraph(const std::string &filename);
 
+// Like the above one, but it reads the graph from a stream, e.g., a buffer
+// read from the assets on Android
+fst::Fst<fst::StdArc> *ReadGraph(std::istream &is);
+
 }
 
 #endif  // SHERPA_ONNX_CSRC_FST_UTILS_H_
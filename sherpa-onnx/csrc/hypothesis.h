@@ -68,6 +68,10 @@ struct Hypothesis {
 
   const ContextState *context_state;
 
+  // State in the base graph of the context graph, if it has one.
+  // See ContextGraph::BaseRoot()
+  const ContextState *base_context_state = nullptr;
+
   // TODO(fangjun): Make it configurable
   // the minimum of tokens in a chunk for streaming RNN LM
   int32_t lm_rescore_min_chunk = 2;  // a const
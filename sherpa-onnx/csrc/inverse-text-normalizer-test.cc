@@ -0,0 +1,115 @@
+// sherpa-onnx/csrc/inverse-text-normalizer-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/inverse-text-normalizer.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "fst/extensions/far/far.h"
+#include "fst/fstlib.h"
+#include "gtest/gtest.h"
+#include "kaldifst/csrc/text-normalizer.h"
+
+namespace sherpa_onnx {
+
+// A rule with a single state that replaces the byte `from` with the byte
+// `to` and keeps all other bytes.
+static fst::StdVectorFst BuildReplaceRule(char from, char to) {
+  fst::StdVectorFst ans;
+  ans.AddState();
+  ans.SetStart(0);
+  ans.SetFinal(0, fst::TropicalWeight::One());
+
+  for (int32_t i = 1; i != 256; ++i) {
+    int32_t olabel = (i == static_cast<uint8_t>(from))
+                         ? static_cast<uint8_t>(to)
+                         : i;
+    ans.AddArc(0, fst::StdArc(i, olabel, fst::TropicalWeight::One(), 0));
+  }
+
+  return ans;
+}
+
+class InverseTextNormalizerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // a -> b, then b -> c
+    BuildReplaceRule('a', 'b').Write(kAToB);
+    BuildReplaceRule('b', 'c').Write(kBToC);
+
+    std::unique_ptr<fst::FarWriter<fst::StdArc>> writer(
+        fst::FarWriter<fst::StdArc>::Create(kFar));
+    writer->Add("a-to-b", BuildReplaceRule('a', 'b'));
+    writer->Add("b-to-c", BuildReplaceRule('b', 'c'));
+  }
+
+  void TearDown() override {
+    std::remove(kAToB);
+    std::remove(kBToC);
+    std::remove(kFar);
+  }
+
+  static constexpr const char *kAToB = "itn-test-a-to-b.fst";
+  static constexpr const char *kBToC = "itn-test-b-to-c.fst";
+
+  // Contains a-to-b followed by b-to-c
+  static constexpr const char *kFar = "itn-test-rules.far";
+};
+
+// Rules are applied from left to right
+TEST_F(InverseTextNormalizerTest, RuleOrder) {
+  std::string a_to_b = kAToB;
+  std::string b_to_c = kBToC;
+
+  for (bool compose : {false, true}) {
+    InverseTextNormalizer forward(a_to_b + "," + b_to_c, "", compose, false);
+    EXPECT_EQ(forward.Apply("abc"), "ccc") << compose;
+
+    InverseTextNormalizer backward(b_to_c + "," + a_to_b, "", compose, false);
+    EXPECT_EQ(backward.Apply("abc"), "bcc") << compose;
+
+    // Rules in an archive keep their order
+    InverseTextNormalizer far("", kFar, compose, false);
+    EXPECT_EQ(far.Apply("abc"), "ccc") << compose;
+
+    // Rule fsts are applied before rule fars
+    InverseTextNormalizer fst_then_far(b_to_c, kFar, compose, false);
+    EXPECT_EQ(fst_then_far.Apply("abc"), "bcc") << compose;
+  }
+}
+
+// Results from the cache are the same as applying each rule directly
+TEST_F(InverseTextNormalizerTest, Cache) {
+  std::string a_to_b = kAToB;
+  std::string b_to_c = kBToC;
+
+  InverseTextNormalizer itn(b_to_c + "," + a_to_b, "", false, false);
+
+  kaldifst::TextNormalizer rule1(
+      std::make_unique<fst::StdConstFst>(BuildReplaceRule('b', 'c')));
+  kaldifst::TextNormalizer rule2(
+      std::make_unique<fst::StdConstFst>(BuildReplaceRule('a', 'b')));
+
+  std::vector<std::string> texts = {"a", "abc", "bab", "xyz", "aaab"};
+
+  for (int32_t k = 0; k != 3; ++k) {
+    for (const auto &t : texts) {
+      std::string expected = rule2.Normalize(rule1.Normalize(t));
+      EXPECT_EQ(itn.Apply(t), expected) << t << ", " << k;
+    }
+  }
+
+  // The first round misses and the other two hit the cache
+  EXPECT_NE(itn.Stats().find("hits=10, misses=5"), std::string::npos)
+      << itn.Stats();
+
+  // Empty text is returned as is
+  EXPECT_EQ(itn.Apply(""), "");
+}
+
+}  // namespace sherpa_onnx
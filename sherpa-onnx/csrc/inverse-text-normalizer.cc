@@ -0,0 +1,293 @@
+// sherpa-onnx/csrc/inverse-text-normalizer.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/inverse-text-normalizer.h"
+
+#include <chrono>  // NOLINT
+#include <fstream>
+#include <istream>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <sstream>
+#include <string>
+#include <strstream>
+#include <utility>
+#include <vector>
+
+#if __ANDROID_API__ >= 9
+#include "android/asset_manager.h"
+#include "android/asset_manager_jni.h"
+#endif
+
+#if __OHOS__
+#include "rawfile/raw_file_manager.h"
+#endif
+
+#include "fst/extensions/far/far.h"
+#include "fst/fstlib.h"
+#include "kaldifst/csrc/kaldi-fst-io.h"
+#include "kaldifst/csrc/text-normalizer.h"
+#include "sherpa-onnx/csrc/file-utils.h"
+#include "sherpa-onnx/csrc/fst-utils.h"
+#include "sherpa-onnx/csrc/lru-cache.h"
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/text-utils.h"
+
+namespace sherpa_onnx {
+
+// Maximum number of memoized results
+static constexpr int32_t kCacheSize = 1000;
+
+static std::unique_ptr<fst::StdConstFst> ReadRule(std::istream &is,
+                                                  const std::string &name) {
+  fst::Fst<fst::StdArc> *f = ReadGraph(is);
+  if (!f) {
+    SHERPA_ONNX_LOGE("Failed to read rule fst '%s'", name.c_str());
+    SHERPA_ONNX_EXIT(-1);
+  }
+
+  // CastOrConvertToConstFst() takes the ownership of f
+  return std::unique_ptr<fst::StdConstFst>(fst::CastOrConvertToConstFst(f));
+}
+
+static void ReadFar(std::unique_ptr<fst::FarReader<fst::StdArc>> reader,
+                    std::vector<std::unique_ptr<fst::StdConstFst>> *rules) {
+  for (; !reader->Done(); reader->Next()) {
+    rules->emplace_back(
+        fst::CastOrConvertToConstFst(reader->GetFst()->Copy()));
+  }
+}
+
+// Compose rules from left to right into a single transducer
+static std::unique_ptr<fst::StdConstFst> ComposeRules(
+    const std::vector<std::unique_ptr<fst::StdConstFst>> &rules) {
+  fst::StdVectorFst composed(*rules[0]);
+
+  for (size_t i = 1; i != rules.size(); ++i) {
+    fst::StdVectorFst next(*rules[i]);
+
+    fst::ArcSort(&composed, fst::OLabelCompare<fst::StdArc>());
+    fst::ArcSort(&next, fst::ILabelCompare<fst::StdArc>());
+
+    fst::StdVectorFst out;
+    fst::Compose(composed, next, &out);
+    fst::Connect(&out);
+
+    composed = std::move(out);
+  }
+
+  return std::make_unique<fst::StdConstFst>(composed);
+}
+
+class InverseTextNormalizer::Impl {
+ public:
+  Impl(const std::string &rule_fsts, const std::string &rule_fars,
+       bool compose, bool debug)
+      : debug_(debug) {
+    std::vector<std::unique_ptr<fst::StdConstFst>> rules;
+
+    std::vector<std::string> files;
+    SplitStringToVector(rule_fsts, ",", true, &files);
+    for (const auto &f : files) {
+      if (debug_) {
+        SHERPA_ONNX_LOGE("rule fst: %s", f.c_str());
+      }
+
+      std::ifstream is(f, std::ios::binary);
+      rules.push_back(ReadRule(is, f));
+    }
+
+    SplitStringToVector(rule_fars, ",", true, &files);
+    for (const auto &f : files) {
+      if (debug_) {
+        SHERPA_ONNX_LOGE("rule far: %s", f.c_str());
+      }
+
+      ReadFar(std::unique_ptr<fst::FarReader<fst::StdArc>>(
+                  fst::FarReader<fst::StdArc>::Open(f)),
+              &rules);
+    }
+
+    Init(std::move(rules), compose);
+  }
+
+  template <typename Manager>
+  Impl(Manager *mgr, const std::string &rule_fsts,
+       const std::string &rule_fars, bool compose, bool debug)
+      : debug_(debug) {
+    std::vector<std::unique_ptr<fst::StdConstFst>> rules;
+
+    std::vector<std::string> files;
+    SplitStringToVector(rule_fsts, ",", true, &files);
+    for (const auto &f : files) {
+      if (debug_) {
+        SHERPA_ONNX_LOGE("rule fst: %s", f.c_str());
+      }
+
+      auto buf = ReadFile(mgr, f);
+      std::istrstream is(buf.data(), buf.size());
+      rules.push_back(ReadRule(is, f));
+    }
+
+    SplitStringToVector(rule_fars, ",", true, &files);
+    for (const auto &f : files) {
+      if (debug_) {
+        SHERPA_ONNX_LOGE("rule far: %s", f.c_str());
+      }
+
+      auto buf = ReadFile(mgr, f);
+
+      std::unique_ptr<std::istream> s(
+          new std::istrstream(buf.data(), buf.size()));
+
+      ReadFar(std::unique_ptr<fst::FarReader<fst::StdArc>>(
+                  fst::FarReader<fst::StdArc>::Open(std::move(s))),
+              &rules);
+    }
+
+    Init(std::move(rules), compose);
+  }
+
+  ~Impl() {
+    if (debug_) {
+      SHERPA_ONNX_LOGE("ITN: %s", Stats().c_str());
+    }
+  }
+
+  std::string Apply(const std::string &text) const {
+    if (normalizers_.empty() || text.empty()) {
+      return text;
+    }
+
+    std::string ans;
+    if (cache_.Get(text, &ans)) {
+      return ans;
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+
+    ans = text;
+    for (const auto &tn : normalizers_) {
+      ans = tn->Normalize(ans);
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    float elapsed_seconds = std::chrono::duration<float>(end - begin).count();
+
+    cache_.Put(text, ans);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      total_seconds_ += elapsed_seconds;
+    }
+
+    if (debug_) {
+      SHERPA_ONNX_LOGE("ITN took %.3f ms. '%s' -> '%s'",
+                       elapsed_seconds * 1000, text.c_str(), ans.c_str());
+    }
+
+    return ans;
+  }
+
+  std::string Stats() const {
+    double total_seconds = 0;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      total_seconds = total_seconds_;
+    }
+
+    int64_t num_misses = cache_.NumMisses();
+
+    std::ostringstream os;
+    os << "num_rules=" << num_rules_
+       << ", num_normalizers=" << normalizers_.size()
+       << ", cache=(" << cache_.Stats() << ")"
+       << ", total_seconds=" << total_seconds << ", average_ms="
+       << (num_misses > 0 ? total_seconds * 1000 / num_misses : 0);
+
+    return os.str();
+  }
+
+ private:
+  void Init(std::vector<std::unique_ptr<fst::StdConstFst>> rules,
+            bool compose) {
+    num_rules_ = static_cast<int32_t>(rules.size());
+
+    if (compose && rules.size() > 1) {
+      auto begin = std::chrono::steady_clock::now();
+
+      auto composed = ComposeRules(rules);
+
+      auto end = std::chrono::steady_clock::now();
+
+      if (debug_) {
+        SHERPA_ONNX_LOGE(
+            "Composed %d rules into a single one with %d states in %.3f "
+            "seconds",
+            num_rules_, static_cast<int32_t>(composed->NumStates()),
+            std::chrono::duration<float>(end - begin).count());
+      }
+
+      rules.clear();
+      rules.push_back(std::move(composed));
+    }
+
+    normalizers_.reserve(rules.size());
+    for (auto &r : rules) {
+      normalizers_.push_back(
+          std::make_unique<kaldifst::TextNormalizer>(std::move(r)));
+    }
+  }
+
+ private:
+  // Applied from left to right
+  std::vector<std::unique_ptr<kaldifst::TextNormalizer>> normalizers_;
+
+  // Number of rules before composition
+  int32_t num_rules_ = 0;
+
+  // Map the input text to the normalized text
+  mutable LruCache<std::string> cache_{kCacheSize};
+
+  // Time spent on cache misses
+  mutable std::mutex mutex_;
+  mutable double total_seconds_ = 0;
+
+  bool debug_ = false;
+};
+
+InverseTextNormalizer::InverseTextNormalizer(const std::string &rule_fsts,
+                                             const std::string &rule_fars,
+                                             bool compose, bool debug)
+    : impl_(std::make_unique<Impl>(rule_fsts, rule_fars, compose, debug)) {}
+
+template <typename Manager>
+InverseTextNormalizer::InverseTextNormalizer(Manager *mgr,
+                                             const std::string &rule_fsts,
+                                             const std::string &rule_fars,
+                                             bool compose, bool debug)
+    : impl_(std::make_unique<Impl>(mgr, rule_fsts, rule_fars, compose,
+                                   debug)) {}
+
+InverseTextNormalizer::~InverseTextNormalizer() = default;
+
+std::string InverseTextNormalizer::Apply(const std::string &text) const {
+  return impl_->Apply(text);
+}
+
+std::string InverseTextNormalizer::Stats() const { return impl_->Stats(); }
+
+#if __ANDROID_API__ >= 9
+template InverseTextNormalizer::InverseTextNormalizer(
+    AAssetManager *mgr, const std::string &rule_fsts,
+    const std::string &rule_fars, bool compose, bool debug);
+#endif
+
+#if __OHOS__
+template InverseTextNormalizer::InverseTextNormalizer(
+    NativeResourceManager *mgr, const std::string &rule_fsts,
+    const std::string &rule_fars, bool compose, bool debug);
+#endif
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,56 @@
+// sherpa-onnx/csrc/inverse-text-normalizer.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_INVERSE_TEXT_NORMALIZER_H_
+#define SHERPA_ONNX_CSRC_INVERSE_TEXT_NORMALIZER_H_
+
+#include <memory>
+#include <string>
+
+namespace sherpa_onnx {
+
+// Inverse text normalization (ITN) with rule FSTs, e.g., from
+// WeTextProcessing.
+//
+// Results are memoized, so repeatedly normalizing the same text, e.g.,
+// polling the partial result of a stream that has not changed, costs only
+// a hash table lookup. It is safe to call Apply() from multiple threads.
+class InverseTextNormalizer {
+ public:
+  // @param rule_fsts Comma separated rule FSTs, e.g., a.fst,b.fst
+  // @param rule_fars Comma separated FST archives. Rules in rule_fsts are
+  //                  applied before rules in the archives.
+  // @param compose If true and there are multiple rules, they are composed
+  //                into a single transducer at load time so that only one
+  //                composition and shortest path search is performed for
+  //                each text. Note that the result may differ from applying
+  //                the rules one by one if a rule has multiple competing
+  //                outputs for an input, since the best path is then found
+  //                jointly over all rules.
+  // @param debug True to print the time spent on each call.
+  InverseTextNormalizer(const std::string &rule_fsts,
+                        const std::string &rule_fars, bool compose,
+                        bool debug);
+
+  template <typename Manager>
+  InverseTextNormalizer(Manager *mgr, const std::string &rule_fsts,
+                        const std::string &rule_fars, bool compose,
+                        bool debug);
+
+  ~InverseTextNormalizer();
+
+  std::string Apply(const std::string &text) const;
+
+  // Return the number of rules, the number of calls, cache hits and the
+  // time spent on normalization
+  std::string Stats() const;
+
+ private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_INVERSE_TEXT_NORMALIZER_H_
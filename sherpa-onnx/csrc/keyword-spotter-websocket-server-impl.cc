@@ -0,0 +1,502 @@
+// sherpa-onnx/csrc/keyword-spotter-websocket-server-impl.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/keyword-spotter-websocket-server-impl.h"
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "sherpa-onnx/csrc/log.h"
+#include "sherpa-onnx/csrc/macros.h"
+
+namespace sherpa_onnx {
+
+void KeywordSpotterWebsocketDecoderConfig::Register(ParseOptions *po) {
+  kws_config.Register(po);
+
+  po->Register("loop-interval-ms", &loop_interval_ms,
+               "It determines how often the decoder loop runs. ");
+
+  po->Register("max-batch-size", &max_batch_size,
+               "Max number of streams to decode in a batch. All streams that "
+               "are ready are decoded in batches of at most this size.");
+
+  po->Register("end-tail-padding", &end_tail_padding,
+               "It determines the length of tail_padding at the end of audio.");
+
+  po->Register("stats-interval-seconds", &stats_interval_seconds,
+               "How often to log the batch and detection latency statistics. "
+               "Use 0 to disable it.");
+}
+
+void KeywordSpotterWebsocketDecoderConfig::Validate() const {
+  if (!kws_config.Validate()) {
+    SHERPA_ONNX_LOGE("Errors in the keyword spotter config");
+    exit(-1);
+  }
+
+  SHERPA_ONNX_CHECK_GT(loop_interval_ms, 0);
+  SHERPA_ONNX_CHECK_GT(max_batch_size, 0);
+  SHERPA_ONNX_CHECK_GT(end_tail_padding, 0);
+  SHERPA_ONNX_CHECK_GE(stats_interval_seconds, 0);
+}
+
+void KeywordSpotterWebsocketServerConfig::Register(
+    sherpa_onnx::ParseOptions *po) {
+  decoder_config.Register(po);
+
+  po->Register("log-file", &log_file,
+               "Path to the log file. Logs are "
+               "appended to this file");
+}
+
+void KeywordSpotterWebsocketServerConfig::Validate() const {
+  decoder_config.Validate();
+}
+
+KeywordSpotterWebsocketDecoder::KeywordSpotterWebsocketDecoder(
+    KeywordSpotterWebsocketServer *server)
+    : server_(server),
+      config_(server->GetConfig().decoder_config),
+      timer_(server->GetWorkContext()),
+      stats_start_(std::chrono::steady_clock::now()) {
+  kws_ = std::make_unique<KeywordSpotter>(config_.kws_config);
+}
+
+std::shared_ptr<KwsConnection> KeywordSpotterWebsocketDecoder::CreateConnection(
+    connection_hdl hdl, const std::string &keywords) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (connections_.count(hdl)) {
+      return nullptr;
+    }
+  }
+
+  // Encoding the keywords and building the graph may take some time, so
+  // we don't hold the lock here
+  std::shared_ptr<OnlineStream> s = kws_->CreateStream(keywords);
+  if (!s) {
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto c = std::make_shared<KwsConnection>(hdl, s);
+
+  // Messages of a connection are handled one at a time, so no other thread
+  // can add this connection in the meantime
+  connections_.insert({hdl, c});
+  return c;
+}
+
+std::shared_ptr<KwsConnection>
+KeywordSpotterWebsocketDecoder::GetOrCreateConnection(connection_hdl hdl) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = connections_.find(hdl);
+  if (it != connections_.end()) {
+    return it->second;
+  } else {
+    // create a new connection
+    std::shared_ptr<OnlineStream> s = kws_->CreateStream();
+    auto c = std::make_shared<KwsConnection>(hdl, s);
+    connections_.insert({hdl, c});
+    return c;
+  }
+}
+
+void KeywordSpotterWebsocketDecoder::AcceptWaveform(
+    std::shared_ptr<KwsConnection> c) {
+  std::lock_guard<std::mutex> lock(c->mutex);
+  float sample_rate = config_.kws_config.feat_config.sampling_rate;
+  while (!c->samples.empty()) {
+    const auto &s = c->samples.front();
+    c->s->AcceptWaveform(sample_rate, s.data(), s.size());
+    c->samples.pop_front();
+  }
+}
+
+void KeywordSpotterWebsocketDecoder::InputFinished(
+    std::shared_ptr<KwsConnection> c) {
+  std::lock_guard<std::mutex> lock(c->mutex);
+
+  float sample_rate = config_.kws_config.feat_config.sampling_rate;
+
+  while (!c->samples.empty()) {
+    const auto &s = c->samples.front();
+    c->s->AcceptWaveform(sample_rate, s.data(), s.size());
+    c->samples.pop_front();
+  }
+
+  std::vector<float> tail_padding(
+      static_cast<int64_t>(config_.end_tail_padding * sample_rate));
+
+  c->s->AcceptWaveform(sample_rate, tail_padding.data(), tail_padding.size());
+
+  c->s->InputFinished();
+  c->eof = true;
+}
+
+void KeywordSpotterWebsocketDecoder::Run() {
+  timer_.expires_after(std::chrono::milliseconds(config_.loop_interval_ms));
+
+  timer_.async_wait(
+      [this](const asio::error_code &ec) { ProcessConnections(ec); });
+}
+
+void KeywordSpotterWebsocketDecoder::ProcessConnections(
+    const asio::error_code &ec) {
+  if (ec) {
+    SHERPA_ONNX_LOG(FATAL) << "The decoder loop is aborted!";
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<connection_hdl> to_remove;
+  for (auto &p : connections_) {
+    auto hdl = p.first;
+    auto c = p.second;
+
+    // The order of `if` below matters!
+    if (!server_->Contains(hdl)) {
+      // If the connection is disconnected, we stop processing it
+      to_remove.push_back(hdl);
+      continue;
+    }
+
+    if (active_.count(hdl)) {
+      // Another thread is decoding this stream, so skip it
+      continue;
+    }
+
+    if (!kws_->IsReady(c->s.get()) && !c->eof) {
+      // this stream has not enough frames to decode, so skip it
+      continue;
+    }
+
+    if (!kws_->IsReady(c->s.get()) && c->eof) {
+      // We won't receive samples from the client, so send a Done! to client
+
+      asio::post(server_->GetWorkContext(),
+                 [this, hdl = c->hdl]() { server_->Send(hdl, "Done!"); });
+
+      to_remove.push_back(hdl);
+      continue;
+    }
+
+    // this stream has enough frames and is currently not processed by any
+    // threads, so put it into the ready queue
+    ready_connections_.push_back(c);
+
+    // In `Decode()`, it will remove hdl from `active_`
+    active_.insert(c->hdl);
+  }
+
+  for (auto hdl : to_remove) {
+    connections_.erase(hdl);
+  }
+
+  // Split the ready connections into batches so that several work threads
+  // can decode them at the same time
+  int32_t num_ready = ready_connections_.size();
+  int32_t num_batches =
+      (num_ready + config_.max_batch_size - 1) / config_.max_batch_size;
+  for (int32_t i = 0; i != num_batches; ++i) {
+    asio::post(server_->GetWorkContext(), [this]() { Decode(); });
+  }
+
+  if (config_.stats_interval_seconds > 0) {
+    LogStats();
+  }
+
+  // Schedule another call
+  timer_.expires_after(std::chrono::milliseconds(config_.loop_interval_ms));
+
+  timer_.async_wait(
+      [this](const asio::error_code &ec) { ProcessConnections(ec); });
+}
+
+void KeywordSpotterWebsocketDecoder::Decode() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (ready_connections_.empty()) {
+    // There are no connections that are ready for decoding,
+    // so we return directly
+    return;
+  }
+
+  std::vector<std::shared_ptr<KwsConnection>> c_vec;
+  std::vector<OnlineStream *> s_vec;
+  while (!ready_connections_.empty() &&
+         static_cast<int32_t>(s_vec.size()) < config_.max_batch_size) {
+    auto c = ready_connections_.front();
+    ready_connections_.pop_front();
+
+    c_vec.push_back(c);
+    s_vec.push_back(c->s.get());
+  }
+
+  lock.unlock();
+
+  auto start = std::chrono::steady_clock::now();
+  kws_->DecodeStreams(s_vec.data(), s_vec.size());
+  auto end = std::chrono::steady_clock::now();
+
+  std::vector<float> latencies;
+  for (auto c : c_vec) {
+    auto r = kws_->GetResult(c->s.get());
+
+    if (!r.keyword.empty()) {
+      // Remember to reset the stream after a keyword is detected
+      kws_->Reset(c->s.get());
+
+      latencies.push_back(GetLatency(c.get(), r));
+
+      asio::post(server_->GetConnectionContext(),
+                 [this, hdl = c->hdl, str = r.AsJsonString()]() {
+                   server_->Send(hdl, str);
+                 });
+    }
+
+    // A keyword detected later ends in audio that is not decoded yet, so
+    // arrivals of decoded audio are no longer needed
+    float decoded_seconds = c->s->GetNumProcessedFrames() *
+                            config_.kws_config.feat_config.frame_shift_ms /
+                            1000;
+
+    std::lock_guard<std::mutex> c_lock(c->mutex);
+    while (!c->arrivals.empty() &&
+           c->arrivals.front().first < decoded_seconds) {
+      c->arrivals.pop_front();
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+    num_batches_ += 1;
+    num_decoded_streams_ += s_vec.size();
+    max_decoded_batch_size_ =
+        std::max<int32_t>(max_decoded_batch_size_, s_vec.size());
+    decode_seconds_ += std::chrono::duration<float>(end - start).count();
+    num_detections_ += latencies.size();
+    for (auto t : latencies) {
+      if (t >= 0) {
+        latencies_.push_back(t);
+      }
+    }
+  }
+
+  lock.lock();
+  for (auto c : c_vec) {
+    active_.erase(c->hdl);
+  }
+}
+
+float KeywordSpotterWebsocketDecoder::GetLatency(
+    KwsConnection *c, const KeywordResult &r) const {
+  if (r.timestamps.empty()) {
+    return -1;
+  }
+
+  // when the last token of the keyword is decoded, in seconds since the
+  // start of the stream
+  float t = r.start_time + r.timestamps.back();
+
+  std::lock_guard<std::mutex> lock(c->mutex);
+  for (const auto &p : c->arrivals) {
+    if (p.first >= t) {
+      return std::chrono::duration<float>(std::chrono::steady_clock::now() -
+                                          p.second)
+          .count();
+    }
+  }
+
+  // It is in the tail padding added by InputFinished()
+  return -1;
+}
+
+void KeywordSpotterWebsocketDecoder::LogStats() {
+  auto now = std::chrono::steady_clock::now();
+
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  float elapsed = std::chrono::duration<float>(now - stats_start_).count();
+  if (elapsed < config_.stats_interval_seconds) {
+    return;
+  }
+
+  if (num_batches_ > 0) {
+    std::ostringstream os;
+    os << "In the last " << elapsed << " seconds: "
+       << "connections: " << server_->NumConnections()
+       << ", batches: " << num_batches_ << ", average batch size: "
+       << static_cast<float>(num_decoded_streams_) / num_batches_
+       << ", max batch size: " << max_decoded_batch_size_
+       << ", average decoding time per batch: "
+       << decode_seconds_ * 1000 / num_batches_ << " ms"
+       << ", detected keywords: " << num_detections_;
+
+    if (!latencies_.empty()) {
+      std::sort(latencies_.begin(), latencies_.end());
+      int32_t n = latencies_.size();
+      float sum = 0;
+      for (auto t : latencies_) {
+        sum += t;
+      }
+
+      os << ", detection latency (ms) average: " << sum * 1000 / n
+         << ", p50: " << latencies_[n / 2] * 1000
+         << ", p95: " << latencies_[std::min(n - 1, n * 95 / 100)] * 1000
+         << ", max: " << latencies_.back() * 1000;
+    }
+
+    SHERPA_ONNX_LOG(INFO) << os.str();
+  }
+
+  stats_start_ = now;
+  num_batches_ = 0;
+  num_decoded_streams_ = 0;
+  max_decoded_batch_size_ = 0;
+  decode_seconds_ = 0;
+  num_detections_ = 0;
+  latencies_.clear();
+}
+
+KeywordSpotterWebsocketServer::KeywordSpotterWebsocketServer(
+    asio::io_context &io_conn, asio::io_context &io_work,
+    const KeywordSpotterWebsocketServerConfig &config)
+    : config_(config),
+      io_conn_(io_conn),
+      io_work_(io_work),
+      log_(config.log_file, std::ios::app),
+      tee_(std::cout, log_),
+      decoder_(this) {
+  SetupLog();
+
+  server_.init_asio(&io_conn_);
+
+  server_.set_open_handler([this](connection_hdl hdl) { OnOpen(hdl); });
+
+  server_.set_close_handler([this](connection_hdl hdl) { OnClose(hdl); });
+
+  server_.set_message_handler(
+      [this](connection_hdl hdl, server::message_ptr msg) {
+        OnMessage(hdl, msg);
+      });
+}
+
+void KeywordSpotterWebsocketServer::Run(uint16_t port) {
+  server_.set_reuse_addr(true);
+  server_.listen(asio::ip::tcp::v4(), port);
+  server_.start_accept();
+  decoder_.Run();
+}
+
+void KeywordSpotterWebsocketServer::SetupLog() {
+  server_.clear_access_channels(websocketpp::log::alevel::all);
+
+  // So that it also prints to std::cout and std::cerr
+  server_.get_alog().set_ostream(&tee_);
+  server_.get_elog().set_ostream(&tee_);
+}
+
+void KeywordSpotterWebsocketServer::Send(connection_hdl hdl,
+                                         const std::string &text) {
+  websocketpp::lib::error_code ec;
+  if (!Contains(hdl)) {
+    return;
+  }
+
+  server_.send(hdl, text, websocketpp::frame::opcode::text, ec);
+  if (ec) {
+    server_.get_alog().write(websocketpp::log::alevel::app, ec.message());
+  }
+}
+
+void KeywordSpotterWebsocketServer::OnOpen(connection_hdl hdl) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  connections_.insert(hdl);
+
+  std::ostringstream os;
+  os << "New connection: "
+     << server_.get_con_from_hdl(hdl)->get_remote_endpoint() << ". "
+     << "Number of active connections: " << connections_.size() << ".\n";
+  SHERPA_ONNX_LOG(INFO) << os.str();
+}
+
+void KeywordSpotterWebsocketServer::OnClose(connection_hdl hdl) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  connections_.erase(hdl);
+
+  SHERPA_ONNX_LOG(INFO) << "Number of active connections: "
+                        << connections_.size() << "\n";
+}
+
+bool KeywordSpotterWebsocketServer::Contains(connection_hdl hdl) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return connections_.count(hdl);
+}
+
+int32_t KeywordSpotterWebsocketServer::NumConnections() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return connections_.size();
+}
+
+void KeywordSpotterWebsocketServer::OnMessage(connection_hdl hdl,
+                                              server::message_ptr msg) {
+  const std::string &payload = msg->get_payload();
+
+  switch (msg->get_opcode()) {
+    case websocketpp::frame::opcode::text:
+      if (payload == "Done") {
+        auto c = decoder_.GetOrCreateConnection(hdl);
+        asio::post(io_work_, [this, c]() { decoder_.InputFinished(c); });
+      } else if (!decoder_.CreateConnection(hdl, payload)) {
+        Close(hdl, websocketpp::close::status::invalid_payload,
+              "Invalid keywords '" + payload +
+                  "'. Keywords must be sent only once, before any audio");
+      }
+      break;
+    case websocketpp::frame::opcode::binary: {
+      auto c = decoder_.GetOrCreateConnection(hdl);
+
+      auto p = reinterpret_cast<const float *>(payload.data());
+      int32_t num_samples = payload.size() / sizeof(float);
+      std::vector<float> samples(p, p + num_samples);
+
+      {
+        std::lock_guard<std::mutex> lock(c->mutex);
+        c->received_seconds +=
+            static_cast<float>(num_samples) /
+            config_.decoder_config.kws_config.feat_config.sampling_rate;
+        c->arrivals.emplace_back(c->received_seconds,
+                                 std::chrono::steady_clock::now());
+
+        c->samples.push_back(std::move(samples));
+      }
+
+      asio::post(io_work_, [this, c]() { decoder_.AcceptWaveform(c); });
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+void KeywordSpotterWebsocketServer::Close(
+    connection_hdl hdl, websocketpp::close::status::value code,
+    const std::string &reason) {
+  auto con = server_.get_con_from_hdl(hdl);
+
+  std::ostringstream os;
+  os << "Closing " << con->get_remote_endpoint() << " with reason: " << reason
+     << "\n";
+
+  websocketpp::lib::error_code ec;
+  server_.close(hdl, code, reason, ec);
+  if (ec) {
+    os << "Failed to close" << con->get_remote_endpoint() << ". "
+       << ec.message() << "\n";
+  }
+  server_.get_alog().write(websocketpp::log::alevel::app, os.str());
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,232 @@
+// sherpa-onnx/csrc/keyword-spotter-websocket-server-impl.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_KEYWORD_SPOTTER_WEBSOCKET_SERVER_IMPL_H_
+#define SHERPA_ONNX_CSRC_KEYWORD_SPOTTER_WEBSOCKET_SERVER_IMPL_H_
+
+#include <chrono>  // NOLINT
+#include <deque>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "asio.hpp"
+#include "sherpa-onnx/csrc/keyword-spotter.h"
+#include "sherpa-onnx/csrc/online-stream.h"
+#include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/tee-stream.h"
+#include "websocketpp/config/asio_no_tls.hpp"  // TODO(fangjun): support TLS
+#include "websocketpp/server.hpp"
+using server = websocketpp::server<websocketpp::config::asio>;
+using connection_hdl = websocketpp::connection_hdl;
+
+namespace sherpa_onnx {
+
+/** Communication protocol
+ *
+ * - The client can send a text message containing keywords before sending
+ *   any audio. The keywords are used only for this connection and are in
+ *   the same format as KeywordSpotter::CreateStream(keywords), e.g.,
+ *   "▁HE LL O ▁WORLD/x iǎo ài t óng x ué". If the client does not send
+ *   it, the keywords from --keywords-file are used.
+ *
+ * - The client sends audio samples in binary messages. Each sample is a
+ *   float32 in the range [-1, 1]. The sample rate must be the one given by
+ *   --sample-rate.
+ *
+ * - The client sends a text message "Done" after sending all audio.
+ *
+ * - The server sends KeywordResult::AsJsonString() whenever a keyword is
+ *   detected and "Done!" after processing all audio of the client.
+ */
+struct KwsConnection {
+  // handle to the connection. We can use it to send messages to the client
+  connection_hdl hdl;
+  std::shared_ptr<OnlineStream> s;
+
+  // set it to true when InputFinished() is called
+  bool eof = false;
+
+  std::mutex mutex;  // protect samples and arrivals
+
+  // Audio samples received from the client.
+  //
+  // The I/O threads receive audio samples into this queue
+  // and invoke work threads to compute features
+  std::deque<std::vector<float>> samples;
+
+  // Total duration in seconds of the audio received so far
+  float received_seconds = 0;
+
+  // (received_seconds, the time it was received) for each message that has
+  // not been decoded yet. It is used to compute the detection latency.
+  std::deque<std::pair<float, std::chrono::steady_clock::time_point>>
+      arrivals;
+
+  KwsConnection(connection_hdl hdl, std::shared_ptr<OnlineStream> s)
+      : hdl(hdl), s(s) {}
+};
+
+struct KeywordSpotterWebsocketDecoderConfig {
+  KeywordSpotterConfig kws_config;
+
+  // It determines how often the decoder loop runs.
+  int32_t loop_interval_ms = 10;
+
+  // All ready streams are decoded in batches of at most this size
+  int32_t max_batch_size = 32;
+
+  float end_tail_padding = 0.8;
+
+  // How often to log the batch and latency statistics.
+  // 0 to disable it.
+  float stats_interval_seconds = 10;
+
+  void Register(ParseOptions *po);
+  void Validate() const;
+};
+
+class KeywordSpotterWebsocketServer;
+
+class KeywordSpotterWebsocketDecoder {
+ public:
+  /**
+   * @param server  Not owned.
+   */
+  explicit KeywordSpotterWebsocketDecoder(
+      KeywordSpotterWebsocketServer *server);
+
+  // Return nullptr if the keywords are invalid or if the connection
+  // already exists, i.e., the client has sent audio or keywords before.
+  std::shared_ptr<KwsConnection> CreateConnection(connection_hdl hdl,
+                                                  const std::string &keywords);
+
+  // Use the keywords from the config if the connection does not exist
+  std::shared_ptr<KwsConnection> GetOrCreateConnection(connection_hdl hdl);
+
+  // Compute features for a stream given audio samples
+  void AcceptWaveform(std::shared_ptr<KwsConnection> c);
+
+  // signal that there will be no more audio samples for a stream
+  void InputFinished(std::shared_ptr<KwsConnection> c);
+
+  void Run();
+
+ private:
+  void ProcessConnections(const asio::error_code &ec);
+
+  /** It is called by one of the worker thread.
+   */
+  void Decode();
+
+  // Return the time from receiving the audio that contains the end of the
+  // keyword to now. Return a negative value if it is unknown.
+  float GetLatency(KwsConnection *c, const KeywordResult &r) const;
+
+  void LogStats();
+
+ private:
+  KeywordSpotterWebsocketServer *server_;  // not owned
+  std::unique_ptr<KeywordSpotter> kws_;
+  KeywordSpotterWebsocketDecoderConfig config_;
+  asio::steady_timer timer_;
+
+  // It protects `connections_`, `ready_connections_`, and `active_`
+  std::mutex mutex_;
+
+  std::map<connection_hdl, std::shared_ptr<KwsConnection>,
+           std::owner_less<connection_hdl>>
+      connections_;
+
+  // Whenever a connection has enough feature frames for decoding, we put
+  // it in this queue
+  std::deque<std::shared_ptr<KwsConnection>> ready_connections_;
+
+  // If we are decoding a stream, we put it in the active_ set so that
+  // only one thread can decode a stream at a time.
+  std::set<connection_hdl, std::owner_less<connection_hdl>> active_;
+
+  // It protects the statistics below
+  std::mutex stats_mutex_;
+  std::chrono::steady_clock::time_point stats_start_;
+  int32_t num_batches_ = 0;
+  int32_t num_decoded_streams_ = 0;
+  int32_t max_decoded_batch_size_ = 0;
+  float decode_seconds_ = 0;
+  int32_t num_detections_ = 0;
+  // in seconds
+  std::vector<float> latencies_;
+};
+
+struct KeywordSpotterWebsocketServerConfig {
+  KeywordSpotterWebsocketDecoderConfig decoder_config;
+
+  std::string log_file = "./log.txt";
+
+  void Register(sherpa_onnx::ParseOptions *po);
+  void Validate() const;
+};
+
+class KeywordSpotterWebsocketServer {
+ public:
+  explicit KeywordSpotterWebsocketServer(
+      asio::io_context &io_conn,  // NOLINT
+      asio::io_context &io_work,  // NOLINT
+      const KeywordSpotterWebsocketServerConfig &config);
+
+  void Run(uint16_t port);
+
+  const KeywordSpotterWebsocketServerConfig &GetConfig() const {
+    return config_;
+  }
+  asio::io_context &GetConnectionContext() { return io_conn_; }
+  asio::io_context &GetWorkContext() { return io_work_; }
+  server &GetServer() { return server_; }
+
+  void Send(connection_hdl hdl, const std::string &text);
+
+  bool Contains(connection_hdl hdl) const;
+
+  int32_t NumConnections() const;
+
+ private:
+  void SetupLog();
+
+  // When a websocket client is connected, it will invoke this method
+  // (Not for HTTP)
+  void OnOpen(connection_hdl hdl);
+
+  // When a websocket client is disconnected, it will invoke this method
+  void OnClose(connection_hdl hdl);
+
+  void OnMessage(connection_hdl hdl, server::message_ptr msg);
+
+  // Close a websocket connection with given code and reason
+  void Close(connection_hdl hdl, websocketpp::close::status::value code,
+             const std::string &reason);
+
+ private:
+  KeywordSpotterWebsocketServerConfig config_;
+  asio::io_context &io_conn_;
+  asio::io_context &io_work_;
+  server server_;
+
+  std::ofstream log_;
+  sherpa_onnx::TeeStream tee_;
+
+  KeywordSpotterWebsocketDecoder decoder_;
+
+  mutable std::mutex mutex_;
+
+  std::set<connection_hdl, std::owner_less<connection_hdl>> connections_;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_KEYWORD_SPOTTER_WEBSOCKET_SERVER_IMPL_H_
@@ -5,7 +5,8 @@
 #include "sherpa-onnx/csrc/kokoro-multi-lang-lexicon.h"
 
 #include <fstream>
-#include <regex>  // NOLINT
+#include <locale>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <strstream>
@@ -29,9 +30,11 @@
 #include "phoneme_ids.hpp"
 #include "phonemize.hpp"
 #include "sherpa-onnx/csrc/file-utils.h"
+#include "sherpa-onnx/csrc/lru-cache.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
 #include "sherpa-onnx/csrc/phrase-matcher.h"
 #include "sherpa-onnx/csrc/symbol-table.h"
+#include "sherpa-onnx/csrc/text-segmenter.h"
 #include "sherpa-onnx/csrc/text-utils.h"
 
 namespace sherpa_onnx {
@@ -44,8 +47,11 @@ class KokoroMultiLangLexicon::Impl {
  public:
   Impl(const std::string &tokens, const std::string &lexicon,
        const std::string &data_dir,
-       const OfflineTtsKokoroModelMetaData &meta_data, bool debug)
+       const OfflineTtsKokoroModelMetaData &meta_data, bool debug,
+       int32_t oov_cache_size)
       : meta_data_(meta_data), debug_(debug) {
+    InitOovCache(oov_cache_size);
+
     InitTokens(tokens);
 
     InitLexicon(lexicon);
@@ -56,8 +62,11 @@ class KokoroMultiLangLexicon::Impl {
   template <typename Manager>
   Impl(Manager *mgr, const std::string &tokens, const std::string &lexicon,
        const std::string &data_dir,
-       const OfflineTtsKokoroModelMetaData &meta_data, bool debug)
+       const OfflineTtsKokoroModelMetaData &meta_data, bool debug,
+       int32_t oov_cache_size)
       : meta_data_(meta_data), debug_(debug) {
+    InitOovCache(oov_cache_size);
+
     InitTokens(mgr, tokens);
 
     InitLexicon(mgr, lexicon);
@@ -76,48 +85,36 @@ class KokoroMultiLangLexicon::Impl {
       SHERPA_ONNX_LOGE("After converting to lowercase:\n%s", text.c_str());
     }
 
-    std::vector<std::pair<std::string, std::string>> replace_str_pairs = {
-        {"，", ","}, {":", ","},  {"、", ","}, {"；", ";"},   {"：", ":"},
-        {"。", "."}, {"？", "?"}, {"！", "!"}, {"\\s+", " "},
-    };
-    for (const auto &p : replace_str_pairs) {
-      std::regex re(p.first);
-      text = std::regex_replace(text, re, p.second);
-    }
+    // Note: ":" is replaced by "," while "：" is replaced by ":"
+    static const PunctuationMap kPunctuationMap(
+        {
+            {"，", ","},
+            {":", ","},
+            {"、", ","},
+            {"；", ";"},
+            {"：", ":"},
+            {"。", "."},
+            {"？", "?"},
+            {"！", "!"},
+        },
+        /*merge_spaces*/ true);
+
+    text = kPunctuationMap.Apply(text);
 
     if (debug_) {
       SHERPA_ONNX_LOGE("After replacing punctuations and merging spaces:\n%s",
                        text.c_str());
     }
 
-    // https://en.cppreference.com/w/cpp/regex
-    // https://stackoverflow.com/questions/37989081/how-to-use-unicode-range-in-c-regex
-    std::string expr_chinese = "([\\u4e00-\\u9fff]+)";
-    std::string expr_not_chinese = "([^\\u4e00-\\u9fff]+)";
-
-    std::string expr_both = expr_chinese + "|" + expr_not_chinese;
-
-    auto ws = ToWideString(text);
-    std::wstring wexpr_both = ToWideString(expr_both);
-    std::wregex we_both(wexpr_both);
-
-    std::wstring wexpr_zh = ToWideString(expr_chinese);
-    std::wregex we_zh(wexpr_zh);
-
-    auto begin = std::wsregex_iterator(ws.begin(), ws.end(), we_both);
-    auto end = std::wsregex_iterator();
+    std::vector<TextSegment> segments = SplitChineseAndNonChinese(text);
 
     std::vector<TokenIDs> ans;
 
-    for (std::wsregex_iterator i = begin; i != end; ++i) {
-      std::wsmatch match = *i;
-      std::wstring match_str = match.str();
-
-      auto ms = ToString(match_str);
-      uint8_t c = reinterpret_cast<const uint8_t *>(ms.data())[0];
+    for (const auto &segment : segments) {
+      const std::string &ms = segment.text;
 
       std::vector<std::vector<int32_t>> ids_vec;
-      if (std::regex_match(match_str, we_zh)) {
+      if (segment.is_chinese) {
         if (debug_) {
           SHERPA_ONNX_LOGE("Chinese: %s", ms.c_str());
         }
@@ -299,6 +296,38 @@ class KokoroMultiLangLexicon::Impl {
     return ans;
   }
 
+  // Use espeak-ng to convert a word that is not in the lexicon
+  std::vector<int32_t> ConvertOovToTokenIDs(const std::string &word) const {
+    piper::eSpeakPhonemeConfig config;
+
+    config.voice = meta_data_.voice;
+
+    std::vector<std::vector<piper::Phoneme>> phonemes;
+
+    CallPhonemizeEspeak(word, config, &phonemes);
+    // Note phonemes[i] contains a vector of unicode codepoints;
+    // we need to convert them to utf8
+
+    std::wstring_convert<std::codecvt_utf8<char32_t>, char32_t> conv;
+
+    std::vector<int32_t> ids;
+    for (const auto &v : phonemes) {
+      for (const auto p : v) {
+        auto token = conv.to_bytes(p);
+        if (token2id_.count(token)) {
+          ids.push_back(token2id_.at(token));
+        } else {
+          if (debug_) {
+            SHERPA_ONNX_LOGE("Skip OOV token '%s' from '%s'", token.c_str(),
+                             word.c_str());
+          }
+        }
+      }
+    }
+
+    return ids;
+  }
+
   std::vector<std::vector<int32_t>> ConvertNonChineseToTokenIDs(
       const std::string &text, const std::string &voice) const {
     if (IsPunctuation(text)) {
@@ -372,30 +401,11 @@ class KokoroMultiLangLexicon::Impl {
                            word.c_str());
         }
 
-        piper::eSpeakPhonemeConfig config;
-
-        config.voice = meta_data_.voice;
-
-        std::vector<std::vector<piper::Phoneme>> phonemes;
-
-        CallPhonemizeEspeak(word, config, &phonemes);
-        // Note phonemes[i] contains a vector of unicode codepoints;
-        // we need to convert them to utf8
-
-        std::wstring_convert<std::codecvt_utf8<char32_t>, char32_t> conv;
-
         std::vector<int32_t> ids;
-        for (const auto &v : phonemes) {
-          for (const auto p : v) {
-            auto token = conv.to_bytes(p);
-            if (token2id_.count(token)) {
-              ids.push_back(token2id_.at(token));
-            } else {
-              if (debug_) {
-                SHERPA_ONNX_LOGE("Skip OOV token '%s' from '%s'", token.c_str(),
-                                 word.c_str());
-              }
-            }
+        if (!oov_cache_ || !oov_cache_->Get(word, &ids)) {
+          ids = ConvertOovToTokenIDs(word);
+          if (oov_cache_) {
+            oov_cache_->Put(word, ids);
           }
         }
 
@@ -546,6 +556,13 @@ class KokoroMultiLangLexicon::Impl {
     }
   }
 
+  void InitOovCache(int32_t oov_cache_size) {
+    if (oov_cache_size > 0) {
+      oov_cache_ =
+          std::make_unique<LruCache<std::vector<int32_t>>>(oov_cache_size);
+    }
+  }
+
  private:
   OfflineTtsKokoroModelMetaData meta_data_;
 
@@ -559,6 +576,10 @@ class KokoroMultiLangLexicon::Impl {
 
   std::unordered_map<char32_t, int32_t> phoneme2id_;
 
+  // Token IDs of recently seen OOV words, which are computed with espeak-ng.
+  // nullptr if the cache is disabled.
+  std::unique_ptr<LruCache<std::vector<int32_t>>> oov_cache_;
+
   bool debug_ = false;
 };
 
@@ -567,17 +588,17 @@ KokoroMultiLangLexicon::~KokoroMultiLangLexicon() = default;
 KokoroMultiLangLexicon::KokoroMultiLangLexicon(
     const std::string &tokens, const std::string &lexicon,
     const std::string &data_dir, const OfflineTtsKokoroModelMetaData &meta_data,
-    bool debug)
-    : impl_(std::make_unique<Impl>(tokens, lexicon, data_dir, meta_data,
-                                   debug)) {}
+    bool debug, int32_t oov_cache_size /*= 0*/)
+    : impl_(std::make_unique<Impl>(tokens, lexicon, data_dir, meta_data, debug,
+                                   oov_cache_size)) {}
 
 template <typename Manager>
 KokoroMultiLangLexicon::KokoroMultiLangLexicon(
     Manager *mgr, const std::string &tokens, const std::string &lexicon,
     const std::string &data_dir, const OfflineTtsKokoroModelMetaData &meta_data,
-    bool debug)
+    bool debug, int32_t oov_cache_size /*= 0*/)
     : impl_(std::make_unique<Impl>(mgr, tokens, lexicon, data_dir, meta_data,
-                                   debug)) {}
+                                   debug, oov_cache_size)) {}
 
 std::vector<TokenIDs> KokoroMultiLangLexicon::ConvertTextToTokenIds(
     const std::string &text, const std::string &voice /*= ""*/) const {
@@ -588,14 +609,15 @@ std::vector<TokenIDs> KokoroMultiLangLexicon::ConvertTextToTokenIds(
 template KokoroMultiLangLexicon::KokoroMultiLangLexicon(
     AAssetManager *mgr, const std::string &tokens, const std::string &lexicon,
     const std::string &data_dir, const OfflineTtsKokoroModelMetaData &meta_data,
-    bool debug);
+    bool debug, int32_t oov_cache_size);
 #endif
 
 #if __OHOS__
 template KokoroMultiLangLexicon::KokoroMultiLangLexicon(
     NativeResourceManager *mgr, const std::string &tokens,
     const std::string &lexicon, const std::string &data_dir,
-    const OfflineTtsKokoroModelMetaData &meta_data, bool debug);
+    const OfflineTtsKokoroModelMetaData &meta_data, bool debug,
+    int32_t oov_cache_size);
 #endif
 
 }  // namespace sherpa_onnx
@@ -18,17 +18,19 @@ class KokoroMultiLangLexicon : public OfflineTtsFrontend {
  public:
   ~KokoroMultiLangLexicon() override;
 
+  // @param oov_cache_size Maximum number of OOV words whose token IDs from
+  //                       espeak-ng are cached. 0 disables the cache.
   KokoroMultiLangLexicon(const std::string &tokens, const std::string &lexicon,
                          const std::string &data_dir,
                          const OfflineTtsKokoroModelMetaData &meta_data,
-                         bool debug);
+                         bool debug, int32_t oov_cache_size = 0);
 
   template <typename Manager>
   KokoroMultiLangLexicon(Manager *mgr, const std::string &tokens,
                          const std::string &lexicon,
                          const std::string &data_dir,
                          const OfflineTtsKokoroModelMetaData &meta_data,
-                         bool debug);
+                         bool debug, int32_t oov_cache_size = 0);
 
   std::vector<TokenIDs> ConvertTextToTokenIds(
       const std::string &text, const std::string &voice = "") const override;
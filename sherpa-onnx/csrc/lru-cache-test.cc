@@ -0,0 +1,85 @@
+// sherpa-onnx/csrc/lru-cache-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/lru-cache.h"
+
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+TEST(LruCache, Basic) {
+  LruCache<int32_t> cache(2);
+
+  int32_t v = 0;
+  EXPECT_FALSE(cache.Get("a", &v));
+
+  cache.Put("a", 1);
+  cache.Put("b", 2);
+  EXPECT_EQ(cache.Size(), 2);
+
+  EXPECT_TRUE(cache.Get("a", &v));
+  EXPECT_EQ(v, 1);
+
+  // "b" is the least recently used one, so it is evicted
+  cache.Put("c", 3);
+  EXPECT_EQ(cache.Size(), 2);
+  EXPECT_FALSE(cache.Get("b", &v));
+  EXPECT_TRUE(cache.Get("c", &v));
+  EXPECT_EQ(v, 3);
+
+  // Update an existing entry
+  cache.Put("a", 10);
+  EXPECT_TRUE(cache.Get("a", &v));
+  EXPECT_EQ(v, 10);
+
+  EXPECT_EQ(cache.NumHits(), 3);
+  EXPECT_EQ(cache.NumMisses(), 2);
+
+  cache.Clear();
+  EXPECT_EQ(cache.Size(), 0);
+  EXPECT_EQ(cache.NumHits(), 0);
+}
+
+TEST(LruCache, ZeroCapacity) {
+  LruCache<std::string> cache(0);
+  cache.Put("a", "b");
+
+  std::string v;
+  EXPECT_FALSE(cache.Get("a", &v));
+  EXPECT_EQ(cache.Size(), 0);
+}
+
+TEST(LruCache, MultiThreaded) {
+  LruCache<std::vector<int32_t>> cache(100);
+
+  std::vector<std::thread> threads;
+  for (int32_t t = 0; t != 4; ++t) {
+    threads.emplace_back([&cache, t]() {
+      for (int32_t i = 0; i != 1000; ++i) {
+        std::string key = std::to_string((i * 7 + t) % 300);
+
+        std::vector<int32_t> v;
+        if (cache.Get(key, &v)) {
+          EXPECT_EQ(v.size(), 1);
+          EXPECT_EQ(std::to_string(v[0]), key);
+        } else {
+          cache.Put(key, {std::stoi(key)});
+        }
+      }
+    });
+  }
+
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  EXPECT_LE(cache.Size(), 100);
+  EXPECT_EQ(cache.NumHits() + cache.NumMisses(), 4000);
+}
+
+}  // namespace sherpa_onnx
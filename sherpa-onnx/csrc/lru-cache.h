@@ -0,0 +1,126 @@
+// sherpa-onnx/csrc/lru-cache.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_LRU_CACHE_H_
+#define SHERPA_ONNX_CSRC_LRU_CACHE_H_
+
+#include <cstdint>
+#include <list>
+#include <mutex>  // NOLINT
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace sherpa_onnx {
+
+// A thread-safe least-recently-used cache with string keys.
+//
+// It keeps at most `capacity` entries. When it is full, inserting a new
+// entry evicts the least recently used one.
+template <typename Value>
+class LruCache {
+ public:
+  explicit LruCache(int32_t capacity) : capacity_(capacity) {}
+
+  // Return true and copy the value to *value if key is found.
+  bool Get(const std::string &key, Value *value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = map_.find(key);
+    if (it == map_.end()) {
+      ++num_misses_;
+      return false;
+    }
+
+    ++num_hits_;
+
+    // move it to the front
+    list_.splice(list_.begin(), list_, it->second);
+    *value = it->second->second;
+
+    return true;
+  }
+
+  void Put(const std::string &key, Value value) {
+    if (capacity_ <= 0) {
+      return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = map_.find(key);
+    if (it != map_.end()) {
+      it->second->second = std::move(value);
+      list_.splice(list_.begin(), list_, it->second);
+      return;
+    }
+
+    if (static_cast<int32_t>(map_.size()) >= capacity_) {
+      map_.erase(list_.back().first);
+      list_.pop_back();
+    }
+
+    list_.emplace_front(key, std::move(value));
+    map_[key] = list_.begin();
+  }
+
+  int32_t Size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<int32_t>(map_.size());
+  }
+
+  int32_t Capacity() const { return capacity_; }
+
+  int64_t NumHits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return num_hits_;
+  }
+
+  int64_t NumMisses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return num_misses_;
+  }
+
+  // Return a string containing the number of entries, hits, misses and the
+  // hit rate
+  std::string Stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    int64_t total = num_hits_ + num_misses_;
+
+    std::ostringstream os;
+    os << "size=" << map_.size() << "/" << capacity_
+       << ", hits=" << num_hits_ << ", misses=" << num_misses_
+       << ", hit_rate=" << (total > 0 ? num_hits_ * 1.0 / total : 0);
+
+    return os.str();
+  }
+
+  void Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    list_.clear();
+    map_.clear();
+    num_hits_ = 0;
+    num_misses_ = 0;
+  }
+
+ private:
+  using Entry = std::pair<std::string, Value>;
+
+  int32_t capacity_;
+
+  mutable std::mutex mutex_;
+
+  // The most recently used entry is at the front
+  std::list<Entry> list_;
+  std::unordered_map<std::string, typename std::list<Entry>::iterator> map_;
+
+  int64_t num_hits_ = 0;
+  int64_t num_misses_ = 0;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_LRU_CACHE_H_
@@ -88,6 +88,21 @@ void LogSoftmax(T *input, int32_t input_len) {
   }
 }
 
+// Return log(sum(exp(input[i])))
+template <class T>
+T LogSumExp(const T *input, int32_t input_len) {
+  assert(input);
+
+  T m = *std::max_element(input, input + input_len);
+
+  T sum = 0.0;
+  for (int32_t i = 0; i < input_len; i++) {
+    sum += exp(input[i] - m);
+  }
+
+  return m + log(sum);
+}
+
 template <typename T>
 void LogSoftmax(T *in, int32_t w, int32_t h) {
   for (int32_t i = 0; i != h; ++i) {
@@ -5,7 +5,6 @@
 #include "sherpa-onnx/csrc/melo-tts-lexicon.h"
 
 #include <fstream>
-#include <regex>  // NOLINT
 #include <sstream>
 #include <string>
 #include <strstream>
@@ -26,6 +25,7 @@
 #include "sherpa-onnx/csrc/onnx-utils.h"
 #include "sherpa-onnx/csrc/phrase-matcher.h"
 #include "sherpa-onnx/csrc/symbol-table.h"
+#include "sherpa-onnx/csrc/text-segmenter.h"
 #include "sherpa-onnx/csrc/text-utils.h"
 
 namespace sherpa_onnx {
@@ -67,23 +67,21 @@ class MeloTtsLexicon::Impl {
 
   std::vector<TokenIDs> ConvertTextToTokenIds(const std::string &_text) const {
     std::string text = ToLowerCase(_text);
-    // see
-    // https://github.com/Plachtaa/VITS-fast-fine-tuning/blob/main/text/mandarin.py#L244
-    std::regex punct_re{"：|、|；"};
-    std::string s = std::regex_replace(text, punct_re, ",");
-
-    std::regex punct_re2("。");
-    s = std::regex_replace(s, punct_re2, ".");
-
-    std::regex punct_re3("？");
-    s = std::regex_replace(s, punct_re3, "?");
-
-    std::regex punct_re4("！");
-    s = std::regex_replace(s, punct_re4, "!");
-
     std::vector<std::string> words = SplitUtf8(text);
 
     if (debug_) {
+      // The replaced text is used only for debugging. See
+      // https://github.com/Plachtaa/VITS-fast-fine-tuning/blob/main/text/mandarin.py#L244
+      static const PunctuationMap kPunctuationMap({
+          {"：", ","},
+          {"、", ","},
+          {"；", ","},
+          {"。", "."},
+          {"？", "?"},
+          {"！", "!"},
+      });
+      std::string s = kPunctuationMap.Apply(text);
+
 #if __OHOS__
       SHERPA_ONNX_LOGE("input text:\n%{public}s", text.c_str());
       SHERPA_ONNX_LOGE("after replacing punctuations:\n%{public}s", s.c_str());
@@ -11,6 +11,8 @@
 
 namespace sherpa_onnx {
 
+class OfflineStream;
+
 struct OfflineCtcDecoderResult {
   /// The decoded token IDs
   std::vector<int64_t> tokens;
@@ -38,11 +40,15 @@ class OfflineCtcDecoder {
    *                  lob_probs.
    * @param log_probs_length A 1-D tensor of shape (N,) containing number
    *                         of valid frames in log_probs before padding.
+   * @param ss Optional. If not nullptr, it contains the `N` streams.
+   *           It is used to get the hotwords of each stream.
+   * @param n  Number of streams in ss.
    *
    * @return Return a vector of size `N` containing the decoded results.
    */
   virtual std::vector<OfflineCtcDecoderResult> Decode(
-      Ort::Value log_probs, Ort::Value log_probs_length) = 0;
+      Ort::Value log_probs, Ort::Value log_probs_length,
+      OfflineStream **ss = nullptr, int32_t n = 0) = 0;
 };
 
 }  // namespace sherpa_onnx
@@ -17,7 +17,8 @@ std::string OfflineCtcFstDecoderConfig::ToString() const {
 
   os << "OfflineCtcFstDecoderConfig(";
   os << "graph=\"" << graph << "\", ";
-  os << "max_active=" << max_active << ")";
+  os << "max_active=" << max_active << ", ";
+  os << "num_workers=" << num_workers << ")";
 
   return os.str();
 }
@@ -26,10 +27,20 @@ void OfflineCtcFstDecoderConfig::Register(ParseOptions *po) {
   std::string prefix = "ctc";
   ParseOptions p(prefix, po);
 
-  p.Register("graph", &graph, "Path to H.fst, HL.fst, or HLG.fst");
+  p.Register("graph", &graph,
+             "Path to H.fst, HL.fst, or HLG.fst. Both StdVectorFst and "
+             "StdConstFst are supported. An aligned StdConstFst is "
+             "memory-mapped instead of being read into memory. You can "
+             "convert a graph with: "
+             "fstconvert --fst_type=const --fst_align HLG.fst HLG.const.fst");
 
   p.Register("max-active", &max_active,
              "Decoder max active states.  Larger->slower; more accurate");
+
+  p.Register("num-workers", &num_workers,
+             "Number of utterances of a batch to decode with the graph in "
+             "parallel. Each of them uses its own decoder and all of them "
+             "share the graph.");
 }
 
 bool OfflineCtcFstDecoderConfig::Validate() const {
@@ -37,6 +48,12 @@ bool OfflineCtcFstDecoderConfig::Validate() const {
     SHERPA_ONNX_LOGE("graph: '%s' does not exist", graph.c_str());
     return false;
   }
+
+  if (num_workers < 1) {
+    SHERPA_ONNX_LOGE("--ctc.num-workers should be positive. Given: %d",
+                     num_workers);
+    return false;
+  }
   return true;
 }
 
@@ -16,10 +16,14 @@ struct OfflineCtcFstDecoderConfig {
   std::string graph;
   int32_t max_active = 3000;
 
+  // Number of utterances of a batch to decode with the graph in parallel
+  int32_t num_workers = 1;
+
   OfflineCtcFstDecoderConfig() = default;
 
-  OfflineCtcFstDecoderConfig(const std::string &graph, int32_t max_active)
-      : graph(graph), max_active(max_active) {}
+  OfflineCtcFstDecoderConfig(const std::string &graph, int32_t max_active,
+                             int32_t num_workers = 1)
+      : graph(graph), max_active(max_active), num_workers(num_workers) {}
 
   std::string ToString() const;
 
@@ -6,6 +6,7 @@
 
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "fst/fstlib.h"
 #include "kaldi-decoder/csrc/decodable-ctc.h"
@@ -13,6 +14,7 @@
 #include "kaldi-decoder/csrc/faster-decoder.h"
 #include "sherpa-onnx/csrc/fst-utils.h"
 #include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/run-in-order.h"
 
 namespace sherpa_onnx {
 
@@ -83,7 +85,8 @@ OfflineCtcFstDecoder::OfflineCtcFstDecoder(
     : config_(config), fst_(ReadGraph(config_.graph)) {}
 
 std::vector<OfflineCtcDecoderResult> OfflineCtcFstDecoder::Decode(
-    Ort::Value log_probs, Ort::Value log_probs_length) {
+    Ort::Value log_probs, Ort::Value log_probs_length,
+    OfflineStream ** /*ss = nullptr*/, int32_t /*n = 0*/) {
   std::vector<int64_t> shape = log_probs.GetTensorTypeAndShapeInfo().GetShape();
 
   assert(static_cast<int32_t>(shape.size()) == 3);
@@ -99,19 +102,27 @@ std::vector<OfflineCtcDecoderResult> OfflineCtcFstDecoder::Decode(
 
   kaldi_decoder::FasterDecoderOptions opts;
   opts.max_active = config_.max_active;
-  kaldi_decoder::FasterDecoder faster_decoder(*fst_, opts);
 
   const float *start = log_probs.GetTensorData<float>();
+  const int64_t *lengths = log_probs_length.GetTensorData<int64_t>();
 
-  std::vector<OfflineCtcDecoderResult> ans;
-  ans.reserve(batch_size);
+  std::vector<OfflineCtcDecoderResult> ans(batch_size);
 
-  for (int32_t i = 0; i != batch_size; ++i) {
-    const float *p = start + i * T * vocab_size;
-    int32_t num_frames = log_probs_length.GetTensorData<int64_t>()[i];
-    auto r = DecodeOne(&faster_decoder, p, num_frames, vocab_size);
-    ans.push_back(std::move(r));
-  }
+  // fst_ is read-only and shared by all workers. FasterDecoder has
+  // per-utterance states, so each utterance uses its own decoder.
+  auto process = [&](int32_t i) -> OfflineCtcDecoderResult {
+    kaldi_decoder::FasterDecoder faster_decoder(*fst_, opts);
+
+    const float *p = start + static_cast<int64_t>(i) * T * vocab_size;
+    return DecodeOne(&faster_decoder, p, lengths[i], vocab_size);
+  };
+
+  auto save = [&ans](int32_t i, OfflineCtcDecoderResult r) -> bool {
+    ans[i] = std::move(r);
+    return true;
+  };
+
+  RunInOrder(batch_size, config_.num_workers, process, save);
 
   return ans;
 }
@@ -20,7 +20,8 @@ class OfflineCtcFstDecoder : public OfflineCtcDecoder {
   explicit OfflineCtcFstDecoder(const OfflineCtcFstDecoderConfig &config);
 
   std::vector<OfflineCtcDecoderResult> Decode(
-      Ort::Value log_probs, Ort::Value log_probs_length) override;
+      Ort::Value log_probs, Ort::Value log_probs_length,
+      OfflineStream **ss = nullptr, int32_t n = 0) override;
 
  private:
   OfflineCtcFstDecoderConfig config_;
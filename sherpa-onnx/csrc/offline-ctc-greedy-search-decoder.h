@@ -17,7 +17,8 @@ class OfflineCtcGreedySearchDecoder : public OfflineCtcDecoder {
       : blank_id_(blank_id) {}
 
   std::vector<OfflineCtcDecoderResult> Decode(
-      Ort::Value log_probs, Ort::Value log_probs_length) override;
+      Ort::Value log_probs, Ort::Value log_probs_length,
+      OfflineStream **ss = nullptr, int32_t n = 0) override;
 
  private:
   int32_t blank_id_;
@@ -0,0 +1,71 @@
+// sherpa-onnx/csrc/offline-ctc-prefix-beam-search-decoder.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/offline-ctc-prefix-beam-search-decoder.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "sherpa-onnx/csrc/ctc-prefix-beam-search.h"
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/offline-stream.h"
+
+namespace sherpa_onnx {
+
+std::vector<OfflineCtcDecoderResult> OfflineCtcPrefixBeamSearchDecoder::Decode(
+    Ort::Value log_probs, Ort::Value log_probs_length,
+    OfflineStream **ss /*= nullptr*/, int32_t n /*= 0*/) {
+  std::vector<int64_t> shape = log_probs.GetTensorTypeAndShapeInfo().GetShape();
+  int32_t batch_size = static_cast<int32_t>(shape[0]);
+  int32_t num_frames = static_cast<int32_t>(shape[1]);
+  int32_t vocab_size = static_cast<int32_t>(shape[2]);
+
+  if (ss != nullptr && n != batch_size) {
+    SHERPA_ONNX_LOGE("Size mismatch! log_probs.size(0) %d, n: %d", batch_size,
+                     n);
+    SHERPA_ONNX_EXIT(-1);
+  }
+
+  const int64_t *p_log_probs_length = log_probs_length.GetTensorData<int64_t>();
+
+  std::vector<Hypotheses> hyps;
+  hyps.reserve(batch_size);
+
+  for (int32_t b = 0; b != batch_size; ++b) {
+    const float *p_log_probs =
+        log_probs.GetTensorData<float>() + b * num_frames * vocab_size;
+
+    ContextGraphPtr context_graph;
+    if (ss != nullptr) {
+      context_graph = ss[b]->GetContextGraph();
+    }
+
+    CtcPrefixBeamSearch search(blank_id_, max_active_paths_,
+                               blank_skip_threshold_, context_graph);
+    search.Decode(p_log_probs, static_cast<int32_t>(p_log_probs_length[b]),
+                  vocab_size);
+
+    hyps.emplace_back(search.GetHypotheses(true));
+  }
+
+  if (lm_) {
+    // Rescore the prefixes of all utterances in one batch
+    lm_->ComputeLMScore(lm_scale_, 0, &hyps);
+  }
+
+  std::vector<OfflineCtcDecoderResult> ans(batch_size);
+  for (int32_t b = 0; b != batch_size; ++b) {
+    // Unlike transducers, the length of a CTC hypothesis can be 0, so we
+    // don't use length normalization here
+    Hypothesis hyp = hyps[b].GetMostProbable(false);
+
+    ans[b].tokens = std::move(hyp.ys);
+    ans[b].timestamps = std::move(hyp.timestamps);
+  }
+
+  return ans;
+}
+
+}  // namespace sherpa_onnx
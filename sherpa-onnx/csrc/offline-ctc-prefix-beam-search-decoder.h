@@ -0,0 +1,48 @@
+// sherpa-onnx/csrc/offline-ctc-prefix-beam-search-decoder.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_OFFLINE_CTC_PREFIX_BEAM_SEARCH_DECODER_H_
+#define SHERPA_ONNX_CSRC_OFFLINE_CTC_PREFIX_BEAM_SEARCH_DECODER_H_
+
+#include <vector>
+
+#include "sherpa-onnx/csrc/offline-ctc-decoder.h"
+#include "sherpa-onnx/csrc/offline-lm.h"
+
+namespace sherpa_onnx {
+
+class OfflineCtcPrefixBeamSearchDecoder : public OfflineCtcDecoder {
+ public:
+  /**
+   * @param lm Optional. Not owned. If not nullptr, the final prefixes of
+   *           all utterances in a batch are rescored with it.
+   *
+   * See CtcPrefixBeamSearch for the other arguments.
+   */
+  OfflineCtcPrefixBeamSearchDecoder(int32_t blank_id,
+                                    int32_t max_active_paths,
+                                    float blank_skip_threshold,
+                                    OfflineLM *lm = nullptr,
+                                    float lm_scale = 0)
+      : blank_id_(blank_id),
+        max_active_paths_(max_active_paths),
+        blank_skip_threshold_(blank_skip_threshold),
+        lm_(lm),
+        lm_scale_(lm_scale) {}
+
+  std::vector<OfflineCtcDecoderResult> Decode(
+      Ort::Value log_probs, Ort::Value log_probs_length,
+      OfflineStream **ss = nullptr, int32_t n = 0) override;
+
+ private:
+  int32_t blank_id_;
+  int32_t max_active_paths_;
+  float blank_skip_threshold_;
+  OfflineLM *lm_;  // not owned
+  float lm_scale_;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_OFFLINE_CTC_PREFIX_BEAM_SEARCH_DECODER_H_
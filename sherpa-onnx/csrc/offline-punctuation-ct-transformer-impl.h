@@ -6,6 +6,8 @@
 
 #include <math.h>
 
+#include <algorithm>
+#include <array>
 #include <memory>
 #include <string>
 #include <utility>
@@ -42,7 +44,85 @@ class OfflinePunctuationCtTransformerImpl : public OfflinePunctuationImpl {
       return {};
     }
 
-    std::vector<std::string> tokens = SplitUtf8(text);
+    OfflinePunctuationStream s;
+    auto ss = &s;
+    return AddPunctuation(&ss, &text, 1)[0];
+  }
+
+  std::vector<std::string> AddPunctuation(OfflinePunctuationStream **ss,
+                                          const std::string *texts,
+                                          int32_t n) const override {
+    std::vector<std::vector<std::string>> tokens(n);
+    std::vector<SegmentState> states(n);
+
+    for (int32_t k = 0; k != n; ++k) {
+      tokens[k] = SplitUtf8(texts[k]);
+      states[k] = Reset(ToTokenIds(tokens[k]), ss[k]);
+    }
+
+    std::vector<int32_t> active;
+    active.reserve(n);
+
+    // Each iteration runs the next segment of all unfinished streams as a
+    // batch. Usually all but the last segment of a stream are restored from
+    // the checkpoints, so there is only one iteration.
+    while (true) {
+      active.clear();
+      for (int32_t k = 0; k != n; ++k) {
+        if (states[k].i < states[k].num_segments) {
+          active.push_back(k);
+        }
+      }
+
+      if (active.empty()) {
+        break;
+      }
+
+      auto punctuations = RunSegments(ss, states.data(), active);
+
+      for (int32_t j = 0; j != static_cast<int32_t>(active.size()); ++j) {
+        int32_t k = active[j];
+        ProcessSegment(std::move(punctuations[j]), ss[k], &states[k]);
+      }
+    }
+
+    std::vector<std::string> ans(n);
+    for (int32_t k = 0; k != n; ++k) {
+      if (texts[k].empty()) {
+        continue;
+      }
+
+      std::vector<int32_t> punctuations = ss[k]->punctuations;
+      punctuations.insert(punctuations.end(), states[k].tail.begin(),
+                          states[k].tail.end());
+
+      ans[k] = ToText(texts[k], std::move(tokens[k]), punctuations);
+    }
+
+    return ans;
+  }
+
+ private:
+  // State of the loop over segments of the token IDs of a stream.
+  struct SegmentState {
+    int32_t num_segments = 0;
+
+    // Index of the next segment to process
+    int32_t i = 0;
+
+    // Start of the window for the next segment. -1 means i * kSegmentSize.
+    int32_t last = -1;
+
+    // Punctuations of the last segments. Unlike stream->punctuations, they
+    // depend on the tokens after the last segment and are not kept.
+    std::vector<int32_t> tail;
+  };
+
+  static constexpr int32_t kSegmentSize = 20;
+  static constexpr int32_t kMaxLen = 200;
+
+  std::vector<int32_t> ToTokenIds(
+      const std::vector<std::string> &tokens) const {
     std::vector<int32_t> token_ids;
     token_ids.reserve(tokens.size());
 
@@ -57,98 +137,191 @@ class OfflinePunctuationCtTransformerImpl : public OfflinePunctuationImpl {
       }
     }
 
-    auto memory_info =
-        Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
+    return token_ids;
+  }
 
-    int32_t segment_size = 20;
-    int32_t max_len = 200;
-    int32_t num_segments =
-        ceil((static_cast<float>(token_ids.size()) + segment_size - 1) /
-             segment_size);
+  // Replace the token IDs of the stream and drop the checkpoints that
+  // depend on the tokens that have changed.
+  static SegmentState Reset(std::vector<int32_t> token_ids,
+                            OfflinePunctuationStream *s) {
+    int32_t num_tokens = static_cast<int32_t>(token_ids.size());
+
+    auto mismatch = std::mismatch(token_ids.begin(), token_ids.end(),
+                                  s->token_ids.begin(), s->token_ids.end());
+    int32_t num_common =
+        static_cast<int32_t>(std::distance(token_ids.begin(), mismatch.first));
+
+    // The i-th segment depends only on token_ids[0:(i+1)*kSegmentSize]
+    int32_t num_valid = std::min<int32_t>(s->checkpoints.size(),
+                                          num_common / kSegmentSize);
+    s->checkpoints.resize(num_valid);
+    s->punctuations.resize(num_valid ? s->checkpoints.back() : 0);
+    s->token_ids = std::move(token_ids);
+
+    SegmentState state;
+    if (num_tokens == 0) {
+      return state;
+    }
 
-    std::vector<int32_t> punctuations;
-    int32_t last = -1;
-    for (int32_t i = 0; i != num_segments; ++i) {
-      int32_t this_start = i * segment_size;         // included
-      int32_t this_end = this_start + segment_size;  // not included
-      if (this_end > static_cast<int32_t>(token_ids.size())) {
-        this_end = token_ids.size();
-      }
+    state.num_segments =
+        ceil((static_cast<float>(num_tokens) + kSegmentSize - 1) /
+             kSegmentSize);
+    state.i = num_valid;
+    state.last = num_valid ? s->checkpoints.back() : -1;
 
-      if (last != -1) {
-        this_start = last;
-      }
-      // token_ids[this_start:this_end] is sent to the model
+    return state;
+  }
+
+  // Return the window [start, end) of the token IDs for the next segment
+  static std::pair<int32_t, int32_t> GetWindow(
+      const OfflinePunctuationStream &s, const SegmentState &state) {
+    int32_t this_start = state.i * kSegmentSize;  // included
+    int32_t this_end = this_start + kSegmentSize;  // not included
+    if (this_end > static_cast<int32_t>(s.token_ids.size())) {
+      this_end = s.token_ids.size();
+    }
+
+    if (state.last != -1) {
+      this_start = state.last;
+    }
+
+    return {this_start, this_end};
+  }
 
-      std::array<int64_t, 2> x_shape = {1, this_end - this_start};
-      Ort::Value x =
-          Ort::Value::CreateTensor(memory_info, token_ids.data() + this_start,
-                                   x_shape[1], x_shape.data(), x_shape.size());
+  // Run the model on the next segment of each stream in active and return
+  // the predicted punctuation IDs of each window.
+  std::vector<std::vector<int32_t>> RunSegments(
+      OfflinePunctuationStream **ss, const SegmentState *states,
+      const std::vector<int32_t> &active) const {
+    const auto &meta_data = model_.GetModelMetadata();
+
+    int32_t batch_size = static_cast<int32_t>(active.size());
 
-      int64_t len_shape = 1;
-      int32_t len = x_shape[1];
-      Ort::Value x_len =
-          Ort::Value::CreateTensor(memory_info, &len, 1, &len_shape, 1);
+    std::vector<int32_t> lens(batch_size);
+    int32_t max_len = 0;
+    for (int32_t j = 0; j != batch_size; ++j) {
+      auto w = GetWindow(*ss[active[j]], states[active[j]]);
+      lens[j] = w.second - w.first;
+      max_len = std::max(max_len, lens[j]);
+    }
+
+    // Windows shorter than max_len are padded. The padded positions are
+    // masked out inside the model using lens.
+    std::vector<int32_t> x(batch_size * max_len, 0);
+    for (int32_t j = 0; j != batch_size; ++j) {
+      auto w = GetWindow(*ss[active[j]], states[active[j]]);
+      const auto &token_ids = ss[active[j]]->token_ids;
+      std::copy(token_ids.begin() + w.first, token_ids.begin() + w.second,
+                x.begin() + j * max_len);
+    }
+
+    auto memory_info =
+        Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
 
-      Ort::Value out = model_.Forward(std::move(x), std::move(x_len));
+    std::array<int64_t, 2> x_shape = {batch_size, max_len};
+    Ort::Value x_tensor = Ort::Value::CreateTensor(
+        memory_info, x.data(), x.size(), x_shape.data(), x_shape.size());
 
-      // [N, T, num_punctuations]
-      std::vector<int64_t> out_shape =
-          out.GetTensorTypeAndShapeInfo().GetShape();
+    int64_t len_shape = batch_size;
+    Ort::Value x_len =
+        Ort::Value::CreateTensor(memory_info, lens.data(), lens.size(),
+                                 &len_shape, 1);
 
-      assert(out_shape[0] == 1);
-      assert(out_shape[1] == len);
-      assert(out_shape[2] == meta_data.num_punctuations);
+    Ort::Value out = model_.Forward(std::move(x_tensor), std::move(x_len));
 
-      std::vector<int32_t> this_punctuations;
-      this_punctuations.reserve(len);
+    // [N, T, num_punctuations]
+    std::vector<int64_t> out_shape = out.GetTensorTypeAndShapeInfo().GetShape();
 
-      const float *p = out.GetTensorData<float>();
-      for (int32_t k = 0; k != len; ++k, p += meta_data.num_punctuations) {
+    assert(out_shape[0] == batch_size);
+    assert(out_shape[1] == max_len);
+    assert(out_shape[2] == meta_data.num_punctuations);
+
+    std::vector<std::vector<int32_t>> ans(batch_size);
+
+    const float *start = out.GetTensorData<float>();
+    for (int32_t j = 0; j != batch_size; ++j) {
+      ans[j].reserve(lens[j]);
+
+      const float *p = start + j * max_len * meta_data.num_punctuations;
+      for (int32_t k = 0; k != lens[j]; ++k, p += meta_data.num_punctuations) {
         auto index = static_cast<int32_t>(std::distance(
             p, std::max_element(p, p + meta_data.num_punctuations)));
-        this_punctuations.push_back(index);
-      }  // for (int32_t k = 0; k != len; ++k, p += meta_data.num_punctuations)
+        ans[j].push_back(index);
+      }
+    }
 
-      int32_t dot_index = -1;
-      int32_t comma_index = -1;
+    return ans;
+  }
 
-      for (int32_t m = static_cast<int32_t>(this_punctuations.size()) - 2;
-           m >= 1; --m) {
-        int32_t punct_id = this_punctuations[m];
+  // this_punctuations are the predicted punctuation IDs of the window of
+  // the next segment. Decide the punctuations up to the last end of
+  // sentence in it and advance to the next segment.
+  void ProcessSegment(std::vector<int32_t> this_punctuations,
+                      OfflinePunctuationStream *s,
+                      SegmentState *state) const {
+    const auto &meta_data = model_.GetModelMetadata();
 
-        if (punct_id == meta_data.dot_id || punct_id == meta_data.quest_id) {
-          dot_index = m;
-          break;
-        }
+    auto window = GetWindow(*s, *state);
+    int32_t this_start = window.first;
+    int32_t len = window.second - window.first;
 
-        if (comma_index == -1 && punct_id == meta_data.comma_id) {
-          comma_index = m;
-        }
-      }  // for (int32_t k = this_punctuations.size() - 1; k >= 1; --k)
+    int32_t dot_index = -1;
+    int32_t comma_index = -1;
 
-      if (dot_index == -1 && len >= max_len && comma_index != -1) {
-        dot_index = comma_index;
-        this_punctuations[dot_index] = meta_data.dot_id;
+    for (int32_t m = static_cast<int32_t>(this_punctuations.size()) - 2;
+         m >= 1; --m) {
+      int32_t punct_id = this_punctuations[m];
+
+      if (punct_id == meta_data.dot_id || punct_id == meta_data.quest_id) {
+        dot_index = m;
+        break;
       }
 
-      if (dot_index == -1) {
-        if (last == -1) {
-          last = this_start;
-        }
+      if (comma_index == -1 && punct_id == meta_data.comma_id) {
+        comma_index = m;
+      }
+    }  // for (int32_t k = this_punctuations.size() - 1; k >= 1; --k)
 
-        if (i == num_segments - 1) {
-          dot_index = static_cast<int32_t>(this_punctuations.size()) - 1;
-        }
-      } else {
-        last = this_start + dot_index + 1;
+    if (dot_index == -1 && len >= kMaxLen && comma_index != -1) {
+      dot_index = comma_index;
+      this_punctuations[dot_index] = meta_data.dot_id;
+    }
+
+    if (dot_index == -1) {
+      if (state->last == -1) {
+        state->last = this_start;
       }
 
-      if (dot_index != -1) {
-        punctuations.insert(punctuations.end(), this_punctuations.begin(),
-                            this_punctuations.begin() + (dot_index + 1));
+      if (state->i == state->num_segments - 1) {
+        dot_index = static_cast<int32_t>(this_punctuations.size()) - 1;
       }
-    }  // for (int32_t i = 0; i != num_segments; ++i)
+    } else {
+      state->last = this_start + dot_index + 1;
+    }
+
+    // If the window is not truncated by the end of the text, the result
+    // does not change when more text is appended, so it is kept in the
+    // stream. Only the last few segments can be truncated.
+    bool is_complete = (window.second == (state->i + 1) * kSegmentSize) &&
+                       state->tail.empty();
+
+    auto &punctuations = is_complete ? s->punctuations : state->tail;
+
+    if (dot_index != -1) {
+      punctuations.insert(punctuations.end(), this_punctuations.begin(),
+                          this_punctuations.begin() + (dot_index + 1));
+    }
+
+    if (is_complete) {
+      s->checkpoints.push_back(s->punctuations.size());
+    }
+
+    state->i += 1;
+  }
+
+  std::string ToText(const std::string &text, std::vector<std::string> tokens,
+                     const std::vector<int32_t> &punctuations) const {
+    const auto &meta_data = model_.GetModelMetadata();
 
     if (punctuations.empty()) {
       return text + meta_data.id2punct[meta_data.dot_id];
@@ -187,7 +360,6 @@ class OfflinePunctuationCtTransformerImpl : public OfflinePunctuationImpl {
     return ans;
   }
 
- private:
   OfflinePunctuationConfig config_;
   OfflineCtTransformerModel model_;
 };
@@ -29,6 +29,10 @@ class OfflinePunctuationImpl {
 #endif
 
   virtual std::string AddPunctuation(const std::string &text) const = 0;
+
+  virtual std::vector<std::string> AddPunctuation(
+      OfflinePunctuationStream **ss, const std::string *texts,
+      int32_t n) const = 0;
 };
 
 }  // namespace sherpa_onnx
@@ -4,6 +4,10 @@
 
 #include "sherpa-onnx/csrc/offline-punctuation.h"
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #if __ANDROID_API__ >= 9
 #include "android/asset_manager.h"
 #include "android/asset_manager_jni.h"
@@ -50,4 +54,20 @@ std::string OfflinePunctuation::AddPunctuation(const std::string &text) const {
   return impl_->AddPunctuation(text);
 }
 
+std::unique_ptr<OfflinePunctuationStream> OfflinePunctuation::CreateStream()
+    const {
+  return std::make_unique<OfflinePunctuationStream>();
+}
+
+std::string OfflinePunctuation::AddPunctuation(OfflinePunctuationStream *s,
+                                               const std::string &text) const {
+  return impl_->AddPunctuation(&s, &text, 1)[0];
+}
+
+std::vector<std::string> OfflinePunctuation::AddPunctuation(
+    OfflinePunctuationStream **ss, const std::string *texts,
+    int32_t n) const {
+  return impl_->AddPunctuation(ss, texts, n);
+}
+
 }  // namespace sherpa_onnx
@@ -32,6 +32,24 @@ struct OfflinePunctuationConfig {
   std::string ToString() const;
 };
 
+// It is used to add punctuation to a text that grows over time, e.g., the
+// partial result of a streaming recognizer. The model is run again only on
+// the part of the text whose punctuation is not decided yet.
+//
+// Please use OfflinePunctuation::CreateStream() to create it.
+struct OfflinePunctuationStream {
+  // Token IDs of the text from the last call
+  std::vector<int32_t> token_ids;
+
+  // Decided punctuation IDs of token_ids[0:punctuations.size()]
+  std::vector<int32_t> punctuations;
+
+  // checkpoints[i] is punctuations.size() after processing the i-th
+  // segment of the text. A segment is processed only once as long as the
+  // tokens it depends on are not changed.
+  std::vector<int32_t> checkpoints;
+};
+
 class OfflinePunctuationImpl;
 
 class OfflinePunctuation {
@@ -48,6 +66,22 @@ class OfflinePunctuation {
   // Add punctuation to the input text and return it.
   std::string AddPunctuation(const std::string &text) const;
 
+  std::unique_ptr<OfflinePunctuationStream> CreateStream() const;
+
+  // text is the whole text so far of the given stream. It usually extends
+  // the text from the previous call, though it can also differ from it,
+  // e.g., when the last few words of a partial result are revised.
+  //
+  // The return value is the same as AddPunctuation(text).
+  std::string AddPunctuation(OfflinePunctuationStream *s,
+                             const std::string &text) const;
+
+  // Process n streams at the same time, where texts[i] is for ss[i].
+  // The unfinished parts of all streams are run in a single batch.
+  std::vector<std::string> AddPunctuation(OfflinePunctuationStream **ss,
+                                          const std::string *texts,
+                                          int32_t n) const;
+
  private:
   std::unique_ptr<OfflinePunctuationImpl> impl_;
 };
@@ -5,20 +5,27 @@
 #ifndef SHERPA_ONNX_CSRC_OFFLINE_RECOGNIZER_CTC_IMPL_H_
 #define SHERPA_ONNX_CSRC_OFFLINE_RECOGNIZER_CTC_IMPL_H_
 
+#include <fstream>
 #include <ios>
 #include <memory>
+#include <regex>  // NOLINT
 #include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "sherpa-onnx/csrc/file-utils.h"
 #include "sherpa-onnx/csrc/offline-ctc-decoder.h"
 #include "sherpa-onnx/csrc/offline-ctc-fst-decoder.h"
 #include "sherpa-onnx/csrc/offline-ctc-greedy-search-decoder.h"
 #include "sherpa-onnx/csrc/offline-ctc-model.h"
+#include "sherpa-onnx/csrc/offline-ctc-prefix-beam-search-decoder.h"
+#include "sherpa-onnx/csrc/offline-lm.h"
 #include "sherpa-onnx/csrc/offline-recognizer-impl.h"
 #include "sherpa-onnx/csrc/pad-sequence.h"
 #include "sherpa-onnx/csrc/symbol-table.h"
+#include "sherpa-onnx/csrc/utils.h"
+#include "ssentencepiece/csrc/ssentencepiece.h"
 
 namespace sherpa_onnx {
 
@@ -77,6 +84,22 @@ class OfflineRecognizerCtcImpl : public OfflineRecognizerImpl {
         config_(config),
         symbol_table_(config_.model_config.tokens),
         model_(OfflineCtcModel::Create(config_.model_config)) {
+    if (config_.decoding_method == "modified_beam_search" &&
+        config_.ctc_fst_decoder_config.graph.empty()) {
+      if (!config_.lm_config.model.empty()) {
+        lm_ = OfflineLM::Create(config_.lm_config);
+      }
+
+      if (!config_.model_config.bpe_vocab.empty()) {
+        bpe_encoder_ = std::make_unique<ssentencepiece::Ssentencepiece>(
+            config_.model_config.bpe_vocab);
+      }
+
+      if (!config_.hotwords_file.empty()) {
+        InitHotwords();
+      }
+    }
+
     Init();
   }
 
@@ -86,6 +109,23 @@ class OfflineRecognizerCtcImpl : public OfflineRecognizerImpl {
         config_(config),
         symbol_table_(mgr, config_.model_config.tokens),
         model_(OfflineCtcModel::Create(mgr, config_.model_config)) {
+    if (config_.decoding_method == "modified_beam_search" &&
+        config_.ctc_fst_decoder_config.graph.empty()) {
+      if (!config_.lm_config.model.empty()) {
+        lm_ = OfflineLM::Create(mgr, config_.lm_config);
+      }
+
+      if (!config_.model_config.bpe_vocab.empty()) {
+        auto buf = ReadFile(mgr, config_.model_config.bpe_vocab);
+        std::istringstream iss(std::string(buf.begin(), buf.end()));
+        bpe_encoder_ = std::make_unique<ssentencepiece::Ssentencepiece>(iss);
+      }
+
+      if (!config_.hotwords_file.empty()) {
+        InitHotwords(mgr);
+      }
+    }
+
     Init();
   }
 
@@ -152,36 +192,52 @@ class OfflineRecognizerCtcImpl : public OfflineRecognizerImpl {
       decoder_ = std::make_unique<OfflineCtcFstDecoder>(
           config_.ctc_fst_decoder_config);
     } else if (config_.decoding_method == "greedy_search") {
-      if (!symbol_table_.Contains("<blk>") &&
-          !symbol_table_.Contains("<eps>") &&
-          !symbol_table_.Contains("<blank>")) {
-        SHERPA_ONNX_LOGE(
-            "We expect that tokens.txt contains "
-            "the symbol <blk> or <eps> or <blank> and its ID.");
-        exit(-1);
-      }
-
-      int32_t blank_id = 0;
-      if (symbol_table_.Contains("<blk>")) {
-        blank_id = symbol_table_["<blk>"];
-      } else if (symbol_table_.Contains("<eps>")) {
-        // for tdnn models of the yesno recipe from icefall
-        blank_id = symbol_table_["<eps>"];
-      } else if (symbol_table_.Contains("<blank>")) {
-        // for Wenet CTC models
-        blank_id = symbol_table_["<blank>"];
-      }
-
-      decoder_ = std::make_unique<OfflineCtcGreedySearchDecoder>(blank_id);
+      decoder_ = std::make_unique<OfflineCtcGreedySearchDecoder>(GetBlankId());
+    } else if (config_.decoding_method == "modified_beam_search") {
+      decoder_ = std::make_unique<OfflineCtcPrefixBeamSearchDecoder>(
+          GetBlankId(), config_.max_active_paths, config_.blank_skip_threshold,
+          lm_.get(), config_.lm_config.scale);
     } else {
-      SHERPA_ONNX_LOGE("Only greedy_search is supported at present. Given %s",
-                       config_.decoding_method.c_str());
+      SHERPA_ONNX_LOGE(
+          "Only greedy_search and modified_beam_search are supported at "
+          "present. Given %s",
+          config_.decoding_method.c_str());
       SHERPA_ONNX_EXIT(-1);
     }
   }
 
+  std::unique_ptr<OfflineStream> CreateStream(
+      const std::string &hotwords) const override {
+    if (config_.decoding_method != "modified_beam_search") {
+      SHERPA_ONNX_LOGE(
+          "Hotwords are used only with modified_beam_search. Ignore them.");
+      return CreateStream();
+    }
+
+    auto hws = std::regex_replace(hotwords, std::regex("/"), "\n");
+    std::istringstream is(hws);
+    std::vector<std::vector<int32_t>> current;
+    std::vector<float> current_scores;
+    if (!EncodeHotwords(is, config_.model_config.modeling_unit, symbol_table_,
+                        bpe_encoder_.get(), &current, &current_scores)) {
+      SHERPA_ONNX_LOGE("Encode hotwords failed, skipping, hotwords are : '%s'",
+                       hotwords.c_str());
+    }
+
+    if (current.empty()) {
+      return CreateStream();
+    }
+
+    // The hotwords given by the config are shared by all streams and
+    // are not re-built here
+    auto context_graph = std::make_shared<ContextGraph>(
+        current, config_.hotwords_score, current_scores, hotwords_graph_);
+    return std::make_unique<OfflineStream>(config_.feat_config, context_graph);
+  }
+
   std::unique_ptr<OfflineStream> CreateStream() const override {
-    return std::make_unique<OfflineStream>(config_.feat_config);
+    return std::make_unique<OfflineStream>(config_.feat_config,
+                                           hotwords_graph_);
   }
 
   void DecodeStreams(OfflineStream **ss, int32_t n) const override {
@@ -238,7 +294,7 @@ class OfflineRecognizerCtcImpl : public OfflineRecognizerImpl {
                                -23.025850929940457f);
     auto t = model_->Forward(std::move(x), std::move(x_length));
 
-    auto results = decoder_->Decode(std::move(t[0]), std::move(t[1]));
+    auto results = decoder_->Decode(std::move(t[0]), std::move(t[1]), ss, n);
 
     int32_t frame_shift_ms = 10;
     for (int32_t i = 0; i != n; ++i) {
@@ -278,7 +334,7 @@ class OfflineRecognizerCtcImpl : public OfflineRecognizerImpl {
                                  x_length_shape.data(), x_length_shape.size());
 
     auto t = model_->Forward(std::move(x), std::move(x_length));
-    auto results = decoder_->Decode(std::move(t[0]), std::move(t[1]));
+    auto results = decoder_->Decode(std::move(t[0]), std::move(t[1]), &s, 1);
     int32_t frame_shift_ms = 10;
 
     auto r = Convert(results[0], symbol_table_, frame_shift_ms,
@@ -288,10 +344,83 @@ class OfflineRecognizerCtcImpl : public OfflineRecognizerImpl {
     s->SetResult(r);
   }
 
+ private:
+  int32_t GetBlankId() const {
+    if (!symbol_table_.Contains("<blk>") && !symbol_table_.Contains("<eps>") &&
+        !symbol_table_.Contains("<blank>")) {
+      SHERPA_ONNX_LOGE(
+          "We expect that tokens.txt contains "
+          "the symbol <blk> or <eps> or <blank> and its ID.");
+      exit(-1);
+    }
+
+    int32_t blank_id = 0;
+    if (symbol_table_.Contains("<blk>")) {
+      blank_id = symbol_table_["<blk>"];
+    } else if (symbol_table_.Contains("<eps>")) {
+      // for tdnn models of the yesno recipe from icefall
+      blank_id = symbol_table_["<eps>"];
+    } else if (symbol_table_.Contains("<blank>")) {
+      // for Wenet CTC models
+      blank_id = symbol_table_["<blank>"];
+    }
+
+    return blank_id;
+  }
+
+  void InitHotwords() {
+    // each line in hotwords_file contains space-separated words
+
+    std::ifstream is(config_.hotwords_file);
+    if (!is) {
+      SHERPA_ONNX_LOGE("Open hotwords file failed: '%s'",
+                       config_.hotwords_file.c_str());
+      exit(-1);
+    }
+
+    if (!EncodeHotwords(is, config_.model_config.modeling_unit, symbol_table_,
+                        bpe_encoder_.get(), &hotwords_, &boost_scores_)) {
+      SHERPA_ONNX_LOGE(
+          "Failed to encode some hotwords, skip them already, see logs above "
+          "for details.");
+    }
+    hotwords_graph_ = std::make_shared<ContextGraph>(
+        hotwords_, config_.hotwords_score, boost_scores_);
+  }
+
+  template <typename Manager>
+  void InitHotwords(Manager *mgr) {
+    // each line in hotwords_file contains space-separated words
+
+    auto buf = ReadFile(mgr, config_.hotwords_file);
+
+    std::istringstream is(std::string(buf.begin(), buf.end()));
+
+    if (!is) {
+      SHERPA_ONNX_LOGE("Open hotwords file failed: '%s'",
+                       config_.hotwords_file.c_str());
+      exit(-1);
+    }
+
+    if (!EncodeHotwords(is, config_.model_config.modeling_unit, symbol_table_,
+                        bpe_encoder_.get(), &hotwords_, &boost_scores_)) {
+      SHERPA_ONNX_LOGE(
+          "Failed to encode some hotwords, skip them already, see logs above "
+          "for details.");
+    }
+    hotwords_graph_ = std::make_shared<ContextGraph>(
+        hotwords_, config_.hotwords_score, boost_scores_);
+  }
+
  private:
   OfflineRecognizerConfig config_;
   SymbolTable symbol_table_;
+  std::vector<std::vector<int32_t>> hotwords_;
+  std::vector<float> boost_scores_;
+  ContextGraphPtr hotwords_graph_;
+  std::unique_ptr<ssentencepiece::Ssentencepiece> bpe_encoder_;
   std::unique_ptr<OfflineCtcModel> model_;
+  std::unique_ptr<OfflineLM> lm_;
   std::unique_ptr<OfflineCtcDecoder> decoder_;
 };
 
@@ -5,7 +5,6 @@
 #include "sherpa-onnx/csrc/offline-recognizer-impl.h"
 
 #include <string>
-#include <strstream>
 #include <utility>
 #include <vector>
 
@@ -19,8 +18,6 @@
 #include "rawfile/raw_file_manager.h"
 #endif
 
-#include "fst/extensions/far/far.h"
-#include "kaldifst/csrc/kaldi-fst-io.h"
 #include "onnxruntime_cxx_api.h"  // NOLINT
 #include "sherpa-onnx/csrc/file-utils.h"
 #include "sherpa-onnx/csrc/macros.h"
@@ -459,45 +456,10 @@ OfflineRecognizerImpl::OfflineRecognizerImpl(
     : config_(config) {
   // TODO(fangjun): Refactor this function
 
-  if (!config.rule_fsts.empty()) {
-    std::vector<std::string> files;
-    SplitStringToVector(config.rule_fsts, ",", false, &files);
-    itn_list_.reserve(files.size());
-    for (const auto &f : files) {
-      if (config.model_config.debug) {
-        SHERPA_ONNX_LOGE("rule fst: %s", f.c_str());
-      }
-      itn_list_.push_back(std::make_unique<kaldifst::TextNormalizer>(f));
-    }
-  }
-
-  if (!config.rule_fars.empty()) {
-    if (config.model_config.debug) {
-      SHERPA_ONNX_LOGE("Loading FST archives");
-    }
-    std::vector<std::string> files;
-    SplitStringToVector(config.rule_fars, ",", false, &files);
-
-    itn_list_.reserve(files.size() + itn_list_.size());
-
-    for (const auto &f : files) {
-      if (config.model_config.debug) {
-        SHERPA_ONNX_LOGE("rule far: %s", f.c_str());
-      }
-      std::unique_ptr<fst::FarReader<fst::StdArc>> reader(
-          fst::FarReader<fst::StdArc>::Open(f));
-      for (; !reader->Done(); reader->Next()) {
-        std::unique_ptr<fst::StdConstFst> r(
-            fst::CastOrConvertToConstFst(reader->GetFst()->Copy()));
-
-        itn_list_.push_back(
-            std::make_unique<kaldifst::TextNormalizer>(std::move(r)));
-      }
-    }
-
-    if (config.model_config.debug) {
-      SHERPA_ONNX_LOGE("FST archives loaded!");
-    }
+  if (!config.rule_fsts.empty() || !config.rule_fars.empty()) {
+    itn_ = std::make_unique<InverseTextNormalizer>(
+        config.rule_fsts, config.rule_fars, config.compose_rule_fsts,
+        config.model_config.debug);
   }
 
   if (!config.hr.lexicon.empty() && !config.hr.rule_fsts.empty()) {
@@ -511,48 +473,12 @@ template <typename Manager>
 OfflineRecognizerImpl::OfflineRecognizerImpl(
     Manager *mgr, const OfflineRecognizerConfig &config)
     : config_(config) {
-  if (!config.rule_fsts.empty()) {
-    std::vector<std::string> files;
-    SplitStringToVector(config.rule_fsts, ",", false, &files);
-    itn_list_.reserve(files.size());
-    for (const auto &f : files) {
-      if (config.model_config.debug) {
-        SHERPA_ONNX_LOGE("rule fst: %s", f.c_str());
-      }
-      auto buf = ReadFile(mgr, f);
-      std::istrstream is(buf.data(), buf.size());
-      itn_list_.push_back(std::make_unique<kaldifst::TextNormalizer>(is));
-    }
+  if (!config.rule_fsts.empty() || !config.rule_fars.empty()) {
+    itn_ = std::make_unique<InverseTextNormalizer>(
+        mgr, config.rule_fsts, config.rule_fars, config.compose_rule_fsts,
+        config.model_config.debug);
   }
 
-  if (!config.rule_fars.empty()) {
-    std::vector<std::string> files;
-    SplitStringToVector(config.rule_fars, ",", false, &files);
-    itn_list_.reserve(files.size() + itn_list_.size());
-
-    for (const auto &f : files) {
-      if (config.model_config.debug) {
-        SHERPA_ONNX_LOGE("rule far: %s", f.c_str());
-      }
-
-      auto buf = ReadFile(mgr, f);
-
-      std::unique_ptr<std::istream> s(
-          new std::istrstream(buf.data(), buf.size()));
-
-      std::unique_ptr<fst::FarReader<fst::StdArc>> reader(
-          fst::FarReader<fst::StdArc>::Open(std::move(s)));
-
-      for (; !reader->Done(); reader->Next()) {
-        std::unique_ptr<fst::StdConstFst> r(
-            fst::CastOrConvertToConstFst(reader->GetFst()->Copy()));
-
-        itn_list_.push_back(
-            std::make_unique<kaldifst::TextNormalizer>(std::move(r)));
-      }  // for (; !reader->Done(); reader->Next())
-    }    // for (const auto &f : files)
-  }      // if (!config.rule_fars.empty())
-
   if (!config.hr.lexicon.empty() && !config.hr.rule_fsts.empty()) {
     auto hr_config = config.hr;
     hr_config.debug = config.model_config.debug;
@@ -564,10 +490,8 @@ std::string OfflineRecognizerImpl::ApplyInverseTextNormalization(
     std::string text) const {
   text = RemoveInvalidUtf8Sequences(text);
 
-  if (!itn_list_.empty()) {
-    for (const auto &tn : itn_list_) {
-      text = tn->Normalize(text);
-    }
+  if (itn_) {
+    text = itn_->Apply(text);
   }
 
   return text;
@@ -9,8 +9,8 @@
 #include <string>
 #include <vector>
 
-#include "kaldifst/csrc/text-normalizer.h"
 #include "sherpa-onnx/csrc/homophone-replacer.h"
+#include "sherpa-onnx/csrc/inverse-text-normalizer.h"
 #include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/offline-recognizer.h"
 #include "sherpa-onnx/csrc/offline-stream.h"
@@ -35,7 +35,8 @@ class OfflineRecognizerImpl {
 
   virtual std::unique_ptr<OfflineStream> CreateStream(
       const std::string &hotwords) const {
-    SHERPA_ONNX_LOGE("Only transducer models support contextual biasing.");
+    SHERPA_ONNX_LOGE(
+        "Only transducer and CTC models support contextual biasing.");
     exit(-1);
   }
 
@@ -56,7 +57,7 @@ class OfflineRecognizerImpl {
   // for inverse text normalization. Used only if
   // config.rule_fsts is not empty or
   // config.rule_fars is not empty
-  std::vector<std::unique_ptr<kaldifst::TextNormalizer>> itn_list_;
+  std::unique_ptr<InverseTextNormalizer> itn_;
   std::unique_ptr<HomophoneReplacer> hr_;
 };
 
@@ -89,7 +89,8 @@ class OfflineRecognizerTransducerImpl : public OfflineRecognizerImpl {
 
     if (config_.decoding_method == "greedy_search") {
       decoder_ = std::make_unique<OfflineTransducerGreedySearchDecoder>(
-          model_.get(), unk_id_, config_.blank_penalty);
+          model_.get(), unk_id_, config_.blank_penalty,
+          config_.blank_skip_threshold);
     } else if (config_.decoding_method == "modified_beam_search") {
       if (!config_.lm_config.model.empty()) {
         lm_ = OfflineLM::Create(config.lm_config);
@@ -106,7 +107,8 @@ class OfflineRecognizerTransducerImpl : public OfflineRecognizerImpl {
 
       decoder_ = std::make_unique<OfflineTransducerModifiedBeamSearchDecoder>(
           model_.get(), lm_.get(), config_.max_active_paths,
-          config_.lm_config.scale, unk_id_, config_.blank_penalty);
+          config_.lm_config.scale, unk_id_, config_.blank_penalty,
+          config_.blank_skip_threshold);
     } else {
       SHERPA_ONNX_LOGE("Unsupported decoding method: %s",
                        config_.decoding_method.c_str());
@@ -128,7 +130,8 @@ class OfflineRecognizerTransducerImpl : public OfflineRecognizerImpl {
 
     if (config_.decoding_method == "greedy_search") {
       decoder_ = std::make_unique<OfflineTransducerGreedySearchDecoder>(
-          model_.get(), unk_id_, config_.blank_penalty);
+          model_.get(), unk_id_, config_.blank_penalty,
+          config_.blank_skip_threshold);
     } else if (config_.decoding_method == "modified_beam_search") {
       if (!config_.lm_config.model.empty()) {
         lm_ = OfflineLM::Create(mgr, config.lm_config);
@@ -146,7 +149,8 @@ class OfflineRecognizerTransducerImpl : public OfflineRecognizerImpl {
 
       decoder_ = std::make_unique<OfflineTransducerModifiedBeamSearchDecoder>(
           model_.get(), lm_.get(), config_.max_active_paths,
-          config_.lm_config.scale, unk_id_, config_.blank_penalty);
+          config_.lm_config.scale, unk_id_, config_.blank_penalty,
+          config_.blank_skip_threshold);
     } else {
       SHERPA_ONNX_LOGE("Unsupported decoding method: %s",
                        config_.decoding_method.c_str());
@@ -166,28 +170,14 @@ class OfflineRecognizerTransducerImpl : public OfflineRecognizerImpl {
                        hotwords.c_str());
     }
 
-    int32_t num_default_hws = hotwords_.size();
-    int32_t num_hws = current.size();
-
-    current.insert(current.end(), hotwords_.begin(), hotwords_.end());
-
-    if (!current_scores.empty() && !boost_scores_.empty()) {
-      current_scores.insert(current_scores.end(), boost_scores_.begin(),
-                            boost_scores_.end());
-    } else if (!current_scores.empty() && boost_scores_.empty()) {
-      current_scores.insert(current_scores.end(), num_default_hws,
-                            config_.hotwords_score);
-    } else if (current_scores.empty() && !boost_scores_.empty()) {
-      current_scores.insert(current_scores.end(), num_hws,
-                            config_.hotwords_score);
-      current_scores.insert(current_scores.end(), boost_scores_.begin(),
-                            boost_scores_.end());
-    } else {
-      // Do nothing.
+    if (current.empty()) {
+      return CreateStream();
     }
 
+    // The hotwords given by the config are shared by all streams and
+    // are not re-built here
     auto context_graph = std::make_shared<ContextGraph>(
-        current, config_.hotwords_score, current_scores);
+        current, config_.hotwords_score, current_scores, hotwords_graph_);
     return std::make_unique<OfflineStream>(config_.feat_config, context_graph);
   }
 
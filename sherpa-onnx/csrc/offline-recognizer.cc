@@ -34,7 +34,8 @@ void OfflineRecognizerConfig::Register(ParseOptions *po) {
       "decoding-method", &decoding_method,
       "decoding method,"
       "Valid values: greedy_search, modified_beam_search. "
-      "modified_beam_search is applicable only for transducer models.");
+      "modified_beam_search is applicable only for transducer and CTC "
+      "models. For CTC models, it uses prefix beam search.");
 
   po->Register("max-active-paths", &max_active_paths,
                "Used only when decoding_method is modified_beam_search");
@@ -46,6 +47,15 @@ void OfflineRecognizerConfig::Register(ParseOptions *po) {
                "of higher insertions. "
                "Currently only applicable for transducer models.");
 
+  po->Register("blank-skip-threshold", &blank_skip_threshold,
+               "Skip frames that are almost surely blank to speed up "
+               "decoding. 0 to disable it. A value such as 0.95 is "
+               "suggested. For CTC models with modified_beam_search, "
+               "only blank is expanded on a frame whose blank probability "
+               "is not less than it. For transducer models, the frame "
+               "after such a frame is treated as blank without running "
+               "the joiner.");
+
   po->Register(
       "hotwords-file", &hotwords_file,
       "The file containing hotwords, one words/phrases per line, For example: "
@@ -65,6 +75,11 @@ void OfflineRecognizerConfig::Register(ParseOptions *po) {
       "rule-fars", &rule_fars,
       "If not empty, it specifies fst archives for inverse text normalization. "
       "If there are multiple archives, they are separated by a comma.");
+
+  po->Register("compose-rule-fsts", &compose_rule_fsts,
+               "True to compose all rules from --rule-fsts and --rule-fars "
+               "into a single FST at startup, so that inverse text "
+               "normalization runs one FST instead of one per rule.");
 }
 
 bool OfflineRecognizerConfig::Validate() const {
@@ -79,6 +94,12 @@ bool OfflineRecognizerConfig::Validate() const {
     }
   }
 
+  if (blank_skip_threshold < 0 || blank_skip_threshold > 1) {
+    SHERPA_ONNX_LOGE("--blank-skip-threshold should be in [0, 1]. Given: %f",
+                     blank_skip_threshold);
+    return false;
+  }
+
   if (!hotwords_file.empty() && decoding_method != "modified_beam_search") {
     SHERPA_ONNX_LOGE(
         "Please use --decoding-method=modified_beam_search if you"
@@ -141,8 +162,11 @@ std::string OfflineRecognizerConfig::ToString() const {
   os << "hotwords_file=\"" << hotwords_file << "\", ";
   os << "hotwords_score=" << hotwords_score << ", ";
   os << "blank_penalty=" << blank_penalty << ", ";
+  os << "blank_skip_threshold=" << blank_skip_threshold << ", ";
   os << "rule_fsts=\"" << rule_fsts << "\", ";
   os << "rule_fars=\"" << rule_fars << "\", ";
+  os << "compose_rule_fsts=" << (compose_rule_fsts ? "True" : "False")
+     << ", ";
   os << "hr=" << hr.ToString() << ")";
 
   return os.str();
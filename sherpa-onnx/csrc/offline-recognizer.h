@@ -36,11 +36,22 @@ struct OfflineRecognizerConfig {
 
   float blank_penalty = 0.0;
 
+  // If the blank probability of a frame is not less than it, only blank is
+  // expanded on that frame for CTC models with modified_beam_search, and
+  // the next frame is treated as blank for transducer models.
+  // 0 to disable it.
+  float blank_skip_threshold = 0;
+
   // If there are multiple rules, they are applied from left to right.
   std::string rule_fsts;
 
   // If there are multiple FST archives, they are applied from left to right.
   std::string rule_fars;
+
+  // If true and there are multiple rules in rule_fsts and rule_fars, they
+  // are composed into a single FST at load time.
+  bool compose_rule_fsts = false;
+
   HomophoneReplacerConfig hr;
 
   // only greedy_search is implemented
@@ -54,7 +65,8 @@ struct OfflineRecognizerConfig {
       const std::string &decoding_method, int32_t max_active_paths,
       const std::string &hotwords_file, float hotwords_score,
       float blank_penalty, const std::string &rule_fsts,
-      const std::string &rule_fars, const HomophoneReplacerConfig &hr)
+      const std::string &rule_fars, const HomophoneReplacerConfig &hr,
+      bool compose_rule_fsts = false)
       : feat_config(feat_config),
         model_config(model_config),
         lm_config(lm_config),
@@ -66,6 +78,7 @@ struct OfflineRecognizerConfig {
         blank_penalty(blank_penalty),
         rule_fsts(rule_fsts),
         rule_fars(rule_fars),
+        compose_rule_fsts(compose_rule_fsts),
         hr(hr) {}
 
   void Register(ParseOptions *po);
@@ -24,7 +24,8 @@ class OfflineSourceSeparationImpl {
   virtual ~OfflineSourceSeparationImpl() = default;
 
   virtual OfflineSourceSeparationOutput Process(
-      const OfflineSourceSeparationInput &input) const = 0;
+      const OfflineSourceSeparationInput &input,
+      OfflineSourceSeparationCallback callback) const = 0;
 
   virtual int32_t GetOutputSampleRate() const = 0;
 
@@ -10,12 +10,12 @@
 #include <vector>
 
 #include "Eigen/Dense"
-#include "kaldi-native-fbank/csrc/istft.h"
-#include "kaldi-native-fbank/csrc/stft.h"
 #include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/offline-source-separation-spleeter-model.h"
 #include "sherpa-onnx/csrc/offline-source-separation.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
+#include "sherpa-onnx/csrc/run-in-order.h"
+#include "sherpa-onnx/csrc/stft-pool.h"
 
 namespace sherpa_onnx {
 
@@ -23,15 +23,18 @@ class OfflineSourceSeparationSpleeterImpl : public OfflineSourceSeparationImpl {
  public:
   explicit OfflineSourceSeparationSpleeterImpl(
       const OfflineSourceSeparationConfig &config)
-      : config_(config), model_(config_.model) {}
+      : config_(config), model_(config_.model), stft_(GetStftConfig()) {}
 
   template <typename Manager>
   OfflineSourceSeparationSpleeterImpl(
       Manager *mgr, const OfflineSourceSeparationConfig &config)
-      : config_(config), model_(mgr, config_.model) {}
+      : config_(config),
+        model_(mgr, config_.model),
+        stft_(GetStftConfig()) {}
 
   OfflineSourceSeparationOutput Process(
-      const OfflineSourceSeparationInput &_input) const override {
+      const OfflineSourceSeparationInput &_input,
+      OfflineSourceSeparationCallback callback) const override {
     auto input = Resample(_input, config_.model.debug);
 
     auto stft_ch0 = ComputeStft(input, 0);
@@ -86,22 +89,11 @@ class OfflineSourceSeparationSpleeterImpl : public OfflineSourceSeparationImpl {
 
     Eigen::VectorXf x = (real.array().square() + imag.array().square()).sqrt();
 
-    auto memory_info =
-        Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
-
-    std::array<int64_t, 4> x_shape{2, num_frames / 512, 512, 1024};
-    Ort::Value x_tensor = Ort::Value::CreateTensor(
-        memory_info, &x[0], x.size(), x_shape.data(), x_shape.size());
-
-    Ort::Value vocals_spec_tensor = model_.RunVocals(View(&x_tensor));
-    Ort::Value accompaniment_spec_tensor =
-        model_.RunAccompaniment(std::move(x_tensor));
+    Eigen::VectorXf vocals_spec(x.size());
+    Eigen::VectorXf accompaniment_spec(x.size());
 
-    Eigen::VectorXf vocals_spec = Eigen::Map<Eigen::VectorXf>(
-        vocals_spec_tensor.GetTensorMutableData<float>(), x.size());
-
-    Eigen::VectorXf accompaniment_spec = Eigen::Map<Eigen::VectorXf>(
-        accompaniment_spec_tensor.GetTensorMutableData<float>(), x.size());
+    RunModel(x, num_frames / 512, &vocals_spec, &accompaniment_spec,
+             callback);
 
     Eigen::VectorXf sum_spec = vocals_spec.array().square() +
                                accompaniment_spec.array().square() + 1e-10;
@@ -144,6 +136,84 @@ class OfflineSourceSeparationSpleeterImpl : public OfflineSourceSeparationImpl {
   }
 
  private:
+  // x, vocals_spec and accompaniment_spec are of shape
+  // (2, num_segments, 512, 1024).
+  //
+  // Segments are independent of each other in the model, so if num_workers
+  // is larger than 1, they are split into groups that are run in parallel.
+  // The result is the same as running all of them in a single call.
+  void RunModel(const Eigen::VectorXf &x, int32_t num_segments,
+                Eigen::VectorXf *vocals_spec,
+                Eigen::VectorXf *accompaniment_spec,
+                const OfflineSourceSeparationCallback &callback) const {
+    int32_t num_workers = std::min(config_.num_workers, num_segments);
+    int32_t num_groups = std::max(num_workers, 1);
+
+    // number of floats in a segment of a channel
+    int32_t segment_size = 512 * 1024;
+
+    auto memory_info =
+        Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
+
+    // Return true after writing the output of the given group
+    auto process = [&](int32_t g) {
+      int32_t start = g * num_segments / num_groups;
+      int32_t end = (g + 1) * num_segments / num_groups;
+      int32_t n = end - start;
+
+      Eigen::VectorXf buf;
+      const float *p = x.data();
+
+      if (n != num_segments) {
+        buf.resize(2 * n * segment_size);
+
+        for (int32_t c = 0; c != 2; ++c) {
+          const float *src = x.data() + (c * num_segments + start) *
+                                            static_cast<int64_t>(segment_size);
+          std::copy(src, src + n * segment_size,
+                    buf.data() + c * n * static_cast<int64_t>(segment_size));
+        }
+
+        p = buf.data();
+      }
+
+      std::array<int64_t, 4> x_shape{2, n, 512, 1024};
+      Ort::Value x_tensor = Ort::Value::CreateTensor(
+          memory_info, const_cast<float *>(p), 2 * n * segment_size,
+          x_shape.data(), x_shape.size());
+
+      Ort::Value vocals = model_.RunVocals(View(&x_tensor));
+      Ort::Value accompaniment = model_.RunAccompaniment(std::move(x_tensor));
+
+      const float *p_vocals = vocals.GetTensorData<float>();
+      const float *p_accompaniment = accompaniment.GetTensorData<float>();
+
+      for (int32_t c = 0; c != 2; ++c) {
+        int64_t src = c * n * static_cast<int64_t>(segment_size);
+        int64_t dst =
+            (c * num_segments + start) * static_cast<int64_t>(segment_size);
+
+        std::copy(p_vocals + src, p_vocals + src + n * segment_size,
+                  vocals_spec->data() + dst);
+
+        std::copy(p_accompaniment + src,
+                  p_accompaniment + src + n * segment_size,
+                  accompaniment_spec->data() + dst);
+      }
+
+      return true;
+    };
+
+    auto report = [&](int32_t g, bool) {
+      if (callback) {
+        callback((g + 1) * 1.0f / num_groups);
+      }
+      return true;
+    };
+
+    RunInOrder(num_groups, num_workers, process, report);
+  }
+
   // spec is of shape (2, num_chunks, 512, 1024)
   std::vector<float> ProcessSpec(const Eigen::VectorXf &spec,
                                  const knf::StftResult &stft,
@@ -183,10 +253,7 @@ class OfflineSourceSeparationSpleeterImpl : public OfflineSourceSeparationImpl {
                                     stft.imag.size())
             .array();
 
-    auto stft_config = GetStftConfig();
-    knf::IStft istft(stft_config);
-
-    return istft.Compute(masked_stft);
+    return stft_.InverseCompute(masked_stft);
   }
 
   knf::StftResult ComputeStft(const OfflineSourceSeparationInput &input,
@@ -205,10 +272,7 @@ class OfflineSourceSeparationSpleeterImpl : public OfflineSourceSeparationImpl {
   }
 
   knf::StftResult ComputeStft(const std::vector<float> &samples) const {
-    auto stft_config = GetStftConfig();
-    knf::Stft stft(stft_config);
-
-    return stft.Compute(samples.data(), samples.size());
+    return stft_.Compute(samples.data(), samples.size());
   }
 
   knf::StftConfig GetStftConfig() const {
@@ -227,6 +291,9 @@ class OfflineSourceSeparationSpleeterImpl : public OfflineSourceSeparationImpl {
  private:
   OfflineSourceSeparationConfig config_;
   OfflineSourceSeparationSpleeterModel model_;
+
+  // It must be initialized after model_
+  StftPool stft_;
 };
 
 }  // namespace sherpa_onnx
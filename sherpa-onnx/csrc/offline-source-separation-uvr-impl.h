@@ -10,13 +10,13 @@
 #include <vector>
 
 #include "Eigen/Dense"
-#include "kaldi-native-fbank/csrc/istft.h"
-#include "kaldi-native-fbank/csrc/stft.h"
 #include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/offline-source-separation-uvr-model.h"
 #include "sherpa-onnx/csrc/offline-source-separation.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
 #include "sherpa-onnx/csrc/resample.h"
+#include "sherpa-onnx/csrc/run-in-order.h"
+#include "sherpa-onnx/csrc/stft-pool.h"
 
 namespace sherpa_onnx {
 
@@ -24,39 +24,64 @@ class OfflineSourceSeparationUvrImpl : public OfflineSourceSeparationImpl {
  public:
   explicit OfflineSourceSeparationUvrImpl(
       const OfflineSourceSeparationConfig &config)
-      : config_(config), model_(config_.model) {}
+      : config_(config), model_(config_.model), stft_(GetStftConfig()) {}
 
   template <typename Manager>
   OfflineSourceSeparationUvrImpl(Manager *mgr,
                                  const OfflineSourceSeparationConfig &config)
-      : config_(config), model_(mgr, config_.model) {}
+      : config_(config),
+        model_(mgr, config_.model),
+        stft_(GetStftConfig()) {}
 
   OfflineSourceSeparationOutput Process(
-      const OfflineSourceSeparationInput &_input) const override {
+      const OfflineSourceSeparationInput &_input,
+      OfflineSourceSeparationCallback callback) const override {
     auto input = Resample(_input, config_.model.debug);
 
-    auto chunks_ch0 = SplitIntoChunks(input.samples.data[0]);
+    const auto &samples = input.samples.data;
 
-    std::vector<std::vector<float>> chunks_ch1;
-    if (input.samples.data.size() > 1) {
-      chunks_ch1 = SplitIntoChunks(input.samples.data[1]);
-    }
+    auto chunks = SplitIntoChunks(samples[0].size());
+    int32_t num_chunks = static_cast<int32_t>(chunks.size());
 
     std::vector<float> samples_ch0;
     std::vector<float> samples_ch1;
 
-    for (int32_t i = 0; i != static_cast<int32_t>(chunks_ch0.size()); ++i) {
+    samples_ch0.reserve(samples[0].size());
+    samples_ch1.reserve(samples[0].size());
+
+    // Chunks are copied from the input only when they are processed, so that
+    // at most 2 * num_workers chunks are in memory at the same time
+    auto process = [&](int32_t i) {
       bool is_first_chunk = (i == 0);
-      bool is_last_chunk = (i == static_cast<int32_t>(chunks_ch0.size()) - 1);
+      bool is_last_chunk = (i == num_chunks - 1);
 
-      auto s = ProcessChunk(
-          chunks_ch0[i],
-          chunks_ch1.empty() ? std::vector<float>{} : chunks_ch1[i],
-          is_first_chunk, is_last_chunk);
+      int32_t start = chunks[i].first;
+      int32_t end = chunks[i].second;
 
+      std::vector<float> chunk_ch0(samples[0].begin() + start,
+                                   samples[0].begin() + end);
+
+      std::vector<float> chunk_ch1;
+      if (samples.size() > 1) {
+        chunk_ch1 = {samples[1].begin() + start, samples[1].begin() + end};
+      }
+
+      return ProcessChunk(chunk_ch0, chunk_ch1, is_first_chunk, is_last_chunk);
+    };
+
+    auto append = [&](int32_t i,
+                      std::pair<std::vector<float>, std::vector<float>> s) {
       samples_ch0.insert(samples_ch0.end(), s.first.begin(), s.first.end());
       samples_ch1.insert(samples_ch1.end(), s.second.begin(), s.second.end());
-    }
+
+      if (callback) {
+        callback((i + 1) * 1.0f / num_chunks);
+      }
+
+      return true;
+    };
+
+    RunInOrder(num_chunks, config_.num_workers, process, append);
 
     auto &vocals_ch0 = samples_ch0;
     auto &vocals_ch1 = samples_ch1;
@@ -273,13 +298,14 @@ class OfflineSourceSeparationUvrImpl : public OfflineSourceSeparationImpl {
       margin = chunk_size;
     }
 
-    auto stft_config = GetStftConfig();
-    knf::IStft istft(stft_config);
-
     std::vector<float> ans;
 
     for (int32_t i = 0; i != static_cast<int32_t>(stft_result.size()); ++i) {
-      auto samples = istft.Compute(stft_result[i]);
+      auto samples = stft_.InverseCompute(stft_result[i]);
+      if (i == 0) {
+        ans.reserve(stft_result.size() * (samples.size() - 2 * trim));
+      }
+
       int32_t num_samples = static_cast<int32_t>(samples.size());
 
       ans.insert(ans.end(), samples.begin() + trim,
@@ -306,24 +332,25 @@ class OfflineSourceSeparationUvrImpl : public OfflineSourceSeparationImpl {
     std::vector<float> samples(trim + chunk.size() + *pad + trim);
     std::copy(chunk.begin(), chunk.end(), samples.begin() + trim);
 
-    auto stft_config = GetStftConfig();
-    knf::Stft stft(stft_config);
-
     std::vector<knf::StftResult> stft_results;
+    stft_results.reserve((num_samples + *pad + gen_size - 1) / gen_size);
+
     // split the chunk into short segments
     for (int32_t i = 0; i < num_samples + *pad; i += gen_size) {
-      auto r = stft.Compute(samples.data() + i, chunk_size);
+      auto r = stft_.Compute(samples.data() + i, chunk_size);
       stft_results.push_back(std::move(r));
     }
 
     return stft_results;
   }
 
-  std::vector<std::vector<float>> SplitIntoChunks(
-      const std::vector<float> &samples) const {
-    std::vector<std::vector<float>> ans;
+  // Return the [start, end) sample range of each chunk, including the
+  // margins on both sides
+  std::vector<std::pair<int32_t, int32_t>> SplitIntoChunks(
+      int32_t num_samples) const {
+    std::vector<std::pair<int32_t, int32_t>> ans;
 
-    if (samples.empty()) {
+    if (num_samples == 0) {
       return ans;
     }
 
@@ -332,26 +359,24 @@ class OfflineSourceSeparationUvrImpl : public OfflineSourceSeparationImpl {
 
     int32_t chunk_size = meta_.num_chunks * meta_.sample_rate;
 
-    if (static_cast<int32_t>(samples.size()) < chunk_size) {
-      chunk_size = samples.size();
+    if (num_samples < chunk_size) {
+      chunk_size = num_samples;
     }
 
     if (margin > chunk_size) {
       margin = chunk_size;
     }
 
-    for (int32_t i = 0; i < static_cast<int32_t>(samples.size());
-         i += chunk_size) {
+    for (int32_t i = 0; i < num_samples; i += chunk_size) {
       int32_t start = std::max<int32_t>(0, i - margin);
-      int32_t end = std::min<int32_t>(i + chunk_size + margin,
-                                      static_cast<int32_t>(samples.size()));
+      int32_t end = std::min<int32_t>(i + chunk_size + margin, num_samples);
       if (start >= end) {
         break;
       }
 
-      ans.emplace_back(samples.begin() + start, samples.begin() + end);
+      ans.emplace_back(start, end);
 
-      if (end == static_cast<int32_t>(samples.size())) {
+      if (end == num_samples) {
         break;
       }
     }
@@ -375,6 +400,9 @@ class OfflineSourceSeparationUvrImpl : public OfflineSourceSeparationImpl {
  private:
   OfflineSourceSeparationConfig config_;
   OfflineSourceSeparationUvrModel model_;
+
+  // It must be initialized after model_
+  StftPool stft_;
 };
 
 }  // namespace sherpa_onnx
@@ -5,7 +5,9 @@
 #include "sherpa-onnx/csrc/offline-source-separation.h"
 
 #include <memory>
+#include <utility>
 
+#include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/offline-source-separation-impl.h"
 
 #if __ANDROID_API__ >= 9
@@ -21,9 +23,19 @@ namespace sherpa_onnx {
 
 void OfflineSourceSeparationConfig::Register(ParseOptions *po) {
   model.Register(po);
+
+  po->Register("num-workers", &num_workers,
+               "Number of chunks of the input audio to process in parallel. "
+               "Total number of threads is about num-workers * num-threads.");
 }
 
 bool OfflineSourceSeparationConfig::Validate() const {
+  if (num_workers < 1) {
+    SHERPA_ONNX_LOGE("--num-workers should be positive. Given: %d",
+                     num_workers);
+    return false;
+  }
+
   return model.Validate();
 }
 
@@ -31,7 +43,8 @@ std::string OfflineSourceSeparationConfig::ToString() const {
   std::ostringstream os;
 
   os << "OfflineSourceSeparationConfig(";
-  os << "model=" << model.ToString() << ")";
+  os << "model=" << model.ToString() << ", ";
+  os << "num_workers=" << num_workers << ")";
 
   return os.str();
 }
@@ -48,8 +61,9 @@ OfflineSourceSeparation::OfflineSourceSeparation(
 OfflineSourceSeparation::~OfflineSourceSeparation() = default;
 
 OfflineSourceSeparationOutput OfflineSourceSeparation::Process(
-    const OfflineSourceSeparationInput &input) const {
-  return impl_->Process(input);
+    const OfflineSourceSeparationInput &input,
+    OfflineSourceSeparationCallback callback /*= nullptr*/) const {
+  return impl_->Process(input, std::move(callback));
 }
 
 int32_t OfflineSourceSeparation::GetOutputSampleRate() const {
@@ -5,6 +5,7 @@
 #ifndef SHERPA_ONNX_CSRC_OFFLINE_SOURCE_SEPARATION_H_
 #define SHERPA_ONNX_CSRC_OFFLINE_SOURCE_SEPARATION_H_
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -17,11 +18,16 @@ namespace sherpa_onnx {
 struct OfflineSourceSeparationConfig {
   OfflineSourceSeparationModelConfig model;
 
+  // Number of chunks of the input audio that are processed in parallel.
+  // Each worker runs the model with model.num_threads threads.
+  int32_t num_workers = 1;
+
   OfflineSourceSeparationConfig() = default;
 
   explicit OfflineSourceSeparationConfig(
-      const OfflineSourceSeparationModelConfig &model)
-      : model(model) {}
+      const OfflineSourceSeparationModelConfig &model,
+      int32_t num_workers = 1)
+      : model(model), num_workers(num_workers) {}
 
   void Register(ParseOptions *po);
 
@@ -49,6 +55,10 @@ struct OfflineSourceSeparationOutput {
   int32_t sample_rate;
 };
 
+// It is called after each chunk of the input is processed.
+// progress is in the range (0, 1].
+using OfflineSourceSeparationCallback = std::function<void(float progress)>;
+
 class OfflineSourceSeparationImpl;
 
 class OfflineSourceSeparation {
@@ -62,7 +72,8 @@ class OfflineSourceSeparation {
                           const OfflineSourceSeparationConfig &config);
 
   OfflineSourceSeparationOutput Process(
-      const OfflineSourceSeparationInput &input) const;
+      const OfflineSourceSeparationInput &input,
+      OfflineSourceSeparationCallback callback = nullptr) const;
 
   int32_t GetOutputSampleRate() const;
 
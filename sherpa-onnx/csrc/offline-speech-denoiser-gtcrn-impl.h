@@ -6,18 +6,15 @@
 #define SHERPA_ONNX_CSRC_OFFLINE_SPEECH_DENOISER_GTCRN_IMPL_H_
 
 #include <algorithm>
-#include <cmath>
 #include <memory>
 #include <utility>
 #include <vector>
 
-#include "kaldi-native-fbank/csrc/feature-window.h"
-#include "kaldi-native-fbank/csrc/istft.h"
-#include "kaldi-native-fbank/csrc/stft.h"
 #include "sherpa-onnx/csrc/offline-speech-denoiser-gtcrn-model.h"
 #include "sherpa-onnx/csrc/offline-speech-denoiser-impl.h"
 #include "sherpa-onnx/csrc/offline-speech-denoiser.h"
 #include "sherpa-onnx/csrc/resample.h"
+#include "sherpa-onnx/csrc/stft-pool.h"
 
 namespace sherpa_onnx {
 
@@ -25,12 +22,13 @@ class OfflineSpeechDenoiserGtcrnImpl : public OfflineSpeechDenoiserImpl {
  public:
   explicit OfflineSpeechDenoiserGtcrnImpl(
       const OfflineSpeechDenoiserConfig &config)
-      : model_(config.model) {}
+      : model_(config.model), stft_(GetStftConfig(model_.GetMetaData())) {}
 
   template <typename Manager>
   OfflineSpeechDenoiserGtcrnImpl(Manager *mgr,
                                  const OfflineSpeechDenoiserConfig &config)
-      : model_(mgr, config.model) {}
+      : model_(mgr, config.model),
+        stft_(GetStftConfig(model_.GetMetaData())) {}
 
   DenoisedAudio Run(const float *samples, int32_t n,
                     int32_t sample_rate) const override {
@@ -57,42 +55,31 @@ class OfflineSpeechDenoiserGtcrnImpl : public OfflineSpeechDenoiserImpl {
       n = tmp.size();
     }
 
-    knf::StftConfig stft_config;
-    stft_config.n_fft = meta.n_fft;
-    stft_config.hop_length = meta.hop_length;
-    stft_config.win_length = meta.window_length;
-    stft_config.window_type = meta.window_type;
-    if (stft_config.window_type == "hann_sqrt") {
-      auto window = knf::GetWindow("hann", stft_config.win_length);
-      for (auto &w : window) {
-        w = std::sqrt(w);
-      }
-      stft_config.window = std::move(window);
-    }
-
-    knf::Stft stft(stft_config);
-    knf::StftResult stft_result = stft.Compute(p, n);
+    knf::StftResult stft_result = stft_.Compute(p, n);
 
     auto states = model_.GetInitStates();
     OfflineSpeechDenoiserGtcrnModel::States next_states;
 
+    int32_t num_bins = meta.n_fft / 2 + 1;
+
     knf::StftResult enhanced_stft_result;
     enhanced_stft_result.num_frames = stft_result.num_frames;
+    enhanced_stft_result.real.resize(stft_result.num_frames * num_bins);
+    enhanced_stft_result.imag.resize(stft_result.num_frames * num_bins);
+
+    // The input of each frame is reused across frames
+    std::vector<float> x(num_bins * 2);
+
     for (int32_t i = 0; i < stft_result.num_frames; ++i) {
-      auto p = Process(stft_result, i, std::move(states), &next_states);
+      Process(stft_result, i, std::move(states), &x, &next_states,
+              enhanced_stft_result.real.data() + i * num_bins,
+              enhanced_stft_result.imag.data() + i * num_bins);
       states = std::move(next_states);
-
-      enhanced_stft_result.real.insert(enhanced_stft_result.real.end(),
-                                       p.first.begin(), p.first.end());
-      enhanced_stft_result.imag.insert(enhanced_stft_result.imag.end(),
-                                       p.second.begin(), p.second.end());
     }
 
-    knf::IStft istft(stft_config);
-
     DenoisedAudio denoised_audio;
     denoised_audio.sample_rate = meta.sample_rate;
-    denoised_audio.samples = istft.Compute(enhanced_stft_result);
+    denoised_audio.samples = stft_.InverseCompute(enhanced_stft_result);
     return denoised_audio;
   }
 
@@ -101,47 +88,62 @@ class OfflineSpeechDenoiserGtcrnImpl : public OfflineSpeechDenoiserImpl {
   }
 
  private:
-  std::pair<std::vector<float>, std::vector<float>> Process(
-      const knf::StftResult &stft_result, int32_t frame_index,
-      OfflineSpeechDenoiserGtcrnModel::States states,
-      OfflineSpeechDenoiserGtcrnModel::States *next_states) const {
+  // Process a frame of stft_result and write the enhanced frame to
+  // real[0:n_fft/2+1] and imag[0:n_fft/2+1].
+  //
+  // x is a buffer of size (n_fft/2+1)*2 for the model input.
+  void Process(const knf::StftResult &stft_result, int32_t frame_index,
+               OfflineSpeechDenoiserGtcrnModel::States states,
+               std::vector<float> *x,
+               OfflineSpeechDenoiserGtcrnModel::States *next_states,
+               float *real, float *imag) const {
     const auto &meta = model_.GetMetaData();
     int32_t n_fft = meta.n_fft;
-    std::vector<float> x((n_fft / 2 + 1) * 2);
 
     const float *p_real =
         stft_result.real.data() + frame_index * (n_fft / 2 + 1);
     const float *p_imag =
         stft_result.imag.data() + frame_index * (n_fft / 2 + 1);
 
+    float *px = x->data();
     for (int32_t i = 0; i < n_fft / 2 + 1; ++i) {
-      x[2 * i] = p_real[i];
-      x[2 * i + 1] = p_imag[i];
+      px[2 * i] = p_real[i];
+      px[2 * i + 1] = p_imag[i];
     }
     auto memory_info =
         Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
 
     std::array<int64_t, 4> x_shape{1, n_fft / 2 + 1, 1, 2};
     Ort::Value x_tensor = Ort::Value::CreateTensor(
-        memory_info, x.data(), x.size(), x_shape.data(), x_shape.size());
+        memory_info, px, x->size(), x_shape.data(), x_shape.size());
 
     Ort::Value output{nullptr};
     std::tie(output, *next_states) =
         model_.Run(std::move(x_tensor), std::move(states));
 
-    std::vector<float> real(n_fft / 2 + 1);
-    std::vector<float> imag(n_fft / 2 + 1);
     const auto *p = output.GetTensorData<float>();
     for (int32_t i = 0; i < n_fft / 2 + 1; ++i) {
       real[i] = p[2 * i];
       imag[i] = p[2 * i + 1];
     }
+  }
+
+  static knf::StftConfig GetStftConfig(
+      const OfflineSpeechDenoiserGtcrnModelMetaData &meta) {
+    knf::StftConfig stft_config;
+    stft_config.n_fft = meta.n_fft;
+    stft_config.hop_length = meta.hop_length;
+    stft_config.win_length = meta.window_length;
+    stft_config.window_type = meta.window_type;
 
-    return {std::move(real), std::move(imag)};
+    return stft_config;
   }
 
  private:
   OfflineSpeechDenoiserGtcrnModel model_;
+
+  // It must be initialized after model_
+  StftPool stft_;
 };
 
 }  // namespace sherpa_onnx
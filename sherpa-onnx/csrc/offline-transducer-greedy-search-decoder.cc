@@ -5,9 +5,12 @@
 #include "sherpa-onnx/csrc/offline-transducer-greedy-search-decoder.h"
 
 #include <algorithm>
+#include <cmath>
 #include <iterator>
 #include <utility>
+#include <vector>
 
+#include "sherpa-onnx/csrc/math.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
 #include "sherpa-onnx/csrc/packed-sequence.h"
 #include "sherpa-onnx/csrc/slice.h"
@@ -38,17 +41,53 @@ OfflineTransducerGreedySearchDecoder::Decode(Ort::Value encoder_out,
   auto decoder_input = model_->BuildDecoderInput(ans, ans.size());
   Ort::Value decoder_out = model_->RunDecoder(std::move(decoder_input));
 
+  float log_blank_skip_threshold =
+      blank_skip_threshold_ > 0 ? std::log(blank_skip_threshold_) : 0;
+
+  // skip_next_frame[i] is true if the next frame of the i-th utterance is
+  // treated as blank without running the joiner
+  std::vector<bool> skip_next_frame(batch_size, false);
+
+  // Indexes of the utterances whose current frame is not skipped
+  std::vector<int32_t> rows;
+  rows.reserve(batch_size);
+
   int32_t start = 0;
   int32_t t = 0;
   for (auto n : packed_encoder_out.batch_sizes) {
+    rows.clear();
+    for (int32_t i = 0; i != n; ++i) {
+      if (skip_next_frame[i]) {
+        skip_next_frame[i] = false;
+      } else {
+        rows.push_back(i);
+      }
+    }
+
+    if (rows.empty()) {
+      start += n;
+      ++t;
+      continue;
+    }
+
     Ort::Value cur_encoder_out = packed_encoder_out.Get(start, n);
-    Ort::Value cur_decoder_out = Slice(model_->Allocator(), &decoder_out, 0, n);
+    Ort::Value cur_decoder_out{nullptr};
     start += n;
+
+    if (static_cast<int32_t>(rows.size()) != n) {
+      // Run the joiner only for utterances that are not skipped
+      cur_encoder_out =
+          GatherRows(model_->Allocator(), &cur_encoder_out, rows);
+      cur_decoder_out = GatherRows(model_->Allocator(), &decoder_out, rows);
+    } else {
+      cur_decoder_out = Slice(model_->Allocator(), &decoder_out, 0, n);
+    }
+
     Ort::Value logit = model_->RunJoiner(std::move(cur_encoder_out),
                                          std::move(cur_decoder_out));
     float *p_logit = logit.GetTensorMutableData<float>();
     bool emitted = false;
-    for (int32_t i = 0; i != n; ++i) {
+    for (auto i : rows) {
       if (blank_penalty_ > 0.0) {
         p_logit[0] -= blank_penalty_;  // assuming blank id is 0
       }
@@ -56,14 +95,18 @@ OfflineTransducerGreedySearchDecoder::Decode(Ort::Value encoder_out,
           static_cast<const float *>(p_logit),
           std::max_element(static_cast<const float *>(p_logit),
                            static_cast<const float *>(p_logit) + vocab_size)));
-      p_logit += vocab_size;
       // blank id is hardcoded to 0
       // also, it treats unk as blank
       if (y != 0 && y != unk_id_) {
         ans[i].tokens.push_back(y);
         ans[i].timestamps.push_back(t);
         emitted = true;
+      } else if (blank_skip_threshold_ > 0 && y == 0 &&
+                 p_logit[0] - LogSumExp(p_logit, vocab_size) >=
+                     log_blank_skip_threshold) {
+        skip_next_frame[i] = true;
       }
+      p_logit += vocab_size;
     }
     if (emitted) {
       Ort::Value decoder_input = model_->BuildDecoderInput(ans, n);
@@ -16,8 +16,12 @@ class OfflineTransducerGreedySearchDecoder : public OfflineTransducerDecoder {
  public:
   OfflineTransducerGreedySearchDecoder(OfflineTransducerModel *model,
                                        int32_t unk_id,
-                                       float blank_penalty)
-      : model_(model), unk_id_(unk_id), blank_penalty_(blank_penalty) {}
+                                       float blank_penalty,
+                                       float blank_skip_threshold)
+      : model_(model),
+        unk_id_(unk_id),
+        blank_penalty_(blank_penalty),
+        blank_skip_threshold_(blank_skip_threshold) {}
 
   std::vector<OfflineTransducerDecoderResult> Decode(
       Ort::Value encoder_out, Ort::Value encoder_out_length,
@@ -27,6 +31,10 @@ class OfflineTransducerGreedySearchDecoder : public OfflineTransducerDecoder {
   OfflineTransducerModel *model_;  // Not owned
   int32_t unk_id_;
   float blank_penalty_;
+
+  // If the blank probability of a frame is not less than it, the next
+  // frame is treated as blank without running the joiner. 0 to disable it.
+  float blank_skip_threshold_;
 };
 
 }  // namespace sherpa_onnx
@@ -4,6 +4,7 @@
 
 #include "sherpa-onnx/csrc/offline-transducer-modified-beam-search-decoder.h"
 
+#include <cmath>
 #include <deque>
 #include <utility>
 #include <vector>
@@ -42,17 +43,33 @@ OfflineTransducerModifiedBeamSearchDecoder::Decode(
   std::vector<ContextGraphPtr> context_graphs(batch_size, nullptr);
 
   for (int32_t i = 0; i < batch_size; ++i) {
-    const ContextState *context_state = nullptr;
+    Hypothesis hyp(blanks, 0);
     if (ss != nullptr) {
       context_graphs[i] =
           ss[packed_encoder_out.sorted_indexes[i]]->GetContextGraph();
-      if (context_graphs[i] != nullptr)
-        context_state = context_graphs[i]->Root();
+      if (context_graphs[i] != nullptr) {
+        hyp.context_state = context_graphs[i]->Root();
+        hyp.base_context_state = context_graphs[i]->BaseRoot();
+      }
     }
-    Hypotheses blank_hyp({{blanks, 0, context_state}});
+    Hypotheses blank_hyp({hyp});
     cur.emplace_back(std::move(blank_hyp));
   }
 
+  float log_blank_skip_threshold =
+      blank_skip_threshold_ > 0 ? std::log(blank_skip_threshold_) : 0;
+
+  // skip_next_frame[i] is true if the next frame of the i-th utterance is
+  // treated as blank without running the decoder and the joiner
+  std::vector<bool> skip_next_frame(batch_size, false);
+
+  // Indexes of the utterances whose current frame is not skipped
+  std::vector<int32_t> rows;
+  rows.reserve(batch_size);
+
+  std::vector<Hypotheses> active;
+  active.reserve(batch_size);
+
   int32_t start = 0;
   int32_t t = 0;
   for (auto n : packed_encoder_out.batch_sizes) {
@@ -67,21 +84,42 @@ OfflineTransducerModifiedBeamSearchDecoder::Decode(
       cur.erase(cur.begin() + n, cur.end());
     }  // if (n < static_cast<int32_t>(cur.size()))
 
+    rows.clear();
+    for (int32_t i = 0; i != n; ++i) {
+      if (skip_next_frame[i]) {
+        // The blank probability of a skipped frame is taken as 1, so the
+        // hypotheses are kept as they are
+        skip_next_frame[i] = false;
+      } else {
+        rows.push_back(i);
+      }
+    }
+
+    if (rows.empty()) {
+      ++t;
+      continue;
+    }
+
+    int32_t num_rows = static_cast<int32_t>(rows.size());
+
+    active.clear();
+    for (auto i : rows) {
+      active.push_back(std::move(cur[i]));
+    }
+
     // Due to merging paths with identical token sequences,
     // not all utterances have "max_active_paths" paths.
-    auto hyps_row_splits = GetHypsRowSplits(cur);
+    auto hyps_row_splits = GetHypsRowSplits(active);
     int32_t num_hyps = hyps_row_splits.back();
 
     prev.clear();
     prev.reserve(num_hyps);
 
-    for (auto &hyps : cur) {
+    for (auto &hyps : active) {
       for (auto &h : hyps) {
         prev.push_back(std::move(h.second));
       }
     }
-    cur.clear();
-    cur.reserve(n);
 
     auto decoder_input = model_->BuildDecoderInput(prev, num_hyps);
     // decoder_input shape: (num_hyps, context_size)
@@ -89,6 +127,11 @@ OfflineTransducerModifiedBeamSearchDecoder::Decode(
     auto decoder_out = model_->RunDecoder(std::move(decoder_input));
     // decoder_out is (num_hyps, joiner_dim)
 
+    if (num_rows != n) {
+      cur_encoder_out =
+          GatherRows(model_->Allocator(), &cur_encoder_out, rows);
+    }
+
     cur_encoder_out =
         Repeat(model_->Allocator(), &cur_encoder_out, hyps_row_splits);
     // now cur_encoder_out is of shape (num_hyps, joiner_dim)
@@ -103,6 +146,24 @@ OfflineTransducerModifiedBeamSearchDecoder::Decode(
     }
     LogSoftmax(p_logit, vocab_size, num_hyps);
 
+    if (blank_skip_threshold_ > 0) {
+      // Skip the next frame of an utterance if blank is confident enough
+      // for its best hypothesis
+      for (int32_t j = 0; j != num_rows; ++j) {
+        int32_t best = hyps_row_splits[j];
+        for (int32_t i = best + 1; i != hyps_row_splits[j + 1]; ++i) {
+          if (prev[i].log_prob > prev[best].log_prob) {
+            best = i;
+          }
+        }
+
+        // assuming blank id is 0
+        if (p_logit[best * vocab_size] >= log_blank_skip_threshold) {
+          skip_next_frame[rows[j]] = true;
+        }
+      }
+    }
+
     // now p_logit contains log_softmax output, we rename it to p_logprob
     // to match what it actually contains
     float *p_logprob = p_logit;
@@ -117,9 +178,10 @@ OfflineTransducerModifiedBeamSearchDecoder::Decode(
     p_logprob = p_logit;  // we changed p_logprob in the above for loop
 
     // Now compute top_k for each utterance
-    for (int32_t i = 0; i != n; ++i) {
-      int32_t start = hyps_row_splits[i];
-      int32_t end = hyps_row_splits[i + 1];
+    for (int32_t j = 0; j != num_rows; ++j) {
+      int32_t i = rows[j];
+      int32_t start = hyps_row_splits[j];
+      int32_t end = hyps_row_splits[j + 1];
       auto topk =
           TopkIndex(p_logprob, vocab_size * (end - start), max_active_paths_);
 
@@ -130,19 +192,15 @@ OfflineTransducerModifiedBeamSearchDecoder::Decode(
         Hypothesis new_hyp = prev[hyp_index];
 
         float context_score = 0;
-        auto context_state = new_hyp.context_state;
         // blank is hardcoded to 0
         // also, it treats unk as blank
         if (new_token != 0 && new_token != unk_id_) {
           new_hyp.ys.push_back(new_token);
           new_hyp.timestamps.push_back(t);
           if (context_graphs[i] != nullptr) {
-            auto context_res =
-                context_graphs[i]->ForwardOneStep(context_state,
-                  new_token,
-                  false /* non-strict mode */);
-            context_score = std::get<0>(context_res);
-            new_hyp.context_state = std::get<1>(context_res);
+            context_score = context_graphs[i]->ForwardOneStep(
+                &new_hyp.context_state, &new_hyp.base_context_state,
+                new_token, false /* non-strict mode */);
           }
         }
 
@@ -150,8 +208,8 @@ OfflineTransducerModifiedBeamSearchDecoder::Decode(
         hyps.Add(std::move(new_hyp));
       }  // for (auto k : topk)
       p_logprob += (end - start) * vocab_size;
-      cur.push_back(std::move(hyps));
-    }  // for (int32_t i = 0; i != n; ++i)
+      cur[i] = std::move(hyps);
+    }  // for (int32_t j = 0; j != num_rows; ++j)
 
     ++t;
   }  // for (auto n : packed_encoder_out.batch_sizes)
@@ -164,10 +222,9 @@ OfflineTransducerModifiedBeamSearchDecoder::Decode(
   for (int32_t i = 0; i < cur.size(); ++i) {
     for (auto iter = cur[i].begin(); iter != cur[i].end(); ++iter) {
       if (context_graphs[i] != nullptr) {
-        auto context_res =
-            context_graphs[i]->Finalize(iter->second.context_state);
-        iter->second.log_prob += context_res.first;
-        iter->second.context_state = context_res.second;
+        iter->second.log_prob +=
+            context_graphs[i]->Finalize(&iter->second.context_state,
+                                        &iter->second.base_context_state);
       }
     }
   }
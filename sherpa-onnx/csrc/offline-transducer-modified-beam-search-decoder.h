@@ -20,13 +20,15 @@ class OfflineTransducerModifiedBeamSearchDecoder
                                              OfflineLM *lm,
                                              int32_t max_active_paths,
                                              float lm_scale, int32_t unk_id,
-                                             float blank_penalty)
+                                             float blank_penalty,
+                                             float blank_skip_threshold)
       : model_(model),
         lm_(lm),
         max_active_paths_(max_active_paths),
         lm_scale_(lm_scale),
         unk_id_(unk_id),
-        blank_penalty_(blank_penalty) {}
+        blank_penalty_(blank_penalty),
+        blank_skip_threshold_(blank_skip_threshold) {}
 
   std::vector<OfflineTransducerDecoderResult> Decode(
       Ort::Value encoder_out, Ort::Value encoder_out_length,
@@ -40,6 +42,11 @@ class OfflineTransducerModifiedBeamSearchDecoder
   float lm_scale_;  // used only when lm_ is not nullptr
   int32_t unk_id_;
   float blank_penalty_;
+
+  // If the blank probability of a frame is not less than it for the best
+  // hypothesis of an utterance, the next frame of that utterance is treated
+  // as blank without running the decoder and the joiner. 0 to disable it.
+  float blank_skip_threshold_;
 };
 
 }  // namespace sherpa_onnx
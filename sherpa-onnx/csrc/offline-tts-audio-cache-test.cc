@@ -0,0 +1,135 @@
+// sherpa-onnx/csrc/offline-tts-audio-cache-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/offline-tts-audio-cache.h"
+
+#include <cstdio>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sherpa-onnx/csrc/file-utils.h"
+#include "sherpa-onnx/csrc/offline-tts.h"
+
+namespace sherpa_onnx {
+
+static std::vector<float> Samples(int32_t n, float offset) {
+  std::vector<float> ans(n);
+  for (int32_t i = 0; i != n; ++i) {
+    ans[i] = offset + i * 0.01f;
+  }
+  return ans;
+}
+
+TEST(OfflineTtsAudioCache, PutGet) {
+  OfflineTtsAudioCache cache(2, "");
+
+  std::vector<float> samples;
+  EXPECT_FALSE(cache.Get("a", &samples));
+
+  cache.Put("a", Samples(10, 1));
+  cache.Put("b", Samples(20, 2));
+
+  EXPECT_TRUE(cache.Get("a", &samples));
+  EXPECT_EQ(samples, Samples(10, 1));
+
+  EXPECT_TRUE(cache.Get("b", &samples));
+  EXPECT_EQ(samples, Samples(20, 2));
+
+  // "a" is the least recently used one and is evicted
+  cache.Put("c", Samples(5, 3));
+  EXPECT_FALSE(cache.Get("a", &samples));
+  EXPECT_TRUE(cache.Get("c", &samples));
+  EXPECT_EQ(samples, Samples(5, 3));
+}
+
+TEST(OfflineTtsAudioCache, KeyPrefix) {
+  OfflineTtsConfig config;
+  config.model.vits.model = "./model.onnx";
+  config.model.vits.tokens = "./tokens.txt";
+
+  std::string prefix = GetAudioCacheKeyPrefix(config, 0, 1.0);
+
+  EXPECT_NE(prefix, GetAudioCacheKeyPrefix(config, 1, 1.0));
+  EXPECT_NE(prefix, GetAudioCacheKeyPrefix(config, 0, 1.2));
+
+  OfflineTtsConfig c = config;
+  c.model.vits.noise_scale = 0.5;
+  EXPECT_NE(prefix, GetAudioCacheKeyPrefix(c, 0, 1.0));
+
+  c = config;
+  c.model.vits.model = "./model.int8.onnx";
+  EXPECT_NE(prefix, GetAudioCacheKeyPrefix(c, 0, 1.0));
+
+  c = config;
+  c.silence_scale = 0.5;
+  EXPECT_NE(prefix, GetAudioCacheKeyPrefix(c, 0, 1.0));
+
+  // They don't affect the generated audio
+  c = config;
+  c.model.num_threads = 4;
+  c.model.debug = true;
+  c.model.provider = "cuda";
+  c.num_workers = 2;
+  c.max_num_sentences = 3;
+  EXPECT_EQ(prefix, GetAudioCacheKeyPrefix(c, 0, 1.0));
+}
+
+TEST(OfflineTtsAudioCache, Disk) {
+  std::string dir = ".";
+  int32_t max_files = 4;
+
+  std::vector<std::string> keys;
+  for (int32_t i = 0; i != 20; ++i) {
+    keys.push_back("sentence " + std::to_string(i));
+  }
+
+  std::set<std::string> filenames;
+  {
+    OfflineTtsAudioCache cache(100, dir, max_files);
+    for (const auto &k : keys) {
+      filenames.insert(cache.GetFilename(k));
+    }
+
+    // Start with an empty cache directory
+    for (const auto &f : filenames) {
+      std::remove(f.c_str());
+    }
+
+    for (int32_t i = 0; i != static_cast<int32_t>(keys.size()); ++i) {
+      cache.Put(keys[i], Samples(10 + i, i));
+    }
+  }
+
+  // At most max_files files are saved
+  EXPECT_LE(filenames.size(), static_cast<size_t>(max_files));
+
+  int32_t num_files = 0;
+  for (const auto &f : filenames) {
+    num_files += FileExists(f);
+  }
+  EXPECT_EQ(num_files, static_cast<int32_t>(filenames.size()));
+
+  // A new instance finds the last entry saved to each slot
+  OfflineTtsAudioCache cache(100, dir, max_files);
+  int32_t num_found = 0;
+  for (int32_t i = 0; i != static_cast<int32_t>(keys.size()); ++i) {
+    std::vector<float> samples;
+    if (cache.Get(keys[i], &samples)) {
+      EXPECT_EQ(samples, Samples(10 + i, i));
+      num_found += 1;
+    }
+  }
+  EXPECT_EQ(num_found, num_files);
+
+  std::vector<float> samples;
+  EXPECT_TRUE(cache.Get(keys.back(), &samples));
+
+  for (const auto &f : filenames) {
+    std::remove(f.c_str());
+  }
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,174 @@
+// sherpa-onnx/csrc/offline-tts-audio-cache.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/offline-tts-audio-cache.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/offline-tts.h"
+
+namespace sherpa_onnx {
+
+// 64-bit FNV-1a. Unlike std::hash, it gives the same value on all
+// platforms, so files in the cache directory can be shared.
+static uint64_t Fnv1a(const std::string &s) {
+  uint64_t h = 14695981039346656037ULL;
+  for (char c : s) {
+    h ^= static_cast<uint8_t>(c);
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+OfflineTtsAudioCache::OfflineTtsAudioCache(int32_t capacity,
+                                           const std::string &dir,
+                                           int32_t max_files /*= 10000*/)
+    : cache_(capacity), dir_(dir), max_files_(max_files) {
+  if (max_files_ <= 0) {
+    dir_.clear();
+  }
+}
+
+bool OfflineTtsAudioCache::Get(const std::string &key,
+                               std::vector<float> *samples) const {
+  if (cache_.Get(key, samples)) {
+    return true;
+  }
+
+  if (dir_.empty() || !Load(key, samples)) {
+    return false;
+  }
+
+  cache_.Put(key, *samples);
+
+  return true;
+}
+
+void OfflineTtsAudioCache::Put(const std::string &key,
+                               const std::vector<float> &samples) const {
+  cache_.Put(key, samples);
+
+  if (!dir_.empty()) {
+    Save(key, samples);
+  }
+}
+
+std::string OfflineTtsAudioCache::Stats() const { return cache_.Stats(); }
+
+std::string OfflineTtsAudioCache::GetFilename(const std::string &key) const {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "tts-audio-%" PRIu64 ".bin",
+           Fnv1a(key) % static_cast<uint64_t>(max_files_));
+
+  return dir_ + "/" + buf;
+}
+
+// The file format is
+//  - key size (int32), followed by the key
+//  - number of samples (int32), followed by the samples (float)
+//
+// The key is saved since a slot is shared by all keys with the same hash
+// modulo max_files_.
+bool OfflineTtsAudioCache::Load(const std::string &key,
+                                std::vector<float> *samples) const {
+  std::ifstream is(GetFilename(key), std::ios::binary);
+  if (!is) {
+    return false;
+  }
+
+  int32_t key_size = 0;
+  is.read(reinterpret_cast<char *>(&key_size), sizeof(key_size));
+  if (!is || key_size != static_cast<int32_t>(key.size())) {
+    return false;
+  }
+
+  std::string saved_key(key_size, '\0');
+  is.read(&saved_key[0], key_size);
+  if (!is || saved_key != key) {
+    return false;
+  }
+
+  int32_t n = 0;
+  is.read(reinterpret_cast<char *>(&n), sizeof(n));
+  if (!is || n < 0) {
+    return false;
+  }
+
+  samples->resize(n);
+  is.read(reinterpret_cast<char *>(samples->data()), n * sizeof(float));
+
+  return static_cast<bool>(is);
+}
+
+void OfflineTtsAudioCache::Save(const std::string &key,
+                                const std::vector<float> &samples) const {
+  std::string filename = GetFilename(key);
+
+  // Write to a temporary file first so that readers never see a partially
+  // written file
+  std::string tmp =
+      filename + "." +
+      std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) +
+      ".tmp";
+  {
+    std::ofstream os(tmp, std::ios::binary);
+    if (!os) {
+      SHERPA_ONNX_LOGE("Failed to create '%s'", tmp.c_str());
+      return;
+    }
+
+    int32_t key_size = static_cast<int32_t>(key.size());
+    int32_t n = static_cast<int32_t>(samples.size());
+
+    os.write(reinterpret_cast<const char *>(&key_size), sizeof(key_size));
+    os.write(key.data(), key_size);
+    os.write(reinterpret_cast<const char *>(&n), sizeof(n));
+    os.write(reinterpret_cast<const char *>(samples.data()),
+             n * sizeof(float));
+
+    if (!os) {
+      SHERPA_ONNX_LOGE("Failed to write '%s'", tmp.c_str());
+      return;
+    }
+  }
+
+  if (std::rename(tmp.c_str(), filename.c_str()) != 0) {
+    SHERPA_ONNX_LOGE("Failed to rename '%s' to '%s'", tmp.c_str(),
+                     filename.c_str());
+    std::remove(tmp.c_str());
+  }
+}
+
+std::string GetAudioCacheKeyPrefix(const OfflineTtsConfig &config,
+                                   int64_t sid, float speed) {
+  const auto &model = config.model;
+
+  std::ostringstream os;
+  if (!model.vits.model.empty()) {
+    os << model.vits.ToString();
+  } else if (!model.matcha.acoustic_model.empty()) {
+    os << model.matcha.ToString();
+  } else if (!model.kokoro.model.empty()) {
+    os << model.kokoro.ToString();
+  } else if (!model.zipvoice.text_model.empty()) {
+    os << model.zipvoice.ToString();
+  } else {
+    os << model.kitten.ToString();
+  }
+
+  os << "|" << config.rule_fsts << "|" << config.rule_fars << "|"
+     << config.silence_scale << "|" << sid << "|" << speed << "|";
+
+  return os.str();
+}
+
+}  // namespace sherpa_onnx
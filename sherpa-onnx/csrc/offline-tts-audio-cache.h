@@ -0,0 +1,68 @@
+// sherpa-onnx/csrc/offline-tts-audio-cache.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_OFFLINE_TTS_AUDIO_CACHE_H_
+#define SHERPA_ONNX_CSRC_OFFLINE_TTS_AUDIO_CACHE_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "sherpa-onnx/csrc/lru-cache.h"
+
+namespace sherpa_onnx {
+
+struct OfflineTtsConfig;
+
+// A cache of generated audio samples.
+//
+// Entries are kept in an in-memory LRU cache. If a directory is given,
+// every entry is also written to a file in it, so entries missing from
+// memory are looked up on disk and survive restarts and evictions.
+//
+// The disk cache has max_files slots. An entry is saved to the slot
+// selected by a hash of its key and replaces the entry saved there
+// before, so the directory contains at most max_files files.
+class OfflineTtsAudioCache {
+ public:
+  // @param capacity Maximum number of entries in memory
+  // @param dir Optional. An existing, writable directory for the on-disk
+  //            cache.
+  // @param max_files Maximum number of files in dir
+  OfflineTtsAudioCache(int32_t capacity, const std::string &dir,
+                       int32_t max_files = 10000);
+
+  // Return true and copy the samples to *samples if key is found
+  bool Get(const std::string &key, std::vector<float> *samples) const;
+
+  void Put(const std::string &key, const std::vector<float> &samples) const;
+
+  // Return the number of entries, hits, misses and the hit rate of the
+  // in-memory cache
+  std::string Stats() const;
+
+  // Return the filename of the slot for key. Used only for tests.
+  std::string GetFilename(const std::string &key) const;
+
+ private:
+  bool Load(const std::string &key, std::vector<float> *samples) const;
+
+  void Save(const std::string &key, const std::vector<float> &samples) const;
+
+ private:
+  mutable LruCache<std::vector<float>> cache_;
+  std::string dir_;
+  int32_t max_files_;
+};
+
+// Return the part of the cache key that depends on the config, the speaker
+// ID and the speed, i.e., the model files and the parameters that affect
+// the generated audio. Settings such as num_threads, debug and provider
+// are excluded so that cached audio stays valid when they change.
+std::string GetAudioCacheKeyPrefix(const OfflineTtsConfig &config,
+                                   int64_t sid, float speed);
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_OFFLINE_TTS_AUDIO_CACHE_H_
@@ -0,0 +1,109 @@
+// sherpa-onnx/csrc/offline-tts-batch-generator.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/offline-tts-batch-generator.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/run-in-order.h"
+
+namespace sherpa_onnx {
+
+namespace {
+
+struct Batch {
+  std::vector<std::vector<int64_t>> tokens;
+  std::vector<std::vector<int64_t>> tones;
+};
+
+}  // namespace
+
+GeneratedAudio GenerateInBatches(std::vector<std::vector<int64_t>> tokens,
+                                 std::vector<std::vector<int64_t>> tones,
+                                 int32_t batch_size, int32_t num_workers,
+                                 const OfflineTtsProcessFunc &process,
+                                 GeneratedAudioCallback callback, bool debug) {
+  int32_t num_sentences = static_cast<int32_t>(tokens.size());
+  if (num_sentences == 0) {
+    return {};
+  }
+
+  if (batch_size <= 0 || batch_size > num_sentences) {
+    batch_size = num_sentences;
+  }
+
+  std::vector<Batch> batches;
+  batches.reserve((num_sentences + batch_size - 1) / batch_size);
+
+  for (int32_t k = 0; k < num_sentences; k += batch_size) {
+    int32_t end = std::min(k + batch_size, num_sentences);
+
+    Batch batch;
+    batch.tokens.reserve(end - k);
+    for (int32_t i = k; i != end; ++i) {
+      batch.tokens.push_back(std::move(tokens[i]));
+    }
+
+    if (!tones.empty()) {
+      batch.tones.reserve(end - k);
+      for (int32_t i = k; i != end; ++i) {
+        batch.tones.push_back(std::move(tones[i]));
+      }
+    }
+
+    batches.push_back(std::move(batch));
+  }
+
+  int32_t num_batches = static_cast<int32_t>(batches.size());
+  num_workers = std::max(1, std::min(num_workers, num_batches));
+
+  if (debug && num_batches > 1) {
+#if __OHOS__
+    SHERPA_ONNX_LOGE(
+        "Split text into %{public}d batches. batch size: %{public}d. Number "
+        "of sentences: %{public}d. Number of workers: %{public}d",
+        num_batches, batch_size, num_sentences, num_workers);
+#else
+    SHERPA_ONNX_LOGE(
+        "Split text into %d batches. batch size: %d. Number of sentences: "
+        "%d. Number of workers: %d",
+        num_batches, batch_size, num_sentences, num_workers);
+#endif
+  }
+
+  GeneratedAudio ans;
+  ans.sample_rate = 0;
+
+  // Return false if the callback asks us to stop
+  auto deliver = [&ans, &callback, num_batches](int32_t b,
+                                                GeneratedAudio audio) {
+    ans.sample_rate = audio.sample_rate;
+    ans.samples.insert(ans.samples.end(), audio.samples.begin(),
+                       audio.samples.end());
+
+    if (!callback) {
+      return true;
+    }
+
+    // Caution(fangjun): audio is freed when the callback returns, so users
+    // should copy the data if they want to access the data after
+    // the callback returns to avoid segmentation fault.
+    return callback(audio.samples.data(), audio.samples.size(),
+                    (b + 1) * 1.0 / num_batches) != 0;
+  };
+
+  RunInOrder(
+      num_batches, num_workers,
+      [&batches, &process](int32_t b) {
+        return process(batches[b].tokens, batches[b].tones);
+      },
+      deliver);
+
+  return ans;
+}
+
+}  // namespace sherpa_onnx
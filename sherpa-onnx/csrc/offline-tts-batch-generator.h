@@ -0,0 +1,57 @@
+// sherpa-onnx/csrc/offline-tts-batch-generator.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_OFFLINE_TTS_BATCH_GENERATOR_H_
+#define SHERPA_ONNX_CSRC_OFFLINE_TTS_BATCH_GENERATOR_H_
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "sherpa-onnx/csrc/offline-tts.h"
+
+namespace sherpa_onnx {
+
+// Convert a batch of sentences to audio samples.
+//
+// @param tokens tokens[i] contains the token IDs of the i-th sentence
+// @param tones  tones[i] contains the tones of the i-th sentence. It is empty
+//               if the model does not use tones.
+using OfflineTtsProcessFunc = std::function<GeneratedAudio(
+    const std::vector<std::vector<int64_t>> & /*tokens*/,
+    const std::vector<std::vector<int64_t>> & /*tones*/)>;
+
+// Split sentences into batches of consecutive sentences and convert each
+// batch to audio with `process`.
+//
+// If num_workers > 1, batches are processed in parallel by a pool of
+// num_workers threads, while the calling thread concatenates the results
+// and invokes the callback. The callback is always invoked in the calling
+// thread and in the order of the input sentences. Workers never run more
+// than 2 * num_workers batches ahead of the callback, so the memory for
+// pending results is bounded.
+//
+// If the callback returns 0, no new batches are started and the audio of
+// the already finished batches is returned.
+//
+// @param tokens Token IDs of each sentence.
+// @param tones  Tones of each sentence. Either empty or of the same size as
+//               tokens.
+// @param batch_size Maximum number of sentences in a batch. If it is less
+//                   than or equal to 0, all sentences are put into a single
+//                   batch.
+// @param num_workers Number of threads for processing batches.
+// @param process  It is called once for each batch. It must be thread-safe
+//                 if num_workers > 1.
+// @param callback Optional. See OfflineTts::Generate().
+// @param debug    True to print debug information.
+GeneratedAudio GenerateInBatches(std::vector<std::vector<int64_t>> tokens,
+                                 std::vector<std::vector<int64_t>> tones,
+                                 int32_t batch_size, int32_t num_workers,
+                                 const OfflineTtsProcessFunc &process,
+                                 GeneratedAudioCallback callback, bool debug);
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_OFFLINE_TTS_BATCH_GENERATOR_H_
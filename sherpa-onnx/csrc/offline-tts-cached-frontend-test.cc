@@ -0,0 +1,115 @@
+// sherpa-onnx/csrc/offline-tts-cached-frontend-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/offline-tts-cached-frontend.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+// Token IDs are the bytes of the text plus a per-voice offset, one
+// subvector per word. It counts the number of calls.
+class FakeFrontend : public OfflineTtsFrontend {
+ public:
+  explicit FakeFrontend(int32_t *num_calls) : num_calls_(num_calls) {}
+
+  std::vector<TokenIDs> ConvertTextToTokenIds(
+      const std::string &text, const std::string &voice = "") const override {
+    *num_calls_ += 1;
+
+    int64_t offset = voice.empty() ? 0 : 1000;
+
+    std::vector<TokenIDs> ans;
+    std::vector<int64_t> tokens;
+    for (char c : text) {
+      if (c == ' ') {
+        if (!tokens.empty()) {
+          ans.emplace_back(std::move(tokens));
+          tokens.clear();
+        }
+        continue;
+      }
+      tokens.push_back(offset + static_cast<unsigned char>(c));
+    }
+
+    if (!tokens.empty()) {
+      ans.emplace_back(std::move(tokens));
+    }
+
+    return ans;
+  }
+
+ private:
+  int32_t *num_calls_;
+};
+
+static std::vector<std::vector<int64_t>> ToVector(
+    const std::vector<TokenIDs> &ids) {
+  std::vector<std::vector<int64_t>> ans;
+  for (const auto &i : ids) {
+    ans.push_back(i.tokens);
+  }
+  return ans;
+}
+
+TEST(OfflineTtsCachedFrontend, SameAsUncached) {
+  int32_t num_uncached_calls = 0;
+  FakeFrontend uncached(&num_uncached_calls);
+
+  int32_t num_calls = 0;
+  OfflineTtsCachedFrontend cached(std::make_unique<FakeFrontend>(&num_calls),
+                                  10, false);
+
+  std::string text = "How are you? I am fine.";
+  std::vector<std::vector<int64_t>> expected;
+  for (const auto &s : {"How are you?", "I am fine."}) {
+    auto ids = ToVector(uncached.ConvertTextToTokenIds(s));
+    expected.insert(expected.end(), ids.begin(), ids.end());
+  }
+
+  // miss
+  EXPECT_EQ(ToVector(cached.ConvertTextToTokenIds(text)), expected);
+  EXPECT_EQ(num_calls, 2);
+
+  // hit
+  EXPECT_EQ(ToVector(cached.ConvertTextToTokenIds(text)), expected);
+  EXPECT_EQ(num_calls, 2);
+
+  // The voice is part of the key
+  EXPECT_EQ(ToVector(cached.ConvertTextToTokenIds(text, "en")),
+            ToVector(uncached.ConvertTextToTokenIds("How are you? I am fine.",
+                                                    "en")));
+  EXPECT_EQ(num_calls, 4);
+}
+
+// A sentence is a hit even if it appears in a different text
+TEST(OfflineTtsCachedFrontend, PerSentence) {
+  int32_t num_uncached_calls = 0;
+  FakeFrontend uncached(&num_uncached_calls);
+
+  int32_t num_calls = 0;
+  OfflineTtsCachedFrontend cached(std::make_unique<FakeFrontend>(&num_calls),
+                                  10, false);
+
+  cached.ConvertTextToTokenIds("Good morning. How are you?");
+  EXPECT_EQ(num_calls, 2);
+
+  auto ids = cached.ConvertTextToTokenIds("How are you? Fine, thanks.");
+  EXPECT_EQ(num_calls, 3);
+
+  EXPECT_EQ(ToVector(ids),
+            ToVector(uncached.ConvertTextToTokenIds("How are you? Fine, "
+                                                    "thanks.")));
+
+  // Whitespace around sentences does not matter
+  cached.ConvertTextToTokenIds("  Good morning.\n");
+  EXPECT_EQ(num_calls, 3);
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,130 @@
+// sherpa-onnx/csrc/offline-tts-cached-frontend.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/offline-tts-cached-frontend.h"
+
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/text-segmenter.h"
+
+namespace sherpa_onnx {
+
+static std::string GetKey(const std::string &text, const std::string &voice) {
+  std::string key;
+  key.reserve(voice.size() + 1 + text.size());
+  key.append(voice);
+  key.push_back('\0');
+  key.append(text);
+
+  return key;
+}
+
+OfflineTtsCachedFrontend::OfflineTtsCachedFrontend(
+    std::unique_ptr<OfflineTtsFrontend> frontend, int32_t capacity, bool debug)
+    : frontend_(std::move(frontend)), cache_(capacity), debug_(debug) {}
+
+std::vector<TokenIDs> OfflineTtsCachedFrontend::ConvertSentence(
+    const std::string &sentence, const std::string &voice) const {
+  std::string key = GetKey(sentence, voice);
+
+  std::vector<TokenIDs> ans;
+  if (!cache_.Get(key, &ans)) {
+    ans = frontend_->ConvertTextToTokenIds(sentence, voice);
+    if (!ans.empty()) {
+      cache_.Put(key, ans);
+    }
+  }
+
+  return ans;
+}
+
+std::vector<TokenIDs> OfflineTtsCachedFrontend::ConvertTextToTokenIds(
+    const std::string &text, const std::string &voice /*= ""*/) const {
+  std::vector<TokenIDs> ans;
+  for (const auto &s : SplitSentences(text)) {
+    auto ids = ConvertSentence(s, voice);
+    ans.insert(ans.end(), std::make_move_iterator(ids.begin()),
+               std::make_move_iterator(ids.end()));
+  }
+
+  if (debug_) {
+#if __OHOS__
+    SHERPA_ONNX_LOGE("Frontend cache: %{public}s", Stats().c_str());
+#else
+    SHERPA_ONNX_LOGE("Frontend cache: %s", Stats().c_str());
+#endif
+  }
+
+  return ans;
+}
+
+int32_t OfflineTtsCachedFrontend::Warmup(const std::string &filename,
+                                         const std::string &voice) {
+  std::ifstream is(filename);
+  if (!is) {
+#if __OHOS__
+    SHERPA_ONNX_LOGE("Failed to open '%{public}s'", filename.c_str());
+#else
+    SHERPA_ONNX_LOGE("Failed to open '%s'", filename.c_str());
+#endif
+    return 0;
+  }
+
+  int32_t n = 0;
+  std::string line;
+  while (std::getline(is, line)) {
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+
+    if (line.empty()) {
+      continue;
+    }
+
+    for (const auto &s : SplitSentences(line)) {
+      auto ids = frontend_->ConvertTextToTokenIds(s, voice);
+      if (!ids.empty()) {
+        cache_.Put(GetKey(s, voice), std::move(ids));
+      }
+    }
+    ++n;
+  }
+
+  return n;
+}
+
+std::string OfflineTtsCachedFrontend::Stats() const { return cache_.Stats(); }
+
+std::unique_ptr<OfflineTtsFrontend> MaybeAddFrontendCache(
+    std::unique_ptr<OfflineTtsFrontend> frontend,
+    const OfflineTtsConfig &config, const std::string &voice) {
+  if (config.frontend_cache_size <= 0) {
+    return frontend;
+  }
+
+  auto ans = std::make_unique<OfflineTtsCachedFrontend>(
+      std::move(frontend), config.frontend_cache_size, config.model.debug);
+
+  if (!config.frontend_cache_warmup.empty()) {
+    int32_t n = ans->Warmup(config.frontend_cache_warmup, voice);
+    if (config.model.debug) {
+#if __OHOS__
+      SHERPA_ONNX_LOGE("Pre-warmed the frontend cache with %{public}d lines",
+                       n);
+#else
+      SHERPA_ONNX_LOGE("Pre-warmed the frontend cache with %d lines", n);
+#endif
+    }
+  }
+
+  return ans;
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,68 @@
+// sherpa-onnx/csrc/offline-tts-cached-frontend.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_OFFLINE_TTS_CACHED_FRONTEND_H_
+#define SHERPA_ONNX_CSRC_OFFLINE_TTS_CACHED_FRONTEND_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "sherpa-onnx/csrc/lru-cache.h"
+#include "sherpa-onnx/csrc/offline-tts-frontend.h"
+#include "sherpa-onnx/csrc/offline-tts.h"
+
+namespace sherpa_onnx {
+
+// It wraps another frontend and caches the token IDs of recently converted
+// sentences. The input text is split into sentences with SplitSentences()
+// and each sentence is converted separately. The key is the
+// (sentence, voice) pair, so a sentence that appears again, even in a
+// different text, skips word segmentation, lexicon lookup and espeak-ng
+// phonemization.
+//
+// It is thread-safe if the wrapped frontend is thread-safe.
+class OfflineTtsCachedFrontend : public OfflineTtsFrontend {
+ public:
+  // @param frontend The frontend to wrap
+  // @param capacity Maximum number of cached entries
+  // @param debug True to print cache statistics after each call
+  OfflineTtsCachedFrontend(std::unique_ptr<OfflineTtsFrontend> frontend,
+                           int32_t capacity, bool debug);
+
+  std::vector<TokenIDs> ConvertTextToTokenIds(
+      const std::string &text, const std::string &voice = "") const override;
+
+  // Convert the sentences in each non-empty line of the given file and
+  // save the results in the cache.
+  //
+  // Return the number of converted lines.
+  int32_t Warmup(const std::string &filename, const std::string &voice);
+
+  // Return the number of entries, hits, misses and the hit rate
+  std::string Stats() const;
+
+ private:
+  std::vector<TokenIDs> ConvertSentence(const std::string &sentence,
+                                        const std::string &voice) const;
+
+ private:
+  std::unique_ptr<OfflineTtsFrontend> frontend_;
+  mutable LruCache<std::vector<TokenIDs>> cache_;
+  bool debug_;
+};
+
+// Wrap the given frontend with OfflineTtsCachedFrontend if
+// config.frontend_cache_size > 0. Otherwise, it is returned unchanged.
+//
+// If config.frontend_cache_warmup is not empty, the cache is pre-filled
+// with the lines of that file converted with the given voice.
+std::unique_ptr<OfflineTtsFrontend> MaybeAddFrontendCache(
+    std::unique_ptr<OfflineTtsFrontend> frontend,
+    const OfflineTtsConfig &config, const std::string &voice);
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_OFFLINE_TTS_CACHED_FRONTEND_H_
@@ -19,6 +19,8 @@
 #include "sherpa-onnx/csrc/kokoro-multi-lang-lexicon.h"
 #include "sherpa-onnx/csrc/lexicon.h"
 #include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/offline-tts-batch-generator.h"
+#include "sherpa-onnx/csrc/offline-tts-cached-frontend.h"
 #include "sherpa-onnx/csrc/offline-tts-frontend.h"
 #include "sherpa-onnx/csrc/offline-tts-impl.h"
 #include "sherpa-onnx/csrc/offline-tts-kokoro-model.h"
@@ -33,6 +35,10 @@ class OfflineTtsKokoroImpl : public OfflineTtsImpl {
       : config_(config),
         model_(std::make_unique<OfflineTtsKokoroModel>(config.model)) {
     InitFrontend();
+    frontend_ = MaybeAddFrontendCache(
+        std::move(frontend_), config_,
+        config_.model.kokoro.lang.empty() ? model_->GetMetaData().voice
+                                          : config_.model.kokoro.lang);
 
     if (!config.rule_fsts.empty()) {
       std::vector<std::string> files;
@@ -89,6 +95,10 @@ class OfflineTtsKokoroImpl : public OfflineTtsImpl {
       : config_(config),
         model_(std::make_unique<OfflineTtsKokoroModel>(mgr, config.model)) {
     InitFrontend(mgr);
+    frontend_ = MaybeAddFrontendCache(
+        std::move(frontend_), config_,
+        config_.model.kokoro.lang.empty() ? model_->GetMetaData().voice
+                                          : config_.model.kokoro.lang);
 
     if (!config.rule_fsts.empty()) {
       std::vector<std::string> files;
@@ -243,8 +253,6 @@ class OfflineTtsKokoroImpl : public OfflineTtsImpl {
       x.push_back(std::move(i.tokens));
     }
 
-    int32_t x_size = static_cast<int32_t>(x.size());
-
     if (config_.max_num_sentences != 1) {
 #if __OHOS__
       SHERPA_ONNX_LOGE(
@@ -258,74 +266,17 @@ class OfflineTtsKokoroImpl : public OfflineTtsImpl {
 #endif
     }
 
-    // the input text is too long, we process sentences within it in batches
-    // to avoid OOM. Batch size is config_.max_num_sentences
-    std::vector<std::vector<int64_t>> batch_x;
-
-    int32_t batch_size = 1;
-    batch_x.reserve(config_.max_num_sentences);
-    int32_t num_batches = x_size / batch_size;
-
-    if (config_.model.debug) {
-#if __OHOS__
-      SHERPA_ONNX_LOGE(
-          "Split it into %{public}d batches. batch size: "
-          "%{public}d. Number of sentences: %{public}d",
-          num_batches, batch_size, x_size);
-#else
-      SHERPA_ONNX_LOGE(
-          "Split it into %d batches. batch size: %d. Number "
-          "of sentences: %d",
-          num_batches, batch_size, x_size);
-#endif
-    }
-
-    GeneratedAudio ans;
-
-    int32_t should_continue = 1;
-
-    int32_t k = 0;
-
-    for (int32_t b = 0; b != num_batches && should_continue; ++b) {
-      batch_x.clear();
-      for (int32_t i = 0; i != batch_size; ++i, ++k) {
-        batch_x.push_back(std::move(x[k]));
-      }
-
-      auto audio = Process(batch_x, sid, speed);
-      ans.sample_rate = audio.sample_rate;
-      ans.samples.insert(ans.samples.end(), audio.samples.begin(),
-                         audio.samples.end());
-      if (callback) {
-        should_continue = callback(audio.samples.data(), audio.samples.size(),
-                                   (b + 1) * 1.0 / num_batches);
-        // Caution(fangjun): audio is freed when the callback returns, so users
-        // should copy the data if they want to access the data after
-        // the callback returns to avoid segmentation fault.
-      }
-    }
-
-    batch_x.clear();
-    while (k < static_cast<int32_t>(x.size()) && should_continue) {
-      batch_x.push_back(std::move(x[k]));
-
-      ++k;
-    }
-
-    if (!batch_x.empty()) {
-      auto audio = Process(batch_x, sid, speed);
-      ans.sample_rate = audio.sample_rate;
-      ans.samples.insert(ans.samples.end(), audio.samples.begin(),
-                         audio.samples.end());
-      if (callback) {
-        callback(audio.samples.data(), audio.samples.size(), 1.0);
-        // Caution(fangjun): audio is freed when the callback returns, so users
-        // should copy the data if they want to access the data after
-        // the callback returns to avoid segmentation fault.
-      }
-    }
-
-    return ans;
+    // Each sentence is processed separately. Sentences can be processed
+    // in parallel if config_.num_workers > 1
+    auto process =
+        [this, sid, speed](
+            const std::vector<std::vector<int64_t>> &batch_tokens,
+            const std::vector<std::vector<int64_t>> & /*batch_tones*/) {
+          return Process(batch_tokens, sid, speed);
+        };
+
+    return GenerateInBatches(std::move(x), {}, 1, config_.num_workers, process,
+                             std::move(callback), config_.model.debug);
   }
 
  private:
@@ -346,7 +297,8 @@ class OfflineTtsKokoroImpl : public OfflineTtsImpl {
 
       frontend_ = std::make_unique<KokoroMultiLangLexicon>(
           mgr, config_.model.kokoro.tokens, config_.model.kokoro.lexicon,
-          config_.model.kokoro.data_dir, meta_data, config_.model.debug);
+          config_.model.kokoro.data_dir, meta_data, config_.model.debug,
+          config_.frontend_cache_size);
 
       return;
     }
@@ -371,7 +323,8 @@ class OfflineTtsKokoroImpl : public OfflineTtsImpl {
 
       frontend_ = std::make_unique<KokoroMultiLangLexicon>(
           config_.model.kokoro.tokens, config_.model.kokoro.lexicon,
-          config_.model.kokoro.data_dir, meta_data, config_.model.debug);
+          config_.model.kokoro.data_dir, meta_data, config_.model.debug,
+          config_.frontend_cache_size);
 
       return;
     }
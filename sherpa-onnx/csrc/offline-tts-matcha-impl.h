@@ -17,6 +17,8 @@
 #include "sherpa-onnx/csrc/lexicon.h"
 #include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/melo-tts-lexicon.h"
+#include "sherpa-onnx/csrc/offline-tts-batch-generator.h"
+#include "sherpa-onnx/csrc/offline-tts-cached-frontend.h"
 #include "sherpa-onnx/csrc/offline-tts-character-frontend.h"
 #include "sherpa-onnx/csrc/offline-tts-frontend.h"
 #include "sherpa-onnx/csrc/offline-tts-impl.h"
@@ -35,6 +37,8 @@ class OfflineTtsMatchaImpl : public OfflineTtsImpl {
         model_(std::make_unique<OfflineTtsMatchaModel>(config.model)),
         vocoder_(Vocoder::Create(config.model)) {
     InitFrontend();
+    frontend_ = MaybeAddFrontendCache(std::move(frontend_), config_,
+                                      model_->GetMetaData().voice);
 
     if (!config.rule_fsts.empty()) {
       std::vector<std::string> files;
@@ -92,6 +96,8 @@ class OfflineTtsMatchaImpl : public OfflineTtsImpl {
         model_(std::make_unique<OfflineTtsMatchaModel>(mgr, config.model)),
         vocoder_(Vocoder::Create(mgr, config.model)) {
     InitFrontend(mgr);
+    frontend_ = MaybeAddFrontendCache(std::move(frontend_), config_,
+                                      model_->GetMetaData().voice);
 
     if (!config.rule_fsts.empty()) {
       std::vector<std::string> files;
@@ -237,84 +243,16 @@ class OfflineTtsMatchaImpl : public OfflineTtsImpl {
       }
     }
 
-    int32_t x_size = static_cast<int32_t>(x.size());
+    auto process =
+        [this, sid, speed](
+            const std::vector<std::vector<int64_t>> &batch_tokens,
+            const std::vector<std::vector<int64_t>> & /*batch_tones*/) {
+          return Process(batch_tokens, sid, speed);
+        };
 
-    if (config_.max_num_sentences <= 0 || x_size <= config_.max_num_sentences) {
-      auto ans = Process(x, sid, speed);
-      if (callback) {
-        callback(ans.samples.data(), ans.samples.size(), 1.0);
-      }
-      return ans;
-    }
-
-    // the input text is too long, we process sentences within it in batches
-    // to avoid OOM. Batch size is config_.max_num_sentences
-    std::vector<std::vector<int64_t>> batch_x;
-
-    int32_t batch_size = config_.max_num_sentences;
-    batch_x.reserve(config_.max_num_sentences);
-    int32_t num_batches = x_size / batch_size;
-
-    if (config_.model.debug) {
-#if __OHOS__
-      SHERPA_ONNX_LOGE(
-          "Text is too long. Split it into %{public}d batches. batch size: "
-          "%{public}d. Number of sentences: %{public}d",
-          num_batches, batch_size, x_size);
-#else
-      SHERPA_ONNX_LOGE(
-          "Text is too long. Split it into %d batches. batch size: %d. Number "
-          "of sentences: %d",
-          num_batches, batch_size, x_size);
-#endif
-    }
-
-    GeneratedAudio ans;
-
-    int32_t should_continue = 1;
-
-    int32_t k = 0;
-
-    for (int32_t b = 0; b != num_batches && should_continue; ++b) {
-      batch_x.clear();
-      for (int32_t i = 0; i != batch_size; ++i, ++k) {
-        batch_x.push_back(std::move(x[k]));
-      }
-
-      auto audio = Process(batch_x, sid, speed);
-      ans.sample_rate = audio.sample_rate;
-      ans.samples.insert(ans.samples.end(), audio.samples.begin(),
-                         audio.samples.end());
-      if (callback) {
-        should_continue = callback(audio.samples.data(), audio.samples.size(),
-                                   (b + 1) * 1.0 / num_batches);
-        // Caution(fangjun): audio is freed when the callback returns, so users
-        // should copy the data if they want to access the data after
-        // the callback returns to avoid segmentation fault.
-      }
-    }
-
-    batch_x.clear();
-    while (k < static_cast<int32_t>(x.size()) && should_continue) {
-      batch_x.push_back(std::move(x[k]));
-
-      ++k;
-    }
-
-    if (!batch_x.empty()) {
-      auto audio = Process(batch_x, sid, speed);
-      ans.sample_rate = audio.sample_rate;
-      ans.samples.insert(ans.samples.end(), audio.samples.begin(),
-                         audio.samples.end());
-      if (callback) {
-        callback(audio.samples.data(), audio.samples.size(), 1.0);
-        // Caution(fangjun): audio is freed when the callback returns, so users
-        // should copy the data if they want to access the data after
-        // the callback returns to avoid segmentation fault.
-      }
-    }
-
-    return ans;
+    return GenerateInBatches(std::move(x), {}, config_.max_num_sentences,
+                             config_.num_workers, process, std::move(callback),
+                             config_.model.debug);
   }
 
  private:
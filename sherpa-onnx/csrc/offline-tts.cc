@@ -4,7 +4,12 @@
 
 #include "sherpa-onnx/csrc/offline-tts.h"
 
+#include <chrono>  // NOLINT
 #include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
@@ -20,11 +25,76 @@
 
 #include "sherpa-onnx/csrc/file-utils.h"
 #include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/offline-tts-audio-cache.h"
 #include "sherpa-onnx/csrc/offline-tts-impl.h"
+#include "sherpa-onnx/csrc/text-segmenter.h"
 #include "sherpa-onnx/csrc/text-utils.h"
 
 namespace sherpa_onnx {
 
+namespace {
+
+// Collect statistics for a call of OfflineTts::Generate()
+class GenerationTimer {
+ public:
+  explicit GenerationTimer(GeneratedAudioCallback callback)
+      : callback_(std::move(callback)),
+        begin_(std::chrono::steady_clock::now()) {}
+
+  // Return a callback that records the time of the first audio samples and
+  // forwards its arguments to the user callback, if any. The progress is
+  // mapped to offset + progress * scale.
+  GeneratedAudioCallback Wrap(float offset = 0, float scale = 1) {
+    return [this, offset, scale](const float *samples, int32_t n,
+                                 float progress) -> int32_t {
+      if (time_to_first_sample_ < 0 && n > 0) {
+        time_to_first_sample_ = ElapsedSeconds();
+      }
+
+      if (!callback_) {
+        return 1;
+      }
+
+      int32_t ans = callback_(samples, n, offset + progress * scale);
+      if (!ans) {
+        stopped_ = true;
+      }
+
+      return ans;
+    };
+  }
+
+  // Return true if the user callback returned 0
+  bool Stopped() const { return stopped_; }
+
+  void SetStatistics(GeneratedAudio *audio) const {
+    audio->elapsed_seconds = ElapsedSeconds();
+    audio->time_to_first_sample = time_to_first_sample_ < 0
+                                      ? audio->elapsed_seconds
+                                      : time_to_first_sample_;
+
+    if (!audio->samples.empty() && audio->sample_rate > 0) {
+      float duration = audio->samples.size() /
+                       static_cast<float>(audio->sample_rate);
+      audio->rtf = audio->elapsed_seconds / duration;
+    }
+  }
+
+ private:
+  float ElapsedSeconds() const {
+    auto now = std::chrono::steady_clock::now();
+    return std::chrono::duration<float>(now - begin_).count();
+  }
+
+ private:
+  GeneratedAudioCallback callback_;
+  std::chrono::steady_clock::time_point begin_;
+  float time_to_first_sample_ = -1;
+  bool stopped_ = false;
+};
+
+}  // namespace
+
 struct SilenceInterval {
   int32_t start;
   int32_t end;
@@ -116,6 +186,39 @@ void OfflineTtsConfig::Register(ParseOptions *po) {
   po->Register("tts-silence-scale", &silence_scale,
                "Duration of the pause is scaled by this number. So a smaller "
                "value leads to a shorter pause.");
+
+  po->Register("tts-num-workers", &num_workers,
+               "Number of threads for processing batches of sentences in "
+               "parallel. See also --tts-max-num-sentences.");
+
+  po->Register("tts-low-latency", &low_latency,
+               "If true, the first clause of the text is synthesized alone "
+               "and passed to the callback before the remaining text. It "
+               "reduces the time to the first audio sample, but the model "
+               "runs twice, one after the other, so the total generation "
+               "time is usually longer.");
+
+  po->Register("tts-frontend-cache-size", &frontend_cache_size,
+               "Maximum number of sentences whose token IDs are cached by "
+               "the text frontend. 0 disables the cache.");
+
+  po->Register("tts-audio-cache-size", &audio_cache_size,
+               "Maximum number of sentences whose generated audio is cached "
+               "in memory. If it is positive, sentences are synthesized one "
+               "at a time and --tts-max-num-sentences and --tts-num-workers "
+               "are ignored. 0 disables the cache.");
+
+  po->Register("tts-audio-cache-dir", &audio_cache_dir,
+               "Optional. An existing directory. If not empty, cached audio "
+               "is also saved to it and reused across restarts.");
+
+  po->Register("tts-audio-cache-max-files", &audio_cache_max_files,
+               "Maximum number of files in --tts-audio-cache-dir. A new "
+               "file may replace an old one when the limit is reached.");
+
+  po->Register("tts-frontend-cache-warmup", &frontend_cache_warmup,
+               "Optional. Path to a text file. Each line is converted to "
+               "token IDs at startup to pre-warm the frontend cache.");
 }
 
 bool OfflineTtsConfig::Validate() const {
@@ -146,6 +249,37 @@ bool OfflineTtsConfig::Validate() const {
     return false;
   }
 
+  if (!frontend_cache_warmup.empty() && !FileExists(frontend_cache_warmup)) {
+    SHERPA_ONNX_LOGE("--tts-frontend-cache-warmup '%s' does not exist",
+                     frontend_cache_warmup.c_str());
+    return false;
+  }
+
+  if (num_workers < 1) {
+    SHERPA_ONNX_LOGE("--tts-num-workers should be positive. Given: %d",
+                     num_workers);
+    return false;
+  }
+
+  if (audio_cache_size > 0 && !audio_cache_dir.empty()) {
+    if (audio_cache_max_files < 1) {
+      SHERPA_ONNX_LOGE(
+          "--tts-audio-cache-max-files should be positive. Given: %d",
+          audio_cache_max_files);
+      return false;
+    }
+
+    // Check that the directory exists and is writable
+    std::string filename = audio_cache_dir + "/.sherpa-onnx-write-test";
+    if (!std::ofstream(filename)) {
+      SHERPA_ONNX_LOGE(
+          "--tts-audio-cache-dir '%s' does not exist or is not writable",
+          audio_cache_dir.c_str());
+      return false;
+    }
+    std::remove(filename.c_str());
+  }
+
   return model.Validate();
 }
 
@@ -157,17 +291,55 @@ std::string OfflineTtsConfig::ToString() const {
   os << "rule_fsts=\"" << rule_fsts << "\", ";
   os << "rule_fars=\"" << rule_fars << "\", ";
   os << "max_num_sentences=" << max_num_sentences << ", ";
-  os << "silence_scale=" << silence_scale << ")";
+  os << "silence_scale=" << silence_scale << ", ";
+  os << "num_workers=" << num_workers << ", ";
+  os << "low_latency=" << (low_latency ? "True" : "False") << ", ";
+  os << "frontend_cache_size=" << frontend_cache_size << ", ";
+  os << "frontend_cache_warmup=\"" << frontend_cache_warmup << "\", ";
+  os << "audio_cache_size=" << audio_cache_size << ", ";
+  os << "audio_cache_dir=\"" << audio_cache_dir << "\", ";
+  os << "audio_cache_max_files=" << audio_cache_max_files << ")";
 
   return os.str();
 }
 
+static std::unique_ptr<OfflineTtsAudioCache> CreateAudioCache(
+    const OfflineTtsConfig &config) {
+  if (config.audio_cache_size <= 0) {
+    return nullptr;
+  }
+
+  if (config.num_workers > 1 || config.max_num_sentences != 1) {
+    // See GenerateWithAudioCache()
+#if __OHOS__
+    SHERPA_ONNX_LOGE(
+        "The audio cache synthesizes one sentence at a time. "
+        "max_num_sentences (%{public}d) and num_workers (%{public}d) are "
+        "ignored",
+        config.max_num_sentences, config.num_workers);
+#else
+    SHERPA_ONNX_LOGE(
+        "The audio cache synthesizes one sentence at a time. "
+        "max_num_sentences (%d) and num_workers (%d) are ignored",
+        config.max_num_sentences, config.num_workers);
+#endif
+  }
+
+  return std::make_unique<OfflineTtsAudioCache>(config.audio_cache_size,
+                                                config.audio_cache_dir,
+                                                config.audio_cache_max_files);
+}
+
 OfflineTts::OfflineTts(const OfflineTtsConfig &config)
-    : impl_(OfflineTtsImpl::Create(config)) {}
+    : config_(config),
+      impl_(OfflineTtsImpl::Create(config)),
+      audio_cache_(CreateAudioCache(config)) {}
 
 template <typename Manager>
 OfflineTts::OfflineTts(Manager *mgr, const OfflineTtsConfig &config)
-    : impl_(OfflineTtsImpl::Create(mgr, config)) {}
+    : config_(config),
+      impl_(OfflineTtsImpl::Create(mgr, config)),
+      audio_cache_(CreateAudioCache(config)) {}
 
 OfflineTts::~OfflineTts() = default;
 
@@ -175,10 +347,10 @@ GeneratedAudio OfflineTts::Generate(
     const std::string &text, int64_t sid /*=0*/, float speed /*= 1.0*/,
     GeneratedAudioCallback callback /*= nullptr*/) const {
 #if !defined(_WIN32)
-  return impl_->Generate(text, sid, speed, std::move(callback));
+  return GenerateUtf8(text, sid, speed, std::move(callback));
 #else
   if (IsUtf8(text)) {
-    return impl_->Generate(text, sid, speed, std::move(callback));
+    return GenerateUtf8(text, sid, speed, std::move(callback));
   } else if (IsGB2312(text)) {
     auto utf8_text = Gb2312ToUtf8(text);
     static bool printed = false;
@@ -187,12 +359,12 @@ GeneratedAudio OfflineTts::Generate(
           "Detected GB2312 encoded string! Converting it to UTF8.");
       printed = true;
     }
-    return impl_->Generate(utf8_text, sid, speed, std::move(callback));
+    return GenerateUtf8(utf8_text, sid, speed, std::move(callback));
   } else {
     SHERPA_ONNX_LOGE(
         "Non UTF8 encoded string is received. You would not get expected "
         "results!");
-    return impl_->Generate(text, sid, speed, std::move(callback));
+    return GenerateUtf8(text, sid, speed, std::move(callback));
   }
 #endif
 }
@@ -202,9 +374,12 @@ GeneratedAudio OfflineTts::Generate(
     const std::vector<float> &prompt_samples, int32_t sample_rate,
     float speed /*=1.0*/, int32_t num_steps /*=4*/,
     GeneratedAudioCallback callback /*=nullptr*/) const {
+  GenerationTimer timer(std::move(callback));
+  GeneratedAudio ans;
+
 #if !defined(_WIN32)
-  return impl_->Generate(text, prompt_text, prompt_samples, sample_rate, speed,
-                         num_steps, std::move(callback));
+  ans = impl_->Generate(text, prompt_text, prompt_samples, sample_rate, speed,
+                        num_steps, timer.Wrap());
 #else
   static bool printed = false;
   auto utf8_text = text;
@@ -224,17 +399,165 @@ GeneratedAudio OfflineTts::Generate(
       printed = true;
     }
   }
-  if (IsUtf8(utf8_text) && IsUtf8(utf8_prompt_text)) {
-    return impl_->Generate(utf8_text, utf8_prompt_text, prompt_samples,
-                           sample_rate, speed, num_steps, std::move(callback));
-  } else {
+  if (!IsUtf8(utf8_text) || !IsUtf8(utf8_prompt_text)) {
     SHERPA_ONNX_LOGE(
         "Non UTF8 encoded string is received. You would not get expected "
         "results!");
-    return impl_->Generate(utf8_text, utf8_prompt_text, prompt_samples,
-                           sample_rate, speed, num_steps, std::move(callback));
   }
+  ans = impl_->Generate(utf8_text, utf8_prompt_text, prompt_samples,
+                        sample_rate, speed, num_steps, timer.Wrap());
+#endif
+
+  timer.SetStatistics(&ans);
+  return ans;
+}
+
+// If low_latency is true, synthesize the first clause of text alone so that
+// its audio is passed to the callback before the remaining text is
+// processed. The progress of text is mapped to [offset, offset + weight].
+static GeneratedAudio GenerateClauseFirst(const OfflineTtsImpl &impl,
+                                          const std::string &text,
+                                          int64_t sid, float speed,
+                                          bool low_latency, bool debug,
+                                          float offset, float weight,
+                                          GenerationTimer *timer) {
+  std::string head;
+  std::string tail;
+  if (!low_latency || !SplitFirstClause(text, &head, &tail)) {
+    return impl.Generate(text, sid, speed, timer->Wrap(offset, weight));
+  }
+
+  if (debug) {
+#if __OHOS__
+    SHERPA_ONNX_LOGE("First clause: %{public}s", head.c_str());
+#else
+    SHERPA_ONNX_LOGE("First clause: %s", head.c_str());
 #endif
+  }
+
+  // The progress of each part is weighted by its length
+  float head_weight = weight * head.size() / text.size();
+
+  GeneratedAudio ans =
+      impl.Generate(head, sid, speed, timer->Wrap(offset, head_weight));
+
+  if (!timer->Stopped()) {
+    GeneratedAudio rest =
+        impl.Generate(tail, sid, speed,
+                      timer->Wrap(offset + head_weight, weight - head_weight));
+
+    if (!rest.samples.empty()) {
+      ans.sample_rate = rest.sample_rate;
+      ans.samples.insert(ans.samples.end(), rest.samples.begin(),
+                         rest.samples.end());
+    }
+  }
+
+  return ans;
+}
+
+// Split text into sentences and look up each of them in the cache before
+// synthesizing it.
+//
+// Sentences are synthesized one at a time so that the audio of each of them
+// can be cached, so max_num_sentences and num_workers are not used here.
+// If low_latency is true, the first clause of the first sentence is
+// synthesized alone.
+static GeneratedAudio GenerateWithAudioCache(const OfflineTtsImpl &impl,
+                                             const OfflineTtsAudioCache &cache,
+                                             const OfflineTtsConfig &config,
+                                             const std::string &text,
+                                             int64_t sid, float speed,
+                                             GenerationTimer *timer) {
+  // Merge spaces so that texts differing only in spaces share cache entries
+  static const PunctuationMap kSpaceMerger({}, /*merge_spaces*/ true);
+
+  std::vector<std::string> sentences = SplitSentences(text);
+  if (sentences.empty()) {
+    return impl.Generate(text, sid, speed, timer->Wrap());
+  }
+
+  int32_t total_size = 0;
+  for (auto &s : sentences) {
+    s = kSpaceMerger.Apply(s);
+    total_size += s.size();
+  }
+
+  std::string prefix = GetAudioCacheKeyPrefix(config, sid, speed);
+
+  GeneratedAudio ans;
+  ans.sample_rate = impl.SampleRate();
+
+  // The progress of each sentence is weighted by its length
+  float offset = 0;
+
+  for (int32_t i = 0; i != static_cast<int32_t>(sentences.size()); ++i) {
+    const auto &s = sentences[i];
+    float weight = static_cast<float>(s.size()) / total_size;
+    float this_offset = offset;
+    offset += weight;
+
+    std::string key = prefix + s;
+
+    std::vector<float> samples;
+    if (cache.Get(key, &samples)) {
+      if (config.model.debug) {
+#if __OHOS__
+        SHERPA_ONNX_LOGE("Audio cache hit: %{public}s", s.c_str());
+#else
+        SHERPA_ONNX_LOGE("Audio cache hit: %s", s.c_str());
+#endif
+      }
+
+      ans.samples.insert(ans.samples.end(), samples.begin(), samples.end());
+      timer->Wrap(this_offset, weight)(samples.data(), samples.size(), 1.0);
+    } else {
+      GeneratedAudio audio = GenerateClauseFirst(
+          impl, s, sid, speed, config.low_latency && i == 0,
+          config.model.debug, this_offset, weight, timer);
+
+      // Don't cache incomplete audio if the callback asks us to stop
+      if (!audio.samples.empty() && !timer->Stopped()) {
+        cache.Put(key, audio.samples);
+      }
+
+      ans.samples.insert(ans.samples.end(), audio.samples.begin(),
+                         audio.samples.end());
+    }
+
+    if (timer->Stopped()) {
+      break;
+    }
+  }
+
+  if (config.model.debug) {
+#if __OHOS__
+    SHERPA_ONNX_LOGE("Audio cache: %{public}s", cache.Stats().c_str());
+#else
+    SHERPA_ONNX_LOGE("Audio cache: %s", cache.Stats().c_str());
+#endif
+  }
+
+  return ans;
+}
+
+GeneratedAudio OfflineTts::GenerateUtf8(const std::string &text, int64_t sid,
+                                        float speed,
+                                        GeneratedAudioCallback callback) const {
+  GenerationTimer timer(std::move(callback));
+
+  if (audio_cache_) {
+    GeneratedAudio ans = GenerateWithAudioCache(
+        *impl_, *audio_cache_, config_, text, sid, speed, &timer);
+    timer.SetStatistics(&ans);
+    return ans;
+  }
+
+  GeneratedAudio ans =
+      GenerateClauseFirst(*impl_, text, sid, speed, config_.low_latency,
+                          config_.model.debug, 0, 1, &timer);
+  timer.SetStatistics(&ans);
+  return ans;
 }
 
 int32_t OfflineTts::SampleRate() const { return impl_->SampleRate(); }
@@ -37,15 +37,77 @@ struct OfflineTtsConfig {
   // the duration of the new interval is old_duration * silence_scale.
   float silence_scale = 0.2;
 
+  // Number of threads for processing batches of sentences in parallel.
+  // Each batch contains at most max_num_sentences sentences. Audio samples
+  // are still passed to the callback in order.
+  //
+  // Note: Each worker runs the model with model.num_threads threads.
+  int32_t num_workers = 1;
+
+  // If true, the first clause of the input text, i.e., the text before the
+  // first comma or sentence-ending punctuation, is synthesized alone and
+  // passed to the callback before the remaining text is processed.
+  // It reduces the time to the first audio sample for long input text.
+  //
+  // Note: The remaining text is processed only after the first clause, so
+  // the model is run twice and the total generation time is usually a bit
+  // longer than without it. Use it when the audio is played while it is
+  // being generated.
+  bool low_latency = false;
+
+  // Maximum number of (sentence, voice) pairs whose token IDs are cached
+  // by the text frontend. 0 disables the cache. If it is positive, the
+  // input text is split into sentences and each sentence is converted to
+  // token IDs separately.
+  int32_t frontend_cache_size = 0;
+
+  // Optional. A text file. Each non-empty line is converted to token IDs
+  // at startup to pre-warm the frontend cache. Used only if
+  // frontend_cache_size > 0. Note that rule_fsts and rule_fars are not
+  // applied to these lines.
+  std::string frontend_cache_warmup;
+
+  // Maximum number of sentences whose generated audio is cached in memory.
+  // If it is positive, the input text is split into sentences and each
+  // sentence is looked up in the cache before it is synthesized.
+  // Sentences are then synthesized one at a time, so max_num_sentences and
+  // num_workers are ignored. The cache key contains the model files and
+  // the parameters that affect the audio, but not num_threads, debug or
+  // provider. 0 disables the cache.
+  int32_t audio_cache_size = 0;
+
+  // Optional. An existing directory. If not empty, cached audio is also
+  // saved to this directory so that it can be reused after it is evicted
+  // from memory or after a restart. Used only if audio_cache_size > 0.
+  std::string audio_cache_dir;
+
+  // Maximum number of files in audio_cache_dir. When a new file is saved,
+  // it may replace an old one, so the directory does not grow without
+  // bound.
+  int32_t audio_cache_max_files = 10000;
+
   OfflineTtsConfig() = default;
   OfflineTtsConfig(const OfflineTtsModelConfig &model,
                    const std::string &rule_fsts, const std::string &rule_fars,
-                   int32_t max_num_sentences, float silence_scale)
+                   int32_t max_num_sentences, float silence_scale,
+                   int32_t num_workers = 1, bool low_latency = false,
+                   int32_t frontend_cache_size = 0,
+                   const std::string &frontend_cache_warmup = "",
+                   int32_t audio_cache_size = 0,
+                   const std::string &audio_cache_dir = "",
+                   int32_t audio_cache_max_files = 10000)
       : model(model),
         rule_fsts(rule_fsts),
         rule_fars(rule_fars),
         max_num_sentences(max_num_sentences),
-        silence_scale(silence_scale) {}
+        silence_scale(silence_scale),
+        num_workers(num_workers),
+        low_latency(low_latency),
+        frontend_cache_size(frontend_cache_size),
+        frontend_cache_warmup(frontend_cache_warmup),
+        audio_cache_size(audio_cache_size),
+        audio_cache_dir(audio_cache_dir),
+        audio_cache_max_files(audio_cache_max_files) {}
 
   void Register(ParseOptions *po);
   bool Validate() const;
@@ -57,12 +119,25 @@ struct GeneratedAudio {
   std::vector<float> samples;
   int32_t sample_rate;
 
+  // The following statistics are set by OfflineTts::Generate()
+
+  // Seconds from the start of Generate() until the first audio samples
+  // are available, i.e., until the first call of the callback
+  float time_to_first_sample = 0;
+
+  // Seconds spent in Generate()
+  float elapsed_seconds = 0;
+
+  // Real-time factor, i.e., elapsed_seconds / (duration of the audio)
+  float rtf = 0;
+
   // Silence means pause here.
   // If scale > 1, then it increases the duration of a pause
   // If scale < 1, then it reduces the duration of a pause
   GeneratedAudio ScaleSilence(float scale) const;
 };
 
+class OfflineTtsAudioCache;
 class OfflineTtsImpl;
 
 // If the callback returns 0, then it stops generating
@@ -123,7 +198,17 @@ class OfflineTts {
   int32_t NumSpeakers() const;
 
  private:
+  // text is UTF-8 encoded
+  GeneratedAudio GenerateUtf8(const std::string &text, int64_t sid,
+                              float speed,
+                              GeneratedAudioCallback callback) const;
+
+ private:
+  OfflineTtsConfig config_;
   std::unique_ptr<OfflineTtsImpl> impl_;
+
+  // Not null if config_.audio_cache_size > 0
+  std::unique_ptr<OfflineTtsAudioCache> audio_cache_;
 };
 
 }  // namespace sherpa_onnx
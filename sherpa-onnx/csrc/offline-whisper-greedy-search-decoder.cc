@@ -31,6 +31,9 @@ OfflineWhisperGreedySearchDecoder::Decode(Ort::Value cross_k,
   // For non-multilingual models, initial_tokens contains [sot]
   std::vector<int64_t> initial_tokens = model_->GetInitialTokens();
 
+  std::pair<Ort::Value, Ort::Value> self_kv_cache{nullptr, nullptr};
+  bool has_self_kv_cache = false;
+
   if (model_->IsMultiLingual()) {
     if (!config_.language.empty()) {
       const auto &lang2id = model_->GetLang2ID();
@@ -45,7 +48,11 @@ OfflineWhisperGreedySearchDecoder::Decode(Ort::Value cross_k,
       // 0: sot, 1: lang_id, 2: task, 3: no_timestamps
       initial_tokens[1] = lang_id;
     } else {
-      int32_t lang_id = model_->DetectLanguage(cross_k, cross_v);
+      // The language is detected from the same encoder output that is used
+      // for decoding below, so we also reuse the self kv cache from it.
+      int32_t lang_id =
+          model_->DetectLanguage(cross_k, cross_v, &self_kv_cache);
+      has_self_kv_cache = true;
 
       // 0: sot, 1: lang_id, 2: task, 3: no_timestamps
       initial_tokens[1] = lang_id;
@@ -76,7 +83,9 @@ OfflineWhisperGreedySearchDecoder::Decode(Ort::Value cross_k,
       model_->Allocator(), offset_shape.data(), offset_shape.size());
   *(offset.GetTensorMutableData<int64_t>()) = 0;
 
-  auto self_kv_cache = model_->GetInitialSelfKVCache();
+  if (!has_self_kv_cache) {
+    self_kv_cache = model_->GetInitialSelfKVCache();
+  }
 
   auto decoder_out = model_->ForwardDecoder(
       std::move(tokens), std::move(self_kv_cache.first),
@@ -74,8 +74,36 @@ class OfflineWhisperModel {
                  Ort::Value n_layer_self_v_cache, Ort::Value n_layer_cross_k,
                  Ort::Value n_layer_cross_v, Ort::Value offset) const;
 
-  int32_t DetectLanguage(Ort::Value &cross_k,   // NOLINT
-                         Ort::Value &cross_v);  // NOLINT
+  /** Detect the language of a single utterance.
+   *
+   * @param cross_k Returned by ForwardEncoder()
+   * @param cross_v Returned by ForwardEncoder()
+   * @param self_kv_cache If not null, it is set to the self kv cache of the
+   *                      decoder after detection. It has the same shape as
+   *                      the one from GetInitialSelfKVCache() and can be
+   *                      passed to ForwardDecoder() at offset 0 in place of
+   *                      it, since the decoder overwrites the entries it
+   *                      reads. This saves allocating and zeroing a second
+   *                      cache, which is large for big models.
+   *
+   * @return Return the token ID of the detected language.
+   */
+  int32_t DetectLanguage(
+      Ort::Value &cross_k,  // NOLINT
+      Ort::Value &cross_v,  // NOLINT
+      std::pair<Ort::Value, Ort::Value> *self_kv_cache = nullptr);
+
+  /** Detect the language of each utterance in a batch.
+   *
+   * @param cross_k Returned by ForwardEncoder(). Its shape is
+   *                (n_text_layer, N, n_audio_ctx, n_text_state)
+   * @param cross_v Same shape as cross_k
+   *
+   * @return Return a vector of size N containing the language token ID
+   *         of each utterance.
+   */
+  std::vector<int32_t> DetectLanguages(Ort::Value &cross_k,   // NOLINT
+                                       Ort::Value &cross_v);  // NOLINT
 
   /** Return the initial self kv cache in a pair
    *  - n_layer_self_k_cache A 4-D tensor of shape
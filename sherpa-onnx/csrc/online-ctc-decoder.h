@@ -8,11 +8,12 @@
 #include <memory>
 #include <vector>
 
-#include "kaldi-decoder/csrc/faster-decoder.h"
 #include "onnxruntime_cxx_api.h"  // NOLINT
+#include "sherpa-onnx/csrc/online-ctc-faster-decoder.h"
 
 namespace sherpa_onnx {
 
+class CtcPrefixBeamSearch;
 class OnlineStream;
 
 struct OnlineCtcDecoderResult {
@@ -35,6 +36,10 @@ struct OnlineCtcDecoderResult {
   std::vector<int32_t> timestamps;
 
   int32_t num_trailing_blanks = 0;
+
+  /// Prefixes of the stream. Used only by prefix beam search.
+  /// It is created on the first chunk and reset along with this result.
+  std::shared_ptr<CtcPrefixBeamSearch> prefix_beam_search;
 };
 
 class OnlineCtcDecoder {
@@ -54,8 +59,7 @@ class OnlineCtcDecoder {
                       std::vector<OnlineCtcDecoderResult> *results,
                       OnlineStream **ss = nullptr, int32_t n = 0) = 0;
 
-  virtual std::unique_ptr<kaldi_decoder::FasterDecoder> CreateFasterDecoder()
-      const {
+  virtual std::unique_ptr<OnlineCtcFasterDecoder> CreateFasterDecoder() const {
     return nullptr;
   }
 };
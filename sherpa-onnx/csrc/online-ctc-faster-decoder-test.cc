@@ -0,0 +1,209 @@
+// sherpa-onnx/csrc/online-ctc-faster-decoder-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/online-ctc-faster-decoder.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "fst/fstlib.h"
+#include "gtest/gtest.h"
+#include "kaldi-decoder/csrc/decodable-ctc.h"
+#include "kaldifst/csrc/fstext-utils.h"
+#include "sherpa-onnx/csrc/math.h"
+
+namespace sherpa_onnx {
+
+// A CTC topology for tokens 0, 1, ..., vocab_size - 1, where 0 is blank.
+//
+// State 0 is the start state and is reached after a blank. State i > 0 is
+// reached after token i. Input labels are token IDs plus 1. A token that
+// does not repeat the previous one outputs a word with the same ID.
+static fst::StdVectorFst BuildCtcTopo(int32_t vocab_size) {
+  fst::StdVectorFst ans;
+  for (int32_t s = 0; s != vocab_size; ++s) {
+    ans.AddState();
+    ans.SetFinal(s, fst::TropicalWeight::One());
+  }
+  ans.SetStart(0);
+
+  for (int32_t s = 0; s != vocab_size; ++s) {
+    ans.AddArc(s, fst::StdArc(1, 0, fst::TropicalWeight::One(), 0));
+    for (int32_t i = 1; i != vocab_size; ++i) {
+      int32_t olabel = (i == s) ? 0 : i;
+      ans.AddArc(s, fst::StdArc(i + 1, olabel, fst::TropicalWeight::One(), i));
+    }
+  }
+
+  return ans;
+}
+
+// A graph with num_states states in which every state has an arc for each
+// input label to a random state. Arc and final weights are random, so
+// the best path can change many frames back when new frames arrive.
+static fst::StdVectorFst BuildRandomGraph(int32_t num_states,
+                                          int32_t vocab_size,
+                                          std::mt19937 *gen) {
+  std::uniform_int_distribution<int32_t> state(0, num_states - 1);
+  std::uniform_int_distribution<int32_t> word(0, 3);
+  std::uniform_real_distribution<float> weight(0, 2);
+
+  fst::StdVectorFst ans;
+  for (int32_t s = 0; s != num_states; ++s) {
+    ans.AddState();
+    ans.SetFinal(s, weight(*gen));
+  }
+  ans.SetStart(0);
+
+  for (int32_t s = 0; s != num_states; ++s) {
+    for (int32_t i = 1; i <= vocab_size; ++i) {
+      ans.AddArc(s, fst::StdArc(i, word(*gen), weight(*gen), state(*gen)));
+    }
+  }
+
+  return ans;
+}
+
+// Return log probs of shape (num_frames, vocab_size).
+// If peaky is true, each frame is dominated by a single token.
+static std::vector<float> RandomLogProbs(int32_t num_frames,
+                                         int32_t vocab_size, bool peaky,
+                                         std::mt19937 *gen) {
+  std::uniform_real_distribution<float> dist(-3, 3);
+  std::uniform_int_distribution<int32_t> token(0, vocab_size - 1);
+
+  std::vector<float> ans(num_frames * vocab_size);
+  for (int32_t t = 0; t != num_frames; ++t) {
+    float *p = ans.data() + t * vocab_size;
+    for (int32_t i = 0; i != vocab_size; ++i) {
+      p[i] = dist(*gen);
+    }
+
+    if (peaky) {
+      p[token(*gen)] += 15;
+    }
+
+    LogSoftmax(p, vocab_size);
+  }
+
+  return ans;
+}
+
+// Compute the result from the whole best path, like OnlineCtcFstDecoder
+// did before OnlineCtcFasterDecoder::UpdateBestPath() was added.
+static void GetExpected(kaldi_decoder::FasterDecoder *decoder,
+                        int32_t blank_id, std::vector<int64_t> *tokens,
+                        std::vector<int32_t> *timestamps,
+                        std::vector<int32_t> *words) {
+  fst::VectorFst<fst::LatticeArc> fst_out;
+  ASSERT_TRUE(decoder->GetBestPath(&fst_out));
+
+  std::vector<int32_t> isymbols_out;
+  ASSERT_TRUE(fst::GetLinearSymbolSequence(fst_out, &isymbols_out, words,
+                                           nullptr));
+
+  tokens->clear();
+  timestamps->clear();
+
+  int32_t prev_id = -1;
+  int32_t f = 0;
+  for (auto i : isymbols_out) {
+    i -= 1;
+    if (i != blank_id && i != prev_id) {
+      tokens->push_back(i);
+      timestamps->push_back(f);
+    }
+    prev_id = i;
+    f += 1;
+  }
+}
+
+// Decode random log probs in chunks of random sizes. After each chunk,
+// the result of UpdateBestPath() must match the whole best path.
+//
+// If max_traced_is_chunk_size is true, the best path must not change
+// before the current chunk.
+static void TestChunkedDecoding(const fst::StdVectorFst &graph,
+                                int32_t vocab_size, bool peaky,
+                                bool max_traced_is_chunk_size,
+                                std::mt19937 *gen) {
+  int32_t blank_id = 0;
+  int32_t num_frames = 200;
+  int32_t max_chunk_size = 8;
+
+  kaldi_decoder::FasterDecoderOptions opts;
+  opts.max_active = 50;
+
+  std::uniform_int_distribution<int32_t> chunk(1, max_chunk_size);
+
+  OnlineCtcFasterDecoder decoder(graph, opts, blank_id);
+
+  for (int32_t n = 0; n != 3; ++n) {
+    std::vector<float> log_probs =
+        RandomLogProbs(num_frames, vocab_size, peaky, gen);
+
+    decoder.Reset();
+
+    int32_t offset = 0;
+    while (offset < num_frames) {
+      int32_t num_rows = std::min(chunk(*gen), num_frames - offset);
+
+      kaldi_decoder::DecodableCtc decodable(
+          log_probs.data() + offset * vocab_size, num_rows, vocab_size,
+          offset);
+      decoder.AdvanceDecoding(&decodable);
+      offset += num_rows;
+
+      ASSERT_TRUE(decoder.UpdateBestPath());
+
+      std::vector<int64_t> tokens;
+      std::vector<int32_t> timestamps;
+      std::vector<int32_t> words;
+      GetExpected(&decoder, blank_id, &tokens, &timestamps, &words);
+
+      EXPECT_EQ(decoder.Tokens(), tokens) << "frame: " << offset;
+      EXPECT_EQ(decoder.Timestamps(), timestamps) << "frame: " << offset;
+      EXPECT_EQ(decoder.Words(), words) << "frame: " << offset;
+
+      // The path has one token per frame plus the start token, which is
+      // traced only in the first chunk
+      int32_t num_start_tokens = (offset == num_rows) ? 1 : 0;
+      EXPECT_LE(decoder.NumTracedTokens(), offset + num_start_tokens)
+          << "frame: " << offset;
+      if (max_traced_is_chunk_size) {
+        EXPECT_LE(decoder.NumTracedTokens(), num_rows + num_start_tokens)
+            << "frame: " << offset;
+      }
+    }
+  }
+}
+
+TEST(OnlineCtcFasterDecoder, RandomGraph) {
+  int32_t vocab_size = 5;
+  std::mt19937 gen(0);
+  fst::StdVectorFst graph = BuildRandomGraph(20, vocab_size, &gen);
+
+  TestChunkedDecoding(graph, vocab_size, /*peaky*/ false,
+                      /*max_traced_is_chunk_size*/ false, &gen);
+  TestChunkedDecoding(graph, vocab_size, /*peaky*/ true,
+                      /*max_traced_is_chunk_size*/ false, &gen);
+}
+
+// In a CTC topology, every state on frame t + 1 has the best state on
+// frame t as its predecessor, so the best path never changes before the
+// current chunk and the number of traced tokens does not grow with the
+// length of the utterance.
+TEST(OnlineCtcFasterDecoder, CtcTopo) {
+  int32_t vocab_size = 6;
+  std::mt19937 gen(0);
+  fst::StdVectorFst topo = BuildCtcTopo(vocab_size);
+
+  TestChunkedDecoding(topo, vocab_size, /*peaky*/ false,
+                      /*max_traced_is_chunk_size*/ true, &gen);
+  TestChunkedDecoding(topo, vocab_size, /*peaky*/ true,
+                      /*max_traced_is_chunk_size*/ true, &gen);
+}
+
+}  // namespace sherpa_onnx
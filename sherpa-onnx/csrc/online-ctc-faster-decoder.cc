@@ -0,0 +1,152 @@
+// sherpa-onnx/csrc/online-ctc-faster-decoder.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/online-ctc-faster-decoder.h"
+
+#include <limits>
+#include <vector>
+
+namespace sherpa_onnx {
+
+OnlineCtcFasterDecoder::OnlineCtcFasterDecoder(
+    const fst::Fst<fst::StdArc> &fst,
+    const kaldi_decoder::FasterDecoderOptions &opts, int32_t blank_id)
+    : kaldi_decoder::FasterDecoder(fst, opts), blank_id_(blank_id) {}
+
+void OnlineCtcFasterDecoder::Reset() {
+  InitDecoding();
+
+  path_.clear();
+  tokens_.clear();
+  timestamps_.clear();
+  words_.clear();
+  num_traced_tokens_ = 0;
+}
+
+int32_t OnlineCtcFasterDecoder::NumTrailingBlanks() const {
+  return path_.empty() ? 0 : path_.back().num_trailing_blanks;
+}
+
+const OnlineCtcFasterDecoder::Token *OnlineCtcFasterDecoder::BestFinalToken()
+    const {
+  const Token *best = nullptr;
+  double best_cost = std::numeric_limits<double>::infinity();
+
+  for (const Elem *e = toks_.GetList(); e != nullptr; e = e->tail) {
+    double cost = e->val->cost_ + fst_.Final(e->key).Value();
+    if (cost < best_cost) {
+      best_cost = cost;
+      best = e->val;
+    }
+  }
+
+  return best;
+}
+
+bool OnlineCtcFasterDecoder::UpdateBestPath() {
+  const Token *tok = BestFinalToken();
+  if (tok == nullptr) {
+    return false;
+  }
+
+  new_tokens_.clear();
+  new_frames_.clear();
+
+  // Walk back until we reach a token on the previous best path. Both paths
+  // are sorted by frame, so k only moves backwards.
+  int32_t frame = NumFramesDecoded();
+  int32_t k = static_cast<int32_t>(path_.size()) - 1;
+  bool found = false;
+
+  for (; tok != nullptr; tok = tok->prev_) {
+    while (k >= 0 && path_[k].frame > frame) {
+      --k;
+    }
+
+    for (int32_t j = k; j >= 0 && path_[j].frame == frame; --j) {
+      if (path_[j].state == tok->arc_.nextstate) {
+        k = j;
+        found = true;
+        break;
+      }
+    }
+
+    if (found) {
+      break;
+    }
+
+    new_tokens_.push_back(tok);
+    new_frames_.push_back(frame);
+
+    if (tok->arc_.ilabel != 0) {
+      // It is created by an emitting arc, so its predecessor is from the
+      // previous frame.
+      frame -= 1;
+    }
+  }
+
+  num_traced_tokens_ = static_cast<int32_t>(new_tokens_.size());
+
+  if (!found) {
+    k = -1;
+  }
+
+  path_.resize(k + 1);
+
+  int32_t last_id = -1;
+  int32_t num_trailing_blanks = 0;
+  if (k >= 0) {
+    const auto &e = path_[k];
+    tokens_.resize(e.num_tokens);
+    timestamps_.resize(e.num_tokens);
+    words_.resize(e.num_words);
+    last_id = e.last_id;
+    num_trailing_blanks = e.num_trailing_blanks;
+  } else {
+    tokens_.clear();
+    timestamps_.clear();
+    words_.clear();
+  }
+
+  for (int32_t i = static_cast<int32_t>(new_tokens_.size()) - 1; i >= 0; --i) {
+    const auto &arc = new_tokens_[i]->arc_;
+    int32_t f = new_frames_[i];
+
+    if (arc.ilabel != 0) {
+      // Input labels are token IDs plus 1 since 0 is reserved for epsilon
+      int32_t id = arc.ilabel - 1;
+
+      if (id == blank_id_) {
+        num_trailing_blanks += 1;
+      } else {
+        num_trailing_blanks = 0;
+
+        if (id != last_id) {
+          tokens_.push_back(id);
+          timestamps_.push_back(f - 1);
+        }
+      }
+
+      last_id = id;
+    }
+
+    if (arc.olabel != 0) {
+      words_.push_back(arc.olabel);
+    }
+
+    PathEntry e;
+    e.frame = f;
+    e.state = arc.nextstate;
+    e.num_tokens = static_cast<int32_t>(tokens_.size());
+    e.num_words = static_cast<int32_t>(words_.size());
+    e.last_id = last_id;
+    e.num_trailing_blanks = num_trailing_blanks;
+
+    path_.push_back(e);
+  }
+
+  return true;
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,98 @@
+// sherpa-onnx/csrc/online-ctc-faster-decoder.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_ONLINE_CTC_FASTER_DECODER_H_
+#define SHERPA_ONNX_CSRC_ONLINE_CTC_FASTER_DECODER_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "fst/fst.h"
+#include "kaldi-decoder/csrc/faster-decoder.h"
+
+namespace sherpa_onnx {
+
+/** A FasterDecoder for streaming CTC decoding with an HLG/HL graph.
+ *
+ * Partial results are needed after every chunk. Instead of converting the
+ * whole best path each time, it keeps the best path traced back last time
+ * and walks back from the current best token only until it meets that path.
+ * The part before the meeting point cannot change any more, so the cost
+ * depends on how far back the best path changes, not on the length of the
+ * utterance.
+ *
+ * A token on a path is identified by the number of frames decoded when it
+ * was created and by its destination state. Tokens of the same frame are
+ * unique per state, so two paths sharing such a pair share everything
+ * before it.
+ */
+class OnlineCtcFasterDecoder : public kaldi_decoder::FasterDecoder {
+ public:
+  OnlineCtcFasterDecoder(const fst::Fst<fst::StdArc> &fst,
+                         const kaldi_decoder::FasterDecoderOptions &opts,
+                         int32_t blank_id);
+
+  // Call it before decoding a new utterance.
+  void Reset();
+
+  /** Update the best path with the frames decoded so far.
+   *
+   * @return Return false if no token is in a final state. The previous best
+   *         path is kept in that case.
+   */
+  bool UpdateBestPath();
+
+  // Token IDs of the best path, with blanks and repeats removed
+  const std::vector<int64_t> &Tokens() const { return tokens_; }
+
+  // timestamps_[i] is the frame index of tokens_[i]
+  const std::vector<int32_t> &Timestamps() const { return timestamps_; }
+
+  // Word IDs, i.e., non-epsilon output labels of the best path
+  const std::vector<int32_t> &Words() const { return words_; }
+
+  // Number of blank frames at the end of the best path
+  int32_t NumTrailingBlanks() const;
+
+  // Number of tokens visited by the last call of UpdateBestPath()
+  int32_t NumTracedTokens() const { return num_traced_tokens_; }
+
+ private:
+  struct PathEntry {
+    // Number of frames decoded when the token was created
+    int32_t frame;
+    fst::StdArc::StateId state;
+
+    // Sizes of tokens_ and words_ after this token is processed
+    int32_t num_tokens;
+    int32_t num_words;
+
+    // Token ID of the last frame up to this token. -1 if there is none.
+    int32_t last_id;
+    int32_t num_trailing_blanks;
+  };
+
+  // Return the token with the least cost in a final state, or nullptr
+  const Token *BestFinalToken() const;
+
+ private:
+  int32_t blank_id_;
+
+  // From the start token to the best token of the last UpdateBestPath()
+  std::vector<PathEntry> path_;
+
+  std::vector<int64_t> tokens_;
+  std::vector<int32_t> timestamps_;
+  std::vector<int32_t> words_;
+
+  int32_t num_traced_tokens_ = 0;
+
+  // Tokens after the meeting point, in reverse order. Reused across calls.
+  std::vector<const Token *> new_tokens_;
+  std::vector<int32_t> new_frames_;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_ONLINE_CTC_FASTER_DECODER_H_
@@ -23,8 +23,7 @@ class OnlineCtcFstDecoder : public OnlineCtcDecoder {
               int32_t vocab_size, std::vector<OnlineCtcDecoderResult> *results,
               OnlineStream **ss = nullptr, int32_t n = 0) override;
 
-  std::unique_ptr<kaldi_decoder::FasterDecoder> CreateFasterDecoder()
-      const override;
+  std::unique_ptr<OnlineCtcFasterDecoder> CreateFasterDecoder() const override;
 
  private:
   OnlineCtcFstDecoderConfig config_;
@@ -0,0 +1,59 @@
+// sherpa-onnx/csrc/online-ctc-prefix-beam-search-decoder.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/online-ctc-prefix-beam-search-decoder.h"
+
+#include <memory>
+#include <vector>
+
+#include "sherpa-onnx/csrc/ctc-prefix-beam-search.h"
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/online-stream.h"
+
+namespace sherpa_onnx {
+
+void OnlineCtcPrefixBeamSearchDecoder::Decode(
+    const float *log_probs, int32_t batch_size, int32_t num_frames,
+    int32_t vocab_size, std::vector<OnlineCtcDecoderResult> *results,
+    OnlineStream **ss /*= nullptr*/, int32_t n /*= 0*/) {
+  if (batch_size != results->size()) {
+    SHERPA_ONNX_LOGE("Size mismatch! log_probs.size(0) %d, results.size(0): %d",
+                     batch_size, static_cast<int32_t>(results->size()));
+    SHERPA_ONNX_EXIT(-1);
+  }
+
+  if (ss != nullptr && n != batch_size) {
+    SHERPA_ONNX_LOGE("Size mismatch! log_probs.size(0) %d, n: %d", batch_size,
+                     n);
+    SHERPA_ONNX_EXIT(-1);
+  }
+
+  const float *p = log_probs;
+
+  for (int32_t b = 0; b != batch_size; ++b, p += num_frames * vocab_size) {
+    auto &r = (*results)[b];
+
+    if (!r.prefix_beam_search) {
+      ContextGraphPtr context_graph;
+      if (ss != nullptr) {
+        context_graph = ss[b]->GetContextGraph();
+      }
+
+      r.prefix_beam_search = std::make_shared<CtcPrefixBeamSearch>(
+          blank_id_, max_active_paths_, blank_skip_threshold_, context_graph,
+          lm_, lm_scale_);
+    }
+
+    auto &search = *r.prefix_beam_search;
+    search.Decode(p, num_frames, vocab_size);
+
+    // Frame indexes in the search start from 0 after each reset, which is
+    // the same as frame_offset
+    search.GetBest(&r.tokens, &r.timestamps);
+    r.num_trailing_blanks = search.NumTrailingBlanks();
+    r.frame_offset += num_frames;
+  }
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,46 @@
+// sherpa-onnx/csrc/online-ctc-prefix-beam-search-decoder.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_ONLINE_CTC_PREFIX_BEAM_SEARCH_DECODER_H_
+#define SHERPA_ONNX_CSRC_ONLINE_CTC_PREFIX_BEAM_SEARCH_DECODER_H_
+
+#include <vector>
+
+#include "sherpa-onnx/csrc/online-ctc-decoder.h"
+#include "sherpa-onnx/csrc/online-lm.h"
+
+namespace sherpa_onnx {
+
+class OnlineCtcPrefixBeamSearchDecoder : public OnlineCtcDecoder {
+ public:
+  /**
+   * @param lm Optional. Not owned. If not nullptr, it is used for shallow
+   *           fusion.
+   *
+   * See CtcPrefixBeamSearch for the other arguments.
+   */
+  OnlineCtcPrefixBeamSearchDecoder(int32_t blank_id, int32_t max_active_paths,
+                                   float blank_skip_threshold,
+                                   OnlineLM *lm = nullptr, float lm_scale = 0)
+      : blank_id_(blank_id),
+        max_active_paths_(max_active_paths),
+        blank_skip_threshold_(blank_skip_threshold),
+        lm_(lm),
+        lm_scale_(lm_scale) {}
+
+  void Decode(const float *log_probs, int32_t batch_size, int32_t num_frames,
+              int32_t vocab_size, std::vector<OnlineCtcDecoderResult> *results,
+              OnlineStream **ss = nullptr, int32_t n = 0) override;
+
+ private:
+  int32_t blank_id_;
+  int32_t max_active_paths_;
+  float blank_skip_threshold_;
+  OnlineLM *lm_;  // not owned
+  float lm_scale_;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_ONLINE_CTC_PREFIX_BEAM_SEARCH_DECODER_H_
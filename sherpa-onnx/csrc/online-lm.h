@@ -21,6 +21,10 @@ class OnlineLM {
 
   static std::unique_ptr<OnlineLM> Create(const OnlineLMConfig &config);
 
+  template <typename Manager>
+  static std::unique_ptr<OnlineLM> Create(Manager *mgr,
+                                          const OnlineLMConfig &config);
+
   // init states for classic rescore
   virtual std::vector<Ort::Value> GetInitStates() = 0;
 
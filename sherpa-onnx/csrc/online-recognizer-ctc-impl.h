@@ -7,8 +7,10 @@
 
 #include <algorithm>
 #include <cassert>
+#include <fstream>
 #include <ios>
 #include <memory>
+#include <regex>  // NOLINT
 #include <sstream>
 #include <string>
 #include <utility>
@@ -21,8 +23,12 @@
 #include "sherpa-onnx/csrc/online-ctc-fst-decoder.h"
 #include "sherpa-onnx/csrc/online-ctc-greedy-search-decoder.h"
 #include "sherpa-onnx/csrc/online-ctc-model.h"
+#include "sherpa-onnx/csrc/online-ctc-prefix-beam-search-decoder.h"
+#include "sherpa-onnx/csrc/online-lm.h"
 #include "sherpa-onnx/csrc/online-recognizer-impl.h"
 #include "sherpa-onnx/csrc/symbol-table.h"
+#include "sherpa-onnx/csrc/utils.h"
+#include "ssentencepiece/csrc/ssentencepiece.h"
 
 namespace sherpa_onnx {
 
@@ -81,6 +87,33 @@ class OnlineRecognizerCtcImpl : public OnlineRecognizerImpl {
         model_(OnlineCtcModel::Create(config.model_config)),
         sym_(config.model_config.tokens),
         endpoint_(config_.endpoint_config) {
+    if (!config_.model_config.tokens_buf.empty()) {
+      /// assuming tokens_buf and tokens are guaranteed not being both empty
+      sym_ = SymbolTable(config_.model_config.tokens_buf, false);
+    }
+
+    if (UsePrefixBeamSearch()) {
+      if (!config_.model_config.bpe_vocab.empty()) {
+        bpe_encoder_ = std::make_unique<ssentencepiece::Ssentencepiece>(
+            config_.model_config.bpe_vocab);
+      }
+
+      if (!config_.hotwords_buf.empty()) {
+        InitHotwordsFromBufStr();
+      } else if (!config_.hotwords_file.empty()) {
+        InitHotwords();
+      }
+
+      if (!config_.lm_config.model.empty()) {
+        if (!config_.lm_config.shallow_fusion) {
+          SHERPA_ONNX_LOGE(
+              "CTC models support only shallow fusion for LM. Use shallow "
+              "fusion.");
+        }
+        lm_ = OnlineLM::Create(config.lm_config);
+      }
+    }
+
     PostInit();
   }
 
@@ -92,11 +125,74 @@ class OnlineRecognizerCtcImpl : public OnlineRecognizerImpl {
         model_(OnlineCtcModel::Create(mgr, config.model_config)),
         sym_(mgr, config.model_config.tokens),
         endpoint_(config_.endpoint_config) {
+    if (!config_.model_config.tokens_buf.empty()) {
+      /// assuming tokens_buf and tokens are guaranteed not being both empty
+      sym_ = SymbolTable(config_.model_config.tokens_buf, false);
+    }
+
+    if (UsePrefixBeamSearch()) {
+      if (!config_.model_config.bpe_vocab.empty()) {
+        auto buf = ReadFile(mgr, config_.model_config.bpe_vocab);
+        std::istringstream iss(std::string(buf.begin(), buf.end()));
+        bpe_encoder_ = std::make_unique<ssentencepiece::Ssentencepiece>(iss);
+      }
+
+      if (!config_.hotwords_buf.empty()) {
+        InitHotwordsFromBufStr();
+      } else if (!config_.hotwords_file.empty()) {
+        InitHotwords(mgr);
+      }
+
+      if (!config_.lm_config.model.empty()) {
+        if (!config_.lm_config.shallow_fusion) {
+          SHERPA_ONNX_LOGE(
+              "CTC models support only shallow fusion for LM. Use shallow "
+              "fusion.");
+        }
+        lm_ = OnlineLM::Create(mgr, config.lm_config);
+      }
+    }
+
     PostInit();
   }
 
   std::unique_ptr<OnlineStream> CreateStream() const override {
-    auto stream = std::make_unique<OnlineStream>(config_.feat_config);
+    auto stream =
+        std::make_unique<OnlineStream>(config_.feat_config, hotwords_graph_);
+    stream->SetStates(model_->GetInitStates());
+    stream->SetFasterDecoder(decoder_->CreateFasterDecoder());
+
+    return stream;
+  }
+
+  std::unique_ptr<OnlineStream> CreateStream(
+      const std::string &hotwords) const override {
+    if (!UsePrefixBeamSearch()) {
+      SHERPA_ONNX_LOGE(
+          "Hotwords are used only with modified_beam_search. Ignore them.");
+      return CreateStream();
+    }
+
+    auto hws = std::regex_replace(hotwords, std::regex("/"), "\n");
+    std::istringstream is(hws);
+    std::vector<std::vector<int32_t>> current;
+    std::vector<float> current_scores;
+    if (!EncodeHotwords(is, config_.model_config.modeling_unit, sym_,
+                        bpe_encoder_.get(), &current, &current_scores)) {
+      SHERPA_ONNX_LOGE("Encode hotwords failed, skipping, hotwords are : %s",
+                       hotwords.c_str());
+    }
+
+    if (current.empty()) {
+      return CreateStream();
+    }
+
+    // The hotwords given by the config are shared by all streams and
+    // are not re-built here
+    auto context_graph = std::make_shared<ContextGraph>(
+        current, config_.hotwords_score, current_scores, hotwords_graph_);
+    auto stream =
+        std::make_unique<OnlineStream>(config_.feat_config, context_graph);
     stream->SetStates(model_->GetInitStates());
     stream->SetFasterDecoder(decoder_->CreateFasterDecoder());
 
@@ -241,12 +337,14 @@ class OnlineRecognizerCtcImpl : public OnlineRecognizerImpl {
   }
 
  private:
-  void PostInit() {
-    if (!config_.model_config.tokens_buf.empty()) {
-      /// assuming tokens_buf and tokens are guaranteed not being both empty
-      sym_ = SymbolTable(config_.model_config.tokens_buf, false);
-    }
+  // For CTC models, modified_beam_search means prefix beam search.
+  // It is not used if an FST graph is given.
+  bool UsePrefixBeamSearch() const {
+    return config_.decoding_method == "modified_beam_search" &&
+           config_.ctc_fst_decoder_config.graph.empty();
+  }
 
+  void PostInit() {
     if (!config_.model_config.wenet_ctc.model.empty()) {
       // WeNet CTC models assume input samples are in the range
       // [-32768, 32767], so we set normalize_samples to false
@@ -291,6 +389,10 @@ class OnlineRecognizerCtcImpl : public OnlineRecognizerImpl {
           config_.ctc_fst_decoder_config, blank_id);
     } else if (config_.decoding_method == "greedy_search") {
       decoder_ = std::make_unique<OnlineCtcGreedySearchDecoder>(blank_id);
+    } else if (config_.decoding_method == "modified_beam_search") {
+      decoder_ = std::make_unique<OnlineCtcPrefixBeamSearchDecoder>(
+          blank_id, config_.max_active_paths, config_.blank_skip_threshold,
+          lm_.get(), config_.lm_config.scale);
     } else {
       SHERPA_ONNX_LOGE(
           "Unsupported decoding method: %s for streaming CTC models",
@@ -344,9 +446,72 @@ class OnlineRecognizerCtcImpl : public OnlineRecognizerImpl {
     s->SetCtcResult(results[0]);
   }
 
+  void InitHotwords() {
+    // each line in hotwords_file contains space-separated words
+
+    std::ifstream is(config_.hotwords_file);
+    if (!is) {
+      SHERPA_ONNX_LOGE("Open hotwords file failed: %s",
+                       config_.hotwords_file.c_str());
+      exit(-1);
+    }
+
+    if (!EncodeHotwords(is, config_.model_config.modeling_unit, sym_,
+                        bpe_encoder_.get(), &hotwords_, &boost_scores_)) {
+      SHERPA_ONNX_LOGE(
+          "Failed to encode some hotwords, skip them already, see logs above "
+          "for details.");
+    }
+    hotwords_graph_ = std::make_shared<ContextGraph>(
+        hotwords_, config_.hotwords_score, boost_scores_);
+  }
+
+  template <typename Manager>
+  void InitHotwords(Manager *mgr) {
+    // each line in hotwords_file contains space-separated words
+
+    auto buf = ReadFile(mgr, config_.hotwords_file);
+
+    std::istringstream is(std::string(buf.begin(), buf.end()));
+
+    if (!is) {
+      SHERPA_ONNX_LOGE("Open hotwords file failed: %s",
+                       config_.hotwords_file.c_str());
+      exit(-1);
+    }
+
+    if (!EncodeHotwords(is, config_.model_config.modeling_unit, sym_,
+                        bpe_encoder_.get(), &hotwords_, &boost_scores_)) {
+      SHERPA_ONNX_LOGE(
+          "Failed to encode some hotwords, skip them already, see logs above "
+          "for details.");
+    }
+    hotwords_graph_ = std::make_shared<ContextGraph>(
+        hotwords_, config_.hotwords_score, boost_scores_);
+  }
+
+  void InitHotwordsFromBufStr() {
+    // each line in hotwords_file contains space-separated words
+
+    std::istringstream iss(config_.hotwords_buf);
+    if (!EncodeHotwords(iss, config_.model_config.modeling_unit, sym_,
+                        bpe_encoder_.get(), &hotwords_, &boost_scores_)) {
+      SHERPA_ONNX_LOGE(
+          "Failed to encode some hotwords, skip them already, see logs above "
+          "for details.");
+    }
+    hotwords_graph_ = std::make_shared<ContextGraph>(
+        hotwords_, config_.hotwords_score, boost_scores_);
+  }
+
  private:
   OnlineRecognizerConfig config_;
+  std::vector<std::vector<int32_t>> hotwords_;
+  std::vector<float> boost_scores_;
+  ContextGraphPtr hotwords_graph_;
+  std::unique_ptr<ssentencepiece::Ssentencepiece> bpe_encoder_;
   std::unique_ptr<OnlineCtcModel> model_;
+  std::unique_ptr<OnlineLM> lm_;
   std::unique_ptr<OnlineCtcDecoder> decoder_;
   SymbolTable sym_;
   Endpoint endpoint_;
@@ -4,7 +4,6 @@
 
 #include "sherpa-onnx/csrc/online-recognizer-impl.h"
 
-#include <strstream>
 #include <utility>
 
 #if __ANDROID_API__ >= 9
@@ -16,8 +15,6 @@
 #include "rawfile/raw_file_manager.h"
 #endif
 
-#include "fst/extensions/far/far.h"
-#include "kaldifst/csrc/kaldi-fst-io.h"
 #include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/online-recognizer-ctc-impl.h"
 #include "sherpa-onnx/csrc/online-recognizer-paraformer-impl.h"
@@ -153,45 +150,10 @@ std::unique_ptr<OnlineRecognizerImpl> OnlineRecognizerImpl::Create(
 
 OnlineRecognizerImpl::OnlineRecognizerImpl(const OnlineRecognizerConfig &config)
     : config_(config) {
-  if (!config.rule_fsts.empty()) {
-    std::vector<std::string> files;
-    SplitStringToVector(config.rule_fsts, ",", false, &files);
-    itn_list_.reserve(files.size());
-    for (const auto &f : files) {
-      if (config.model_config.debug) {
-        SHERPA_ONNX_LOGE("rule fst: %s", f.c_str());
-      }
-      itn_list_.push_back(std::make_unique<kaldifst::TextNormalizer>(f));
-    }
-  }
-
-  if (!config.rule_fars.empty()) {
-    if (config.model_config.debug) {
-      SHERPA_ONNX_LOGE("Loading FST archives");
-    }
-    std::vector<std::string> files;
-    SplitStringToVector(config.rule_fars, ",", false, &files);
-
-    itn_list_.reserve(files.size() + itn_list_.size());
-
-    for (const auto &f : files) {
-      if (config.model_config.debug) {
-        SHERPA_ONNX_LOGE("rule far: %s", f.c_str());
-      }
-      std::unique_ptr<fst::FarReader<fst::StdArc>> reader(
-          fst::FarReader<fst::StdArc>::Open(f));
-      for (; !reader->Done(); reader->Next()) {
-        std::unique_ptr<fst::StdConstFst> r(
-            fst::CastOrConvertToConstFst(reader->GetFst()->Copy()));
-
-        itn_list_.push_back(
-            std::make_unique<kaldifst::TextNormalizer>(std::move(r)));
-      }
-    }
-
-    if (config.model_config.debug) {
-      SHERPA_ONNX_LOGE("FST archives loaded!");
-    }
+  if (!config.rule_fsts.empty() || !config.rule_fars.empty()) {
+    itn_ = std::make_unique<InverseTextNormalizer>(
+        config.rule_fsts, config.rule_fars, config.compose_rule_fsts,
+        config.model_config.debug);
   }
 
   if (!config.hr.lexicon.empty() && !config.hr.rule_fsts.empty()) {
@@ -205,47 +167,12 @@ template <typename Manager>
 OnlineRecognizerImpl::OnlineRecognizerImpl(Manager *mgr,
                                            const OnlineRecognizerConfig &config)
     : config_(config) {
-  if (!config.rule_fsts.empty()) {
-    std::vector<std::string> files;
-    SplitStringToVector(config.rule_fsts, ",", false, &files);
-    itn_list_.reserve(files.size());
-    for (const auto &f : files) {
-      if (config.model_config.debug) {
-        SHERPA_ONNX_LOGE("rule fst: %s", f.c_str());
-      }
-      auto buf = ReadFile(mgr, f);
-      std::istrstream is(buf.data(), buf.size());
-      itn_list_.push_back(std::make_unique<kaldifst::TextNormalizer>(is));
-    }
+  if (!config.rule_fsts.empty() || !config.rule_fars.empty()) {
+    itn_ = std::make_unique<InverseTextNormalizer>(
+        mgr, config.rule_fsts, config.rule_fars, config.compose_rule_fsts,
+        config.model_config.debug);
   }
 
-  if (!config.rule_fars.empty()) {
-    std::vector<std::string> files;
-    SplitStringToVector(config.rule_fars, ",", false, &files);
-    itn_list_.reserve(files.size() + itn_list_.size());
-
-    for (const auto &f : files) {
-      if (config.model_config.debug) {
-        SHERPA_ONNX_LOGE("rule far: %s", f.c_str());
-      }
-
-      auto buf = ReadFile(mgr, f);
-
-      std::unique_ptr<std::istream> s(
-          new std::istrstream(buf.data(), buf.size()));
-
-      std::unique_ptr<fst::FarReader<fst::StdArc>> reader(
-          fst::FarReader<fst::StdArc>::Open(std::move(s)));
-
-      for (; !reader->Done(); reader->Next()) {
-        std::unique_ptr<fst::StdConstFst> r(
-            fst::CastOrConvertToConstFst(reader->GetFst()->Copy()));
-
-        itn_list_.push_back(
-            std::make_unique<kaldifst::TextNormalizer>(std::move(r)));
-      }  // for (; !reader->Done(); reader->Next())
-    }    // for (const auto &f : files)
-  }      // if (!config.rule_fars.empty())
   if (!config.hr.lexicon.empty() && !config.hr.rule_fsts.empty()) {
     auto hr_config = config.hr;
     hr_config.debug = config.model_config.debug;
@@ -257,10 +184,8 @@ std::string OnlineRecognizerImpl::ApplyInverseTextNormalization(
     std::string text) const {
   text = RemoveInvalidUtf8Sequences(text);
 
-  if (!itn_list_.empty()) {
-    for (const auto &tn : itn_list_) {
-      text = tn->Normalize(text);
-    }
+  if (itn_) {
+    text = itn_->Apply(text);
   }
 
   return text;
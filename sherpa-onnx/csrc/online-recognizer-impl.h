@@ -9,8 +9,8 @@
 #include <string>
 #include <vector>
 
-#include "kaldifst/csrc/text-normalizer.h"
 #include "sherpa-onnx/csrc/homophone-replacer.h"
+#include "sherpa-onnx/csrc/inverse-text-normalizer.h"
 #include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/online-recognizer.h"
 #include "sherpa-onnx/csrc/online-stream.h"
@@ -37,7 +37,8 @@ class OnlineRecognizerImpl {
 
   virtual std::unique_ptr<OnlineStream> CreateStream(
       const std::string &hotwords) const {
-    SHERPA_ONNX_LOGE("Only transducer models support contextual biasing.");
+    SHERPA_ONNX_LOGE(
+        "Only transducer and CTC models support contextual biasing.");
     exit(-1);
   }
 
@@ -65,7 +66,7 @@ class OnlineRecognizerImpl {
   // for inverse text normalization. Used only if
   // config.rule_fsts is not empty or
   // config.rule_fars is not empty
-  std::vector<std::unique_ptr<kaldifst::TextNormalizer>> itn_list_;
+  std::unique_ptr<InverseTextNormalizer> itn_;
   std::unique_ptr<HomophoneReplacer> hr_;
 };
 
@@ -122,12 +122,13 @@ class OnlineRecognizerTransducerImpl : public OnlineRecognizerImpl {
       decoder_ = std::make_unique<OnlineTransducerModifiedBeamSearchDecoder>(
           model_.get(), lm_.get(), config_.max_active_paths,
           config_.lm_config.scale, config_.lm_config.shallow_fusion, unk_id_,
-          config_.blank_penalty, config_.temperature_scale);
+          config_.blank_penalty, config_.temperature_scale,
+          config_.blank_skip_threshold);
 
     } else if (config.decoding_method == "greedy_search") {
       decoder_ = std::make_unique<OnlineTransducerGreedySearchDecoder>(
           model_.get(), unk_id_, config_.blank_penalty,
-          config_.temperature_scale);
+          config_.temperature_scale, config_.blank_skip_threshold);
 
     } else {
       SHERPA_ONNX_LOGE("Unsupported decoding method: %s",
@@ -175,12 +176,13 @@ class OnlineRecognizerTransducerImpl : public OnlineRecognizerImpl {
       decoder_ = std::make_unique<OnlineTransducerModifiedBeamSearchDecoder>(
           model_.get(), lm_.get(), config_.max_active_paths,
           config_.lm_config.scale, config_.lm_config.shallow_fusion, unk_id_,
-          config_.blank_penalty, config_.temperature_scale);
+          config_.blank_penalty, config_.temperature_scale,
+          config_.blank_skip_threshold);
 
     } else if (config.decoding_method == "greedy_search") {
       decoder_ = std::make_unique<OnlineTransducerGreedySearchDecoder>(
           model_.get(), unk_id_, config_.blank_penalty,
-          config_.temperature_scale);
+          config_.temperature_scale, config_.blank_skip_threshold);
 
     } else {
       SHERPA_ONNX_LOGE("Unsupported decoding method: %s",
@@ -212,28 +214,14 @@ class OnlineRecognizerTransducerImpl : public OnlineRecognizerImpl {
                        hotwords.c_str());
     }
 
-    int32_t num_default_hws = hotwords_.size();
-    int32_t num_hws = current.size();
-
-    current.insert(current.end(), hotwords_.begin(), hotwords_.end());
-
-    if (!current_scores.empty() && !boost_scores_.empty()) {
-      current_scores.insert(current_scores.end(), boost_scores_.begin(),
-                            boost_scores_.end());
-    } else if (!current_scores.empty() && boost_scores_.empty()) {
-      current_scores.insert(current_scores.end(), num_default_hws,
-                            config_.hotwords_score);
-    } else if (current_scores.empty() && !boost_scores_.empty()) {
-      current_scores.insert(current_scores.end(), num_hws,
-                            config_.hotwords_score);
-      current_scores.insert(current_scores.end(), boost_scores_.begin(),
-                            boost_scores_.end());
-    } else {
-      // Do nothing.
+    if (current.empty()) {
+      return CreateStream();
     }
 
+    // The hotwords given by the config are shared by all streams and
+    // are not re-built here
     auto context_graph = std::make_shared<ContextGraph>(
-        current, config_.hotwords_score, current_scores);
+        current, config_.hotwords_score, current_scores, hotwords_graph_);
     auto stream =
         std::make_unique<OnlineStream>(config_.feat_config, context_graph);
     InitOnlineStream(stream.get());
@@ -424,6 +412,7 @@ class OnlineRecognizerTransducerImpl : public OnlineRecognizerImpl {
         nullptr != s->GetContextGraph()) {
       for (auto it = r.hyps.begin(); it != r.hyps.end(); ++it) {
         it->second.context_state = s->GetContextGraph()->Root();
+        it->second.base_context_state = s->GetContextGraph()->BaseRoot();
       }
     }
 
@@ -501,6 +490,7 @@ class OnlineRecognizerTransducerImpl : public OnlineRecognizerImpl {
       // r.hyps has only one element.
       for (auto it = r.hyps.begin(); it != r.hyps.end(); ++it) {
         it->second.context_state = stream->GetContextGraph()->Root();
+        it->second.base_context_state = stream->GetContextGraph()->BaseRoot();
       }
     }
 
@@ -101,6 +101,14 @@ void OnlineRecognizerConfig::Register(ParseOptions *po) {
                "Increasing value will lead to lower deletion at the cost"
                "of higher insertions. "
                "Currently only applicable for transducer models.");
+  po->Register("blank-skip-threshold", &blank_skip_threshold,
+               "Skip frames that are almost surely blank to speed up "
+               "decoding. 0 to disable it. A value such as 0.95 is "
+               "suggested. For CTC models with modified_beam_search, "
+               "only blank is expanded on a frame whose blank probability "
+               "is not less than it. For transducer models, the frame "
+               "after such a frame is treated as blank without running "
+               "the joiner.");
   po->Register("hotwords-score", &hotwords_score,
                "The bonus score for each token in context word/phrase. "
                "Used only when decoding_method is modified_beam_search");
@@ -124,6 +132,11 @@ void OnlineRecognizerConfig::Register(ParseOptions *po) {
       "If not empty, it specifies fst archives for inverse text normalization. "
       "If there are multiple archives, they are separated by a comma.");
 
+  po->Register("compose-rule-fsts", &compose_rule_fsts,
+               "True to compose all rules from --rule-fsts and --rule-fars "
+               "into a single FST at startup, so that inverse text "
+               "normalization runs one FST instead of one per rule.");
+
   po->Register("reset-encoder", &reset_encoder,
                "True to reset encoder_state on an endpoint after empty segment."
                "Done in `Reset()` method, after an endpoint was detected.");
@@ -142,6 +155,12 @@ bool OnlineRecognizerConfig::Validate() const {
     }
   }
 
+  if (blank_skip_threshold < 0 || blank_skip_threshold > 1) {
+    SHERPA_ONNX_LOGE("--blank-skip-threshold should be in [0, 1]. Given: %f",
+                     blank_skip_threshold);
+    return false;
+  }
+
   if (!hotwords_file.empty() && decoding_method != "modified_beam_search") {
     SHERPA_ONNX_LOGE(
         "Please use --decoding-method=modified_beam_search if you"
@@ -206,9 +225,12 @@ std::string OnlineRecognizerConfig::ToString() const {
   os << "hotwords_file=\"" << hotwords_file << "\", ";
   os << "decoding_method=\"" << decoding_method << "\", ";
   os << "blank_penalty=" << blank_penalty << ", ";
+  os << "blank_skip_threshold=" << blank_skip_threshold << ", ";
   os << "temperature_scale=" << temperature_scale << ", ";
   os << "rule_fsts=\"" << rule_fsts << "\", ";
   os << "rule_fars=\"" << rule_fars << "\", ";
+  os << "compose_rule_fsts=" << (compose_rule_fsts ? "True" : "False")
+     << ", ";
   os << "reset_encoder=" << (reset_encoder ? "True" : "False") << ", ";
   os << "hr=" << hr.ToString() << ")";
 
@@ -101,6 +101,12 @@ struct OnlineRecognizerConfig {
 
   float blank_penalty = 0.0;
 
+  // If the blank probability of a frame is not less than it, only blank is
+  // expanded on that frame for CTC models with modified_beam_search, and
+  // the next frame is treated as blank for transducer models.
+  // 0 to disable it.
+  float blank_skip_threshold = 0;
+
   float temperature_scale = 2.0;
 
   // If there are multiple rules, they are applied from left to right.
@@ -109,6 +115,10 @@ struct OnlineRecognizerConfig {
   // If there are multiple FST archives, they are applied from left to right.
   std::string rule_fars;
 
+  // If true and there are multiple rules in rule_fsts and rule_fars, they
+  // are composed into a single FST at load time.
+  bool compose_rule_fsts = false;
+
   // True to reset encoder_state on an endpoint after empty segment.
   // Done in `Reset()` method, after an endpoint was detected,
   // currently only in `OnlineRecognizerTransducerImpl`.
@@ -132,7 +142,8 @@ struct OnlineRecognizerConfig {
       int32_t max_active_paths, const std::string &hotwords_file,
       float hotwords_score, float blank_penalty, float temperature_scale,
       const std::string &rule_fsts, const std::string &rule_fars,
-      bool reset_encoder, const HomophoneReplacerConfig &hr)
+      bool reset_encoder, const HomophoneReplacerConfig &hr,
+      bool compose_rule_fsts = false)
       : feat_config(feat_config),
         model_config(model_config),
         lm_config(lm_config),
@@ -147,6 +158,7 @@ struct OnlineRecognizerConfig {
         temperature_scale(temperature_scale),
         rule_fsts(rule_fsts),
         rule_fars(rule_fars),
+        compose_rule_fsts(compose_rule_fsts),
         reset_encoder(reset_encoder),
         hr(hr) {}
 
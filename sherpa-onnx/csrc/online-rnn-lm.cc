@@ -10,6 +10,15 @@
 #include <utility>
 #include <vector>
 
+#if __ANDROID_API__ >= 9
+#include "android/asset_manager.h"
+#include "android/asset_manager_jni.h"
+#endif
+
+#if __OHOS__
+#include "rawfile/raw_file_manager.h"
+#endif
+
 #include "onnxruntime_cxx_api.h"  // NOLINT
 #include "sherpa-onnx/csrc/file-utils.h"
 #include "sherpa-onnx/csrc/lodr-fst.h"
@@ -27,7 +36,18 @@ class OnlineRnnLM::Impl {
         env_(ORT_LOGGING_LEVEL_ERROR),
         sess_opts_{GetSessionOptions(config)},
         allocator_{} {
-    Init(config);
+    auto buf = ReadFile(config_.model);
+    Init(buf.data(), buf.size());
+  }
+
+  template <typename Manager>
+  Impl(Manager *mgr, const OnlineLMConfig &config)
+      : config_(config),
+        env_(ORT_LOGGING_LEVEL_ERROR),
+        sess_opts_{GetSessionOptions(config)},
+        allocator_{} {
+    auto buf = ReadFile(mgr, config_.model);
+    Init(buf.data(), buf.size());
   }
 
   // shallow fusion scoring function
@@ -160,10 +180,8 @@ class OnlineRnnLM::Impl {
   }
 
  private:
-  void Init(const OnlineLMConfig &config) {
-    auto buf = ReadFile(config_.model);
-
-    sess_ = std::make_unique<Ort::Session>(env_, buf.data(), buf.size(),
+  void Init(void *model_data, size_t model_data_length) {
+    sess_ = std::make_unique<Ort::Session>(env_, model_data, model_data_length,
                                            sess_opts_);
 
     GetInputNames(sess_.get(), &input_names_, &input_names_ptr_);
@@ -237,6 +255,10 @@ class OnlineRnnLM::Impl {
 OnlineRnnLM::OnlineRnnLM(const OnlineLMConfig &config)
     : impl_(std::make_unique<Impl>(config)) {}
 
+template <typename Manager>
+OnlineRnnLM::OnlineRnnLM(Manager *mgr, const OnlineLMConfig &config)
+    : impl_(std::make_unique<Impl>(mgr, config)) {}
+
 OnlineRnnLM::~OnlineRnnLM() = default;
 
 // classic rescore state init
@@ -265,4 +287,14 @@ void OnlineRnnLM::ComputeLMScoreSF(float scale, Hypothesis *hyp) {
   return impl_->ComputeLMScoreSF(scale, hyp);
 }
 
+#if __ANDROID_API__ >= 9
+template OnlineRnnLM::OnlineRnnLM(AAssetManager *mgr,
+                                  const OnlineLMConfig &config);
+#endif
+
+#if __OHOS__
+template OnlineRnnLM::OnlineRnnLM(NativeResourceManager *mgr,
+                                  const OnlineLMConfig &config);
+#endif
+
 }  // namespace sherpa_onnx
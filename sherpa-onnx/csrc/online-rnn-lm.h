@@ -22,6 +22,9 @@ class OnlineRnnLM : public OnlineLM {
 
   explicit OnlineRnnLM(const OnlineLMConfig &config);
 
+  template <typename Manager>
+  OnlineRnnLM(Manager *mgr, const OnlineLMConfig &config);
+
   // init scores for classic rescore
   std::vector<Ort::Value> GetInitStates() override;
 
@@ -0,0 +1,592 @@
+// sherpa-onnx/csrc/online-speaker-diarization-pyannote-impl.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+#ifndef SHERPA_ONNX_CSRC_ONLINE_SPEAKER_DIARIZATION_PYANNOTE_IMPL_H_
+#define SHERPA_ONNX_CSRC_ONLINE_SPEAKER_DIARIZATION_PYANNOTE_IMPL_H_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Eigen/Dense"
+#include "sherpa-onnx/csrc/circular-buffer.h"
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/offline-speaker-segmentation-pyannote-model.h"
+#include "sherpa-onnx/csrc/online-speaker-diarization-impl.h"
+#include "sherpa-onnx/csrc/speaker-embedding-extractor.h"
+#include "sherpa-onnx/csrc/speaker-embedding-kernels.h"
+#include "sherpa-onnx/csrc/speaker-segment-tracker.h"
+
+namespace sherpa_onnx {
+
+class OnlineSpeakerDiarizationPyannoteImpl
+    : public OnlineSpeakerDiarizationImpl {
+ public:
+  using Matrix2D =
+      Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+  using Matrix2DInt32 =
+      Eigen::Matrix<int32_t, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+  using FloatRowVector = Eigen::Matrix<float, 1, Eigen::Dynamic>;
+
+  ~OnlineSpeakerDiarizationPyannoteImpl() override = default;
+
+  explicit OnlineSpeakerDiarizationPyannoteImpl(
+      const OnlineSpeakerDiarizationConfig &config)
+      : config_(config),
+        segmentation_model_(config_.segmentation),
+        embedding_extractor_(config_.embedding),
+        buffer_(segmentation_model_.GetModelMetaData().window_size),
+        tracker_(segmentation_model_.GetModelMetaData().sample_rate,
+                 config_.min_duration_on, config_.min_duration_off) {
+    Init();
+  }
+
+  template <typename Manager>
+  OnlineSpeakerDiarizationPyannoteImpl(
+      Manager *mgr, const OnlineSpeakerDiarizationConfig &config)
+      : config_(config),
+        segmentation_model_(mgr, config_.segmentation),
+        embedding_extractor_(mgr, config_.embedding),
+        buffer_(segmentation_model_.GetModelMetaData().window_size),
+        tracker_(segmentation_model_.GetModelMetaData().sample_rate,
+                 config_.min_duration_on, config_.min_duration_off) {
+    Init();
+  }
+
+  int32_t SampleRate() const override {
+    const auto &meta_data = segmentation_model_.GetModelMetaData();
+
+    return meta_data.sample_rate;
+  }
+
+  bool SetSpeakers(const SpeakerEmbeddingManager &manager) override {
+    int32_t dim = embedding_extractor_.Dim();
+    if (manager.Dim() != dim) {
+      SHERPA_ONNX_LOGE(
+          "Embedding dim mismatch. Speaker manager: %d, embedding "
+          "extractor: %d",
+          manager.Dim(), dim);
+      return false;
+    }
+
+    seeded_speakers_.clear();
+
+    for (const auto &name : manager.GetAllSpeakers()) {
+      std::vector<float> embedding = manager.GetEmbedding(name);
+
+      Speaker s;
+      s.centroid = Eigen::Map<FloatRowVector>(embedding.data(), dim);
+      s.sum = s.centroid;
+      s.name = name;
+      s.fixed = true;
+
+      seeded_speakers_.push_back(std::move(s));
+    }
+
+    speakers_ = seeded_speakers_;
+    tracker_.Reset(speakers_.size());
+
+    return true;
+  }
+
+  void AcceptWaveform(const float *samples, int32_t n) override {
+    const auto &meta_data = segmentation_model_.GetModelMetaData();
+    int32_t window_size = meta_data.window_size;
+    int32_t window_shift = meta_data.window_shift;
+
+    // buffer_ never holds more than one window so that the memory
+    // usage does not depend on the length of the input
+    while (n > 0) {
+      int32_t k = std::min(n, window_size - buffer_.Size());
+      buffer_.Push(samples, k);
+      samples += k;
+      n -= k;
+
+      if (buffer_.Size() == window_size) {
+        std::vector<float> window = buffer_.Get(buffer_.Head(), window_size);
+        ProcessWindow(window.data(), window_size);
+        buffer_.Pop(window_shift);
+
+        if (buffer_.Head() > kMaxBufferHead) {
+          RebaseBuffer();
+        }
+      }
+    }
+  }
+
+  void Flush() override {
+    const auto &meta_data = segmentation_model_.GetModelMetaData();
+    int32_t window_size = meta_data.window_size;
+
+    if (buffer_offset_ + buffer_.Tail() > tracker_.Committed()) {
+      // NOTE: window is zero initialized by default
+      std::vector<float> window(window_size);
+      std::vector<float> s = buffer_.Get(buffer_.Head(), buffer_.Size());
+      std::copy(s.begin(), s.end(), window.begin());
+
+      ProcessWindow(window.data(), s.size());
+    }
+
+    tracker_.Flush();
+
+    buffer_.Pop(buffer_.Size());
+    prev_labels_.resize(0, 0);
+    prev_local2global_.clear();
+  }
+
+  void Reset() override {
+    buffer_.Reset();
+    buffer_offset_ = 0;
+
+    speakers_ = seeded_speakers_;
+    tracker_.Reset(speakers_.size());
+
+    prev_window_start_ = 0;
+    prev_labels_.resize(0, 0);
+    prev_local2global_.clear();
+  }
+
+  bool Empty() const override { return tracker_.Empty(); }
+
+  const OfflineSpeakerDiarizationSegment &Front() const override {
+    return tracker_.Front();
+  }
+
+  void Pop() override { tracker_.Pop(); }
+
+  int32_t NumSpeakers() const override { return speakers_.size(); }
+
+  std::string SpeakerName(int32_t speaker) const override {
+    if (speaker < 0 || speaker >= static_cast<int32_t>(speakers_.size())) {
+      return {};
+    }
+
+    return speakers_[speaker].name;
+  }
+
+ private:
+  struct Speaker {
+    // sum of the normalized embeddings assigned to this speaker
+    FloatRowVector sum;
+
+    // normalized sum
+    FloatRowVector centroid;
+
+    // non-empty only for speakers from SetSpeakers()
+    std::string name;
+
+    // true if the centroid is not updated
+    bool fixed = false;
+  };
+
+  void Init() { InitPowersetMapping(); }
+
+  // CircularBuffer uses int32_t indexes. Move the samples in buffer_ to
+  // its start so that the indexes do not overflow for long streams.
+  void RebaseBuffer() {
+    std::vector<float> s;
+    if (buffer_.Size() > 0) {
+      s = buffer_.Get(buffer_.Head(), buffer_.Size());
+    }
+
+    buffer_offset_ += buffer_.Head();
+    buffer_.Reset();
+    buffer_.Push(s.data(), s.size());
+  }
+
+  // see also
+  // https://github.com/pyannote/pyannote-audio/blob/develop/pyannote/audio/utils/powerset.py#L68
+  void InitPowersetMapping() {
+    const auto &meta_data = segmentation_model_.GetModelMetaData();
+    int32_t num_classes = meta_data.num_classes;
+    int32_t powerset_max_classes = meta_data.powerset_max_classes;
+    int32_t num_speakers = meta_data.num_speakers;
+
+    powerset_mapping_ = Matrix2DInt32(num_classes, num_speakers);
+    powerset_mapping_.setZero();
+
+    int32_t k = 1;
+    for (int32_t i = 1; i <= powerset_max_classes; ++i) {
+      if (i == 1) {
+        for (int32_t j = 0; j != num_speakers; ++j, ++k) {
+          powerset_mapping_(k, j) = 1;
+        }
+      } else if (i == 2) {
+        for (int32_t j = 0; j != num_speakers; ++j) {
+          for (int32_t m = j + 1; m < num_speakers; ++m, ++k) {
+            powerset_mapping_(k, j) = 1;
+            powerset_mapping_(k, m) = 1;
+          }
+        }
+      } else {
+        SHERPA_ONNX_LOGE(
+            "powerset_max_classes = %d is currently not supported!", i);
+        SHERPA_ONNX_EXIT(-1);
+      }
+    }
+  }
+
+  Matrix2D ProcessChunk(const float *p) const {
+    const auto &meta_data = segmentation_model_.GetModelMetaData();
+    int32_t window_size = meta_data.window_size;
+
+    auto memory_info =
+        Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
+
+    std::array<int64_t, 3> shape = {1, 1, window_size};
+
+    Ort::Value x =
+        Ort::Value::CreateTensor(memory_info, const_cast<float *>(p),
+                                 window_size, shape.data(), shape.size());
+
+    Ort::Value out = segmentation_model_.Forward(std::move(x));
+    std::vector<int64_t> out_shape = out.GetTensorTypeAndShapeInfo().GetShape();
+    Matrix2D m(out_shape[1], out_shape[2]);
+    std::copy(out.GetTensorData<float>(), out.GetTensorData<float>() + m.size(),
+              &m(0, 0));
+    return m;
+  }
+
+  Matrix2DInt32 ToMultiLabel(const Matrix2D &m) const {
+    int32_t num_rows = m.rows();
+    Matrix2DInt32 ans(num_rows, powerset_mapping_.cols());
+
+    std::ptrdiff_t col_id;
+
+    for (int32_t i = 0; i != num_rows; ++i) {
+      m.row(i).maxCoeff(&col_id);
+      ans.row(i) = powerset_mapping_.row(col_id);
+    }
+
+    return ans;
+  }
+
+  // If there are multiple speakers at a frame, then this frame is excluded.
+  static Matrix2DInt32 ExcludeOverlap(const Matrix2DInt32 &label) {
+    Matrix2DInt32 ans(label.rows(), label.cols());
+    ans.setZero();
+
+    for (int32_t i = 0; i != label.rows(); ++i) {
+      if (label.row(i).sum() < 2) {
+        ans.row(i) = label.row(i);
+      }
+    }
+
+    return ans;
+  }
+
+  // Index of the first sample of the given frame, relative to the start
+  // of the window
+  int32_t FrameToSample(int32_t frame_index, int32_t num_frames) const {
+    const auto &meta_data = segmentation_model_.GetModelMetaData();
+    int32_t window_size = meta_data.window_size;
+
+    return static_cast<int64_t>(frame_index) * window_size / num_frames;
+  }
+
+  /**
+   * @param p Pointer to the samples of the window. Its length is window_size.
+   * @param num_valid_samples Number of samples in p that are not padding.
+   */
+  void ProcessWindow(const float *p, int32_t num_valid_samples) {
+    int64_t window_start = buffer_offset_ + buffer_.Head();
+
+    Matrix2DInt32 labels = ToMultiLabel(ProcessChunk(p));
+    // labels: (num_frames, num_local_speakers)
+
+    int32_t num_frames = labels.rows();
+
+    int32_t num_valid_frames = 0;
+    while (num_valid_frames < num_frames &&
+           FrameToSample(num_valid_frames, num_frames) < num_valid_samples) {
+      ++num_valid_frames;
+    }
+
+    if (num_valid_frames < num_frames) {
+      labels.bottomRows(num_frames - num_valid_frames).setZero();
+    }
+
+    std::vector<int32_t> local2global =
+        AssignSpeakers(p, labels, window_start);
+
+    int32_t num_speakers = speakers_.size();
+    std::vector<bool> is_active(num_speakers);
+
+    // Only frames that have not been covered by previous windows
+    // are used to generate segments.
+    for (int32_t k = 0; k != num_valid_frames; ++k) {
+      int64_t t = window_start + FrameToSample(k, num_frames);
+      if (t < tracker_.Committed()) {
+        continue;
+      }
+
+      std::fill(is_active.begin(), is_active.end(), false);
+      for (int32_t s = 0; s != labels.cols(); ++s) {
+        if (labels(k, s) && local2global[s] >= 0) {
+          is_active[local2global[s]] = true;
+        }
+      }
+
+      tracker_.Update(t, is_active);
+    }
+
+    tracker_.Commit(window_start + num_valid_samples);
+
+    prev_window_start_ = window_start;
+    prev_labels_ = std::move(labels);
+    prev_local2global_ = std::move(local2global);
+  }
+
+  // Return a vector of size num_local_speakers. ans[i] is the global speaker
+  // index of local speaker i, or -1 if it cannot be determined.
+  std::vector<int32_t> AssignSpeakers(const float *p,
+                                      const Matrix2DInt32 &labels,
+                                      int64_t window_start) {
+    int32_t num_frames = labels.rows();
+    int32_t num_local_speakers = labels.cols();
+    int32_t dim = embedding_extractor_.Dim();
+
+    std::vector<int32_t> ans(num_local_speakers, -1);
+
+    Matrix2DInt32 no_overlap = ExcludeOverlap(labels);
+
+    Matrix2D embeddings(num_local_speakers, dim);
+    std::vector<int32_t> candidates;
+    candidates.reserve(num_local_speakers);
+
+    for (int32_t s = 0; s != num_local_speakers; ++s) {
+      float *embedding = &embeddings(candidates.size(), 0);
+      if (ComputeEmbedding(p, no_overlap, s, embedding)) {
+        candidates.push_back(s);
+      }
+    }
+
+    int32_t num_candidates = candidates.size();
+    std::vector<bool> done(num_candidates, false);
+    float min_score = 1 - config_.threshold;
+
+    if (num_candidates > 0 && !speakers_.empty()) {
+      int32_t num_speakers = speakers_.size();
+      Matrix2D centroids(num_speakers, dim);
+      for (int32_t g = 0; g != num_speakers; ++g) {
+        centroids.row(g) = speakers_[g].centroid;
+      }
+
+      Matrix2D scores =
+          embeddings.topRows(num_candidates) * centroids.transpose();
+
+      // Greedily pick the best (local, global) pair so that two local
+      // speakers of the same window are never mapped to the same
+      // global speaker.
+      std::vector<bool> used(num_speakers, false);
+      while (true) {
+        int32_t best_i = -1;
+        int32_t best_g = -1;
+        float best_score = min_score;
+
+        for (int32_t i = 0; i != num_candidates; ++i) {
+          if (done[i]) {
+            continue;
+          }
+
+          for (int32_t g = 0; g != num_speakers; ++g) {
+            if (!used[g] && scores(i, g) >= best_score) {
+              best_i = i;
+              best_g = g;
+              best_score = scores(i, g);
+            }
+          }
+        }
+
+        if (best_i == -1) {
+          break;
+        }
+
+        done[best_i] = true;
+        used[best_g] = true;
+        ans[candidates[best_i]] = best_g;
+        UpdateSpeaker(best_g, embeddings.row(best_i));
+      }
+    }
+
+    for (int32_t i = 0; i != num_candidates; ++i) {
+      if (done[i]) {
+        continue;
+      }
+
+      if (static_cast<int32_t>(speakers_.size()) < config_.max_num_speakers) {
+        Speaker s;
+        s.sum = embeddings.row(i);
+        s.centroid = s.sum;
+        speakers_.push_back(std::move(s));
+
+        ans[candidates[i]] = speakers_.size() - 1;
+      } else {
+        FloatRowVector e = embeddings.row(i);
+
+        int32_t g = 0;
+        float best_score = EmbeddingDot(e.data(), speakers_[0].centroid.data(),
+                                        dim);
+        for (int32_t k = 1; k != static_cast<int32_t>(speakers_.size()); ++k) {
+          float score =
+              EmbeddingDot(e.data(), speakers_[k].centroid.data(), dim);
+          if (score > best_score) {
+            best_score = score;
+            g = k;
+          }
+        }
+
+        ans[candidates[i]] = g;
+        UpdateSpeaker(g, e);
+      }
+    }
+
+    tracker_.AddSpeakers(speakers_.size());
+
+    AlignWithPreviousWindow(labels, window_start, &ans);
+
+    return ans;
+  }
+
+  // A local speaker that is too short to compute an embedding keeps
+  // the global speaker of the local speaker in the previous window
+  // that agrees with it most in the overlapped region.
+  void AlignWithPreviousWindow(const Matrix2DInt32 &labels,
+                               int64_t window_start,
+                               std::vector<int32_t> *local2global) const {
+    if (prev_local2global_.empty()) {
+      return;
+    }
+
+    int32_t num_frames = labels.rows();
+    const auto &meta_data = segmentation_model_.GetModelMetaData();
+    int32_t window_size = meta_data.window_size;
+
+    int32_t offset = static_cast<float>(window_start - prev_window_start_) *
+                         num_frames / window_size +
+                     0.5;
+    if (offset <= 0 || offset >= num_frames ||
+        prev_labels_.rows() != num_frames) {
+      return;
+    }
+
+    int32_t num_overlap = num_frames - offset;
+
+    auto &ans = *local2global;
+    for (int32_t s = 0; s != labels.cols(); ++s) {
+      if (ans[s] >= 0) {
+        continue;
+      }
+
+      int32_t best = -1;
+      int32_t best_count = 0;
+      for (int32_t q = 0; q != prev_labels_.cols(); ++q) {
+        int32_t g = prev_local2global_[q];
+        if (g < 0 || std::find(ans.begin(), ans.end(), g) != ans.end()) {
+          continue;
+        }
+
+        int32_t count = (labels.col(s).head(num_overlap).array() *
+                         prev_labels_.col(q).tail(num_overlap).array())
+                            .sum();
+        if (count > best_count) {
+          best_count = count;
+          best = g;
+        }
+      }
+
+      ans[s] = best;
+    }
+  }
+
+  // Compute the normalized embedding of the given local speaker
+  // and save it to embedding.
+  //
+  // Return false if the speaker is too short or the embedding is invalid.
+  bool ComputeEmbedding(const float *p, const Matrix2DInt32 &labels,
+                        int32_t speaker_index, float *embedding) const {
+    auto d = labels.col(speaker_index);
+    if (d.sum() < 10) {
+      // skip segments less than 10 frames
+      return false;
+    }
+
+    int32_t num_frames = labels.rows();
+    int32_t sample_rate = SampleRate();
+
+    auto stream = embedding_extractor_.CreateStream();
+
+    int32_t start_index = -1;
+    for (int32_t k = 0; k <= num_frames; ++k) {
+      bool is_active = k < num_frames && d[k] != 0;
+      if (is_active && start_index == -1) {
+        start_index = k;
+      } else if (!is_active && start_index != -1) {
+        int32_t start_sample = FrameToSample(start_index, num_frames);
+        int32_t end_sample = FrameToSample(k, num_frames);
+
+        stream->AcceptWaveform(sample_rate, p + start_sample,
+                               end_sample - start_sample);
+        start_index = -1;
+      }
+    }
+
+    stream->InputFinished();
+    if (!embedding_extractor_.IsReady(stream.get())) {
+      return false;
+    }
+
+    std::vector<float> v = embedding_extractor_.Compute(stream.get());
+    if (std::any_of(v.begin(), v.end(),
+                    [](float f) -> bool { return std::isnan(f); })) {
+      return false;
+    }
+
+    Eigen::Map<FloatRowVector> e(embedding, v.size());
+    e = Eigen::Map<FloatRowVector>(v.data(), v.size()).normalized();
+
+    return true;
+  }
+
+  void UpdateSpeaker(int32_t g, const FloatRowVector &embedding) {
+    auto &s = speakers_[g];
+    if (s.fixed) {
+      return;
+    }
+
+    s.sum += embedding;
+    s.centroid = s.sum.normalized();
+  }
+
+ private:
+  OnlineSpeakerDiarizationConfig config_;
+  OfflineSpeakerSegmentationPyannoteModel segmentation_model_;
+  SpeakerEmbeddingExtractor embedding_extractor_;
+  Matrix2DInt32 powerset_mapping_;
+
+  // It contains at most window_size samples
+  CircularBuffer buffer_;
+
+  // Index of the sample at position 0 of buffer_ in the input stream
+  int64_t buffer_offset_ = 0;
+
+  static constexpr int32_t kMaxBufferHead = 1 << 30;
+
+  std::vector<Speaker> seeded_speakers_;
+  std::vector<Speaker> speakers_;
+
+  int64_t prev_window_start_ = 0;
+  Matrix2DInt32 prev_labels_;
+  std::vector<int32_t> prev_local2global_;
+
+  SpeakerSegmentTracker tracker_;
+};
+
+}  // namespace sherpa_onnx
+#endif  // SHERPA_ONNX_CSRC_ONLINE_SPEAKER_DIARIZATION_PYANNOTE_IMPL_H_
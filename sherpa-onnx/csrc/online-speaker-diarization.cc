@@ -0,0 +1,154 @@
+// sherpa-onnx/csrc/online-speaker-diarization.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/online-speaker-diarization.h"
+
+#include <sstream>
+#include <string>
+
+#if __ANDROID_API__ >= 9
+#include "android/asset_manager.h"
+#include "android/asset_manager_jni.h"
+#endif
+
+#if __OHOS__
+#include "rawfile/raw_file_manager.h"
+#endif
+
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/online-speaker-diarization-impl.h"
+
+namespace sherpa_onnx {
+
+void OnlineSpeakerDiarizationConfig::Register(ParseOptions *po) {
+  ParseOptions po_segmentation("segmentation", po);
+  segmentation.Register(&po_segmentation);
+
+  ParseOptions po_embedding("embedding", po);
+  embedding.Register(&po_embedding);
+
+  po->Register("cluster-threshold", &threshold,
+               "If the cosine distance between a segment and all known "
+               "speakers is larger than this value, a new speaker is "
+               "created. smaller value -> more speakers. larger value -> "
+               "fewer speakers");
+
+  po->Register("max-num-speakers", &max_num_speakers,
+               "Maximum number of speakers to track. Once it is reached, "
+               "segments are assigned to the nearest known speaker.");
+
+  po->Register("min-duration-on", &min_duration_on,
+               "if a segment is less than this value, then it is discarded. "
+               "Set it to 0 so that no segment is discarded");
+
+  po->Register("min-duration-off", &min_duration_off,
+               "if the gap between two segments of the same speaker is less "
+               "than this value, then these two segments are merged into a "
+               "single segment.");
+}
+
+bool OnlineSpeakerDiarizationConfig::Validate() const {
+  if (!segmentation.Validate()) {
+    return false;
+  }
+
+  if (!embedding.Validate()) {
+    return false;
+  }
+
+  if (threshold < 0) {
+    SHERPA_ONNX_LOGE("threshold %.3f is negative", threshold);
+    return false;
+  }
+
+  if (max_num_speakers < 1) {
+    SHERPA_ONNX_LOGE("max_num_speakers should be positive. Given: %d",
+                     max_num_speakers);
+    return false;
+  }
+
+  if (min_duration_on < 0) {
+    SHERPA_ONNX_LOGE("min_duration_on %.3f is negative", min_duration_on);
+    return false;
+  }
+
+  if (min_duration_off < 0) {
+    SHERPA_ONNX_LOGE("min_duration_off %.3f is negative", min_duration_off);
+    return false;
+  }
+
+  return true;
+}
+
+std::string OnlineSpeakerDiarizationConfig::ToString() const {
+  std::ostringstream os;
+
+  os << "OnlineSpeakerDiarizationConfig(";
+  os << "segmentation=" << segmentation.ToString() << ", ";
+  os << "embedding=" << embedding.ToString() << ", ";
+  os << "threshold=" << threshold << ", ";
+  os << "max_num_speakers=" << max_num_speakers << ", ";
+  os << "min_duration_on=" << min_duration_on << ", ";
+  os << "min_duration_off=" << min_duration_off << ")";
+
+  return os.str();
+}
+
+OnlineSpeakerDiarization::OnlineSpeakerDiarization(
+    const OnlineSpeakerDiarizationConfig &config)
+    : impl_(OnlineSpeakerDiarizationImpl::Create(config)) {}
+
+template <typename Manager>
+OnlineSpeakerDiarization::OnlineSpeakerDiarization(
+    Manager *mgr, const OnlineSpeakerDiarizationConfig &config)
+    : impl_(OnlineSpeakerDiarizationImpl::Create(mgr, config)) {}
+
+OnlineSpeakerDiarization::~OnlineSpeakerDiarization() = default;
+
+int32_t OnlineSpeakerDiarization::SampleRate() const {
+  return impl_->SampleRate();
+}
+
+bool OnlineSpeakerDiarization::SetSpeakers(
+    const SpeakerEmbeddingManager &manager) {
+  return impl_->SetSpeakers(manager);
+}
+
+void OnlineSpeakerDiarization::AcceptWaveform(const float *samples,
+                                              int32_t n) {
+  impl_->AcceptWaveform(samples, n);
+}
+
+void OnlineSpeakerDiarization::Flush() { impl_->Flush(); }
+
+void OnlineSpeakerDiarization::Reset() { impl_->Reset(); }
+
+bool OnlineSpeakerDiarization::Empty() const { return impl_->Empty(); }
+
+const OfflineSpeakerDiarizationSegment &OnlineSpeakerDiarization::Front()
+    const {
+  return impl_->Front();
+}
+
+void OnlineSpeakerDiarization::Pop() { impl_->Pop(); }
+
+int32_t OnlineSpeakerDiarization::NumSpeakers() const {
+  return impl_->NumSpeakers();
+}
+
+std::string OnlineSpeakerDiarization::SpeakerName(int32_t speaker) const {
+  return impl_->SpeakerName(speaker);
+}
+
+#if __ANDROID_API__ >= 9
+template OnlineSpeakerDiarization::OnlineSpeakerDiarization(
+    AAssetManager *mgr, const OnlineSpeakerDiarizationConfig &config);
+#endif
+
+#if __OHOS__
+template OnlineSpeakerDiarization::OnlineSpeakerDiarization(
+    NativeResourceManager *mgr, const OnlineSpeakerDiarizationConfig &config);
+#endif
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,127 @@
+// sherpa-onnx/csrc/online-speaker-diarization.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_ONLINE_SPEAKER_DIARIZATION_H_
+#define SHERPA_ONNX_CSRC_ONLINE_SPEAKER_DIARIZATION_H_
+
+#include <memory>
+#include <string>
+
+#include "sherpa-onnx/csrc/offline-speaker-diarization-result.h"
+#include "sherpa-onnx/csrc/offline-speaker-segmentation-model-config.h"
+#include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/speaker-embedding-extractor.h"
+#include "sherpa-onnx/csrc/speaker-embedding-manager.h"
+
+namespace sherpa_onnx {
+
+struct OnlineSpeakerDiarizationConfig {
+  OfflineSpeakerSegmentationModelConfig segmentation;
+  SpeakerEmbeddingExtractorConfig embedding;
+
+  // Cosine distance threshold, i.e., 1 - (cosine similarity).
+  //
+  // If the distance between the embedding of a segment and the centroids of
+  // all known speakers is larger than this value, a new speaker is created.
+  // The smaller, the more speakers it will generate.
+  float threshold = 0.5;
+
+  // Maximum number of speakers that are tracked. Once it is reached, every
+  // new segment is assigned to its nearest speaker. It bounds the memory
+  // used by the speaker centroids.
+  int32_t max_num_speakers = 20;
+
+  // if a segment is less than this value, then it is discarded
+  float min_duration_on = 0.3;  // in seconds
+
+  // if the gap between two segments of the same speaker is less than this
+  // value, then these two segments are merged into a single segment.
+  float min_duration_off = 0.5;  // in seconds
+
+  OnlineSpeakerDiarizationConfig() = default;
+
+  OnlineSpeakerDiarizationConfig(
+      const OfflineSpeakerSegmentationModelConfig &segmentation,
+      const SpeakerEmbeddingExtractorConfig &embedding, float threshold,
+      int32_t max_num_speakers, float min_duration_on, float min_duration_off)
+      : segmentation(segmentation),
+        embedding(embedding),
+        threshold(threshold),
+        max_num_speakers(max_num_speakers),
+        min_duration_on(min_duration_on),
+        min_duration_off(min_duration_off) {}
+
+  void Register(ParseOptions *po);
+  bool Validate() const;
+  std::string ToString() const;
+};
+
+class OnlineSpeakerDiarizationImpl;
+
+// Streaming speaker diarization.
+//
+// Audio samples are fed incrementally via AcceptWaveform(). The segmentation
+// model is run on each window as soon as it is available. Each local speaker
+// in a window is assigned to a global speaker by comparing its embedding
+// with incrementally updated speaker centroids.
+//
+// Finished segments are available via Empty()/Front()/Pop(), like
+// VoiceActivityDetector. A segment is emitted at most
+// window_size + min_duration_off seconds after it ends.
+class OnlineSpeakerDiarization {
+ public:
+  explicit OnlineSpeakerDiarization(
+      const OnlineSpeakerDiarizationConfig &config);
+
+  template <typename Manager>
+  OnlineSpeakerDiarization(Manager *mgr,
+                           const OnlineSpeakerDiarizationConfig &config);
+
+  ~OnlineSpeakerDiarization();
+
+  // Expected sample rate of the input audio samples
+  int32_t SampleRate() const;
+
+  // Use speakers from the given manager as initial speakers. The i-th speaker
+  // of manager.GetAllSpeakers() gets the speaker ID i. Their centroids are
+  // not updated.
+  //
+  // It should be called before the first call of AcceptWaveform() or
+  // after Reset(). It returns false if the embedding dimension of the manager
+  // does not match the one of the embedding extractor.
+  bool SetSpeakers(const SpeakerEmbeddingManager &manager);
+
+  void AcceptWaveform(const float *samples, int32_t n);
+
+  // Call it at the end of the input so that the remaining samples are
+  // processed and all pending segments are emitted.
+  void Flush();
+
+  // Clear all internal states, including non-seeded speakers.
+  void Reset();
+
+  bool Empty() const;
+
+  // It is an error to call Front() if Empty() returns true.
+  //
+  // The returned reference is valid until the next call to any
+  // methods of OnlineSpeakerDiarization.
+  const OfflineSpeakerDiarizationSegment &Front() const;
+
+  void Pop();
+
+  // Number of speakers found so far, including seeded speakers
+  int32_t NumSpeakers() const;
+
+  // Return the name of the given speaker if it is from SetSpeakers().
+  // Otherwise, it returns an empty string.
+  std::string SpeakerName(int32_t speaker) const;
+
+ private:
+  std::unique_ptr<OnlineSpeakerDiarizationImpl> impl_;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_ONLINE_SPEAKER_DIARIZATION_H_
@@ -128,11 +128,11 @@ class OnlineStream::Impl {
     return paraformer_alpha_cache_;
   }
 
-  void SetFasterDecoder(std::unique_ptr<kaldi_decoder::FasterDecoder> decoder) {
+  void SetFasterDecoder(std::unique_ptr<OnlineCtcFasterDecoder> decoder) {
     faster_decoder_ = std::move(decoder);
   }
 
-  kaldi_decoder::FasterDecoder *GetFasterDecoder() const {
+  OnlineCtcFasterDecoder *GetFasterDecoder() const {
     return faster_decoder_.get();
   }
 
@@ -159,7 +159,7 @@ class OnlineStream::Impl {
   std::vector<float> paraformer_encoder_out_cache_;
   std::vector<float> paraformer_alpha_cache_;
   OnlineParaformerDecoderResult paraformer_result_;
-  std::unique_ptr<kaldi_decoder::FasterDecoder> faster_decoder_;
+  std::unique_ptr<OnlineCtcFasterDecoder> faster_decoder_;
   int32_t faster_decoder_processed_frames_ = 0;
 };
 
@@ -258,11 +258,11 @@ const ContextGraphPtr &OnlineStream::GetContextGraph() const {
 }
 
 void OnlineStream::SetFasterDecoder(
-    std::unique_ptr<kaldi_decoder::FasterDecoder> decoder) {
+    std::unique_ptr<OnlineCtcFasterDecoder> decoder) {
   impl_->SetFasterDecoder(std::move(decoder));
 }
 
-kaldi_decoder::FasterDecoder *OnlineStream::GetFasterDecoder() const {
+OnlineCtcFasterDecoder *OnlineStream::GetFasterDecoder() const {
   return impl_->GetFasterDecoder();
 }
 
@@ -8,7 +8,6 @@
 #include <memory>
 #include <vector>
 
-#include "kaldi-decoder/csrc/faster-decoder.h"
 #include "onnxruntime_cxx_api.h"  // NOLINT
 #include "sherpa-onnx/csrc/context-graph.h"
 #include "sherpa-onnx/csrc/features.h"
@@ -102,8 +101,8 @@ class OnlineStream {
   const ContextGraphPtr &GetContextGraph() const;
 
   // for online ctc decoder
-  void SetFasterDecoder(std::unique_ptr<kaldi_decoder::FasterDecoder> decoder);
-  kaldi_decoder::FasterDecoder *GetFasterDecoder() const;
+  void SetFasterDecoder(std::unique_ptr<OnlineCtcFasterDecoder> decoder);
+  OnlineCtcFasterDecoder *GetFasterDecoder() const;
   int32_t &GetFasterDecoderProcessedFrames();
 
   // for streaming paraformer
@@ -41,6 +41,8 @@ OnlineTransducerDecoderResult &OnlineTransducerDecoderResult::operator=(
   lm_probs = other.lm_probs;
   context_scores = other.context_scores;
 
+  skip_next_frame = other.skip_next_frame;
+
   return *this;
 }
 
@@ -68,6 +70,8 @@ OnlineTransducerDecoderResult &OnlineTransducerDecoderResult::operator=(
   lm_probs = std::move(other.lm_probs);
   context_scores = std::move(other.context_scores);
 
+  skip_next_frame = other.skip_next_frame;
+
   return *this;
 }
 
@@ -36,6 +36,10 @@ struct OnlineTransducerDecoderResult {
   // used only in modified beam_search
   Hypotheses hyps;
 
+  // Used only when blank skipping is enabled. If true, the next frame is
+  // treated as a blank frame without running the joiner.
+  bool skip_next_frame = false;
+
   OnlineTransducerDecoderResult()
       : tokens{}, num_trailing_blanks(0), decoder_out{nullptr}, hyps{} {}
 
@@ -5,10 +5,12 @@
 #include "sherpa-onnx/csrc/online-transducer-greedy-search-decoder.h"
 
 #include <algorithm>
+#include <cmath>
 #include <utility>
 #include <vector>
 
 #include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/math.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
 
 namespace sherpa_onnx {
@@ -112,16 +114,47 @@ void OnlineTransducerGreedySearchDecoder::Decode(
     decoder_out = model_->RunDecoder(std::move(decoder_input));
   }
 
+  float log_blank_skip_threshold =
+      blank_skip_threshold_ > 0 ? std::log(blank_skip_threshold_) : 0;
+
+  // Indexes of the streams whose current frame is not skipped
+  std::vector<int32_t> rows;
+  rows.reserve(batch_size);
+
   for (int32_t t = 0; t != num_frames; ++t) {
+    rows.clear();
+    for (int32_t i = 0; i != batch_size; ++i) {
+      auto &r = (*result)[i];
+      if (r.skip_next_frame) {
+        r.skip_next_frame = false;
+        ++r.num_trailing_blanks;
+      } else {
+        rows.push_back(i);
+      }
+    }
+
+    if (rows.empty()) {
+      continue;
+    }
+
     Ort::Value cur_encoder_out =
         GetEncoderOutFrame(model_->Allocator(), &encoder_out, t);
-    Ort::Value logit =
-        model_->RunJoiner(std::move(cur_encoder_out), View(&decoder_out));
+    Ort::Value cur_decoder_out = View(&decoder_out);
+
+    if (static_cast<int32_t>(rows.size()) != batch_size) {
+      // Run the joiner only for streams that are not skipped
+      cur_encoder_out =
+          GatherRows(model_->Allocator(), &cur_encoder_out, rows);
+      cur_decoder_out = GatherRows(model_->Allocator(), &decoder_out, rows);
+    }
+
+    Ort::Value logit = model_->RunJoiner(std::move(cur_encoder_out),
+                                         std::move(cur_decoder_out));
 
     float *p_logit = logit.GetTensorMutableData<float>();
 
     bool emitted = false;
-    for (int32_t i = 0; i < batch_size; ++i, p_logit += vocab_size) {
+    for (auto i : rows) {
       auto &r = (*result)[i];
       if (blank_penalty_ > 0.0) {
         p_logit[0] -= blank_penalty_;  // assuming blank id is 0
@@ -140,6 +173,12 @@ void OnlineTransducerGreedySearchDecoder::Decode(
         r.num_trailing_blanks = 0;
       } else {
         ++r.num_trailing_blanks;
+
+        if (blank_skip_threshold_ > 0 && y == 0 &&
+            p_logit[0] - LogSumExp(p_logit, vocab_size) >=
+                log_blank_skip_threshold) {
+          r.skip_next_frame = true;
+        }
       }
 
       // export the per-token log scores
@@ -156,6 +195,8 @@ void OnlineTransducerGreedySearchDecoder::Decode(
                                            // probability
         r.ys_probs.push_back(p_logprob[y]);
       }
+
+      p_logit += vocab_size;
     }
     if (emitted) {
       Ort::Value decoder_input = model_->BuildDecoderInput(*result);
@@ -17,11 +17,13 @@ class OnlineTransducerGreedySearchDecoder : public OnlineTransducerDecoder {
   OnlineTransducerGreedySearchDecoder(OnlineTransducerModel *model,
                                       int32_t unk_id,
                                       float blank_penalty,
-                                      float temperature_scale)
+                                      float temperature_scale,
+                                      float blank_skip_threshold)
       : model_(model),
       unk_id_(unk_id),
       blank_penalty_(blank_penalty),
-      temperature_scale_(temperature_scale) {}
+      temperature_scale_(temperature_scale),
+      blank_skip_threshold_(blank_skip_threshold) {}
 
   OnlineTransducerDecoderResult GetEmptyResult() const override;
 
@@ -35,6 +37,10 @@ class OnlineTransducerGreedySearchDecoder : public OnlineTransducerDecoder {
   int32_t unk_id_;
   float blank_penalty_;
   float temperature_scale_;
+
+  // If the blank probability of a frame is not less than it, the next
+  // frame is treated as blank without running the joiner. 0 to disable it.
+  float blank_skip_threshold_;
 };
 
 }  // namespace sherpa_onnx
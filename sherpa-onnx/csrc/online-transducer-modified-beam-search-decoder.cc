@@ -6,6 +6,7 @@
 #include "sherpa-onnx/csrc/online-transducer-modified-beam-search-decoder.h"
 
 #include <algorithm>
+#include <cmath>
 #include <utility>
 #include <vector>
 
@@ -14,8 +15,10 @@
 
 namespace sherpa_onnx {
 
+// hyps_row_splits[i] corresponds to results[streams[i]]
 static void UseCachedDecoderOut(
     const std::vector<int32_t> &hyps_row_splits,
+    const std::vector<int32_t> &streams,
     const std::vector<OnlineTransducerDecoderResult> &results,
     Ort::Value *decoder_out) {
   std::vector<int64_t> shape =
@@ -23,15 +26,16 @@ static void UseCachedDecoderOut(
 
   float *dst = decoder_out->GetTensorMutableData<float>();
 
-  int32_t batch_size = static_cast<int32_t>(results.size());
-  for (int32_t i = 0; i != batch_size; ++i) {
+  int32_t num_streams = static_cast<int32_t>(streams.size());
+  for (int32_t i = 0; i != num_streams; ++i) {
+    const auto &r = results[streams[i]];
     int32_t num_hyps = hyps_row_splits[i + 1] - hyps_row_splits[i];
-    if (num_hyps > 1 || !results[i].decoder_out) {
+    if (num_hyps > 1 || !r.decoder_out) {
       dst += num_hyps * shape[1];
       continue;
     }
 
-    const float *src = results[i].decoder_out.GetTensorData<float>();
+    const float *src = r.decoder_out.GetTensorData<float>();
     std::copy(src, src + shape[1], dst);
     dst += shape[1];
   }
@@ -100,29 +104,67 @@ void OnlineTransducerModifiedBeamSearchDecoder::Decode(
   }
   std::vector<Hypothesis> prev;
 
+  float log_blank_skip_threshold =
+      blank_skip_threshold_ > 0 ? std::log(blank_skip_threshold_) : 0;
+
+  // Indexes of the streams whose current frame is not skipped
+  std::vector<int32_t> streams;
+  streams.reserve(batch_size);
+
+  std::vector<Hypotheses> active;
+  active.reserve(batch_size);
+
   for (int32_t t = 0; t != num_frames; ++t) {
+    streams.clear();
+    for (int32_t b = 0; b != batch_size; ++b) {
+      auto &r = (*result)[b];
+      if (r.skip_next_frame) {
+        // The blank probability of a skipped frame is taken as 1, so
+        // the hypotheses are kept as they are
+        r.skip_next_frame = false;
+        for (auto &h : cur[b]) {
+          ++h.second.num_trailing_blanks;
+        }
+      } else {
+        streams.push_back(b);
+      }
+    }
+
+    if (streams.empty()) {
+      continue;
+    }
+
+    int32_t num_streams = static_cast<int32_t>(streams.size());
+
+    active.clear();
+    for (auto b : streams) {
+      active.push_back(std::move(cur[b]));
+    }
+
     // Due to merging paths with identical token sequences,
     // not all utterances have "num_active_paths" paths.
-    auto hyps_row_splits = GetHypsRowSplits(cur);
+    auto hyps_row_splits = GetHypsRowSplits(active);
     int32_t num_hyps =
         hyps_row_splits.back();  // total num hyps for all utterance
     prev.clear();
-    for (auto &hyps : cur) {
+    for (auto &hyps : active) {
       for (auto &h : hyps) {
         prev.push_back(std::move(h.second));
       }
     }
-    cur.clear();
-    cur.reserve(batch_size);
 
     Ort::Value decoder_input = model_->BuildDecoderInput(prev);
     Ort::Value decoder_out = model_->RunDecoder(std::move(decoder_input));
     if (t == 0) {
-      UseCachedDecoderOut(hyps_row_splits, *result, &decoder_out);
+      UseCachedDecoderOut(hyps_row_splits, streams, *result, &decoder_out);
     }
 
     Ort::Value cur_encoder_out =
         GetEncoderOutFrame(model_->Allocator(), &encoder_out, t);
+    if (num_streams != batch_size) {
+      cur_encoder_out =
+          GatherRows(model_->Allocator(), &cur_encoder_out, streams);
+    }
     cur_encoder_out =
         Repeat(model_->Allocator(), &cur_encoder_out, hyps_row_splits);
     Ort::Value logit =
@@ -150,6 +192,24 @@ void OnlineTransducerModifiedBeamSearchDecoder::Decode(
     }
     LogSoftmax(p_logit, vocab_size, num_hyps);
 
+    if (blank_skip_threshold_ > 0) {
+      // Skip the next frame of a stream if blank is confident enough for
+      // its best hypothesis
+      for (int32_t j = 0; j != num_streams; ++j) {
+        int32_t best = hyps_row_splits[j];
+        for (int32_t i = best + 1; i != hyps_row_splits[j + 1]; ++i) {
+          if (prev[i].log_prob > prev[best].log_prob) {
+            best = i;
+          }
+        }
+
+        // assuming blank id is 0
+        if (p_logit[best * vocab_size] >= log_blank_skip_threshold) {
+          (*result)[streams[j]].skip_next_frame = true;
+        }
+      }
+    }
+
     // now p_logit contains log_softmax output, we rename it to p_logprob
     // to match what it actually contains
     float *p_logprob = p_logit;
@@ -167,10 +227,11 @@ void OnlineTransducerModifiedBeamSearchDecoder::Decode(
     }
     p_logprob = p_logit;  // we changed p_logprob in the above for loop
 
-    for (int32_t b = 0; b != batch_size; ++b) {
+    for (int32_t j = 0; j != num_streams; ++j) {
+      int32_t b = streams[j];
       int32_t frame_offset = (*result)[b].frame_offset;
-      int32_t start = hyps_row_splits[b];
-      int32_t end = hyps_row_splits[b + 1];
+      int32_t start = hyps_row_splits[j];
+      int32_t end = hyps_row_splits[j + 1];
       auto topk =
           TopkIndex(p_logprob, vocab_size * (end - start), max_active_paths_);
 
@@ -182,7 +243,6 @@ void OnlineTransducerModifiedBeamSearchDecoder::Decode(
         Hypothesis new_hyp = prev[hyp_index];
         const float prev_lm_log_prob = new_hyp.lm_log_prob;
         float context_score = 0;
-        auto context_state = new_hyp.context_state;
 
         // blank is hardcoded to 0
         // also, it treats unk as blank
@@ -191,10 +251,9 @@ void OnlineTransducerModifiedBeamSearchDecoder::Decode(
           new_hyp.timestamps.push_back(t + frame_offset);
           new_hyp.num_trailing_blanks = 0;
           if (ss != nullptr && ss[b]->GetContextGraph() != nullptr) {
-            auto context_res = ss[b]->GetContextGraph()->ForwardOneStep(
-                context_state, new_token, false /*strict mode*/);
-            context_score = std::get<0>(context_res);
-            new_hyp.context_state = std::get<1>(context_res);
+            context_score = ss[b]->GetContextGraph()->ForwardOneStep(
+                &new_hyp.context_state, &new_hyp.base_context_state,
+                new_token, false /*strict mode*/);
           }
           if (lm_ && shallow_fusion_) {
             lm_->ComputeLMScoreSF(lm_scale_, &new_hyp);
@@ -235,9 +294,9 @@ void OnlineTransducerModifiedBeamSearchDecoder::Decode(
 
         hyps.Add(std::move(new_hyp));
       }  // for (auto k : topk)
-      cur.push_back(std::move(hyps));
+      cur[b] = std::move(hyps);
       p_logprob += (end - start) * vocab_size;
-    }  // for (int32_t b = 0; b != batch_size; ++b)
+    }  // for (int32_t j = 0; j != num_streams; ++j)
   }    // for (int32_t t = 0; t != num_frames; ++t)
 
   // classic lm rescore
@@ -25,7 +25,8 @@ class OnlineTransducerModifiedBeamSearchDecoder
                                             bool shallow_fusion,
                                             int32_t unk_id,
                                             float blank_penalty,
-                                            float temperature_scale)
+                                            float temperature_scale,
+                                            float blank_skip_threshold)
       : model_(model),
         lm_(lm),
         max_active_paths_(max_active_paths),
@@ -33,7 +34,8 @@ class OnlineTransducerModifiedBeamSearchDecoder
         shallow_fusion_(shallow_fusion),
         unk_id_(unk_id),
         blank_penalty_(blank_penalty),
-        temperature_scale_(temperature_scale) {}
+        temperature_scale_(temperature_scale),
+        blank_skip_threshold_(blank_skip_threshold) {}
 
   OnlineTransducerDecoderResult GetEmptyResult() const override;
 
@@ -57,6 +59,11 @@ class OnlineTransducerModifiedBeamSearchDecoder
   int32_t unk_id_;
   float blank_penalty_;
   float temperature_scale_;
+
+  // If the blank probability of a frame is not less than it for the best
+  // hypothesis of a stream, the next frame of that stream is treated as
+  // blank without running the decoder and the joiner. 0 to disable it.
+  float blank_skip_threshold_;
 };
 
 }  // namespace sherpa_onnx
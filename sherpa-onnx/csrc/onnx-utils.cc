@@ -356,6 +356,30 @@ Ort::Value Repeat(OrtAllocator *allocator, Ort::Value *cur_encoder_out,
   return ans;
 }
 
+Ort::Value GatherRows(OrtAllocator *allocator, const Ort::Value *v,
+                      const std::vector<int32_t> &rows) {
+  std::vector<int64_t> shape = v->GetTensorTypeAndShapeInfo().GetShape();
+
+  int64_t row_size = 1;
+  for (size_t i = 1; i != shape.size(); ++i) {
+    row_size *= shape[i];
+  }
+
+  shape[0] = static_cast<int64_t>(rows.size());
+
+  Ort::Value ans =
+      Ort::Value::CreateTensor<float>(allocator, shape.data(), shape.size());
+
+  const float *src = v->GetTensorData<float>();
+  float *dst = ans.GetTensorMutableData<float>();
+  for (auto r : rows) {
+    std::copy(src + r * row_size, src + (r + 1) * row_size, dst);
+    dst += row_size;
+  }
+
+  return ans;
+}
+
 CopyableOrtValue::CopyableOrtValue(const CopyableOrtValue &other) {
   *this = other;
 }
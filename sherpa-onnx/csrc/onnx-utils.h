@@ -97,6 +97,16 @@ void Fill(Ort::Value *tensor, T value) {
 Ort::Value Repeat(OrtAllocator *allocator, Ort::Value *cur_encoder_out,
                   const std::vector<int32_t> &hyps_num_split);
 
+/** Select rows of a float tensor.
+ *
+ * @param v A float tensor of shape (N, ...).
+ * @param rows Indexes into the first dimension of v.
+ *
+ * @return Return a tensor of shape (rows.size(), ...) with ans[i] = v[rows[i]]
+ */
+Ort::Value GatherRows(OrtAllocator *allocator, const Ort::Value *v,
+                      const std::vector<int32_t> &rows);
+
 struct CopyableOrtValue {
   Ort::Value value{nullptr};
 
@@ -0,0 +1,178 @@
+// sherpa-onnx/csrc/process-file-list.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_PROCESS_FILE_LIST_H_
+#define SHERPA_ONNX_CSRC_PROCESS_FILE_LIST_H_
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sherpa-onnx/csrc/offline-stream.h"
+#include "sherpa-onnx/csrc/run-in-order.h"
+#include "sherpa-onnx/csrc/wave-reader.h"
+
+// Helpers for command-line tools that compute a batch of offline streams
+// at a time, e.g., audio tagging and spoken language identification.
+
+namespace sherpa_onnx {
+
+// Return the non-empty lines of the given text file
+inline std::vector<std::string> ReadFileList(const std::string &filename) {
+  std::vector<std::string> ans;
+
+  std::ifstream is(filename);
+  if (!is) {
+    fprintf(stderr, "Failed to open '%s'\n", filename.c_str());
+    return ans;
+  }
+
+  std::string line;
+  while (std::getline(is, line)) {
+    if (!line.empty()) {
+      ans.push_back(std::move(line));
+    }
+  }
+
+  return ans;
+}
+
+template <typename Result>
+struct FileBatchResult {
+  std::vector<std::string> filenames;
+
+  // results[i] is empty if filenames[i] cannot be read
+  std::vector<Result> results;
+
+  // Total duration in seconds of the files that can be read
+  float duration = 0;
+};
+
+// Read files[start], ..., files[end - 1] and compute them with a single
+// call of model.Compute(ss, n).
+//
+// Model is, e.g., AudioTagging or SpokenLanguageIdentification.
+template <typename Model>
+auto ProcessFileBatch(const Model &model, const std::vector<std::string> &files,
+                      int32_t start, int32_t end) {
+  using Result = typename decltype(model.Compute(
+      static_cast<OfflineStream **>(nullptr), 0))::value_type;
+
+  FileBatchResult<Result> ans;
+  ans.filenames.assign(files.begin() + start, files.begin() + end);
+  ans.results.resize(end - start);
+
+  std::vector<std::unique_ptr<OfflineStream>> streams;
+  std::vector<OfflineStream *> ss;
+  std::vector<int32_t> indexes;
+
+  for (int32_t i = start; i != end; ++i) {
+    int32_t sampling_rate = -1;
+    bool is_ok = false;
+    const std::vector<float> samples =
+        ReadWave(files[i], &sampling_rate, &is_ok);
+
+    if (!is_ok) {
+      fprintf(stderr, "Failed to read '%s'\n", files[i].c_str());
+      continue;
+    }
+
+    ans.duration += samples.size() / static_cast<float>(sampling_rate);
+
+    auto s = model.CreateStream();
+    s->AcceptWaveform(sampling_rate, samples.data(), samples.size());
+
+    ss.push_back(s.get());
+    streams.push_back(std::move(s));
+    indexes.push_back(i - start);
+  }
+
+  auto results = model.Compute(ss.data(), ss.size());
+  for (int32_t i = 0; i != static_cast<int32_t>(indexes.size()); ++i) {
+    ans.results[indexes[i]] = std::move(results[i]);
+  }
+
+  return ans;
+}
+
+// Compute the files listed in file_list in batches of batch_size on
+// num_workers threads.
+//
+// print(filename, result) is called on the calling thread in the order of
+// the file list for each file whose result is not empty. Statistics are
+// printed to stderr at the end.
+//
+// @return Return 0 on success and -1 if there are no files to process.
+template <typename Model, typename Print>
+int32_t ProcessFileList(const Model &model, const std::string &file_list,
+                        int32_t batch_size, int32_t num_workers,
+                        int32_t num_threads, const Print &print) {
+  std::vector<std::string> files = ReadFileList(file_list);
+  if (files.empty()) {
+    fprintf(stderr, "No files to process in '%s'\n", file_list.c_str());
+    return -1;
+  }
+
+  int32_t num_files = static_cast<int32_t>(files.size());
+  int32_t num_batches = (num_files + batch_size - 1) / batch_size;
+
+  float duration = 0;
+  int32_t num_processed = 0;
+
+  fprintf(stderr, "Started %d files\n", num_files);
+  const auto begin = std::chrono::steady_clock::now();
+
+  auto process = [&](int32_t b) {
+    int32_t start = b * batch_size;
+    int32_t end = std::min(start + batch_size, num_files);
+    return ProcessFileBatch(model, files, start, end);
+  };
+
+  auto consume = [&](int32_t /*b*/, auto r) {
+    for (int32_t i = 0; i != static_cast<int32_t>(r.filenames.size()); ++i) {
+      if (r.results[i].empty()) {
+        continue;
+      }
+
+      print(r.filenames[i], r.results[i]);
+
+      num_processed += 1;
+    }
+
+    duration += r.duration;
+    return true;
+  };
+
+  RunInOrder(num_batches, num_workers, process, consume);
+
+  const auto end = std::chrono::steady_clock::now();
+
+  float elapsed_seconds =
+      std::chrono::duration_cast<std::chrono::milliseconds>(end - begin)
+          .count() /
+      1000.;
+
+  fprintf(stderr, "Num threads: %d\n", num_threads);
+  fprintf(stderr, "Num workers: %d\n", num_workers);
+  fprintf(stderr, "Batch size: %d\n", batch_size);
+  fprintf(stderr, "Processed files: %d/%d\n", num_processed, num_files);
+  fprintf(stderr, "Total wave duration: %.3f s\n", duration);
+  fprintf(stderr, "Elapsed seconds: %.3f s\n", elapsed_seconds);
+  fprintf(stderr, "Throughput: %.3f files/s\n",
+          num_processed / elapsed_seconds);
+  fprintf(stderr, "Real time factor (RTF): %.3f / %.3f = %.3f\n",
+          elapsed_seconds, duration, elapsed_seconds / duration);
+
+  return 0;
+}
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_PROCESS_FILE_LIST_H_
@@ -0,0 +1,121 @@
+// sherpa-onnx/csrc/resample-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/resample.h"
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cmath>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sherpa-onnx/csrc/macros.h"
+
+namespace sherpa_onnx {
+
+// The same settings as FeatureExtractor::AcceptWaveform()
+static LinearResample CreateResampler(int32_t in, int32_t out) {
+  float min_freq = std::min<int32_t>(in, out);
+  float lowpass_cutoff = 0.99 * 0.5 * min_freq;
+  int32_t lowpass_filter_width = 6;
+  return LinearResample(in, out, lowpass_cutoff, lowpass_filter_width);
+}
+
+static std::vector<float> GetSine(int32_t sample_rate, float freq, int32_t n) {
+  std::vector<float> samples(n);
+  for (int32_t i = 0; i != n; ++i) {
+    samples[i] = std::sin(2 * M_PI * freq * i / sample_rate);
+  }
+  return samples;
+}
+
+static const std::vector<std::pair<int32_t, int32_t>> kRates = {
+    {8000, 16000}, {48000, 16000}, {44100, 16000}, {16000, 8000}};
+
+TEST(LinearResample, Sine) {
+  float freq = 440;
+  for (const auto &p : kRates) {
+    auto resampler = CreateResampler(p.first, p.second);
+    auto input = GetSine(p.first, freq, p.first);
+
+    std::vector<float> output;
+    resampler.Resample(input.data(), input.size(), true, &output);
+    EXPECT_EQ(output.size(), p.second);
+
+    auto expected = GetSine(p.second, freq, output.size());
+
+    // Skip the edges, where the signal is cut
+    int32_t skip = p.second / 100;
+    for (int32_t i = skip; i < static_cast<int32_t>(output.size()) - skip;
+         ++i) {
+      EXPECT_NEAR(output[i], expected[i], 1e-2) << p.first << " " << i;
+    }
+  }
+}
+
+TEST(LinearResample, Streaming) {
+  for (const auto &p : kRates) {
+    auto input = GetSine(p.first, 1000, p.first * 2);
+
+    auto resampler = CreateResampler(p.first, p.second);
+
+    std::vector<float> expected;
+    resampler.Resample(input.data(), input.size(), true, &expected);
+
+    // Use chunks of different sizes, including ones shorter than the filter
+    std::vector<float> output;
+    std::vector<float> tmp;
+    int32_t start = 0;
+    int32_t i = 0;
+    while (start < static_cast<int32_t>(input.size())) {
+      int32_t n = std::min<int32_t>((i++ % 7) * 37 + 1, input.size() - start);
+      bool flush = start + n == static_cast<int32_t>(input.size());
+      resampler.Resample(input.data() + start, n, flush, &tmp);
+      output.insert(output.end(), tmp.begin(), tmp.end());
+      start += n;
+    }
+
+    ASSERT_EQ(output.size(), expected.size());
+    for (int32_t k = 0; k != static_cast<int32_t>(output.size()); ++k) {
+      EXPECT_NEAR(output[k], expected[k], 1e-5) << p.first << " " << k;
+    }
+  }
+}
+
+TEST(LinearResample, Benchmark) {
+  // 10 seconds of audio, resampled in chunks of 100 ms as in streaming ASR
+  for (const auto &p : kRates) {
+    auto input = GetSine(p.first, 440, p.first * 10);
+    int32_t chunk = p.first / 10;
+
+    auto begin = std::chrono::steady_clock::now();
+    for (int32_t k = 0; k != 100; ++k) {
+      auto resampler = CreateResampler(p.first, p.second);
+    }
+    auto end = std::chrono::steady_clock::now();
+    float create_us =
+        std::chrono::duration<float>(end - begin).count() * 1e6 / 100;
+
+    auto resampler = CreateResampler(p.first, p.second);
+    std::vector<float> output;
+
+    int32_t num_iters = 10;
+    begin = std::chrono::steady_clock::now();
+    for (int32_t k = 0; k != num_iters; ++k) {
+      for (int32_t start = 0; start < static_cast<int32_t>(input.size());
+           start += chunk) {
+        resampler.Resample(input.data() + start, chunk, false, &output);
+      }
+      resampler.Reset();
+    }
+    end = std::chrono::steady_clock::now();
+    float seconds = std::chrono::duration<float>(end - begin).count();
+
+    SHERPA_ONNX_LOGE(
+        "%d Hz -> %d Hz: %.3f ms per second of audio, construction %.1f us",
+        p.first, p.second, seconds * 1000 / (num_iters * 10), create_us);
+  }
+}
+
+}  // namespace sherpa_onnx
@@ -24,12 +24,25 @@
 
 #include "sherpa-onnx/csrc/resample.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
+#include <map>
+#include <mutex>  // NOLINT
+#include <tuple>
 #include <type_traits>
 
+#include "sherpa-onnx/csrc/cpu-features.h"
+
+#if SHERPA_ONNX_ENABLE_AVX2_KERNELS
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define SHERPA_ONNX_RESAMPLE_NEON 1
+#endif
+
 #ifndef M_2PI
 #define M_2PI 6.283185307179586476925286766559005
 #endif
@@ -72,14 +85,193 @@ static I Lcm(I m, I n) {
   return gcd * (m / gcd) * (n / gcd);
 }
 
+// The weights of all phases of the polyphase filter in one contiguous
+// table. Each phase starts at a 32-byte aligned address and is padded
+// with zeros to a multiple of 8 weights.
+struct ResampleFilter {
+  // first_index[i] is the first input-sample index that we sum over for
+  // output-sample index i in a unit
+  std::vector<int32_t> first_index;
+
+  // Number of weights of each phase, without padding
+  std::vector<int32_t> num_weights;
+
+  // Distance in floats between two phases in weights
+  int32_t stride = 0;
+
+  std::vector<float> storage;
+
+  // Points into storage. Weights of phase i are at weights + i * stride
+  const float *weights = nullptr;
+
+  const float *Weights(int32_t phase) const {
+    return weights + phase * stride;
+  }
+};
+
+#if SHERPA_ONNX_ENABLE_AVX2_KERNELS
+// b must be aligned to 32 bytes
+SHERPA_ONNX_TARGET_AVX2 static float DotProductAvx2(const float *a,
+                                                    const float *b,
+                                                    int32_t n) {
+  int32_t i = 0;
+
+  __m256 sum0 = _mm256_setzero_ps();
+  __m256 sum1 = _mm256_setzero_ps();
+  for (; i + 16 <= n; i += 16) {
+    sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_load_ps(b + i),
+                           sum0);
+    sum1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8),
+                           _mm256_load_ps(b + i + 8), sum1);
+  }
+
+  for (; i + 8 <= n; i += 8) {
+    sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_load_ps(b + i),
+                           sum0);
+  }
+
+  __m256 v = _mm256_add_ps(sum0, sum1);
+  __m128 lo = _mm_add_ps(_mm256_castps256_ps128(v),
+                         _mm256_extractf128_ps(v, 1));
+  lo = _mm_add_ps(lo, _mm_movehl_ps(lo, lo));
+  lo = _mm_add_ss(lo, _mm_movehdup_ps(lo));
+  float sum = _mm_cvtss_f32(lo);
+
+  for (; i < n; ++i) {
+    sum += a[i] * b[i];
+  }
+  return sum;
+}
+#endif
+
 static float DotProduct(const float *a, const float *b, int32_t n) {
+#if SHERPA_ONNX_ENABLE_AVX2_KERNELS
+  if (CpuSupportsAvx2Fma()) {
+    return DotProductAvx2(a, b, n);
+  }
+#endif
+
+  int32_t i = 0;
   float sum = 0;
-  for (int32_t i = 0; i != n; ++i) {
+
+#if SHERPA_ONNX_RESAMPLE_NEON
+  float32x4_t sum0 = vdupq_n_f32(0);
+  float32x4_t sum1 = vdupq_n_f32(0);
+  for (; i + 8 <= n; i += 8) {
+    sum0 = vfmaq_f32(sum0, vld1q_f32(a + i), vld1q_f32(b + i));
+    sum1 = vfmaq_f32(sum1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+  }
+
+  for (; i + 4 <= n; i += 4) {
+    sum0 = vfmaq_f32(sum0, vld1q_f32(a + i), vld1q_f32(b + i));
+  }
+  sum = vaddvq_f32(vaddq_f32(sum0, sum1));
+#endif
+
+  for (; i < n; ++i) {
     sum += a[i] * b[i];
   }
   return sum;
 }
 
+/** Here, t is a time in seconds representing an offset from
+    the center of the windowed filter function, and FilterFunction(t)
+    returns the windowed filter function, described
+    in the header as h(t) = f(t)g(t), evaluated at t.
+*/
+static float FilterFunc(float t, float filter_cutoff, int32_t num_zeros) {
+  float window = 0,  // raised-cosine (Hanning) window of width
+                     // num_zeros/2*filter_cutoff
+      filter = 0;    // sinc filter function
+  if (std::fabs(t) < num_zeros / (2.0 * filter_cutoff))
+    window = 0.5 * (1 + cos(M_2PI * filter_cutoff / num_zeros * t));
+  else
+    window = 0.0;  // outside support of window function
+  if (t != 0)
+    filter = sin(M_2PI * filter_cutoff * t) / (M_PI * t);
+  else
+    filter = 2 * filter_cutoff;  // limit of the function at t = 0
+  return filter * window;
+}
+
+static std::shared_ptr<const ResampleFilter> CreateFilter(
+    int32_t samp_rate_in, int32_t samp_rate_out, float filter_cutoff,
+    int32_t num_zeros, int32_t output_samples_in_unit) {
+  auto filter = std::make_shared<ResampleFilter>();
+  filter->first_index.resize(output_samples_in_unit);
+  filter->num_weights.resize(output_samples_in_unit);
+
+  double window_width = num_zeros / (2.0 * filter_cutoff);
+
+  for (int32_t i = 0; i < output_samples_in_unit; i++) {
+    double output_t = i / static_cast<double>(samp_rate_out);
+    double min_t = output_t - window_width, max_t = output_t + window_width;
+    // we do ceil on the min and floor on the max, because if we did it
+    // the other way around we would unnecessarily include indexes just
+    // outside the window, with zero coefficients.  It's possible
+    // if the arguments to the ceil and floor expressions are integers
+    // (e.g. if filter_cutoff has an exact ratio with the sample rates),
+    // that we unnecessarily include something with a zero coefficient,
+    // but this is only a slight efficiency issue.
+    int32_t min_input_index = ceil(min_t * samp_rate_in),
+            max_input_index = floor(max_t * samp_rate_in),
+            num_indices = max_input_index - min_input_index + 1;
+    filter->first_index[i] = min_input_index;
+    filter->num_weights[i] = num_indices;
+  }
+
+  int32_t max_num_weights = *std::max_element(filter->num_weights.begin(),
+                                              filter->num_weights.end());
+  filter->stride = (max_num_weights + 7) / 8 * 8;
+
+  // 8 more floats so that we can align the start to 32 bytes
+  filter->storage.resize(output_samples_in_unit * filter->stride + 8);
+  float *weights = filter->storage.data();
+  while (reinterpret_cast<uintptr_t>(weights) % 32 != 0) {
+    ++weights;
+  }
+  filter->weights = weights;
+
+  for (int32_t i = 0; i < output_samples_in_unit; i++) {
+    double output_t = i / static_cast<double>(samp_rate_out);
+    float *w = weights + i * filter->stride;
+    for (int32_t j = 0; j < filter->num_weights[i]; j++) {
+      int32_t input_index = filter->first_index[i] + j;
+      double input_t = input_index / static_cast<double>(samp_rate_in),
+             delta_t = input_t - output_t;
+      // sign of delta_t doesn't matter.
+      w[j] = FilterFunc(delta_t, filter_cutoff, num_zeros) / samp_rate_in;
+    }
+  }
+
+  return filter;
+}
+
+// Streams usually share a few sample rate pairs, e.g., 8 kHz -> 16 kHz,
+// so each filter is computed once and shared by all resamplers.
+static std::shared_ptr<const ResampleFilter> GetFilter(
+    int32_t samp_rate_in, int32_t samp_rate_out, float filter_cutoff,
+    int32_t num_zeros, int32_t output_samples_in_unit) {
+  static std::mutex mutex;
+  static std::map<std::tuple<int32_t, int32_t, float, int32_t>,
+                  std::shared_ptr<const ResampleFilter>>
+      cache;
+
+  auto key =
+      std::make_tuple(samp_rate_in, samp_rate_out, filter_cutoff, num_zeros);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = cache.find(key);
+  if (it != cache.end()) {
+    return it->second;
+  }
+
+  auto filter = CreateFilter(samp_rate_in, samp_rate_out, filter_cutoff,
+                             num_zeros, output_samples_in_unit);
+  cache.emplace(key, filter);
+  return filter;
+}
+
 LinearResample::LinearResample(int32_t samp_rate_in_hz,
                                int32_t samp_rate_out_hz, float filter_cutoff_hz,
                                int32_t num_zeros)
@@ -97,59 +289,18 @@ LinearResample::LinearResample(int32_t samp_rate_in_hz,
   input_samples_in_unit_ = samp_rate_in_ / base_freq;
   output_samples_in_unit_ = samp_rate_out_ / base_freq;
 
-  SetIndexesAndWeights();
-  Reset();
-}
-
-void LinearResample::SetIndexesAndWeights() {
-  first_index_.resize(output_samples_in_unit_);
-  weights_.resize(output_samples_in_unit_);
-
-  double window_width = num_zeros_ / (2.0 * filter_cutoff_);
+  filter_ = GetFilter(samp_rate_in_, samp_rate_out_, filter_cutoff_,
+                      num_zeros_, output_samples_in_unit_);
 
-  for (int32_t i = 0; i < output_samples_in_unit_; i++) {
-    double output_t = i / static_cast<double>(samp_rate_out_);
-    double min_t = output_t - window_width, max_t = output_t + window_width;
-    // we do ceil on the min and floor on the max, because if we did it
-    // the other way around we would unnecessarily include indexes just
-    // outside the window, with zero coefficients.  It's possible
-    // if the arguments to the ceil and floor expressions are integers
-    // (e.g. if filter_cutoff_ has an exact ratio with the sample rates),
-    // that we unnecessarily include something with a zero coefficient,
-    // but this is only a slight efficiency issue.
-    int32_t min_input_index = ceil(min_t * samp_rate_in_),
-            max_input_index = floor(max_t * samp_rate_in_),
-            num_indices = max_input_index - min_input_index + 1;
-    first_index_[i] = min_input_index;
-    weights_[i].resize(num_indices);
-    for (int32_t j = 0; j < num_indices; j++) {
-      int32_t input_index = min_input_index + j;
-      double input_t = input_index / static_cast<double>(samp_rate_in_),
-             delta_t = input_t - output_t;
-      // sign of delta_t doesn't matter.
-      weights_[i][j] = FilterFunc(delta_t) / samp_rate_in_;
-    }
-  }
-}
+  // max_remainder_needed is the width of the filter from side to side,
+  // measured in input samples.  you might think it should be half that,
+  // but you have to consider that you might be wanting to output samples
+  // that are "in the past" relative to the beginning of the latest
+  // input... anyway, storing more remainder than needed is not harmful.
+  max_remainder_needed_ =
+      std::ceil(samp_rate_in_ * num_zeros_ / filter_cutoff_);
 
-/** Here, t is a time in seconds representing an offset from
-    the center of the windowed filter function, and FilterFunction(t)
-    returns the windowed filter function, described
-    in the header as h(t) = f(t)g(t), evaluated at t.
-*/
-float LinearResample::FilterFunc(float t) const {
-  float window = 0,  // raised-cosine (Hanning) window of width
-                     // num_zeros_/2*filter_cutoff_
-      filter = 0;    // sinc filter function
-  if (std::fabs(t) < num_zeros_ / (2.0 * filter_cutoff_))
-    window = 0.5 * (1 + cos(M_2PI * filter_cutoff_ / num_zeros_ * t));
-  else
-    window = 0.0;  // outside support of window function
-  if (t != 0)
-    filter = sin(M_2PI * filter_cutoff_ * t) / (M_PI * t);
-  else
-    filter = 2 * filter_cutoff_;  // limit of the function at t = 0
-  return filter * window;
+  Reset();
 }
 
 void LinearResample::Reset() {
@@ -167,26 +318,38 @@ void LinearResample::Resample(const float *input, int32_t input_dim, bool flush,
 
   output->resize(tot_output_samp - output_sample_offset_);
 
+  const ResampleFilter &filter = *filter_;
+  float *out = output->data();
+
+  // Instead of calling GetIndexes() for each output sample, we move to the
+  // next phase of the filter and wrap to the next unit after the last one.
+  int64_t first_samp_in = 0;
+  int32_t samp_out_wrapped = 0;
+  GetIndexes(output_sample_offset_, &first_samp_in, &samp_out_wrapped);
+
+  // The first input-sample index of the current unit, relative to "input"
+  int64_t unit_offset = first_samp_in -
+                        filter.first_index[samp_out_wrapped] -
+                        input_sample_offset_;
+
   // samp_out is the index into the total output signal, not just the part
   // of it we are producing here.
   for (int64_t samp_out = output_sample_offset_; samp_out < tot_output_samp;
        samp_out++) {
-    int64_t first_samp_in = 0;
-    int32_t samp_out_wrapped = 0;
-    GetIndexes(samp_out, &first_samp_in, &samp_out_wrapped);
-    const std::vector<float> &weights = weights_[samp_out_wrapped];
+    const float *weights = filter.Weights(samp_out_wrapped);
+    int32_t num_weights = filter.num_weights[samp_out_wrapped];
+
     // first_input_index is the first index into "input" that we have a weight
     // for.
-    int32_t first_input_index =
-        static_cast<int32_t>(first_samp_in - input_sample_offset_);
+    int32_t first_input_index = static_cast<int32_t>(
+        unit_offset + filter.first_index[samp_out_wrapped]);
     float this_output = 0;
     if (first_input_index >= 0 &&
-        first_input_index + static_cast<int32_t>(weights.size()) <= input_dim) {
-      this_output =
-          DotProduct(input + first_input_index, weights.data(), weights.size());
+        first_input_index + num_weights <= input_dim) {
+      this_output = DotProduct(input + first_input_index, weights, num_weights);
     } else {  // Handle edge cases.
       this_output = 0.0;
-      for (int32_t i = 0; i < static_cast<int32_t>(weights.size()); i++) {
+      for (int32_t i = 0; i < num_weights; i++) {
         float weight = weights[i];
         int32_t input_index = first_input_index + i;
         if (input_index < 0 &&
@@ -203,9 +366,12 @@ void LinearResample::Resample(const float *input, int32_t input_dim, bool flush,
         }
       }
     }
-    int32_t output_index =
-        static_cast<int32_t>(samp_out - output_sample_offset_);
-    (*output)[output_index] = this_output;
+    *out++ = this_output;
+
+    if (++samp_out_wrapped == output_samples_in_unit_) {
+      samp_out_wrapped = 0;
+      unit_offset += input_samples_in_unit_;
+    }
   }
 
   if (flush) {
@@ -275,34 +441,29 @@ void LinearResample::GetIndexes(int64_t samp_out, int64_t *first_samp_in,
   *samp_out_wrapped =
       static_cast<int32_t>(samp_out - unit_index * output_samples_in_unit_);
   *first_samp_in =
-      first_index_[*samp_out_wrapped] + unit_index * input_samples_in_unit_;
+      filter_->first_index[*samp_out_wrapped] +
+      unit_index * input_samples_in_unit_;
 }
 
 void LinearResample::SetRemainder(const float *input, int32_t input_dim) {
-  std::vector<float> old_remainder(input_remainder_);
-  // max_remainder_needed is the width of the filter from side to side,
-  // measured in input samples.  you might think it should be half that,
-  // but you have to consider that you might be wanting to output samples
-  // that are "in the past" relative to the beginning of the latest
-  // input... anyway, storing more remainder than needed is not harmful.
-  int32_t max_remainder_needed =
-      std::ceil(samp_rate_in_ * num_zeros_ / filter_cutoff_);
-  input_remainder_.resize(max_remainder_needed);
-  for (int32_t index = -static_cast<int32_t>(input_remainder_.size());
-       index < 0; index++) {
-    // we interpret "index" as an offset from the end of "input" and
-    // from the end of input_remainder_.
-    int32_t input_index = index + input_dim;
-    if (input_index >= 0) {
-      input_remainder_[index + static_cast<int32_t>(input_remainder_.size())] =
-          input[input_index];
-    } else if (input_index + static_cast<int32_t>(old_remainder.size()) >= 0) {
-      input_remainder_[index + static_cast<int32_t>(input_remainder_.size())] =
-          old_remainder[input_index +
-                        static_cast<int32_t>(old_remainder.size())];
-      // else leave it at zero.
-    }
+  // The remainder keeps the last max_remainder_needed_ samples of the signal
+  // seen so far, with zeros before the start of the signal. We update it
+  // in place instead of copying the old remainder.
+  int32_t n = max_remainder_needed_;
+  if (input_dim >= n) {
+    input_remainder_.assign(input + input_dim - n, input + input_dim);
+    return;
   }
+
+  int32_t old_size = input_remainder_.size();
+  if (old_size < n) {
+    // It happens only for the first call after Reset()
+    input_remainder_.insert(input_remainder_.begin(), n - old_size, 0);
+  }
+
+  std::copy(input_remainder_.begin() + input_dim, input_remainder_.end(),
+            input_remainder_.begin());
+  std::copy(input, input + input_dim, input_remainder_.end() - input_dim);
 }
 
 }  // namespace sherpa_onnx
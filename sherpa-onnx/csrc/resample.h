@@ -25,10 +25,13 @@
 #define SHERPA_ONNX_CSRC_RESAMPLE_H_
 
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 namespace sherpa_onnx {
 
+struct ResampleFilter;
+
 /*
    We require that the input and output sampling rate be specified as
    integers, as this is an easy way to specify that their ratio be rational.
@@ -78,10 +81,6 @@ class LinearResample {
   int32_t GetOutputSamplingRate() const { return samp_rate_out_; }
 
  private:
-  void SetIndexesAndWeights();
-
-  float FilterFunc(float) const;
-
   /// This function outputs the number of output samples we will output
   /// for a signal with "input_num_samp" input samples.  If flush == true,
   /// we return the largest n such that
@@ -94,8 +93,8 @@ class LinearResample {
 
   /// Given an output-sample index, this function outputs to *first_samp_in the
   /// first input-sample index that we have a weight on (may be negative),
-  /// and to *samp_out_wrapped the index into weights_ where we can get the
-  /// corresponding weights on the input.
+  /// and to *samp_out_wrapped the index of the filter phase where we can get
+  /// the corresponding weights on the input.
   inline void GetIndexes(int64_t samp_out, int64_t *first_samp_in,
                          int32_t *samp_out_wrapped) const;
 
@@ -118,14 +117,15 @@ class LinearResample {
                                     ///< = samp_rate_out_hz /
                                     ///< Gcd(samp_rate_in_hz, samp_rate_out_hz)
 
-  /// The first input-sample index that we sum over, for this output-sample
-  /// index.  May be negative; any truncation at the beginning is handled
-  /// separately.  This is just for the first few output samples, but we can
-  /// extrapolate the correct input-sample index for arbitrary output samples.
-  std::vector<int32_t> first_index_;
+  /// The polyphase filter, i.e., the first input-sample index and the
+  /// weights on the input samples for each output-sample index in a unit.
+  /// It depends only on the constructor arguments and is shared by all
+  /// objects constructed with the same arguments.
+  std::shared_ptr<const ResampleFilter> filter_;
 
-  /// Weights on the input samples, for this output-sample index.
-  std::vector<std::vector<float>> weights_;
+  /// Width of the filter from side to side, measured in input samples.
+  /// It is the size of input_remainder_.
+  int32_t max_remainder_needed_;
 
   // the following variables keep track of where we are in a particular signal,
   // if it is being provided over multiple calls to Resample().
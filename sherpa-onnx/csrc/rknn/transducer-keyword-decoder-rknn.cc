@@ -128,7 +128,7 @@ void TransducerKeywordDecoderRknn::Decode(std::vector<float> encoder_out,
                     best_hyp.ys.end()};
         r.timestamps = {best_hyp.timestamps.end() - matched_state->level,
                         best_hyp.timestamps.end()};
-        r.keyword = matched_state->phrase;
+        r.keyword = s->GetContextGraph()->Phrase(matched_state);
 
         hyps = Hypotheses({{blanks, 0, s->GetContextGraph()->Root()}});
       }
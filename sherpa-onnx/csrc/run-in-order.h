@@ -0,0 +1,121 @@
+// sherpa-onnx/csrc/run-in-order.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_RUN_IN_ORDER_H_
+#define SHERPA_ONNX_CSRC_RUN_IN_ORDER_H_
+
+#include <algorithm>
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sherpa_onnx {
+
+// Run process(i) for i = 0, 1, ..., n - 1 on num_workers threads and call
+// consume(i, result) on the calling thread in increasing order of i.
+//
+// At most 2 * num_workers items are being processed or waiting to be
+// consumed at any time, so the memory used by results is bounded
+// independent of n.
+//
+// If consume() returns false, no new items are started and RunInOrder()
+// returns after the running ones finish.
+//
+// If num_workers <= 1, everything runs on the calling thread.
+//
+// process is called concurrently from multiple threads and must be
+// thread-safe.
+template <typename Process, typename Consume>
+void RunInOrder(int32_t n, int32_t num_workers, const Process &process,
+                const Consume &consume) {
+  using Result = std::decay_t<decltype(process(0))>;
+
+  num_workers = std::max(1, std::min(num_workers, n));
+
+  if (num_workers == 1) {
+    for (int32_t i = 0; i < n; ++i) {
+      if (!consume(i, process(i))) {
+        break;
+      }
+    }
+    return;
+  }
+
+  // The following variables are protected by mutex
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::vector<Result> results(n);
+  std::vector<char> finished(n, 0);
+  int32_t next = 0;
+  int32_t num_consumed = 0;
+  bool stop = false;
+
+  int32_t max_pending = 2 * num_workers;
+
+  auto worker = [&]() {
+    while (true) {
+      int32_t i = 0;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&]() {
+          return stop || next >= n || next < num_consumed + max_pending;
+        });
+
+        if (stop || next >= n) {
+          return;
+        }
+
+        i = next;
+        ++next;
+      }
+
+      auto r = process(i);
+
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        results[i] = std::move(r);
+        finished[i] = 1;
+      }
+      cv.notify_all();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(num_workers);
+  for (int32_t k = 0; k != num_workers; ++k) {
+    threads.emplace_back(worker);
+  }
+
+  for (int32_t i = 0; i != n; ++i) {
+    Result r;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      cv.wait(lock, [&]() { return finished[i] != 0; });
+      r = std::move(results[i]);
+      ++num_consumed;
+    }
+    cv.notify_all();
+
+    if (!consume(i, std::move(r))) {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+      }
+      cv.notify_all();
+      break;
+    }
+  }
+
+  for (auto &t : threads) {
+    t.join();
+  }
+}
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_RUN_IN_ORDER_H_
@@ -3,8 +3,13 @@
 // Copyright (c)  2024  Xiaomi Corporation
 #include <stdio.h>
 
+#include <chrono>  // NOLINT
+#include <string>
+#include <vector>
+
 #include "sherpa-onnx/csrc/audio-tagging.h"
 #include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/process-file-list.h"
 #include "sherpa-onnx/csrc/wave-reader.h"
 
 int32_t main(int32_t argc, char *argv[]) {
@@ -25,6 +30,18 @@ rm sherpa-onnx-zipformer-audio-tagging-2024-04-09.tar.bz2
 Input wave files should be of single channel, 16-bit PCM encoded wave file; its
 sampling rate can be arbitrary and does not need to be 16kHz.
 
+To process many files, put their paths into a text file, one per line, and
+use
+
+./bin/sherpa-onnx-offline-audio-tagging \
+  --zipformer-model=./sherpa-onnx-zipformer-audio-tagging-2024-04-09/model.onnx \
+  --labels=./sherpa-onnx-zipformer-audio-tagging-2024-04-09/class_labels_indices.csv \
+  --file-list=./wav.list \
+  --batch-size=8 \
+  --num-workers=4
+
+The top events of each file are printed to stdout in the order of wav.list.
+
 Please see
 https://github.com/k2-fsa/sherpa-onnx/releases/tag/audio-tagging-models
 for more models.
@@ -33,14 +50,44 @@ for more models.
   sherpa_onnx::ParseOptions po(kUsageMessage);
   sherpa_onnx::AudioTaggingConfig config;
   config.Register(&po);
+
+  std::string file_list;
+  int32_t batch_size = 1;
+  int32_t num_workers = 1;
+
+  po.Register("file-list", &file_list,
+              "If not empty, it is a text file containing paths of wave "
+              "files to process, one per line.");
+
+  po.Register("batch-size", &batch_size,
+              "Used only with --file-list. Number of files to compute in a "
+              "single model call");
+
+  po.Register("num-workers", &num_workers,
+              "Used only with --file-list. Number of batches to compute in "
+              "parallel. Each worker uses --num-threads threads");
+
   po.Read(argc, argv);
 
-  if (po.NumArgs() != 1) {
+  if (file_list.empty() && po.NumArgs() != 1) {
     fprintf(stderr, "\nError: Please provide 1 wave file\n\n");
     po.PrintUsage();
     exit(EXIT_FAILURE);
   }
 
+  if (!file_list.empty() && po.NumArgs() != 0) {
+    fprintf(stderr,
+            "\nError: Please don't provide wave files when --file-list is "
+            "given\n\n");
+    po.PrintUsage();
+    exit(EXIT_FAILURE);
+  }
+
+  if (batch_size < 1 || num_workers < 1) {
+    fprintf(stderr, "--batch-size and --num-workers should be positive\n");
+    exit(EXIT_FAILURE);
+  }
+
   fprintf(stderr, "%s\n", config.ToString().c_str());
 
   if (!config.Validate()) {
@@ -49,6 +96,20 @@ for more models.
   }
 
   sherpa_onnx::AudioTagging tagger(config);
+
+  if (!file_list.empty()) {
+    return sherpa_onnx::ProcessFileList(
+        tagger, file_list, batch_size, num_workers, config.model.num_threads,
+        [](const std::string &filename,
+           const std::vector<sherpa_onnx::AudioEvent> &events) {
+          fprintf(stdout, "%s", filename.c_str());
+          for (const auto &e : events) {
+            fprintf(stdout, "\t%s:%.3f", e.name.c_str(), e.prob);
+          }
+          fprintf(stdout, "\n");
+        });
+  }
+
   std::string wav_filename = po.GetArg(1);
 
   int32_t sampling_rate = -1;
@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/process-file-list.h"
 #include "sherpa-onnx/csrc/spoken-language-identification.h"
 #include "sherpa-onnx/csrc/wave-reader.h"
 
@@ -42,19 +43,62 @@ https://k2-fsa.github.io/sherpa/onnx/pretrained_models/whisper/index.html
 Note that only whisper multilingual models are supported. For instance,
 "tiny" is supported but "tiny.en" is not.
 for a list of pre-trained models to download.
+
+(2) Process many files
+
+Put the paths of the wave files into a text file, one per line, and use
+
+./bin/sherpa-onnx-offline-spoken-language-identification \
+  --whisper-encoder=sherpa-onnx-whisper-tiny/tiny-encoder.int8.onnx \
+  --whisper-decoder=sherpa-onnx-whisper-tiny/tiny-decoder.int8.onnx \
+  --num-threads=1 \
+  --file-list=./wav.list \
+  --batch-size=8 \
+  --num-workers=4
+
+The language of each file is printed to stdout in the order of wav.list.
 )usage";
 
   sherpa_onnx::ParseOptions po(kUsageMessage);
   sherpa_onnx::SpokenLanguageIdentificationConfig config;
   config.Register(&po);
 
+  std::string file_list;
+  int32_t batch_size = 1;
+  int32_t num_workers = 1;
+
+  po.Register("file-list", &file_list,
+              "If not empty, it is a text file containing paths of wave "
+              "files to process, one per line.");
+
+  po.Register("batch-size", &batch_size,
+              "Used only with --file-list. Number of files to compute in a "
+              "single model call");
+
+  po.Register("num-workers", &num_workers,
+              "Used only with --file-list. Number of batches to compute in "
+              "parallel. Each worker uses --num-threads threads");
+
   po.Read(argc, argv);
-  if (po.NumArgs() != 1) {
+  if (file_list.empty() && po.NumArgs() != 1) {
     fprintf(stderr, "Error: Please provide 1 wave file.\n\n");
     po.PrintUsage();
     exit(EXIT_FAILURE);
   }
 
+  if (!file_list.empty() && po.NumArgs() != 0) {
+    fprintf(stderr,
+            "Error: Please don't provide wave files when --file-list is "
+            "given.\n\n");
+    po.PrintUsage();
+    exit(EXIT_FAILURE);
+  }
+
+  if (batch_size < 1 || num_workers < 1) {
+    fprintf(stderr, "--batch-size and --num-workers should be positive\n");
+    exit(EXIT_FAILURE);
+  }
+
   fprintf(stderr, "%s\n", config.ToString().c_str());
 
   if (!config.Validate()) {
@@ -65,6 +109,14 @@ for a list of pre-trained models to download.
   fprintf(stderr, "Creating spoken language identifier ...\n");
   sherpa_onnx::SpokenLanguageIdentification slid(config);
 
+  if (!file_list.empty()) {
+    return sherpa_onnx::ProcessFileList(
+        slid, file_list, batch_size, num_workers, config.num_threads,
+        [](const std::string &filename, const std::string &language) {
+          fprintf(stdout, "%s\t%s\n", filename.c_str(), language.c_str());
+        });
+  }
+
   fprintf(stderr, "Started\n");
   const std::string wav_filename = po.GetArg(1);
 
@@ -0,0 +1,435 @@
+// sherpa-onnx/csrc/sherpa-onnx-offline-pipeline.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include <stdio.h>
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "sherpa-onnx/csrc/batch-by-duration.h"
+#include "sherpa-onnx/csrc/bounded-queue.h"
+#include "sherpa-onnx/csrc/offline-recognizer.h"
+#include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/wave-reader.h"
+
+namespace {
+
+struct Input {
+  std::string id;
+  std::string path;
+};
+
+// Output of the reader stage
+struct Wave {
+  std::string id;
+  std::vector<float> samples;
+  int32_t sampling_rate = 0;
+};
+
+// Output of the feature extraction stage
+struct Utterance {
+  std::string id;
+  std::unique_ptr<sherpa_onnx::OfflineStream> stream;
+  float duration = 0;
+};
+
+using Batch = std::vector<Utterance>;
+
+// Output of the decoding stage
+struct Output {
+  std::string id;
+  float duration = 0;
+  std::string json;
+};
+
+struct Stats {
+  std::mutex mutex;
+
+  int32_t num_failed = 0;
+  int32_t num_batches = 0;
+  int32_t num_utterances = 0;
+
+  // Sum of the durations of the utterances
+  double duration = 0;
+
+  // Sum of batch_size * (duration of the longest utterance) over batches.
+  // duration / padded_duration shows how much of the computation is
+  // wasted on padding.
+  double padded_duration = 0;
+};
+
+std::vector<Input> ReadWavScp(const std::string &filename) {
+  std::vector<Input> ans;
+
+  std::ifstream is(filename);
+  if (!is) {
+    fprintf(stderr, "Failed to open '%s'\n", filename.c_str());
+    return ans;
+  }
+
+  std::string line;
+  while (std::getline(is, line)) {
+    std::istringstream iss(line);
+    Input in;
+    if (iss >> in.id >> in.path) {
+      ans.push_back(std::move(in));
+    }
+  }
+
+  return ans;
+}
+
+// Split the utterances in the pool into batches of similar durations.
+// See sherpa_onnx::BatchByDuration().
+void EmitBatches(std::vector<Utterance> *pool, int32_t batch_size,
+                 float max_batch_duration,
+                 sherpa_onnx::BoundedQueue<Batch> *batch_queue,
+                 Stats *stats) {
+  sherpa_onnx::BatchByDuration(
+      pool, batch_size, max_batch_duration,
+      [](const Utterance &u) { return u.duration; },
+      [batch_queue, stats](Batch batch) {
+        {
+          std::lock_guard<std::mutex> lock(stats->mutex);
+          stats->num_batches += 1;
+          stats->padded_duration += batch.size() * batch.back().duration;
+        }
+
+        batch_queue->Push(std::move(batch));
+      });
+}
+
+}  // namespace
+
+int main(int32_t argc, char *argv[]) {
+  const char *kUsageMessage = R"usage(
+Transcribe a large number of files with a non-streaming model.
+
+The files are processed by a pipeline of stages that run in parallel:
+
+  readers -> feature extraction -> batcher -> decoders -> writer
+
+  - readers read wave files
+  - feature extraction creates a stream for each file and computes features
+  - the batcher sorts utterances by duration within a window of
+    --sort-window utterances and groups utterances of similar durations into
+    batches of up to --batch-size utterances
+  - decoders call OfflineRecognizer::DecodeStreams() on each batch
+  - the writer writes one JSON object per line to --output
+
+Stages are connected by bounded queues, so a fast stage waits for a slow
+one and the memory usage does not grow with the number of files.
+
+Usage:
+
+  ./bin/sherpa-onnx-offline-pipeline \
+    --tokens=./sherpa-onnx-paraformer-zh-2023-09-14/tokens.txt \
+    --paraformer=./sherpa-onnx-paraformer-zh-2023-09-14/model.int8.onnx \
+    --num-threads=2 \
+    --num-decoders=2 \
+    --batch-size=16 \
+    --wav-scp=./wav.scp \
+    --output=./results.jsonl
+
+wav.scp contains one utterance per line in the form
+
+  utterance_id /path/to/foo.wav
+
+You can also pass wave files directly instead of using --wav-scp, in which
+case the path of a file is used as its utterance ID.
+
+All models supported by sherpa-onnx-offline can be used. Please refer to
+https://k2-fsa.github.io/sherpa/onnx/pretrained_models/index.html
+for a list of pre-trained models to download.
+)usage";
+
+  sherpa_onnx::ParseOptions po(kUsageMessage);
+  sherpa_onnx::OfflineRecognizerConfig config;
+  config.Register(&po);
+
+  std::string wav_scp;
+  std::string output;
+  int32_t num_readers = 2;
+  int32_t num_feature_workers = 2;
+  int32_t num_decoders = 1;
+  int32_t batch_size = 16;
+  int32_t sort_window = 0;
+  float max_batch_duration = 0;
+
+  po.Register("wav-scp", &wav_scp,
+              "Kaldi style wav.scp. Each line contains an utterance ID and "
+              "the path to a wave file");
+
+  po.Register("output", &output,
+              "Path to the output JSONL file. If empty, results are written "
+              "to stdout");
+
+  po.Register("num-readers", &num_readers,
+              "Number of threads for reading wave files");
+
+  po.Register("num-feature-workers", &num_feature_workers,
+              "Number of threads for computing features");
+
+  po.Register("num-decoders", &num_decoders,
+              "Number of batches to decode in parallel. Each decoder uses "
+              "--num-threads threads");
+
+  po.Register("batch-size", &batch_size,
+              "Maximum number of utterances in a batch");
+
+  po.Register("sort-window", &sort_window,
+              "Number of utterances to collect before sorting them by "
+              "duration and splitting them into batches. A larger value "
+              "reduces padding but increases latency and memory usage. If it "
+              "is 0, 8 * --batch-size is used");
+
+  po.Register("max-batch-duration", &max_batch_duration,
+              "If positive, limit batch size * the duration in seconds of "
+              "the longest utterance in a batch, so that batches of long "
+              "utterances are smaller");
+
+  po.Read(argc, argv);
+
+  if (po.NumArgs() < 1 && wav_scp.empty()) {
+    fprintf(stderr, "Error: Please provide at least 1 wave file.\n\n");
+    po.PrintUsage();
+    exit(EXIT_FAILURE);
+  }
+
+  if (num_readers < 1 || num_feature_workers < 1 || num_decoders < 1 ||
+      batch_size < 1 || sort_window < 0) {
+    fprintf(stderr,
+            "--num-readers, --num-feature-workers, --num-decoders and "
+            "--batch-size should be positive. --sort-window should be "
+            "non-negative\n");
+    exit(EXIT_FAILURE);
+  }
+
+  if (sort_window == 0) {
+    sort_window = 8 * batch_size;
+  }
+
+  fprintf(stderr, "%s\n", config.ToString().c_str());
+
+  if (!config.Validate()) {
+    fprintf(stderr, "Errors in config!\n");
+    return -1;
+  }
+
+  std::vector<Input> inputs;
+  if (!wav_scp.empty()) {
+    inputs = ReadWavScp(wav_scp);
+  }
+
+  for (int32_t i = 1; i <= po.NumArgs(); ++i) {
+    inputs.push_back({po.GetArg(i), po.GetArg(i)});
+  }
+
+  if (inputs.empty()) {
+    fprintf(stderr, "No wave files to process\n");
+    return -1;
+  }
+
+  FILE *fp = stdout;
+  if (!output.empty()) {
+    fp = fopen(output.c_str(), "w");
+    if (!fp) {
+      fprintf(stderr, "Failed to open '%s' for writing\n", output.c_str());
+      return -1;
+    }
+  }
+
+  fprintf(stderr, "Creating recognizer ...\n");
+  sherpa_onnx::OfflineRecognizer recognizer(config);
+
+  fprintf(stderr, "Started %d files\n", static_cast<int32_t>(inputs.size()));
+  const auto begin = std::chrono::steady_clock::now();
+
+  sherpa_onnx::BoundedQueue<Wave> wave_queue(2 * batch_size);
+  sherpa_onnx::BoundedQueue<Utterance> feature_queue(sort_window);
+  sherpa_onnx::BoundedQueue<Batch> batch_queue(2 * num_decoders);
+  sherpa_onnx::BoundedQueue<Output> output_queue(2 * batch_size);
+
+  Stats stats;
+
+  std::atomic<int32_t> next_input{0};
+
+  auto reader = [&]() {
+    while (true) {
+      int32_t i = next_input.fetch_add(1);
+      if (i >= static_cast<int32_t>(inputs.size())) {
+        break;
+      }
+
+      Wave w;
+      w.id = inputs[i].id;
+
+      bool is_ok = false;
+      w.samples =
+          sherpa_onnx::ReadWave(inputs[i].path, &w.sampling_rate, &is_ok);
+
+      if (!is_ok) {
+        fprintf(stderr, "Failed to read '%s'\n", inputs[i].path.c_str());
+
+        std::lock_guard<std::mutex> lock(stats.mutex);
+        stats.num_failed += 1;
+        continue;
+      }
+
+      wave_queue.Push(std::move(w));
+    }
+  };
+
+  auto feature_worker = [&]() {
+    Wave w;
+    while (wave_queue.Pop(&w)) {
+      Utterance u;
+      u.id = std::move(w.id);
+      u.duration = w.samples.size() / static_cast<float>(w.sampling_rate);
+      u.stream = recognizer.CreateStream();
+      u.stream->AcceptWaveform(w.sampling_rate, w.samples.data(),
+                               w.samples.size());
+
+      feature_queue.Push(std::move(u));
+    }
+  };
+
+  auto batcher = [&]() {
+    std::vector<Utterance> pool;
+    while (feature_queue.PopBatch(sort_window - pool.size(), &pool)) {
+      if (static_cast<int32_t>(pool.size()) >= sort_window) {
+        EmitBatches(&pool, batch_size, max_batch_duration, &batch_queue,
+                    &stats);
+      }
+    }
+
+    EmitBatches(&pool, batch_size, max_batch_duration, &batch_queue, &stats);
+    batch_queue.Close();
+  };
+
+  auto decoder = [&]() {
+    Batch batch;
+    std::vector<sherpa_onnx::OfflineStream *> ss;
+
+    while (batch_queue.Pop(&batch)) {
+      ss.clear();
+      for (auto &u : batch) {
+        ss.push_back(u.stream.get());
+      }
+
+      recognizer.DecodeStreams(ss.data(), ss.size());
+
+      for (auto &u : batch) {
+        Output o;
+        o.id = std::move(u.id);
+        o.duration = u.duration;
+        o.json = u.stream->GetResult().AsJsonString();
+        output_queue.Push(std::move(o));
+      }
+    }
+  };
+
+  auto writer = [&]() {
+    Output o;
+    while (output_queue.Pop(&o)) {
+      std::ostringstream os;
+      os << "{\"id\": " << std::quoted(o.id) << ", \"duration\": "
+         << std::fixed << std::setprecision(3) << o.duration
+         << ", \"result\": " << o.json << "}";
+
+      fprintf(fp, "%s\n", os.str().c_str());
+
+      std::lock_guard<std::mutex> lock(stats.mutex);
+      stats.num_utterances += 1;
+      stats.duration += o.duration;
+    }
+  };
+
+  std::vector<std::thread> readers;
+  for (int32_t i = 0; i != num_readers; ++i) {
+    readers.emplace_back(reader);
+  }
+
+  std::vector<std::thread> feature_workers;
+  for (int32_t i = 0; i != num_feature_workers; ++i) {
+    feature_workers.emplace_back(feature_worker);
+  }
+
+  std::thread batcher_thread(batcher);
+
+  std::vector<std::thread> decoders;
+  for (int32_t i = 0; i != num_decoders; ++i) {
+    decoders.emplace_back(decoder);
+  }
+
+  std::thread writer_thread(writer);
+
+  // Each queue is closed after all of its producers have finished so that
+  // its consumers exit after processing the remaining items.
+  for (auto &t : readers) {
+    t.join();
+  }
+  wave_queue.Close();
+
+  for (auto &t : feature_workers) {
+    t.join();
+  }
+  feature_queue.Close();
+
+  // The batcher closes batch_queue
+  batcher_thread.join();
+
+  for (auto &t : decoders) {
+    t.join();
+  }
+  output_queue.Close();
+
+  writer_thread.join();
+
+  if (fp != stdout) {
+    fclose(fp);
+  }
+
+  const auto end = std::chrono::steady_clock::now();
+
+  float elapsed_seconds =
+      std::chrono::duration_cast<std::chrono::milliseconds>(end - begin)
+          .count() /
+      1000.;
+
+  fprintf(stderr, "num threads: %d\n", config.model_config.num_threads);
+  fprintf(stderr, "num decoders: %d\n", num_decoders);
+  fprintf(stderr, "decoding method: %s\n", config.decoding_method.c_str());
+  fprintf(stderr, "Processed utterances: %d\n", stats.num_utterances);
+  fprintf(stderr, "Failed files: %d\n", stats.num_failed);
+  fprintf(stderr, "Number of batches: %d\n", stats.num_batches);
+  if (stats.num_batches > 0) {
+    fprintf(stderr, "Average batch size: %.2f\n",
+            stats.num_utterances / static_cast<float>(stats.num_batches));
+  }
+  if (stats.padded_duration > 0) {
+    fprintf(stderr, "Padding efficiency: %.2f%%\n",
+            stats.duration / stats.padded_duration * 100);
+  }
+  fprintf(stderr, "Total wave duration: %.3f s\n", stats.duration);
+  fprintf(stderr, "Elapsed seconds: %.3f s\n", elapsed_seconds);
+  fprintf(stderr, "Throughput: %.3f utterances/s\n",
+          stats.num_utterances / elapsed_seconds);
+
+  float rtf = elapsed_seconds / stats.duration;
+  fprintf(stderr, "Real time factor (RTF): %.3f / %.3f = %.4f\n",
+          elapsed_seconds, stats.duration, rtf);
+  fprintf(stderr, "SPEEDUP: %.4f\n", 1.0 / rtf);
+
+  return 0;
+}
@@ -105,7 +105,10 @@ wget https://github.com/k2-fsa/sherpa-onnx/releases/download/source-separation-m
   sherpa_onnx::OfflineSourceSeparation sp(config);
 
   const auto begin = std::chrono::steady_clock::now();
-  auto output = sp.Process(input);
+  auto output = sp.Process(input, [](float progress) {
+    fprintf(stderr, "Progress: %.1f%%\r", progress * 100);
+  });
+  fprintf(stderr, "\n");
   const auto end = std::chrono::steady_clock::now();
 
   float elapsed_seconds =
@@ -140,6 +143,7 @@ wget https://github.com/k2-fsa/sherpa-onnx/releases/download/source-separation-m
   float duration =
       input.samples.data[0].size() / static_cast<float>(input.sample_rate);
   fprintf(stderr, "num threads: %d\n", config.model.num_threads);
+  fprintf(stderr, "num workers: %d\n", config.num_workers);
   fprintf(stderr, "Elapsed seconds: %.3f s\n", elapsed_seconds);
   float rtf = elapsed_seconds / duration;
   fprintf(stderr, "Real time factor (RTF): %.3f / %.3f = %.3f\n",
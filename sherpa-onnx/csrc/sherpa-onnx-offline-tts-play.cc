@@ -301,6 +301,8 @@ or details.
 
   float rtf = elapsed_seconds / duration;
   fprintf(stderr, "Elapsed seconds: %.3f s\n", elapsed_seconds);
+  fprintf(stderr, "Time to first sample: %.3f s\n",
+          audio.time_to_first_sample);
   fprintf(stderr, "Audio duration: %.3f s\n", duration);
   fprintf(stderr, "Real-time factor (RTF): %.3f/%.3f = %.3f\n", elapsed_seconds,
           duration, rtf);
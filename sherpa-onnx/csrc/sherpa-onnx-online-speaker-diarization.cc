@@ -0,0 +1,117 @@
+// sherpa-onnx/csrc/sherpa-onnx-online-speaker-diarization.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "sherpa-onnx/csrc/online-speaker-diarization.h"
+#include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/wave-reader.h"
+
+int main(int32_t argc, char *argv[]) {
+  const char *kUsageMessage = R"usage(
+Streaming speaker diarization with sherpa-onnx.
+
+The input wave file is fed to the diarizer in small chunks to simulate
+live audio. Segments are printed as soon as they are finished.
+
+Please refer to ./sherpa-onnx-offline-speaker-diarization --help for
+how to download the models and test wave files.
+
+Usage example:
+
+  ./bin/sherpa-onnx-online-speaker-diarization \
+    --cluster-threshold=0.5 \
+    --segmentation.pyannote-model=./sherpa-onnx-pyannote-segmentation-3-0/model.onnx \
+    --embedding.model=./3dspeaker_speech_eres2net_base_sv_zh-cn_3dspeaker_16k.onnx \
+    ./0-four-speakers-zh.wav
+  )usage";
+  sherpa_onnx::OnlineSpeakerDiarizationConfig config;
+  sherpa_onnx::ParseOptions po(kUsageMessage);
+
+  float chunk_size = 0.1;  // in seconds
+  po.Register("chunk-size", &chunk_size,
+              "Number of seconds of audio to feed to the diarizer at a time");
+
+  config.Register(&po);
+  po.Read(argc, argv);
+
+  std::cout << config.ToString() << "\n";
+
+  if (!config.Validate()) {
+    po.PrintUsage();
+    std::cerr << "Errors in config!\n";
+    return -1;
+  }
+
+  if (po.NumArgs() != 1) {
+    std::cerr << "Error: Please provide exactly 1 wave file.\n\n";
+    po.PrintUsage();
+    return -1;
+  }
+
+  sherpa_onnx::OnlineSpeakerDiarization sd(config);
+
+  std::cout << "Started\n";
+  const auto begin = std::chrono::steady_clock::now();
+  const std::string wav_filename = po.GetArg(1);
+  int32_t sample_rate = -1;
+  bool is_ok = false;
+  const std::vector<float> samples =
+      sherpa_onnx::ReadWave(wav_filename, &sample_rate, &is_ok);
+  if (!is_ok) {
+    std::cerr << "Failed to read " << wav_filename.c_str() << "\n";
+    return -1;
+  }
+
+  if (sample_rate != sd.SampleRate()) {
+    std::cerr << "Expect sample rate " << sd.SampleRate()
+              << ". Given: " << sample_rate << "\n";
+    return -1;
+  }
+
+  float duration = samples.size() / static_cast<float>(sample_rate);
+
+  int32_t n = std::max<int32_t>(1, chunk_size * sample_rate);
+  int32_t num_samples = samples.size();
+
+  for (int32_t start = 0; start < num_samples; start += n) {
+    int32_t this_n = std::min(n, num_samples - start);
+    sd.AcceptWaveform(samples.data() + start, this_n);
+
+    while (!sd.Empty()) {
+      fprintf(stderr, "[%.3f s] %s\n",
+              static_cast<float>(start + this_n) / sample_rate,
+              sd.Front().ToString().c_str());
+      sd.Pop();
+    }
+  }
+
+  sd.Flush();
+
+  while (!sd.Empty()) {
+    fprintf(stderr, "[end] %s\n", sd.Front().ToString().c_str());
+    sd.Pop();
+  }
+
+  const auto end = std::chrono::steady_clock::now();
+  float elapsed_seconds =
+      std::chrono::duration_cast<std::chrono::milliseconds>(end - begin)
+          .count() /
+      1000.;
+
+  fprintf(stderr, "Number of speakers: %d\n", sd.NumSpeakers());
+  fprintf(stderr, "Duration : %.3f s\n", duration);
+  fprintf(stderr, "Elapsed seconds: %.3f s\n", elapsed_seconds);
+  float rtf = elapsed_seconds / duration;
+  fprintf(stderr, "Real time factor (RTF): %.3f / %.3f = %.3f\n",
+          elapsed_seconds, duration, rtf);
+
+  return 0;
+}
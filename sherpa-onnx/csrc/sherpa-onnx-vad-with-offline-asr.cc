@@ -4,20 +4,36 @@
 
 #include <stdio.h>
 
+#include <algorithm>
 #include <chrono>  // NOLINT
+#include <memory>
 #include <string>
 #include <vector>
 
-#include "sherpa-onnx/csrc/offline-recognizer.h"
 #include "sherpa-onnx/csrc/parse-options.h"
 #include "sherpa-onnx/csrc/resample.h"
-#include "sherpa-onnx/csrc/voice-activity-detector.h"
+#include "sherpa-onnx/csrc/vad-offline-recognizer.h"
 #include "sherpa-onnx/csrc/wave-reader.h"
 
+static void PrintResults(sherpa_onnx::VadOfflineRecognizer *recognizer) {
+  while (!recognizer->Empty()) {
+    const auto &r = recognizer->Front();
+    if (!r.result.text.empty()) {
+      fprintf(stderr, "%.3f -- %.3f: %s\n", r.start, r.start + r.duration,
+              r.result.text.c_str());
+    }
+    recognizer->Pop();
+  }
+}
+
 int main(int32_t argc, char *argv[]) {
   const char *kUsageMessage = R"usage(
 Speech recognition using VAD + non-streaming models with sherpa-onnx.
 
+Speech segments from the VAD are sorted by duration and decoded in batches
+of up to --batch-size segments by --num-workers threads. Results are printed
+in the order of the segments in the file.
+
 Usage:
 
 Note you can download silero_vad.onnx using
@@ -123,11 +139,8 @@ for a list of pre-trained models to download.
 )usage";
 
   sherpa_onnx::ParseOptions po(kUsageMessage);
-  sherpa_onnx::OfflineRecognizerConfig asr_config;
-  asr_config.Register(&po);
-
-  sherpa_onnx::VadModelConfig vad_config;
-  vad_config.Register(&po);
+  sherpa_onnx::VadOfflineRecognizerConfig config;
+  config.Register(&po);
 
   po.Read(argc, argv);
   if (po.NumArgs() != 1) {
@@ -137,84 +150,73 @@ for a list of pre-trained models to download.
     exit(EXIT_FAILURE);
   }
 
-  fprintf(stderr, "%s\n", vad_config.ToString().c_str());
-  fprintf(stderr, "%s\n", asr_config.ToString().c_str());
-
-  if (!vad_config.Validate()) {
-    fprintf(stderr, "Errors in vad_config!\n");
-    return -1;
-  }
+  fprintf(stderr, "%s\n", config.ToString().c_str());
 
-  if (!asr_config.Validate()) {
-    fprintf(stderr, "Errors in ASR config!\n");
+  if (!config.Validate()) {
+    fprintf(stderr, "Errors in config!\n");
     return -1;
   }
 
   fprintf(stderr, "Creating recognizer ...\n");
-  sherpa_onnx::OfflineRecognizer recognizer(asr_config);
+  sherpa_onnx::VadOfflineRecognizer recognizer(config);
   fprintf(stderr, "Recognizer created!\n");
 
-  auto vad = std::make_unique<sherpa_onnx::VoiceActivityDetector>(vad_config);
-
   fprintf(stderr, "Started\n");
   const auto begin = std::chrono::steady_clock::now();
 
   std::string wave_filename = po.GetArg(1);
   fprintf(stderr, "Reading: %s\n", wave_filename.c_str());
-  int32_t sampling_rate = -1;
-  bool is_ok = false;
-  auto samples = sherpa_onnx::ReadWave(wave_filename, &sampling_rate, &is_ok);
-  if (!is_ok) {
+  // Read the file block by block so that long files can be processed
+  // with bounded memory
+  sherpa_onnx::WaveReader reader(wave_filename);
+  if (!reader.IsOk()) {
     fprintf(stderr, "Failed to read '%s'\n", wave_filename.c_str());
     return -1;
   }
 
+  int32_t sampling_rate = reader.SampleRate();
+
+  std::unique_ptr<sherpa_onnx::LinearResample> resampler;
   if (sampling_rate != 16000) {
-    fprintf(stderr, "Resampling from %d Hz to 16000 Hz", sampling_rate);
+    fprintf(stderr, "Resampling from %d Hz to 16000 Hz\n", sampling_rate);
     float min_freq = std::min<int32_t>(sampling_rate, 16000);
     float lowpass_cutoff = 0.99 * 0.5 * min_freq;
 
     int32_t lowpass_filter_width = 6;
-    auto resampler = std::make_unique<sherpa_onnx::LinearResample>(
+    resampler = std::make_unique<sherpa_onnx::LinearResample>(
         sampling_rate, 16000, lowpass_cutoff, lowpass_filter_width);
-    std::vector<float> out_samples;
-    resampler->Resample(samples.data(), samples.size(), true, &out_samples);
-    samples = std::move(out_samples);
-    fprintf(stderr, "Resampling done\n");
   }
 
   fprintf(stderr, "Started!\n");
-  int32_t window_size = vad_config.silero_vad.window_size;
-  int32_t i = 0;
-  while (i < samples.size()) {
-    if (i + window_size <= samples.size()) {
-      vad->AcceptWaveform(samples.data() + i, window_size);
-    } else {
-      vad->Flush();
+
+  // 0.1 second per read
+  int32_t block_size = sampling_rate / 10;
+
+  std::vector<float> block;
+  std::vector<float> resampled;
+
+  // Total number of 16 kHz samples
+  int64_t num_samples = 0;
+
+  bool is_eof = false;
+  while (!is_eof) {
+    int32_t n = reader.Read(block_size, &block);
+    is_eof = (n == 0);
+
+    const std::vector<float> *samples = &block;
+    if (resampler) {
+      resampler->Resample(block.data(), n, is_eof, &resampled);
+      samples = &resampled;
     }
 
-    i += window_size;
-
-    while (!vad->Empty()) {
-      const auto &segment = vad->Front();
-      float duration = segment.samples.size() / 16000.;
-      float start_time = segment.start / 16000.;
-      float end_time = start_time + duration;
-      if (duration < 0.1) {
-        vad->Pop();
-        continue;
-      }
-
-      auto s = recognizer.CreateStream();
-      s->AcceptWaveform(16000, segment.samples.data(), segment.samples.size());
-      recognizer.DecodeStream(s.get());
-      const auto &result = s->GetResult();
-      if (!result.text.empty()) {
-        fprintf(stderr, "%.3f -- %.3f: %s\n", start_time, end_time,
-                result.text.c_str());
-      }
-      vad->Pop();
+    num_samples += samples->size();
+    recognizer.AcceptWaveform(samples->data(), samples->size());
+
+    if (is_eof) {
+      recognizer.Flush();
     }
+
+    PrintResults(&recognizer);
   }
 
   const auto end = std::chrono::steady_clock::now();
@@ -224,13 +226,16 @@ for a list of pre-trained models to download.
           .count() /
       1000.;
 
+  const auto &asr_config = config.recognizer;
   fprintf(stderr, "num threads: %d\n", asr_config.model_config.num_threads);
+  fprintf(stderr, "num workers: %d\n", config.num_workers);
+  fprintf(stderr, "batch size: %d\n", config.batch_size);
   fprintf(stderr, "decoding method: %s\n", asr_config.decoding_method.c_str());
   if (asr_config.decoding_method == "modified_beam_search") {
     fprintf(stderr, "max active paths: %d\n", asr_config.max_active_paths);
   }
 
-  float duration = samples.size() / 16000.;
+  float duration = num_samples / 16000.;
   fprintf(stderr, "Elapsed seconds: %.3f s\n", elapsed_seconds);
   float rtf = elapsed_seconds / duration;
   fprintf(stderr, "Real time factor (RTF): %.3f / %.3f = %.3f\n",
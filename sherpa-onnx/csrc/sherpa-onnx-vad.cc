@@ -7,6 +7,8 @@
 
 #include <algorithm>
 #include <iomanip>
+#include <memory>
+#include <vector>
 
 #include "sherpa-onnx/csrc/voice-activity-detector.h"
 #include "sherpa-onnx/csrc/wave-reader.h"
@@ -52,17 +54,14 @@ input.wav should be 16kHz.
   }
 
   std::string wav_filename = po.GetArg(1);
-  int32_t sampling_rate = -1;
+  sherpa_onnx::WaveReader reader(wav_filename);
 
-  bool is_ok = false;
-  std::vector<float> samples =
-      sherpa_onnx::ReadWave(wav_filename, &sampling_rate, &is_ok);
-
-  if (!is_ok) {
+  if (!reader.IsOk()) {
     fprintf(stderr, "Failed to read '%s'\n", wav_filename.c_str());
     return -1;
   }
 
+  int32_t sampling_rate = reader.SampleRate();
   if (sampling_rate != 16000) {
     fprintf(stderr, "Support only 16000Hz. Given: %d\n", sampling_rate);
     return -1;
@@ -72,15 +71,17 @@ input.wav should be 16kHz.
 
   int32_t window_size = config.silero_vad.window_size;
 
-  int32_t i = 0;
   bool is_eof = false;
 
+  // Read one window at a time so that long files can be processed with
+  // bounded memory
+  std::vector<float> samples;
+
   std::vector<float> samples_without_silence;
 
   while (!is_eof) {
-    if (i + window_size < samples.size()) {
-      vad->AcceptWaveform(samples.data() + i, window_size);
-      i += window_size;
+    if (reader.Read(window_size, &samples) == window_size) {
+      vad->AcceptWaveform(samples.data(), window_size);
     } else {
       vad->Flush();
       is_eof = true;
@@ -0,0 +1,175 @@
+// sherpa-onnx/csrc/speaker-embedding-kernels-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/speaker-embedding-kernels.h"
+
+#include <chrono>  // NOLINT
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sherpa-onnx/csrc/macros.h"
+
+namespace sherpa_onnx {
+
+static std::vector<float> RandomVector(int32_t n, std::mt19937 *mt) {
+  std::normal_distribution<float> dist;
+  std::vector<float> ans(n);
+  for (auto &f : ans) {
+    f = dist(*mt);
+  }
+  return ans;
+}
+
+TEST(SpeakerEmbeddingKernels, Dot) {
+  std::mt19937 mt(0);
+  // use dims that exercise both the vectorized and the scalar tail
+  for (int32_t dim : {1, 3, 8, 15, 16, 17, 192, 199, 256, 512}) {
+    auto a = RandomVector(dim, &mt);
+    auto b = RandomVector(dim, &mt);
+
+    double expected = 0;
+    for (int32_t i = 0; i != dim; ++i) {
+      expected += a[i] * b[i];
+    }
+
+    EXPECT_NEAR(EmbeddingDot(a.data(), b.data(), dim), expected, 1e-3);
+  }
+}
+
+TEST(SpeakerEmbeddingKernels, Normalize) {
+  std::mt19937 mt(0);
+  auto a = RandomVector(192, &mt);
+  NormalizeEmbedding(a.data(), a.size());
+  EXPECT_NEAR(EmbeddingDot(a.data(), a.data(), a.size()), 1, 1e-5);
+
+  std::vector<float> zero(10);
+  NormalizeEmbedding(zero.data(), zero.size());
+  for (auto f : zero) {
+    EXPECT_EQ(f, 0);
+  }
+}
+
+TEST(SpeakerEmbeddingKernels, Quantized) {
+  std::mt19937 mt(0);
+  for (int32_t dim : {5, 16, 23, 192, 256}) {
+    auto a = RandomVector(dim, &mt);
+    auto b = RandomVector(dim, &mt);
+    NormalizeEmbedding(a.data(), dim);
+    NormalizeEmbedding(b.data(), dim);
+
+    std::vector<int8_t> q(dim);
+    float scale = QuantizeEmbedding(a.data(), dim, q.data());
+
+    std::vector<float> a2(dim);
+    DequantizeEmbedding(q.data(), scale, dim, a2.data());
+    for (int32_t i = 0; i != dim; ++i) {
+      EXPECT_NEAR(a[i], a2[i], scale);
+    }
+
+    float expected = EmbeddingDot(a.data(), b.data(), dim);
+    EXPECT_NEAR(EmbeddingDot(q.data(), scale, b.data(), dim), expected, 1e-2);
+  }
+}
+
+TEST(SpeakerEmbeddingKernels, QuantizedTail) {
+  std::mt19937 mt(0);
+  std::uniform_int_distribution<int32_t> dist(-127, 127);
+  // every remainder of the 16-, 8- and 4-wide loops
+  for (int32_t dim = 1; dim <= 40; ++dim) {
+    std::vector<int8_t> q(dim);
+    for (auto &i : q) {
+      i = dist(mt);
+    }
+    auto v = RandomVector(dim, &mt);
+
+    double expected = 0;
+    for (int32_t i = 0; i != dim; ++i) {
+      expected += q[i] * v[i];
+    }
+    expected *= 0.5;
+
+    EXPECT_NEAR(EmbeddingDot(q.data(), 0.5f, v.data(), dim), expected, 1e-3)
+        << "dim: " << dim;
+  }
+}
+
+// Compare the vectorized kernels with a scalar implementation.
+// num_rows covers full blocks of 4 rows plus each number of remaining rows.
+TEST(SpeakerEmbeddingKernels, BatchDot) {
+  std::mt19937 mt(0);
+  for (int32_t dim : {3, 8, 17, 192}) {
+    for (int32_t num_rows = 1; num_rows <= 9; ++num_rows) {
+      auto m = RandomVector(num_rows * dim, &mt);
+      auto v = RandomVector(dim, &mt);
+
+      std::vector<int8_t> q(num_rows * dim);
+      std::vector<float> scales(num_rows);
+      for (int32_t r = 0; r != num_rows; ++r) {
+        scales[r] = QuantizeEmbedding(&m[r * dim], dim, &q[r * dim]);
+      }
+
+      std::vector<float> scores(num_rows);
+      std::vector<float> quantized_scores(num_rows);
+      EmbeddingBatchDot(m.data(), num_rows, v.data(), dim, scores.data());
+      EmbeddingBatchDot(q.data(), scales.data(), num_rows, v.data(), dim,
+                        quantized_scores.data());
+
+      for (int32_t r = 0; r != num_rows; ++r) {
+        double expected = 0;
+        double quantized_expected = 0;
+        for (int32_t i = 0; i != dim; ++i) {
+          expected += m[r * dim + i] * v[i];
+          quantized_expected += q[r * dim + i] * v[i];
+        }
+        quantized_expected *= scales[r];
+
+        EXPECT_NEAR(scores[r], expected, 1e-3)
+            << "dim: " << dim << ", num_rows: " << num_rows;
+        EXPECT_NEAR(quantized_scores[r], quantized_expected, 1e-3)
+            << "dim: " << dim << ", num_rows: " << num_rows;
+        EXPECT_NEAR(quantized_scores[r], scores[r],
+                    0.05 * std::abs(scores[r]) + 0.1);
+      }
+    }
+  }
+}
+
+// Run it with --gtest_also_run_disabled_tests
+TEST(SpeakerEmbeddingKernels, DISABLED_Benchmark) {
+  std::mt19937 mt(0);
+  int32_t dim = 192;
+  int32_t num_rows = 100000;
+
+  auto m = RandomVector(num_rows * dim, &mt);
+  auto v = RandomVector(dim, &mt);
+
+  std::vector<int8_t> q(num_rows * dim);
+  std::vector<float> scales(num_rows);
+  for (int32_t r = 0; r != num_rows; ++r) {
+    scales[r] = QuantizeEmbedding(&m[r * dim], dim, &q[r * dim]);
+  }
+
+  std::vector<float> scores(num_rows);
+
+  auto start = std::chrono::steady_clock::now();
+  EmbeddingBatchDot(m.data(), num_rows, v.data(), dim, scores.data());
+  auto stop = std::chrono::steady_clock::now();
+  auto float_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(stop - start);
+
+  start = std::chrono::steady_clock::now();
+  EmbeddingBatchDot(q.data(), scales.data(), num_rows, v.data(), dim,
+                    scores.data());
+  stop = std::chrono::steady_clock::now();
+  auto int8_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(stop - start);
+
+  SHERPA_ONNX_LOGE("Scoring %d embeddings of dim %d. float: %d us, int8: %d us",
+                   num_rows, dim, static_cast<int32_t>(float_us.count()),
+                   static_cast<int32_t>(int8_us.count()));
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,323 @@
+// sherpa-onnx/csrc/speaker-embedding-kernels.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/speaker-embedding-kernels.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "sherpa-onnx/csrc/cpu-features.h"
+
+#if SHERPA_ONNX_ENABLE_AVX2_KERNELS
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define SHERPA_ONNX_EMBEDDING_NEON 1
+#endif
+
+namespace sherpa_onnx {
+
+#if SHERPA_ONNX_ENABLE_AVX2_KERNELS
+SHERPA_ONNX_TARGET_AVX2 static inline float HorizontalSum(__m256 v) {
+  __m128 lo = _mm256_castps256_ps128(v);
+  __m128 hi = _mm256_extractf128_ps(v, 1);
+  lo = _mm_add_ps(lo, hi);
+  lo = _mm_add_ps(lo, _mm_movehl_ps(lo, lo));
+  lo = _mm_add_ss(lo, _mm_movehdup_ps(lo));
+  return _mm_cvtss_f32(lo);
+}
+
+// Convert 8 int8 values to 8 floats
+SHERPA_ONNX_TARGET_AVX2 static inline __m256 LoadInt8AsFloat(
+    const int8_t *p) {
+  __m128i i8 = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(p));
+  return _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(i8));
+}
+
+SHERPA_ONNX_TARGET_AVX2 static float EmbeddingDotAvx2(const float *a,
+                                                      const float *b,
+                                                      int32_t dim) {
+  int32_t i = 0;
+
+  __m256 sum0 = _mm256_setzero_ps();
+  __m256 sum1 = _mm256_setzero_ps();
+  for (; i + 16 <= dim; i += 16) {
+    sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i),
+                           sum0);
+    sum1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8),
+                           _mm256_loadu_ps(b + i + 8), sum1);
+  }
+
+  for (; i + 8 <= dim; i += 8) {
+    sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i),
+                           sum0);
+  }
+  float ans = HorizontalSum(_mm256_add_ps(sum0, sum1));
+
+  for (; i < dim; ++i) {
+    ans += a[i] * b[i];
+  }
+
+  return ans;
+}
+
+// Return the dot product of q and v, without the scale of q
+SHERPA_ONNX_TARGET_AVX2 static float EmbeddingDotAvx2(const int8_t *q,
+                                                      const float *v,
+                                                      int32_t dim) {
+  int32_t i = 0;
+
+  __m256 sum0 = _mm256_setzero_ps();
+  __m256 sum1 = _mm256_setzero_ps();
+  for (; i + 16 <= dim; i += 16) {
+    sum0 = _mm256_fmadd_ps(LoadInt8AsFloat(q + i), _mm256_loadu_ps(v + i),
+                           sum0);
+    sum1 = _mm256_fmadd_ps(LoadInt8AsFloat(q + i + 8),
+                           _mm256_loadu_ps(v + i + 8), sum1);
+  }
+
+  for (; i + 8 <= dim; i += 8) {
+    sum0 = _mm256_fmadd_ps(LoadInt8AsFloat(q + i), _mm256_loadu_ps(v + i),
+                           sum0);
+  }
+  float ans = HorizontalSum(_mm256_add_ps(sum0, sum1));
+
+  for (; i < dim; ++i) {
+    ans += q[i] * v[i];
+  }
+
+  return ans;
+}
+
+// Score 4 rows of m at a time so that each load of v is shared by 4 rows.
+// The remaining num_rows % 4 rows are scored one by one.
+SHERPA_ONNX_TARGET_AVX2 static void EmbeddingBatchDotAvx2(const float *m,
+                                                          int32_t num_rows,
+                                                          const float *v,
+                                                          int32_t dim,
+                                                          float *scores) {
+  int32_t r = 0;
+  for (; r + 4 <= num_rows; r += 4, m += 4 * dim) {
+    const float *m0 = m;
+    const float *m1 = m + dim;
+    const float *m2 = m + 2 * dim;
+    const float *m3 = m + 3 * dim;
+
+    __m256 sum0 = _mm256_setzero_ps();
+    __m256 sum1 = _mm256_setzero_ps();
+    __m256 sum2 = _mm256_setzero_ps();
+    __m256 sum3 = _mm256_setzero_ps();
+
+    int32_t i = 0;
+    for (; i + 8 <= dim; i += 8) {
+      __m256 x = _mm256_loadu_ps(v + i);
+      sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(m0 + i), x, sum0);
+      sum1 = _mm256_fmadd_ps(_mm256_loadu_ps(m1 + i), x, sum1);
+      sum2 = _mm256_fmadd_ps(_mm256_loadu_ps(m2 + i), x, sum2);
+      sum3 = _mm256_fmadd_ps(_mm256_loadu_ps(m3 + i), x, sum3);
+    }
+
+    float s0 = HorizontalSum(sum0);
+    float s1 = HorizontalSum(sum1);
+    float s2 = HorizontalSum(sum2);
+    float s3 = HorizontalSum(sum3);
+    for (; i < dim; ++i) {
+      s0 += m0[i] * v[i];
+      s1 += m1[i] * v[i];
+      s2 += m2[i] * v[i];
+      s3 += m3[i] * v[i];
+    }
+
+    scores[r] = s0;
+    scores[r + 1] = s1;
+    scores[r + 2] = s2;
+    scores[r + 3] = s3;
+  }
+
+  for (; r < num_rows; ++r, m += dim) {
+    scores[r] = EmbeddingDotAvx2(m, v, dim);
+  }
+}
+
+// The int8 version of the above function
+SHERPA_ONNX_TARGET_AVX2 static void EmbeddingBatchDotAvx2(
+    const int8_t *m, const float *scales, int32_t num_rows, const float *v,
+    int32_t dim, float *scores) {
+  int32_t r = 0;
+  for (; r + 4 <= num_rows; r += 4, m += 4 * dim) {
+    const int8_t *m0 = m;
+    const int8_t *m1 = m + dim;
+    const int8_t *m2 = m + 2 * dim;
+    const int8_t *m3 = m + 3 * dim;
+
+    __m256 sum0 = _mm256_setzero_ps();
+    __m256 sum1 = _mm256_setzero_ps();
+    __m256 sum2 = _mm256_setzero_ps();
+    __m256 sum3 = _mm256_setzero_ps();
+
+    int32_t i = 0;
+    for (; i + 8 <= dim; i += 8) {
+      __m256 x = _mm256_loadu_ps(v + i);
+      sum0 = _mm256_fmadd_ps(LoadInt8AsFloat(m0 + i), x, sum0);
+      sum1 = _mm256_fmadd_ps(LoadInt8AsFloat(m1 + i), x, sum1);
+      sum2 = _mm256_fmadd_ps(LoadInt8AsFloat(m2 + i), x, sum2);
+      sum3 = _mm256_fmadd_ps(LoadInt8AsFloat(m3 + i), x, sum3);
+    }
+
+    float s0 = HorizontalSum(sum0);
+    float s1 = HorizontalSum(sum1);
+    float s2 = HorizontalSum(sum2);
+    float s3 = HorizontalSum(sum3);
+    for (; i < dim; ++i) {
+      s0 += m0[i] * v[i];
+      s1 += m1[i] * v[i];
+      s2 += m2[i] * v[i];
+      s3 += m3[i] * v[i];
+    }
+
+    scores[r] = s0 * scales[r];
+    scores[r + 1] = s1 * scales[r + 1];
+    scores[r + 2] = s2 * scales[r + 2];
+    scores[r + 3] = s3 * scales[r + 3];
+  }
+
+  for (; r < num_rows; ++r, m += dim) {
+    scores[r] = EmbeddingDotAvx2(m, v, dim) * scales[r];
+  }
+}
+#endif
+
+float EmbeddingDot(const float *a, const float *b, int32_t dim) {
+#if SHERPA_ONNX_ENABLE_AVX2_KERNELS
+  if (CpuSupportsAvx2Fma()) {
+    return EmbeddingDotAvx2(a, b, dim);
+  }
+#endif
+
+  int32_t i = 0;
+  float ans = 0;
+
+#if SHERPA_ONNX_EMBEDDING_NEON
+  float32x4_t sum0 = vdupq_n_f32(0);
+  float32x4_t sum1 = vdupq_n_f32(0);
+  for (; i + 8 <= dim; i += 8) {
+    sum0 = vfmaq_f32(sum0, vld1q_f32(a + i), vld1q_f32(b + i));
+    sum1 = vfmaq_f32(sum1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+  }
+
+  for (; i + 4 <= dim; i += 4) {
+    sum0 = vfmaq_f32(sum0, vld1q_f32(a + i), vld1q_f32(b + i));
+  }
+  ans = vaddvq_f32(vaddq_f32(sum0, sum1));
+#endif
+
+  for (; i < dim; ++i) {
+    ans += a[i] * b[i];
+  }
+
+  return ans;
+}
+
+void NormalizeEmbedding(float *x, int32_t dim) {
+  float norm = std::sqrt(EmbeddingDot(x, x, dim));
+  if (norm == 0) {
+    return;
+  }
+
+  float scale = 1.0f / norm;
+  for (int32_t i = 0; i != dim; ++i) {
+    x[i] *= scale;
+  }
+}
+
+void EmbeddingBatchDot(const float *m, int32_t num_rows, const float *v,
+                       int32_t dim, float *scores) {
+#if SHERPA_ONNX_ENABLE_AVX2_KERNELS
+  if (CpuSupportsAvx2Fma()) {
+    EmbeddingBatchDotAvx2(m, num_rows, v, dim, scores);
+    return;
+  }
+#endif
+
+  for (int32_t r = 0; r != num_rows; ++r, m += dim) {
+    scores[r] = EmbeddingDot(m, v, dim);
+  }
+}
+
+float QuantizeEmbedding(const float *x, int32_t dim, int8_t *q) {
+  float max_abs = 0;
+  for (int32_t i = 0; i != dim; ++i) {
+    max_abs = std::max(max_abs, std::abs(x[i]));
+  }
+
+  if (max_abs == 0) {
+    std::fill(q, q + dim, 0);
+    return 0;
+  }
+
+  float scale = max_abs / 127;
+  float inv_scale = 1.0f / scale;
+
+  for (int32_t i = 0; i != dim; ++i) {
+    float f = std::round(x[i] * inv_scale);
+    q[i] = static_cast<int8_t>(std::min(127.0f, std::max(-127.0f, f)));
+  }
+
+  return scale;
+}
+
+void DequantizeEmbedding(const int8_t *q, float scale, int32_t dim, float *x) {
+  for (int32_t i = 0; i != dim; ++i) {
+    x[i] = q[i] * scale;
+  }
+}
+
+float EmbeddingDot(const int8_t *q, float scale, const float *v, int32_t dim) {
+#if SHERPA_ONNX_ENABLE_AVX2_KERNELS
+  if (CpuSupportsAvx2Fma()) {
+    return EmbeddingDotAvx2(q, v, dim) * scale;
+  }
+#endif
+
+  int32_t i = 0;
+  float ans = 0;
+
+#if SHERPA_ONNX_EMBEDDING_NEON
+  float32x4_t sum0 = vdupq_n_f32(0);
+  float32x4_t sum1 = vdupq_n_f32(0);
+  for (; i + 8 <= dim; i += 8) {
+    int16x8_t q16 = vmovl_s8(vld1_s8(q + i));
+    float32x4_t lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(q16)));
+    float32x4_t hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(q16)));
+
+    sum0 = vfmaq_f32(sum0, lo, vld1q_f32(v + i));
+    sum1 = vfmaq_f32(sum1, hi, vld1q_f32(v + i + 4));
+  }
+  ans = vaddvq_f32(vaddq_f32(sum0, sum1));
+#endif
+
+  // The remaining dim % 8 elements for NEON, or all of them otherwise.
+  // vld1_s8() reads 8 bytes, so it must not be used for them.
+  for (; i < dim; ++i) {
+    ans += q[i] * v[i];
+  }
+
+  return ans * scale;
+}
+
+void EmbeddingBatchDot(const int8_t *m, const float *scales, int32_t num_rows,
+                       const float *v, int32_t dim, float *scores) {
+#if SHERPA_ONNX_ENABLE_AVX2_KERNELS
+  if (CpuSupportsAvx2Fma()) {
+    EmbeddingBatchDotAvx2(m, scales, num_rows, v, dim, scores);
+    return;
+  }
+#endif
+
+  for (int32_t r = 0; r != num_rows; ++r, m += dim) {
+    scores[r] = EmbeddingDot(m, scales[r], v, dim);
+  }
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,56 @@
+// sherpa-onnx/csrc/speaker-embedding-kernels.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_SPEAKER_EMBEDDING_KERNELS_H_
+#define SHERPA_ONNX_CSRC_SPEAKER_EMBEDDING_KERNELS_H_
+
+#include <cstdint>
+
+// Kernels for scoring speaker embeddings with cosine similarity.
+//
+// On x86 CPUs with AVX2 and FMA (selected at runtime, see cpu-features.h)
+// and on CPUs with NEON, vectorized implementations are used. Otherwise,
+// a portable scalar implementation is used.
+
+namespace sherpa_onnx {
+
+// Return the dot product of a and b.
+float EmbeddingDot(const float *a, const float *b, int32_t dim);
+
+// Normalize x in-place so that its L2 norm is 1.
+// It is a no-op if x is a zero vector.
+void NormalizeEmbedding(float *x, int32_t dim);
+
+// scores[i] = EmbeddingDot(m + i * dim, v, dim) for 0 <= i < num_rows
+//
+// With AVX2, several rows are scored at a time so that v is loaded once
+// for all of them. The results may differ from EmbeddingDot() in the last
+// bits because of a different order of summation.
+//
+// @param m A row-major matrix of shape (num_rows, dim)
+void EmbeddingBatchDot(const float *m, int32_t num_rows, const float *v,
+                       int32_t dim, float *scores);
+
+// Quantize x to int8 with a per-vector scale so that
+// x[i] is approximately q[i] * scale.
+//
+// @return Return the scale.
+float QuantizeEmbedding(const float *x, int32_t dim, int8_t *q);
+
+// The inverse of QuantizeEmbedding()
+void DequantizeEmbedding(const int8_t *q, float scale, int32_t dim, float *x);
+
+// Return the dot product of (q * scale) and v.
+float EmbeddingDot(const int8_t *q, float scale, const float *v, int32_t dim);
+
+// scores[i] = EmbeddingDot(m + i * dim, scales[i], v, dim)
+// for 0 <= i < num_rows
+//
+// @param m A row-major int8 matrix of shape (num_rows, dim)
+void EmbeddingBatchDot(const int8_t *m, const float *scales, int32_t num_rows,
+                       const float *v, int32_t dim, float *scores);
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_SPEAKER_EMBEDDING_KERNELS_H_
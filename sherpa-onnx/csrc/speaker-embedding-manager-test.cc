@@ -144,4 +144,35 @@ TEST(SpeakerEmbeddingManager, Verify) {
   ASSERT_FALSE(status);
 }
 
+TEST(SpeakerEmbeddingManager, Quantized) {
+  int32_t dim = 2;
+  SpeakerEmbeddingManager manager(dim, /*quantize*/ true);
+  std::vector<float> v1 = {0.1, 0.1};
+  std::vector<float> v2 = {0.1, 0.9};
+  std::vector<float> v3 = {0.9, 0.1};
+  ASSERT_TRUE(manager.Add("first", v1.data()));
+  ASSERT_TRUE(manager.Add("second", v2.data()));
+  ASSERT_TRUE(manager.Add("third", v3.data()));
+
+  std::vector<float> v = {15, 16};
+  float threshold = 0.9;
+
+  EXPECT_EQ(manager.Search(v.data(), threshold), "first");
+  EXPECT_TRUE(manager.Verify("first", v.data(), threshold));
+  EXPECT_NEAR(manager.Score("first", v1.data()), 1, 1e-2);
+
+  v = {2, 17};
+  EXPECT_EQ(manager.Search(v.data(), threshold), "second");
+
+  ASSERT_TRUE(manager.Remove("second"));
+  EXPECT_EQ(manager.Search(v.data(), threshold), "");
+
+  v = {17, 2};
+  EXPECT_EQ(manager.Search(v.data(), threshold), "third");
+
+  std::vector<float> e = manager.GetEmbedding("third");
+  ASSERT_EQ(e.size(), dim);
+  EXPECT_NEAR(e[0] * e[0] + e[1] * e[1], 1, 1e-2);
+}
+
 }  // namespace sherpa_onnx
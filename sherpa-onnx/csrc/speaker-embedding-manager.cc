@@ -8,17 +8,14 @@
 #include <unordered_map>
 #include <utility>
 
-#include "Eigen/Dense"
 #include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/speaker-embedding-kernels.h"
 
 namespace sherpa_onnx {
 
-using FloatMatrix =
-    Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
-
 class SpeakerEmbeddingManager::Impl {
  public:
-  explicit Impl(int32_t dim) : dim_(dim) {}
+  Impl(int32_t dim, bool quantize) : dim_(dim), quantize_(quantize) {}
 
   bool Add(const std::string &name, const float *p) {
     if (name2row_.count(name)) {
@@ -26,14 +23,10 @@ class SpeakerEmbeddingManager::Impl {
       return false;
     }
 
-    embedding_matrix_.conservativeResize(embedding_matrix_.rows() + 1, dim_);
-
-    std::copy(p, p + dim_, &embedding_matrix_.bottomRows(1)(0, 0));
-
-    embedding_matrix_.bottomRows(1).normalize();  // inplace
+    std::vector<float> v(p, p + dim_);
+    NormalizeEmbedding(v.data(), dim_);
 
-    name2row_[name] = embedding_matrix_.rows() - 1;
-    row2name_[embedding_matrix_.rows() - 1] = name;
+    AddNormalized(name, v.data());
 
     return true;
   }
@@ -59,27 +52,18 @@ class SpeakerEmbeddingManager::Impl {
     }
 
     // compute the average
-    Eigen::RowVectorXf v = Eigen::Map<Eigen::RowVectorXf>(
-        const_cast<float *>(embedding_list[0].data()), dim_);
-    int32_t i = -1;
-    for (const auto &x : embedding_list) {
-      ++i;
-      if (i == 0) {
-        continue;
+    std::vector<float> v = embedding_list[0];
+    for (size_t i = 1; i < embedding_list.size(); ++i) {
+      const auto &x = embedding_list[i];
+      for (int32_t k = 0; k != dim_; ++k) {
+        v[k] += x[k];
       }
-      v += Eigen::Map<Eigen::RowVectorXf>(const_cast<float *>(x.data()), dim_);
     }
 
     // no need to compute the mean since we are going to normalize it anyway
-    // v /= embedding_list.size();
-
-    v.normalize();
+    NormalizeEmbedding(v.data(), dim_);
 
-    embedding_matrix_.conservativeResize(embedding_matrix_.rows() + 1, dim_);
-    embedding_matrix_.bottomRows(1) = v;
-
-    name2row_[name] = embedding_matrix_.rows() - 1;
-    row2name_[embedding_matrix_.rows() - 1] = name;
+    AddNormalized(name, v.data());
 
     return true;
   }
@@ -91,14 +75,17 @@ class SpeakerEmbeddingManager::Impl {
 
     int32_t row_idx = name2row_.at(name);
 
-    int32_t num_rows = embedding_matrix_.rows();
+    int32_t num_rows = NumSpeakers();
 
-    if (row_idx < num_rows - 1) {
-      embedding_matrix_.block(row_idx, 0, num_rows - 1 - row_idx, dim_) =
-          embedding_matrix_.bottomRows(num_rows - 1 - row_idx);
+    if (quantize_) {
+      quantized_.erase(quantized_.begin() + row_idx * dim_,
+                       quantized_.begin() + (row_idx + 1) * dim_);
+      scales_.erase(scales_.begin() + row_idx);
+    } else {
+      embeddings_.erase(embeddings_.begin() + row_idx * dim_,
+                        embeddings_.begin() + (row_idx + 1) * dim_);
     }
 
-    embedding_matrix_.conservativeResize(num_rows - 1, dim_);
     for (auto &p : name2row_) {
       if (p.second > row_idx) {
         p.second -= 1;
@@ -113,41 +100,32 @@ class SpeakerEmbeddingManager::Impl {
   }
 
   std::string Search(const float *p, float threshold) {
-    if (embedding_matrix_.rows() == 0) {
+    if (NumSpeakers() == 0) {
       return {};
     }
 
-    Eigen::VectorXf v =
-        Eigen::Map<Eigen::VectorXf>(const_cast<float *>(p), dim_);
-    v.normalize();
-
-    Eigen::VectorXf scores = embedding_matrix_ * v;
+    std::vector<float> scores = ComputeScores(p);
 
-    Eigen::VectorXf::Index max_index = 0;
-    float max_score = scores.maxCoeff(&max_index);
-    if (max_score < threshold) {
+    auto it = std::max_element(scores.begin(), scores.end());
+    if (*it < threshold) {
       return {};
     }
 
-    return row2name_.at(max_index);
+    return row2name_.at(it - scores.begin());
   }
 
   std::vector<SpeakerMatch> GetBestMatches(const float *p, float threshold,
                                            int32_t n) {
     std::vector<SpeakerMatch> matches;
 
-    if (embedding_matrix_.rows() == 0) {
+    if (NumSpeakers() == 0) {
       return matches;
     }
 
-    Eigen::VectorXf v =
-        Eigen::Map<Eigen::VectorXf>(const_cast<float *>(p), dim_);
-    v.normalize();
-
-    Eigen::VectorXf scores = embedding_matrix_ * v;
+    std::vector<float> scores = ComputeScores(p);
 
     std::vector<std::pair<float, int>> score_indices;
-    for (int i = 0; i < scores.size(); ++i) {
+    for (int i = 0; i < static_cast<int32_t>(scores.size()); ++i) {
       if (scores[i] >= threshold) {
         score_indices.emplace_back(scores[i], i);
       }
@@ -171,13 +149,7 @@ class SpeakerEmbeddingManager::Impl {
       return false;
     }
 
-    int32_t row_idx = name2row_.at(name);
-
-    Eigen::VectorXf v =
-        Eigen::Map<Eigen::VectorXf>(const_cast<float *>(p), dim_);
-    v.normalize();
-
-    float score = embedding_matrix_.row(row_idx) * v;
+    float score = Score(name, p);
 
     if (score < threshold) {
       return false;
@@ -194,20 +166,22 @@ class SpeakerEmbeddingManager::Impl {
 
     int32_t row_idx = name2row_.at(name);
 
-    Eigen::VectorXf v =
-        Eigen::Map<Eigen::VectorXf>(const_cast<float *>(p), dim_);
-    v.normalize();
+    std::vector<float> v(p, p + dim_);
+    NormalizeEmbedding(v.data(), dim_);
 
-    float score = embedding_matrix_.row(row_idx) * v;
+    if (quantize_) {
+      return EmbeddingDot(quantized_.data() + row_idx * dim_, scales_[row_idx],
+                          v.data(), dim_);
+    }
 
-    return score;
+    return EmbeddingDot(embeddings_.data() + row_idx * dim_, v.data(), dim_);
   }
 
   bool Contains(const std::string &name) const {
     return name2row_.count(name) > 0;
   }
 
-  int32_t NumSpeakers() const { return embedding_matrix_.rows(); }
+  int32_t NumSpeakers() const { return name2row_.size(); }
 
   int32_t Dim() const { return dim_; }
 
@@ -222,15 +196,80 @@ class SpeakerEmbeddingManager::Impl {
     return all_speakers;
   }
 
+  std::vector<float> GetEmbedding(const std::string &name) const {
+    if (!name2row_.count(name)) {
+      return {};
+    }
+
+    int32_t row_idx = name2row_.at(name);
+
+    if (quantize_) {
+      std::vector<float> ans(dim_);
+      DequantizeEmbedding(quantized_.data() + row_idx * dim_, scales_[row_idx],
+                          dim_, ans.data());
+      return ans;
+    }
+
+    const float *p = embeddings_.data() + row_idx * dim_;
+
+    return {p, p + dim_};
+  }
+
+ private:
+  // p is normalized
+  void AddNormalized(const std::string &name, const float *p) {
+    int32_t row = NumSpeakers();
+
+    if (quantize_) {
+      quantized_.resize((row + 1) * dim_);
+      scales_.push_back(QuantizeEmbedding(p, dim_, &quantized_[row * dim_]));
+    } else {
+      embeddings_.insert(embeddings_.end(), p, p + dim_);
+    }
+
+    name2row_[name] = row;
+    row2name_[row] = name;
+  }
+
+  // Return the cosine similarity between p and all speakers
+  std::vector<float> ComputeScores(const float *p) const {
+    std::vector<float> v(p, p + dim_);
+    NormalizeEmbedding(v.data(), dim_);
+
+    int32_t num_rows = NumSpeakers();
+    std::vector<float> scores(num_rows);
+
+    if (quantize_) {
+      EmbeddingBatchDot(quantized_.data(), scales_.data(), num_rows, v.data(),
+                        dim_, scores.data());
+    } else {
+      EmbeddingBatchDot(embeddings_.data(), num_rows, v.data(), dim_,
+                        scores.data());
+    }
+
+    return scores;
+  }
+
  private:
   int32_t dim_;
-  FloatMatrix embedding_matrix_;
+  bool quantize_;
+
+  // Normalized embeddings in row major. Used only if quantize_ is false.
+  std::vector<float> embeddings_;
+
+  // Used only if quantize_ is true.
+  // Row i of the normalized embeddings is quantized_[i * dim_ : (i+1) * dim_]
+  // multiplied by scales_[i]
+  std::vector<int8_t> quantized_;
+  std::vector<float> scales_;
+
   std::unordered_map<std::string, int32_t> name2row_;
   std::unordered_map<int32_t, std::string> row2name_;
 };
 
-SpeakerEmbeddingManager::SpeakerEmbeddingManager(int32_t dim)
-    : impl_(std::make_unique<Impl>(dim)) {}
+SpeakerEmbeddingManager::SpeakerEmbeddingManager(int32_t dim,
+                                                 bool quantize /*= false*/)
+    : impl_(std::make_unique<Impl>(dim, quantize)) {}
 
 SpeakerEmbeddingManager::~SpeakerEmbeddingManager() = default;
 
@@ -283,4 +322,9 @@ std::vector<std::string> SpeakerEmbeddingManager::GetAllSpeakers() const {
   return impl_->GetAllSpeakers();
 }
 
+std::vector<float> SpeakerEmbeddingManager::GetEmbedding(
+    const std::string &name) const {
+  return impl_->GetEmbedding(name);
+}
+
 }  // namespace sherpa_onnx
@@ -0,0 +1,165 @@
+// sherpa-onnx/csrc/speaker-segment-tracker-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/speaker-segment-tracker.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+struct Segment {
+  float start;
+  float end;
+  int32_t speaker;
+};
+
+static constexpr int32_t kSampleRate = 16000;
+
+// activity[s][k] is '1' if speaker s is active in frame k. A frame is
+// 0.1 second. Frames are committed every chunk_size frames, like windows
+// of the streaming diarization.
+//
+// If num_frames_before_emit is not null, num_frames_before_emit[i] is the
+// number of frames passed to Update() before the i-th segment was emitted.
+static std::vector<Segment> Track(SpeakerSegmentTracker *tracker,
+                                const std::vector<std::string> &activity,
+                                int32_t chunk_size, int64_t offset = 0,
+                                std::vector<int32_t> *num_frames_before_emit =
+                                    nullptr) {
+  int32_t num_speakers = activity.size();
+  int32_t num_frames = activity[0].size();
+  int32_t frame_shift = kSampleRate / 10;
+
+  tracker->AddSpeakers(num_speakers);
+
+  std::vector<Segment> ans;
+  auto collect = [&](int32_t num_frames_done) {
+    while (!tracker->Empty()) {
+      const auto &s = tracker->Front();
+      ans.push_back({s.Start(), s.End(), s.Speaker()});
+      if (num_frames_before_emit) {
+        num_frames_before_emit->push_back(num_frames_done);
+      }
+      tracker->Pop();
+    }
+  };
+
+  std::vector<bool> is_active(num_speakers);
+  for (int32_t k = 0; k != num_frames; ++k) {
+    for (int32_t s = 0; s != num_speakers; ++s) {
+      is_active[s] = activity[s][k] == '1';
+    }
+    tracker->Update(offset + k * frame_shift, is_active);
+
+    if ((k + 1) % chunk_size == 0 || k + 1 == num_frames) {
+      tracker->Commit(offset + (k + 1) * frame_shift);
+      collect(k + 1);
+    }
+  }
+
+  tracker->Flush();
+  collect(num_frames);
+
+  return ans;
+}
+
+static void ExpectSegment(const Segment &s, float start, float end,
+                          int32_t speaker) {
+  EXPECT_NEAR(s.start, start, 1e-4);
+  EXPECT_NEAR(s.end, end, 1e-4);
+  EXPECT_EQ(s.speaker, speaker);
+}
+
+// The result does not depend on where the chunk boundaries are
+TEST(SpeakerSegmentTracker, ChunkBoundaries) {
+  std::vector<std::string> activity = {
+      "0111111111000000000011111",
+      "0000000111111111110000000",
+  };
+
+  for (int32_t chunk_size : {1, 2, 3, 7, 10, 100}) {
+    SpeakerSegmentTracker tracker(kSampleRate, 0.3, 0.5);
+    auto segments = Track(&tracker, activity, chunk_size);
+
+    ASSERT_EQ(segments.size(), 3) << chunk_size;
+    ExpectSegment(segments[0], 0.1, 1.0, 0);
+    ExpectSegment(segments[1], 0.7, 1.8, 1);
+    ExpectSegment(segments[2], 2.0, 2.5, 0);
+  }
+}
+
+// A segment is emitted once more than min_duration_off seconds after it
+// have been committed, not at the end of the stream
+TEST(SpeakerSegmentTracker, EmitEarly) {
+  std::vector<std::string> activity = {"0111100000000000000000"};
+
+  std::vector<int32_t> num_frames_before_emit;
+  SpeakerSegmentTracker tracker(kSampleRate, 0.1, 0.5);
+  auto segments = Track(&tracker, activity, 1, 0, &num_frames_before_emit);
+
+  ASSERT_EQ(segments.size(), 1);
+  ExpectSegment(segments[0], 0.1, 0.5, 0);
+
+  // The segment ends at frame 5 and the gap must be larger than 5 frames
+  EXPECT_EQ(num_frames_before_emit[0], 11);
+}
+
+TEST(SpeakerSegmentTracker, MinDurationOn) {
+  // segments of 0.2, 0.3 and 0.4 seconds
+  std::vector<std::string> activity = {"01100000001110000000111100000"};
+
+  SpeakerSegmentTracker tracker(kSampleRate, 0.3, 0.5);
+  auto segments = Track(&tracker, activity, 4);
+
+  // A segment must be longer than min_duration_on
+  ASSERT_EQ(segments.size(), 1);
+  ExpectSegment(segments[0], 2.0, 2.4, 0);
+}
+
+TEST(SpeakerSegmentTracker, MinDurationOff) {
+  // gaps of 0.5, 0.6 and 0.3 seconds
+  std::vector<std::string> activity = {"111000001100000011000111"};
+
+  SpeakerSegmentTracker tracker(kSampleRate, 0.1, 0.5);
+  auto segments = Track(&tracker, activity, 5);
+
+  ASSERT_EQ(segments.size(), 2);
+  // The gap of 0.5 is merged
+  ExpectSegment(segments[0], 0.0, 1.0, 0);
+  // The gap of 0.3 is merged and the last segment ends at the end of
+  // the stream
+  ExpectSegment(segments[1], 1.6, 2.4, 0);
+}
+
+// Short segments that are merged can pass min_duration_on together
+TEST(SpeakerSegmentTracker, MergeBeforeMinDurationOn) {
+  std::vector<std::string> activity = {"0110110110000000"};
+
+  SpeakerSegmentTracker tracker(kSampleRate, 0.3, 0.2);
+  auto segments = Track(&tracker, activity, 3);
+
+  ASSERT_EQ(segments.size(), 1);
+  ExpectSegment(segments[0], 0.1, 0.9, 0);
+}
+
+// Sample indexes beyond the range of int32_t
+TEST(SpeakerSegmentTracker, LongStream) {
+  std::vector<std::string> activity = {"0111100000000"};
+
+  // 2^32 samples at 16 kHz, i.e., more than 74 hours
+  int64_t offset = 4294967296;
+  SpeakerSegmentTracker tracker(kSampleRate, 0.1, 0.5);
+  auto segments = Track(&tracker, activity, 3, offset);
+
+  // float has a precision of about 0.03 second at this time
+  ASSERT_EQ(segments.size(), 1);
+  double start = offset / static_cast<double>(kSampleRate);
+  EXPECT_NEAR(segments[0].start, start + 0.1, 0.05);
+  EXPECT_NEAR(segments[0].end, start + 0.5, 0.05);
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,103 @@
+// sherpa-onnx/csrc/speaker-segment-tracker.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/speaker-segment-tracker.h"
+
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace sherpa_onnx {
+
+SpeakerSegmentTracker::SpeakerSegmentTracker(int32_t sample_rate,
+                                             float min_duration_on,
+                                             float min_duration_off)
+    : sample_rate_(sample_rate),
+      min_duration_on_(min_duration_on),
+      min_duration_off_(static_cast<int64_t>(min_duration_off * sample_rate)) {
+}
+
+void SpeakerSegmentTracker::AddSpeakers(int32_t num_speakers) {
+  if (num_speakers > NumSpeakers()) {
+    active_start_.resize(num_speakers, -1);
+    pending_.resize(num_speakers, {-1, -1});
+  }
+}
+
+void SpeakerSegmentTracker::Update(int64_t t,
+                                   const std::vector<bool> &is_active) {
+  for (int32_t s = 0; s != NumSpeakers(); ++s) {
+    if (is_active[s] && active_start_[s] < 0) {
+      active_start_[s] = t;
+    } else if (!is_active[s] && active_start_[s] >= 0) {
+      AddSegment(s, active_start_[s], t);
+      active_start_[s] = -1;
+    }
+  }
+}
+
+void SpeakerSegmentTracker::Commit(int64_t t) {
+  committed_ = t;
+
+  for (int32_t s = 0; s != NumSpeakers(); ++s) {
+    if (pending_[s].first < 0) {
+      continue;
+    }
+
+    int64_t next_start = active_start_[s] >= 0 ? active_start_[s] : committed_;
+    if (next_start - pending_[s].second > min_duration_off_) {
+      EmitPending(s);
+    }
+  }
+}
+
+void SpeakerSegmentTracker::Flush() {
+  for (int32_t s = 0; s != NumSpeakers(); ++s) {
+    if (active_start_[s] >= 0) {
+      AddSegment(s, active_start_[s], committed_);
+      active_start_[s] = -1;
+    }
+
+    EmitPending(s);
+  }
+}
+
+void SpeakerSegmentTracker::Reset(int32_t num_speakers) {
+  active_start_.assign(num_speakers, -1);
+  pending_.assign(num_speakers, {-1, -1});
+  committed_ = 0;
+  std::queue<OfflineSpeakerDiarizationSegment>().swap(segments_);
+}
+
+void SpeakerSegmentTracker::AddSegment(int32_t speaker, int64_t start,
+                                       int64_t end) {
+  auto &pending = pending_[speaker];
+
+  if (pending.first >= 0 && start - pending.second <= min_duration_off_) {
+    pending.second = end;
+    return;
+  }
+
+  EmitPending(speaker);
+  pending = {start, end};
+}
+
+void SpeakerSegmentTracker::EmitPending(int32_t speaker) {
+  auto &pending = pending_[speaker];
+  if (pending.first < 0) {
+    return;
+  }
+
+  // Compare durations in samples since start and end in seconds lose
+  // precision for long streams
+  if (pending.second - pending.first > min_duration_on_ * sample_rate_) {
+    float start = pending.first / static_cast<double>(sample_rate_);
+    float end = pending.second / static_cast<double>(sample_rate_);
+    segments_.emplace(start, end, speaker);
+  }
+
+  pending = {-1, -1};
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,91 @@
+// sherpa-onnx/csrc/speaker-segment-tracker.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_SPEAKER_SEGMENT_TRACKER_H_
+#define SHERPA_ONNX_CSRC_SPEAKER_SEGMENT_TRACKER_H_
+
+#include <cstdint>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "sherpa-onnx/csrc/offline-speaker-diarization-result.h"
+
+namespace sherpa_onnx {
+
+// It converts the frame-level activity of speakers in a stream into
+// segments, which are emitted as soon as they cannot change any more.
+//
+// A segment shorter than min_duration_on seconds is discarded. Two segments
+// of the same speaker with a gap of at most min_duration_off seconds are
+// merged. So a segment is emitted after the following min_duration_off
+// seconds have been committed without the speaker being active.
+//
+// All positions are sample indexes from the start of the stream.
+class SpeakerSegmentTracker {
+ public:
+  SpeakerSegmentTracker(int32_t sample_rate, float min_duration_on,
+                        float min_duration_off);
+
+  // Increase the number of tracked speakers to num_speakers.
+  // It is a no-op if num_speakers is not larger than the current one.
+  void AddSpeakers(int32_t num_speakers);
+
+  int32_t NumSpeakers() const { return active_start_.size(); }
+
+  // Set the activity of each speaker at sample t. t must increase with each
+  // call and must not be less than Committed().
+  //
+  // @param is_active Its size must be NumSpeakers().
+  void Update(int64_t t, const std::vector<bool> &is_active);
+
+  // All samples before t have been passed to Update(). Pending segments
+  // that can no longer be merged with a later segment are emitted.
+  void Commit(int64_t t);
+
+  // Samples before it have been committed
+  int64_t Committed() const { return committed_; }
+
+  // End of the stream. Ongoing segments end at Committed() and all pending
+  // segments are emitted.
+  void Flush();
+
+  // Clear all states. The number of speakers is set to num_speakers.
+  void Reset(int32_t num_speakers);
+
+  bool Empty() const { return segments_.empty(); }
+
+  const OfflineSpeakerDiarizationSegment &Front() const {
+    return segments_.front();
+  }
+
+  void Pop() { segments_.pop(); }
+
+ private:
+  // [start, end) are sample indexes
+  void AddSegment(int32_t speaker, int64_t start, int64_t end);
+
+  void EmitPending(int32_t speaker);
+
+ private:
+  int32_t sample_rate_;
+  float min_duration_on_;  // in seconds
+  int64_t min_duration_off_;  // in samples
+
+  // active_start_[s] is the start sample of the ongoing segment of speaker s.
+  // It is -1 if speaker s is not active.
+  std::vector<int64_t> active_start_;
+
+  // pending_[s] is the last finished segment of speaker s that may still be
+  // merged with the next segment. It is {-1, -1} if there is none.
+  std::vector<std::pair<int64_t, int64_t>> pending_;
+
+  int64_t committed_ = 0;
+
+  std::queue<OfflineSpeakerDiarizationSegment> segments_;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_SPEAKER_SEGMENT_TRACKER_H_
@@ -30,7 +30,9 @@ class SpokenLanguageIdentificationImpl {
 
   virtual std::unique_ptr<OfflineStream> CreateStream() const = 0;
 
-  virtual std::string Compute(OfflineStream *s) const = 0;
+  // ans[i] is the language of ss[i]
+  virtual std::vector<std::string> Compute(OfflineStream **ss,
+                                           int32_t n) const = 0;
 };
 
 }  // namespace sherpa_onnx
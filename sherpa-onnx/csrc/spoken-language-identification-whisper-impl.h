@@ -6,6 +6,7 @@
 #define SHERPA_ONNX_CSRC_SPOKEN_LANGUAGE_IDENTIFICATION_WHISPER_IMPL_H_
 
 #include <algorithm>
+#include <array>
 #include <memory>
 #include <string>
 #include <utility>
@@ -16,6 +17,7 @@
 #include "android/asset_manager_jni.h"
 #endif
 
+#include "sherpa-onnx/csrc/batch-by-duration.h"
 #include "sherpa-onnx/csrc/offline-whisper-model.h"
 #include "sherpa-onnx/csrc/spoken-language-identification-impl.h"
 #include "sherpa-onnx/csrc/transpose.h"
@@ -44,24 +46,13 @@ class SpokenLanguageIdentificationWhisperImpl
     return std::make_unique<OfflineStream>(WhisperTag{});
   }
 
-  std::string Compute(OfflineStream *s) const override {
-    int32_t max_num_frames = 3000;
-    auto memory_info =
-        Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
-
-    int32_t feat_dim = s->FeatureDim();
-    std::vector<float> f = s->GetFrames();
-    int32_t num_frames = f.size() / feat_dim;
-
-    // we use 50 here so that there will be some zero tail paddings
-    if (num_frames >= max_num_frames - 50) {
-      SHERPA_ONNX_LOGE(
-          "Only waves less than 30 seconds are supported. We process only the "
-          "first 30 seconds and discard the remaining data");
-      num_frames = max_num_frames - 50;
+  std::vector<std::string> Compute(OfflineStream **ss,
+                                   int32_t n) const override {
+    if (n == 0) {
+      return {};
     }
 
-    model_->NormalizeFeatures(f.data(), num_frames, feat_dim);
+    int32_t max_num_frames = 3000;
 
     // note that 1000 is an experience-value.
     // You can replace 1000 by other values, say, 100.
@@ -74,32 +65,95 @@ class SpokenLanguageIdentificationWhisperImpl
       tail_padding_frames = config_.whisper.tail_paddings;
     }
 
-    int32_t actual_frames =
-        std::min(num_frames + tail_padding_frames, max_num_frames);
+    int32_t feat_dim = ss[0]->FeatureDim();
+
+    std::vector<std::vector<float>> features(n);
+    std::vector<int32_t> num_frames(n);
+
+    // Number of frames of each stream after adding tail paddings
+    std::vector<int32_t> padded_frames(n);
+
+    for (int32_t i = 0; i != n; ++i) {
+      features[i] = ss[i]->GetFrames();
+      num_frames[i] = features[i].size() / feat_dim;
+
+      // we use 50 here so that there will be some zero tail paddings
+      if (num_frames[i] >= max_num_frames - 50) {
+        SHERPA_ONNX_LOGE(
+            "Only waves less than 30 seconds are supported. We process only "
+            "the first 30 seconds and discard the remaining data");
+        num_frames[i] = max_num_frames - 50;
+      }
+
+      model_->NormalizeFeatures(features[i].data(), num_frames[i], feat_dim);
+
+      padded_frames[i] =
+          std::min(num_frames[i] + tail_padding_frames, max_num_frames);
+    }
+
+    // The model has no input for the number of frames of each stream, so
+    // a stream that is padded to the longest one in its batch gets extra
+    // tail padding frames. We group streams so that the extra padding is at
+    // most max_batch_padding frames.
+    std::vector<std::vector<int32_t>> groups =
+        GroupByLength(padded_frames, config_.whisper.max_batch_padding);
+
+    if (config_.debug) {
+      SHERPA_ONNX_LOGE("%d streams in %d batches", n,
+                       static_cast<int32_t>(groups.size()));
+    }
+
+    std::vector<std::string> ans(n);
 
-    std::array<int64_t, 3> shape{1, actual_frames, feat_dim};
+    for (const auto &g : groups) {
+      ComputeBatch(features, num_frames, g.data(), g.size(),
+                   padded_frames[g.back()], feat_dim, tail_padding_frames,
+                   &ans);
+    }
+
+    return ans;
+  }
+
+ private:
+  // Compute the languages of streams indexes[0], ..., indexes[batch_size-1],
+  // which are padded to actual_frames frames, and save them in *ans.
+  void ComputeBatch(const std::vector<std::vector<float>> &features,
+                    const std::vector<int32_t> &num_frames,
+                    const int32_t *indexes, int32_t batch_size,
+                    int32_t actual_frames, int32_t feat_dim,
+                    int32_t tail_padding_frames,
+                    std::vector<std::string> *ans) const {
+    std::array<int64_t, 3> shape{batch_size, actual_frames, feat_dim};
 
     Ort::Value mel = Ort::Value::CreateTensor<float>(
         model_->Allocator(), shape.data(), shape.size());
 
     float *p_mel = mel.GetTensorMutableData<float>();
-    std::copy(f.data(), f.data() + num_frames * feat_dim, p_mel);
-
-    std::fill_n(p_mel + num_frames * feat_dim,
-                (actual_frames - num_frames) * feat_dim, 0);
+    std::fill_n(p_mel, batch_size * actual_frames * feat_dim, 0);
+
+    int32_t max_input_frames = 0;
+    for (int32_t i = 0; i != batch_size; ++i) {
+      const auto &f = features[indexes[i]];
+      int32_t n = num_frames[indexes[i]];
+      std::copy(f.data(), f.data() + n * feat_dim,
+                p_mel + i * actual_frames * feat_dim);
+      max_input_frames = std::max(max_input_frames, n);
+    }
 
     mel = Transpose12(model_->Allocator(), &mel);
 
     try {
       auto cross_kv = model_->ForwardEncoder(std::move(mel));
-      int32_t lang_id = model_->DetectLanguage(cross_kv.first, cross_kv.second);
+      auto lang_ids = model_->DetectLanguages(cross_kv.first, cross_kv.second);
       const auto &id2lang = model_->GetID2Lang();
-      if (id2lang.count(lang_id)) {
-        return id2lang.at(lang_id);
-      } else {
-        SHERPA_ONNX_LOGE("Unknown language ID: %d. Return an empty string.",
-                         lang_id);
-        return "";
+
+      for (int32_t i = 0; i != batch_size; ++i) {
+        if (id2lang.count(lang_ids[i])) {
+          (*ans)[indexes[i]] = id2lang.at(lang_ids[i]);
+        } else {
+          SHERPA_ONNX_LOGE("Unknown language ID: %d. Return an empty string.",
+                           lang_ids[i]);
+        }
       }
     } catch (const Ort::Exception &ex) {
       SHERPA_ONNX_LOGE(
@@ -107,12 +161,10 @@ class SpokenLanguageIdentificationWhisperImpl
           "input frames: %d, Current tail "
           "paddings: %d. If you see a lot of such exceptions, please consider "
           "using a larger --whisper-tail-paddings",
-          ex.what(), num_frames, tail_padding_frames);
-      return "";
+          ex.what(), max_input_frames, tail_padding_frames);
     }
   }
 
- private:
   void Check() const {
     if (!model_->IsMultiLingual()) {
       SHERPA_ONNX_LOGE(
@@ -34,6 +34,12 @@ void SpokenLanguageIdentificationWhisperConfig::Register(ParseOptions *po) {
       "Since we have removed the 30-second constraint, we need to add some "
       "tail padding frames "
       "so that whisper can detect the eot token. Leave it to -1 to use 1000");
+
+  po->Register(
+      "whisper-max-batch-padding", &max_batch_padding,
+      "Streams whose numbers of frames differ by at most this value are "
+      "computed in the same batch. Shorter streams get extra tail padding "
+      "frames. 0 batches only streams of the same length.");
 }
 
 bool SpokenLanguageIdentificationWhisperConfig::Validate() const {
@@ -59,6 +65,13 @@ bool SpokenLanguageIdentificationWhisperConfig::Validate() const {
     return false;
   }
 
+  if (max_batch_padding < 0) {
+    SHERPA_ONNX_LOGE("--whisper-max-batch-padding should be non-negative. "
+                     "Given: %d",
+                     max_batch_padding);
+    return false;
+  }
+
   return true;
 }
 
@@ -68,7 +81,8 @@ std::string SpokenLanguageIdentificationWhisperConfig::ToString() const {
   os << "SpokenLanguageIdentificationWhisperConfig(";
   os << "encoder=\"" << encoder << "\", ";
   os << "decoder=\"" << decoder << "\", ";
-  os << "tail_paddings=" << tail_paddings << ")";
+  os << "tail_paddings=" << tail_paddings << ", ";
+  os << "max_batch_padding=" << max_batch_padding << ")";
 
   return os.str();
 }
@@ -124,7 +138,12 @@ std::unique_ptr<OfflineStream> SpokenLanguageIdentification::CreateStream()
 }
 
 std::string SpokenLanguageIdentification::Compute(OfflineStream *s) const {
-  return impl_->Compute(s);
+  return impl_->Compute(&s, 1)[0];
+}
+
+std::vector<std::string> SpokenLanguageIdentification::Compute(
+    OfflineStream **ss, int32_t n) const {
+  return impl_->Compute(ss, n);
 }
 
 }  // namespace sherpa_onnx
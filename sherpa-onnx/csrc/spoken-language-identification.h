@@ -34,12 +34,23 @@ struct SpokenLanguageIdentificationWhisperConfig {
   //   - 300 for multilingual models
   int32_t tail_paddings = -1;
 
+  // When a batch of streams is computed, streams whose numbers of frames
+  // after adding tail paddings differ by at most this value are put into
+  // the same batch. Shorter streams of the batch get extra tail padding
+  // frames, which have little effect on the result. 0 batches only streams
+  // of the same length.
+  int32_t max_batch_padding = 100;
+
   SpokenLanguageIdentificationWhisperConfig() = default;
 
   SpokenLanguageIdentificationWhisperConfig(const std::string &encoder,
                                             const std::string &decoder,
-                                            int32_t tail_paddings)
-      : encoder(encoder), decoder(decoder), tail_paddings(tail_paddings) {}
+                                            int32_t tail_paddings,
+                                            int32_t max_batch_padding = 100)
+      : encoder(encoder),
+        decoder(decoder),
+        tail_paddings(tail_paddings),
+        max_batch_padding(max_batch_padding) {}
 
   void Register(ParseOptions *po);
   bool Validate() const;
@@ -70,6 +81,11 @@ struct SpokenLanguageIdentificationConfig {
 
 class SpokenLanguageIdentificationImpl;
 
+// If you also need the transcript, please don't run this class and then an
+// OfflineRecognizer with the same whisper model, which computes the features
+// and runs the encoder twice. Instead, leave --whisper-language empty for
+// the OfflineRecognizer. It detects the language from the encoder output
+// used for decoding and returns it in OfflineRecognitionResult::lang.
 class SpokenLanguageIdentification {
  public:
   explicit SpokenLanguageIdentification(
@@ -90,6 +106,12 @@ class SpokenLanguageIdentification {
   // Note: en is for English, zh is for Chinese, de is for German, etc.
   std::string Compute(OfflineStream *s) const;
 
+  // Compute n streams in a batch. ans[i] is the language of ss[i].
+  //
+  // Only streams with the same number of frames after tail padding are run
+  // in the same batch, so the result is the same as Compute(ss[i]).
+  std::vector<std::string> Compute(OfflineStream **ss, int32_t n) const;
+
  private:
   std::unique_ptr<SpokenLanguageIdentificationImpl> impl_;
 };
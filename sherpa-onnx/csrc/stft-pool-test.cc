@@ -0,0 +1,147 @@
+// sherpa-onnx/csrc/stft-pool-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/stft-pool.h"
+
+#include <chrono>  // NOLINT
+#include <cmath>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "kaldi-native-fbank/csrc/feature-window.h"
+#include "sherpa-onnx/csrc/macros.h"
+
+namespace sherpa_onnx {
+
+static knf::StftConfig GetTestConfig() {
+  knf::StftConfig config;
+  config.n_fft = 512;
+  config.hop_length = 128;
+  config.win_length = 512;
+  config.window_type = "hann";
+  config.center = true;
+  return config;
+}
+
+static std::vector<float> GetTestSamples(int32_t n) {
+  std::vector<float> samples(n);
+  for (int32_t i = 0; i != n; ++i) {
+    samples[i] = std::sin(0.01f * i) + 0.5f * std::cos(0.3f * i);
+  }
+  return samples;
+}
+
+TEST(StftPool, SameAsStft) {
+  auto config = GetTestConfig();
+
+  StftPool pool(config);
+
+  // Reused objects give the same result as fresh ones for inputs of any
+  // size, including the frame-sized chunks of GTCRN and UVR
+  for (int32_t n : {16000, 2048, 513, 16000, 2048}) {
+    auto samples = GetTestSamples(n);
+
+    knf::Stft stft(config);
+    knf::IStft istft(config);
+
+    auto expected = stft.Compute(samples.data(), samples.size());
+
+    for (int32_t i = 0; i != 3; ++i) {
+      auto r = pool.Compute(samples.data(), samples.size());
+      EXPECT_EQ(r.num_frames, expected.num_frames) << n;
+      EXPECT_EQ(r.real, expected.real) << n;
+      EXPECT_EQ(r.imag, expected.imag) << n;
+
+      EXPECT_EQ(pool.InverseCompute(r), istft.Compute(expected)) << n;
+    }
+  }
+}
+
+TEST(StftPool, HannSqrt) {
+  auto config = GetTestConfig();
+  config.window_type = "hann_sqrt";
+
+  StftPool pool(config);
+
+  auto hann = knf::GetWindow("hann", config.win_length);
+  const auto &window = pool.GetConfig().window;
+
+  ASSERT_EQ(window.size(), hann.size());
+  for (int32_t i = 0; i != static_cast<int32_t>(hann.size()); ++i) {
+    EXPECT_NEAR(window[i] * window[i], hann[i], 1e-6);
+  }
+}
+
+TEST(StftPool, MultipleThreads) {
+  auto config = GetTestConfig();
+  auto samples = GetTestSamples(8000);
+
+  StftPool pool(config);
+  auto expected = pool.InverseCompute(pool.Compute(samples.data(),
+                                                   samples.size()));
+
+  int32_t num_threads = 4;
+  std::vector<std::vector<float>> results(num_threads);
+
+  std::vector<std::thread> threads;
+  for (int32_t t = 0; t != num_threads; ++t) {
+    threads.emplace_back([&, t]() {
+      for (int32_t i = 0; i != 10; ++i) {
+        results[t] =
+            pool.InverseCompute(pool.Compute(samples.data(), samples.size()));
+      }
+    });
+  }
+
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  for (const auto &r : results) {
+    EXPECT_EQ(r, expected);
+  }
+}
+
+// Compare the pool with constructing knf::Stft and knf::IStft for every
+// call, which is what the vocoder, denoiser and source separation code did.
+// Run it with --gtest_also_run_disabled_tests
+TEST(StftPool, DISABLED_Benchmark) {
+  auto config = GetTestConfig();
+
+  // About one frame-sized call, as in the GTCRN and UVR chunk loops
+  auto samples = GetTestSamples(2048);
+  int32_t num_iters = 2000;
+
+  std::vector<float> expected;
+
+  auto begin = std::chrono::steady_clock::now();
+  for (int32_t i = 0; i != num_iters; ++i) {
+    knf::Stft stft(config);
+    auto r = stft.Compute(samples.data(), samples.size());
+
+    knf::IStft istft(config);
+    expected = istft.Compute(r);
+  }
+  auto end = std::chrono::steady_clock::now();
+  float per_call_seconds = std::chrono::duration<float>(end - begin).count();
+
+  StftPool pool(config);
+
+  begin = std::chrono::steady_clock::now();
+  for (int32_t i = 0; i != num_iters; ++i) {
+    auto r = pool.Compute(samples.data(), samples.size());
+    auto s = pool.InverseCompute(r);
+    EXPECT_EQ(s, expected);
+  }
+  end = std::chrono::steady_clock::now();
+  float pool_seconds = std::chrono::duration<float>(end - begin).count();
+
+  SHERPA_ONNX_LOGE("Construct per call: %.3f ms per iteration",
+                   per_call_seconds * 1000 / num_iters);
+  SHERPA_ONNX_LOGE("StftPool: %.3f ms per iteration",
+                   pool_seconds * 1000 / num_iters);
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,68 @@
+// sherpa-onnx/csrc/stft-pool.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/stft-pool.h"
+
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "kaldi-native-fbank/csrc/feature-window.h"
+
+namespace sherpa_onnx {
+
+// Take an object out of the pool or create a new one if the pool is empty
+template <typename T>
+static std::unique_ptr<T> Acquire(const knf::StftConfig &config,
+                                  std::mutex *mutex,
+                                  std::vector<std::unique_ptr<T>> *pool) {
+  {
+    std::lock_guard<std::mutex> lock(*mutex);
+    if (!pool->empty()) {
+      auto ans = std::move(pool->back());
+      pool->pop_back();
+      return ans;
+    }
+  }
+
+  return std::make_unique<T>(config);
+}
+
+template <typename T>
+static void Release(std::unique_ptr<T> p, std::mutex *mutex,
+                    std::vector<std::unique_ptr<T>> *pool) {
+  std::lock_guard<std::mutex> lock(*mutex);
+  pool->push_back(std::move(p));
+}
+
+StftPool::StftPool(const knf::StftConfig &config) : config_(config) {
+  if (config_.window_type == "hann_sqrt" && config_.window.empty()) {
+    auto window = knf::GetWindow("hann", config_.win_length);
+    for (auto &w : window) {
+      w = std::sqrt(w);
+    }
+    config_.window = std::move(window);
+  }
+}
+
+StftPool::~StftPool() = default;
+
+knf::StftResult StftPool::Compute(const float *samples, int32_t n) const {
+  auto stft = Acquire(config_, &mutex_, &stft_);
+  auto ans = stft->Compute(samples, n);
+  Release(std::move(stft), &mutex_, &stft_);
+
+  return ans;
+}
+
+std::vector<float> StftPool::InverseCompute(const knf::StftResult &r) const {
+  auto istft = Acquire(config_, &mutex_, &istft_);
+  auto ans = istft->Compute(r);
+  Release(std::move(istft), &mutex_, &istft_);
+
+  return ans;
+}
+
+}  // namespace sherpa_onnx
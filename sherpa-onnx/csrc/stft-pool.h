@@ -0,0 +1,50 @@
+// sherpa-onnx/csrc/stft-pool.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_STFT_POOL_H_
+#define SHERPA_ONNX_CSRC_STFT_POOL_H_
+
+#include <memory>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "kaldi-native-fbank/csrc/istft.h"
+#include "kaldi-native-fbank/csrc/stft.h"
+
+namespace sherpa_onnx {
+
+// STFT and inverse STFT for a fixed config.
+//
+// knf::Stft and knf::IStft compute the window and the FFT tables in their
+// constructors. Instead of constructing them for every call, this class
+// keeps constructed objects in a pool and reuses them. An object is taken
+// out of the pool while it is in use, so Compute() and InverseCompute() can
+// be called from multiple threads.
+class StftPool {
+ public:
+  // If config.window_type is "hann_sqrt" and config.window is empty, the
+  // window is set to the square root of a hann window.
+  explicit StftPool(const knf::StftConfig &config);
+
+  ~StftPool();
+
+  const knf::StftConfig &GetConfig() const { return config_; }
+
+  knf::StftResult Compute(const float *samples, int32_t n) const;
+
+  std::vector<float> InverseCompute(const knf::StftResult &r) const;
+
+ private:
+  knf::StftConfig config_;
+
+  mutable std::mutex mutex_;
+
+  // Objects that are not in use
+  mutable std::vector<std::unique_ptr<knf::Stft>> stft_;
+  mutable std::vector<std::unique_ptr<knf::IStft>> istft_;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_STFT_POOL_H_
@@ -0,0 +1,217 @@
+// sherpa-onnx/csrc/text-segmenter-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/text-segmenter.h"
+
+#include <chrono>  // NOLINT
+#include <regex>   // NOLINT
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/text-utils.h"
+
+namespace sherpa_onnx {
+
+static const std::vector<std::pair<std::string, std::string>> &
+KokoroPunctuations() {
+  static const std::vector<std::pair<std::string, std::string>> pairs = {
+      {"，", ","}, {":", ","}, {"、", ","}, {"；", ";"},
+      {"：", ":"}, {"。", "."}, {"？", "?"}, {"！", "!"},
+  };
+  return pairs;
+}
+
+// The implementation using std::regex that PunctuationMap replaces
+static std::string RegexNormalize(const std::string &text) {
+  std::string s = text;
+  for (const auto &p : KokoroPunctuations()) {
+    std::regex re(p.first);
+    s = std::regex_replace(s, re, p.second);
+  }
+
+  std::regex re("\\s+");
+  return std::regex_replace(s, re, " ");
+}
+
+// The implementation using std::wregex that SplitChineseAndNonChinese()
+// replaces
+static std::vector<TextSegment> RegexSplit(const std::string &text) {
+  std::string expr_chinese = "([\\u4e00-\\u9fff]+)";
+  std::string expr_not_chinese = "([^\\u4e00-\\u9fff]+)";
+
+  std::wregex we_both(ToWideString(expr_chinese + "|" + expr_not_chinese));
+  std::wregex we_zh(ToWideString(expr_chinese));
+
+  auto ws = ToWideString(text);
+
+  std::vector<TextSegment> ans;
+  auto begin = std::wsregex_iterator(ws.begin(), ws.end(), we_both);
+  auto end = std::wsregex_iterator();
+  for (auto i = begin; i != end; ++i) {
+    std::wstring match_str = i->str();
+    ans.push_back({ToString(match_str), std::regex_match(match_str, we_zh)});
+  }
+
+  return ans;
+}
+
+static const std::vector<std::string> &TestSentences() {
+  static const std::vector<std::string> sentences = {
+      "",
+      "Hello",
+      "你好",
+      "中英文混合 mixed text，测试！How are you?  I'm fine：ok.",
+      "Time: 10:30。下一句；还有、顿号\t\n end",
+      "  leading and trailing spaces  ",
+      "émigré café naïve – “quotes” … 日本語テキスト",
+      "数字123和English单词混在一起，然后是😀表情",
+  };
+  return sentences;
+}
+
+TEST(TextSegmenter, DecodeUtf8) {
+  char32_t cp = 0;
+  EXPECT_EQ(DecodeUtf8("a", 0, &cp), 1);
+  EXPECT_EQ(cp, U'a');
+
+  EXPECT_EQ(DecodeUtf8("é", 0, &cp), 2);
+  EXPECT_EQ(cp, U'é');
+
+  EXPECT_EQ(DecodeUtf8("中", 0, &cp), 3);
+  EXPECT_EQ(cp, U'中');
+
+  EXPECT_EQ(DecodeUtf8("😀", 0, &cp), 4);
+  EXPECT_EQ(cp, U'😀');
+
+  // truncated and invalid sequences
+  std::string s = "中";
+  EXPECT_EQ(DecodeUtf8(s.substr(0, 2), 0, &cp), 1);
+  EXPECT_EQ(cp, 0xfffd);
+
+  EXPECT_EQ(DecodeUtf8("\x80", 0, &cp), 1);
+  EXPECT_EQ(cp, 0xfffd);
+}
+
+TEST(TextSegmenter, PunctuationMap) {
+  PunctuationMap m(KokoroPunctuations(), /*merge_spaces*/ true);
+
+  for (const auto &s : TestSentences()) {
+    EXPECT_EQ(m.Apply(s), RegexNormalize(s)) << s;
+  }
+
+  PunctuationMap m2({{"，", ""}, {"!", "！"}});
+  EXPECT_EQ(m2.Apply("a，b!  c"), "ab！  c");
+}
+
+TEST(TextSegmenter, SplitChineseAndNonChinese) {
+  for (const auto &s : TestSentences()) {
+    auto segments = SplitChineseAndNonChinese(s);
+    auto expected = RegexSplit(s);
+
+    ASSERT_EQ(segments.size(), expected.size()) << s;
+    for (size_t i = 0; i != segments.size(); ++i) {
+      EXPECT_EQ(segments[i].text, expected[i].text);
+      EXPECT_EQ(segments[i].is_chinese, expected[i].is_chinese);
+    }
+  }
+}
+
+TEST(TextSegmenter, SplitSentences) {
+  auto sentences =
+      SplitSentences("  It costs 3.14 dollars. Really?!  好的。再见！ end");
+
+  std::vector<std::string> expected = {"It costs 3.14 dollars.", "Really?!",
+                                       "好的。", "再见！", "end"};
+  EXPECT_EQ(sentences, expected);
+
+  EXPECT_TRUE(SplitSentences("").empty());
+  EXPECT_TRUE(SplitSentences("  \n ").empty());
+}
+
+TEST(TextSegmenter, SplitFirstClause) {
+  struct TestCase {
+    std::string text;
+    std::string head;  // empty if the text is not split
+  };
+
+  std::vector<TestCase> test_cases = {
+      {"Hello, world.", "Hello,"},
+      {"Wait! Then go.", "Wait!"},
+      // decimals and dotted abbreviations are not followed by a space
+      {"It costs 3.14 dollars, right?", "It costs 3.14 dollars,"},
+      {"Dr. Smith is here. Bye", "Dr. Smith is here."},
+      {"The U.S. team won. Great", "The U.S. team won."},
+      {"Use e.g. this one. OK", "Use e.g. this one."},
+      // a single letter ends a sentence unless the next word is lowercase
+      {"Plan A. Then plan B.", "Plan A."},
+      {"Me, I. Then you.", "Me,"},
+      {"It was I. Then you.", "It was I."},
+      {"Call J. smith now. OK", "Call J. smith now."},
+      // CJK punctuations
+      {"你好，世界。", "你好，"},
+      {"今天很好。明天见", "今天很好。"},
+      {"苹果、香蕉", "苹果、"},
+      // no words before or after the punctuation
+      {", hello world", ""},
+      {"Hello world,", ""},
+      {"Hello world, ", ""},
+      {"Hello world, ...", ""},
+      {"你好，", ""},
+      {"No punctuation here", ""},
+      {"", ""},
+  };
+
+  for (const auto &t : test_cases) {
+    std::string head;
+    std::string tail;
+    bool ok = SplitFirstClause(t.text, &head, &tail);
+    EXPECT_EQ(ok, !t.head.empty()) << t.text;
+    if (ok) {
+      EXPECT_EQ(head, t.head) << t.text;
+      EXPECT_EQ(head + tail, t.text);
+    }
+  }
+}
+
+TEST(TextSegmenter, Benchmark) {
+  std::string text;
+  for (int32_t i = 0; i != 20; ++i) {
+    for (const auto &s : TestSentences()) {
+      text += s;
+    }
+  }
+
+  int32_t num_chars = static_cast<int32_t>(SplitUtf8(text).size());
+  int32_t num_iters = 50;
+
+  auto begin = std::chrono::steady_clock::now();
+  for (int32_t i = 0; i != num_iters; ++i) {
+    auto s = RegexNormalize(text);
+    auto segments = RegexSplit(s);
+    EXPECT_FALSE(segments.empty());
+  }
+  auto end = std::chrono::steady_clock::now();
+  float regex_seconds = std::chrono::duration<float>(end - begin).count();
+
+  PunctuationMap m(KokoroPunctuations(), /*merge_spaces*/ true);
+
+  begin = std::chrono::steady_clock::now();
+  for (int32_t i = 0; i != num_iters; ++i) {
+    auto s = m.Apply(text);
+    auto segments = SplitChineseAndNonChinese(s);
+    EXPECT_FALSE(segments.empty());
+  }
+  end = std::chrono::steady_clock::now();
+  float seconds = std::chrono::duration<float>(end - begin).count();
+
+  SHERPA_ONNX_LOGE("std::regex: %.3e characters/second",
+                   num_chars * num_iters / regex_seconds);
+  SHERPA_ONNX_LOGE("PunctuationMap: %.3e characters/second",
+                   num_chars * num_iters / seconds);
+}
+
+}  // namespace sherpa_onnx
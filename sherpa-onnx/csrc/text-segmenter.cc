@@ -0,0 +1,339 @@
+// sherpa-onnx/csrc/text-segmenter.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/text-segmenter.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/text-utils.h"
+
+namespace sherpa_onnx {
+
+int32_t DecodeUtf8(const std::string &text, int32_t pos, char32_t *cp) {
+  int32_t n = static_cast<int32_t>(text.size());
+  const auto *p = reinterpret_cast<const uint8_t *>(text.data()) + pos;
+
+  uint8_t c = p[0];
+  if (c < 0x80) {
+    *cp = c;
+    return 1;
+  }
+
+  int32_t len = 0;
+  char32_t value = 0;
+  if ((c & 0xe0) == 0xc0) {
+    len = 2;
+    value = c & 0x1f;
+  } else if ((c & 0xf0) == 0xe0) {
+    len = 3;
+    value = c & 0x0f;
+  } else if ((c & 0xf8) == 0xf0) {
+    len = 4;
+    value = c & 0x07;
+  } else {
+    *cp = 0xfffd;
+    return 1;
+  }
+
+  if (pos + len > n) {
+    *cp = 0xfffd;
+    return 1;
+  }
+
+  for (int32_t i = 1; i != len; ++i) {
+    if ((p[i] & 0xc0) != 0x80) {
+      *cp = 0xfffd;
+      return 1;
+    }
+    value = (value << 6) | (p[i] & 0x3f);
+  }
+
+  *cp = value;
+  return len;
+}
+
+PunctuationMap::PunctuationMap(
+    const std::vector<std::pair<std::string, std::string>> &pairs,
+    bool merge_spaces /*= false*/)
+    : merge_spaces_(merge_spaces) {
+  ascii_.fill(-1);
+
+  replacements_.reserve(pairs.size());
+
+  for (const auto &p : pairs) {
+    char32_t cp = 0;
+    if (p.first.empty() ||
+        DecodeUtf8(p.first, 0, &cp) != static_cast<int32_t>(p.first.size())) {
+      SHERPA_ONNX_LOGE("Expect a single code point. Given: '%s'",
+                       p.first.c_str());
+      SHERPA_ONNX_EXIT(-1);
+    }
+
+    int32_t index = static_cast<int32_t>(replacements_.size());
+    replacements_.push_back(p.second);
+
+    if (cp < 0x80) {
+      ascii_[cp] = index;
+    } else {
+      non_ascii_[cp] = index;
+    }
+  }
+}
+
+static bool IsAsciiSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' ||
+         c == '\r';
+}
+
+std::string PunctuationMap::Apply(const std::string &text) const {
+  std::string ans;
+  ans.reserve(text.size());
+
+  int32_t n = static_cast<int32_t>(text.size());
+  int32_t i = 0;
+  while (i < n) {
+    char c = text[i];
+    if (static_cast<uint8_t>(c) < 0x80) {
+      if (merge_spaces_ && IsAsciiSpace(c)) {
+        while (i < n && IsAsciiSpace(text[i])) {
+          ++i;
+        }
+        ans.push_back(' ');
+        continue;
+      }
+
+      int32_t index = ascii_[static_cast<uint8_t>(c)];
+      if (index == -1) {
+        ans.push_back(c);
+      } else {
+        ans.append(replacements_[index]);
+      }
+      ++i;
+      continue;
+    }
+
+    char32_t cp = 0;
+    int32_t len = DecodeUtf8(text, i, &cp);
+
+    auto it = non_ascii_.find(cp);
+    if (it == non_ascii_.end()) {
+      ans.append(text, i, len);
+    } else {
+      ans.append(replacements_[it->second]);
+    }
+
+    i += len;
+  }
+
+  return ans;
+}
+
+std::vector<TextSegment> SplitChineseAndNonChinese(const std::string &text) {
+  std::vector<TextSegment> ans;
+
+  int32_t n = static_cast<int32_t>(text.size());
+  int32_t start = 0;
+  bool is_chinese = false;
+
+  int32_t i = 0;
+  while (i < n) {
+    char32_t cp = 0;
+    int32_t len = DecodeUtf8(text, i, &cp);
+    bool b = IsChineseCharacter(cp);
+
+    if (i > start && b != is_chinese) {
+      ans.push_back({text.substr(start, i - start), is_chinese});
+      start = i;
+    }
+
+    is_chinese = b;
+    i += len;
+  }
+
+  if (n > start) {
+    ans.push_back({text.substr(start), is_chinese});
+  }
+
+  return ans;
+}
+
+static void AddSentence(const std::string &text, int32_t start, int32_t end,
+                        std::vector<std::string> *sentences) {
+  while (start < end && IsAsciiSpace(text[start])) {
+    ++start;
+  }
+
+  while (end > start && IsAsciiSpace(text[end - 1])) {
+    --end;
+  }
+
+  if (end > start) {
+    sentences->push_back(text.substr(start, end - start));
+  }
+}
+
+std::vector<std::string> SplitSentences(const std::string &text) {
+  std::vector<std::string> ans;
+
+  int32_t n = static_cast<int32_t>(text.size());
+  int32_t start = 0;
+
+  int32_t i = 0;
+  while (i < n) {
+    char32_t cp = 0;
+    int32_t len = DecodeUtf8(text, i, &cp);
+
+    bool is_end = false;
+    switch (cp) {
+      case U'.':
+      case U'!':
+      case U'?':
+      case U';':
+        is_end = i + 1 == n || IsAsciiSpace(text[i + 1]);
+        break;
+      case U'。':
+      case U'！':
+      case U'？':
+      case U'；':
+        is_end = true;
+        break;
+      default:
+        break;
+    }
+
+    i += len;
+
+    if (is_end) {
+      AddSentence(text, start, i, &ans);
+      start = i;
+    }
+  }
+
+  AddSentence(text, start, n, &ans);
+
+  return ans;
+}
+
+
+// Return true if the period at text[i] ends an abbreviation, i.e., a common
+// English one such as Dr., single letters separated by periods such as U.S.
+// and e.g., or a single letter followed by a lowercase word as in J. smith.
+//
+// A single letter followed by anything else ends a sentence, e.g.,
+// "Plan A. Then".
+static bool IsAbbreviationPeriod(const std::string &text, int32_t i) {
+  static const char *kAbbreviations[] = {"dr", "mr", "mrs", "ms",   "st",
+                                         "jr", "sr", "vs",  "prof", "etc"};
+
+  auto is_letter_or_period = [&text](int32_t k) {
+    return std::isalpha(static_cast<unsigned char>(text[k])) || text[k] == '.';
+  };
+
+  int32_t begin = i;
+  while (begin > 0 && is_letter_or_period(begin - 1)) {
+    --begin;
+  }
+
+  if (begin == i) {
+    return false;
+  }
+
+  std::string word = ToLowerAscii(text.substr(begin, i - begin));
+
+  for (const char *a : kAbbreviations) {
+    if (word == a) {
+      return true;
+    }
+  }
+
+  // Single letters separated by periods, e.g., u.s and e.g
+  for (int32_t k = 0; k != static_cast<int32_t>(word.size()); ++k) {
+    if ((k % 2 == 0) != (word[k] != '.')) {
+      return false;
+    }
+  }
+
+  if (word.size() % 2 == 0) {
+    return false;
+  }
+
+  if (word.size() > 1) {
+    return true;
+  }
+
+  // A single letter. Check whether the next word starts with a lowercase
+  // letter.
+  int32_t n = static_cast<int32_t>(text.size());
+  int32_t k = i + 1;
+  while (k < n && IsAsciiSpace(text[k])) {
+    ++k;
+  }
+
+  return k < n && std::islower(static_cast<unsigned char>(text[k]));
+}
+
+bool SplitFirstClause(const std::string &text, std::string *head,
+                      std::string *tail) {
+  static const char *kPunctuations[] = {"，", "。", "！", "？",
+                                        "；", "：", "、"};
+
+  auto is_word_char = [](char c) {
+    auto u = static_cast<unsigned char>(c);
+    return u >= 0x80 || std::isalnum(u);
+  };
+
+  bool has_word = false;
+  int32_t n = static_cast<int32_t>(text.size());
+
+  for (int32_t i = 0; i < n; ++i) {
+    char c = text[i];
+    int32_t end = -1;
+
+    if (c == ',' || c == '.' || c == '!' || c == '?' || c == ';' ||
+        c == ':') {
+      // Skip it if it is not followed by a space, e.g., 3.14 and U.S,
+      // or if it ends an abbreviation, e.g., Dr. Smith
+      if ((i + 1 == n || IsAsciiSpace(text[i + 1])) &&
+          (c != '.' || !IsAbbreviationPeriod(text, i))) {
+        end = i + 1;
+      }
+    } else if (static_cast<unsigned char>(c) >= 0x80) {
+      for (const char *p : kPunctuations) {
+        int32_t len = static_cast<int32_t>(strlen(p));
+        if (text.compare(i, len, p) == 0) {
+          end = i + len;
+          break;
+        }
+      }
+    }
+
+    if (end == -1) {
+      has_word = has_word || is_word_char(c);
+      continue;
+    }
+
+    if (!has_word) {
+      continue;
+    }
+
+    if (std::none_of(text.begin() + end, text.end(), is_word_char)) {
+      return false;
+    }
+
+    *head = text.substr(0, end);
+    *tail = text.substr(end);
+
+    return true;
+  }
+
+  return false;
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,88 @@
+// sherpa-onnx/csrc/text-segmenter.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_TEXT_SEGMENTER_H_
+#define SHERPA_ONNX_CSRC_TEXT_SEGMENTER_H_
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace sherpa_onnx {
+
+// Decode the UTF-8 encoded code point starting at text[pos].
+//
+// Return the number of bytes of the code point, which is at least 1 if
+// pos < text.size(). An invalid byte is decoded as U+FFFD and consumes
+// a single byte.
+int32_t DecodeUtf8(const std::string &text, int32_t pos, char32_t *cp);
+
+// Return true if cp is in the CJK Unified Ideographs block [U+4E00, U+9FFF]
+inline bool IsChineseCharacter(char32_t cp) {
+  return cp >= 0x4e00 && cp <= 0x9fff;
+}
+
+// Replace code points in a single pass over the UTF-8 encoded text.
+//
+// It replaces a chain of std::regex_replace() calls that replace single
+// punctuation characters. The table is built once and can be shared by
+// multiple threads.
+class PunctuationMap {
+ public:
+  // @param pairs Each pair maps a single UTF-8 encoded code point to a
+  //              string, which may be empty.
+  // @param merge_spaces If true, a run of ASCII whitespace characters is
+  //                     replaced by a single space, like the regex "\s+".
+  explicit PunctuationMap(
+      const std::vector<std::pair<std::string, std::string>> &pairs,
+      bool merge_spaces = false);
+
+  std::string Apply(const std::string &text) const;
+
+ private:
+  // ASCII code points are looked up in ascii_, others in non_ascii_
+  std::array<int32_t, 128> ascii_;
+  std::unordered_map<char32_t, int32_t> non_ascii_;
+
+  // Replacement strings
+  std::vector<std::string> replacements_;
+
+  bool merge_spaces_;
+};
+
+struct TextSegment {
+  std::string text;
+  bool is_chinese = false;
+};
+
+// Split text into maximal runs of Chinese characters (see
+// IsChineseCharacter()) and runs of other code points.
+std::vector<TextSegment> SplitChineseAndNonChinese(const std::string &text);
+
+// Split text into sentences after sentence-ending punctuations, i.e.,
+// . ! ? ; and their full-width forms. An ASCII punctuation ends a sentence
+// only if it is followed by whitespace or the end of the text, so that
+// numbers like 3.14 are not split.
+//
+// Leading and trailing whitespace of each sentence is removed and empty
+// sentences are skipped.
+std::vector<std::string> SplitSentences(const std::string &text);
+
+// Split text after its first clause, i.e., after the first comma or
+// sentence-ending punctuation, including their full-width forms and 、.
+// As in SplitSentences(), an ASCII punctuation counts only if it is
+// followed by whitespace or the end of the text. A period that ends an
+// abbreviation such as Dr. or U.S. does not count.
+//
+// Return false if there is no such punctuation or if either part would
+// contain no words.
+bool SplitFirstClause(const std::string &text, std::string *head,
+                      std::string *tail);
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_TEXT_SEGMENTER_H_
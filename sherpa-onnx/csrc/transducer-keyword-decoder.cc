@@ -162,7 +162,7 @@ void TransducerKeywordDecoder::Decode(
                       best_hyp.ys.end()};
           r.timestamps = {best_hyp.timestamps.end() - matched_state->level,
                           best_hyp.timestamps.end()};
-          r.keyword = matched_state->phrase;
+          r.keyword = ss[b]->GetContextGraph()->Phrase(matched_state);
 
           hyps = Hypotheses({{blanks, 0, ss[b]->GetContextGraph()->Root()}});
         }
@@ -0,0 +1,287 @@
+// sherpa-onnx/csrc/vad-offline-recognizer.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/vad-offline-recognizer.h"
+
+#include <condition_variable>  // NOLINT
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "sherpa-onnx/csrc/batch-by-duration.h"
+#include "sherpa-onnx/csrc/bounded-queue.h"
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/voice-activity-detector.h"
+
+namespace sherpa_onnx {
+
+void VadOfflineRecognizerConfig::Register(ParseOptions *po) {
+  vad.Register(po);
+  recognizer.Register(po);
+
+  po->Register("min-segment-duration", &min_segment_duration,
+               "Speech segments shorter than this value in seconds are "
+               "discarded");
+
+  po->Register("batch-size", &batch_size,
+               "Maximum number of speech segments in a batch");
+
+  po->Register("max-batch-duration", &max_batch_duration,
+               "If positive, limit batch size * the duration in seconds of "
+               "the longest segment in a batch, so that batches of long "
+               "segments are smaller");
+
+  po->Register("sort-window", &sort_window,
+               "Number of speech segments to collect before sorting them by "
+               "duration and splitting them into batches. If it is 0, "
+               "4 * --batch-size is used");
+
+  po->Register("num-workers", &num_workers,
+               "Number of batches to decode in parallel. Each of them uses "
+               "--num-threads threads");
+}
+
+bool VadOfflineRecognizerConfig::Validate() const {
+  if (!vad.Validate()) {
+    return false;
+  }
+
+  if (!recognizer.Validate()) {
+    return false;
+  }
+
+  if (min_segment_duration < 0) {
+    SHERPA_ONNX_LOGE("min_segment_duration %.3f is negative",
+                     min_segment_duration);
+    return false;
+  }
+
+  if (batch_size < 1) {
+    SHERPA_ONNX_LOGE("batch_size should be positive. Given: %d", batch_size);
+    return false;
+  }
+
+  if (sort_window < 0) {
+    SHERPA_ONNX_LOGE("sort_window %d is negative", sort_window);
+    return false;
+  }
+
+  if (num_workers < 1) {
+    SHERPA_ONNX_LOGE("num_workers should be positive. Given: %d",
+                     num_workers);
+    return false;
+  }
+
+  return true;
+}
+
+std::string VadOfflineRecognizerConfig::ToString() const {
+  std::ostringstream os;
+
+  os << "VadOfflineRecognizerConfig(";
+  os << "vad=" << vad.ToString() << ", ";
+  os << "recognizer=" << recognizer.ToString() << ", ";
+  os << "min_segment_duration=" << min_segment_duration << ", ";
+  os << "batch_size=" << batch_size << ", ";
+  os << "max_batch_duration=" << max_batch_duration << ", ";
+  os << "sort_window=" << sort_window << ", ";
+  os << "num_workers=" << num_workers << ")";
+
+  return os.str();
+}
+
+class VadOfflineRecognizer::Impl {
+ public:
+  explicit Impl(const VadOfflineRecognizerConfig &config)
+      : config_(config),
+        vad_(config.vad),
+        recognizer_(config.recognizer),
+        batch_queue_(2 * config.num_workers),
+        sort_window_(config.sort_window > 0 ? config.sort_window
+                                            : 4 * config.batch_size) {
+    for (int32_t i = 0; i != config_.num_workers; ++i) {
+      workers_.emplace_back([this]() { Work(); });
+    }
+  }
+
+  ~Impl() {
+    batch_queue_.Close();
+
+    for (auto &t : workers_) {
+      t.join();
+    }
+  }
+
+  void AcceptWaveform(const float *samples, int32_t n) {
+    vad_.AcceptWaveform(samples, n);
+    CollectSegments();
+
+    if (static_cast<int32_t>(pool_.size()) >= sort_window_) {
+      EmitBatches();
+    }
+  }
+
+  void Flush() {
+    vad_.Flush();
+    CollectSegments();
+    EmitBatches();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    all_decoded_.wait(lock,
+                      [this]() { return num_decoded_ == num_segments_; });
+  }
+
+  bool Empty() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return results_.empty() || results_.begin()->first != next_result_;
+  }
+
+  const VadOfflineRecognizerResult &Front() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return results_.begin()->second;
+  }
+
+  void Pop() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    results_.erase(results_.begin());
+    next_result_ += 1;
+  }
+
+ private:
+  struct Segment {
+    // Position of the segment in the input audio. Results are returned
+    // in this order.
+    int32_t index;
+    float start;  // in seconds
+    std::vector<float> samples;
+  };
+
+  using Batch = std::vector<Segment>;
+
+  // Move segments from the VAD to pool_
+  void CollectSegments() {
+    float sample_rate = config_.vad.sample_rate;
+
+    while (!vad_.Empty()) {
+      const auto &s = vad_.Front();
+      if (s.samples.size() / sample_rate >= config_.min_segment_duration) {
+        Segment segment;
+        segment.start = s.start / sample_rate;
+        segment.samples = s.samples;
+
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          segment.index = num_segments_++;
+        }
+
+        pool_.push_back(std::move(segment));
+      }
+
+      vad_.Pop();
+    }
+  }
+
+  // Split segments in pool_ into batches of similar durations
+  void EmitBatches() {
+    float sample_rate = config_.vad.sample_rate;
+
+    BatchByDuration(
+        &pool_, config_.batch_size, config_.max_batch_duration,
+        [sample_rate](const Segment &s) {
+          return s.samples.size() / sample_rate;
+        },
+        [this](Batch batch) { batch_queue_.Push(std::move(batch)); });
+  }
+
+  void Work() {
+    int32_t sample_rate = config_.vad.sample_rate;
+
+    Batch batch;
+    std::vector<std::unique_ptr<OfflineStream>> streams;
+    std::vector<OfflineStream *> ss;
+
+    while (batch_queue_.Pop(&batch)) {
+      streams.clear();
+      ss.clear();
+
+      for (const auto &s : batch) {
+        auto stream = recognizer_.CreateStream();
+        stream->AcceptWaveform(sample_rate, s.samples.data(),
+                               s.samples.size());
+        ss.push_back(stream.get());
+        streams.push_back(std::move(stream));
+      }
+
+      recognizer_.DecodeStreams(ss.data(), ss.size());
+
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (int32_t i = 0; i != static_cast<int32_t>(batch.size()); ++i) {
+          VadOfflineRecognizerResult r;
+          r.start = batch[i].start;
+          r.duration =
+              batch[i].samples.size() / static_cast<float>(sample_rate);
+          r.result = streams[i]->GetResult();
+
+          results_.emplace(batch[i].index, std::move(r));
+        }
+
+        num_decoded_ += batch.size();
+      }
+
+      all_decoded_.notify_all();
+    }
+  }
+
+ private:
+  VadOfflineRecognizerConfig config_;
+  VoiceActivityDetector vad_;
+  OfflineRecognizer recognizer_;
+
+  BoundedQueue<Batch> batch_queue_;
+  std::vector<std::thread> workers_;
+
+  // Segments that are not yet given to the workers
+  std::vector<Segment> pool_;
+  int32_t sort_window_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable all_decoded_;
+
+  int32_t num_segments_ = 0;
+  int32_t num_decoded_ = 0;
+
+  // Results that are decoded but not yet popped, indexed by
+  // Segment::index. Workers finish batches out of order, so a result
+  // is ready only after all results before it are ready.
+  std::map<int32_t, VadOfflineRecognizerResult> results_;
+  int32_t next_result_ = 0;
+};
+
+VadOfflineRecognizer::VadOfflineRecognizer(
+    const VadOfflineRecognizerConfig &config)
+    : impl_(std::make_unique<Impl>(config)) {}
+
+VadOfflineRecognizer::~VadOfflineRecognizer() = default;
+
+void VadOfflineRecognizer::AcceptWaveform(const float *samples, int32_t n) {
+  impl_->AcceptWaveform(samples, n);
+}
+
+void VadOfflineRecognizer::Flush() { impl_->Flush(); }
+
+bool VadOfflineRecognizer::Empty() const { return impl_->Empty(); }
+
+const VadOfflineRecognizerResult &VadOfflineRecognizer::Front() const {
+  return impl_->Front();
+}
+
+void VadOfflineRecognizer::Pop() { impl_->Pop(); }
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,109 @@
+// sherpa-onnx/csrc/vad-offline-recognizer.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_VAD_OFFLINE_RECOGNIZER_H_
+#define SHERPA_ONNX_CSRC_VAD_OFFLINE_RECOGNIZER_H_
+
+#include <memory>
+#include <string>
+
+#include "sherpa-onnx/csrc/offline-recognizer.h"
+#include "sherpa-onnx/csrc/offline-stream.h"
+#include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/vad-model-config.h"
+
+namespace sherpa_onnx {
+
+struct VadOfflineRecognizerConfig {
+  VadModelConfig vad;
+  OfflineRecognizerConfig recognizer;
+
+  // Speech segments shorter than this value are discarded
+  float min_segment_duration = 0.1;  // in seconds
+
+  // Maximum number of segments in a batch
+  int32_t batch_size = 8;
+
+  // If positive, batch_size * (duration of the longest segment in a batch)
+  // does not exceed it unless the batch contains a single segment
+  float max_batch_duration = 0;  // in seconds
+
+  // Number of segments to collect before sorting them by duration and
+  // splitting them into batches. If it is 0, 4 * batch_size is used.
+  int32_t sort_window = 0;
+
+  // Number of batches that are decoded in parallel
+  int32_t num_workers = 1;
+
+  VadOfflineRecognizerConfig() = default;
+
+  VadOfflineRecognizerConfig(const VadModelConfig &vad,
+                             const OfflineRecognizerConfig &recognizer,
+                             float min_segment_duration, int32_t batch_size,
+                             float max_batch_duration, int32_t sort_window,
+                             int32_t num_workers)
+      : vad(vad),
+        recognizer(recognizer),
+        min_segment_duration(min_segment_duration),
+        batch_size(batch_size),
+        max_batch_duration(max_batch_duration),
+        sort_window(sort_window),
+        num_workers(num_workers) {}
+
+  void Register(ParseOptions *po);
+  bool Validate() const;
+  std::string ToString() const;
+};
+
+struct VadOfflineRecognizerResult {
+  // Start time of the segment in the input audio
+  float start = 0;  // in seconds
+
+  float duration = 0;  // in seconds
+
+  // Timestamps in it are relative to the start of the segment
+  OfflineRecognitionResult result;
+};
+
+// Speech recognition of long audio with a VAD and a non-streaming model.
+//
+// Audio is fed via AcceptWaveform(). Speech segments from the VAD are
+// collected, sorted by duration and grouped into batches, which are decoded
+// with OfflineRecognizer::DecodeStreams() by num_workers threads. A bounded
+// queue sits between the VAD and the workers, so AcceptWaveform() blocks
+// while the workers are busy and the memory for pending segments does not
+// grow with the input length.
+//
+// Results are available via Empty()/Front()/Pop() in the order of the
+// segments in the input audio, like VoiceActivityDetector.
+class VadOfflineRecognizer {
+ public:
+  explicit VadOfflineRecognizer(const VadOfflineRecognizerConfig &config);
+
+  ~VadOfflineRecognizer();
+
+  // samples are expected to be sampled at config.vad.sample_rate
+  void AcceptWaveform(const float *samples, int32_t n);
+
+  // Call it at the end of the input. It decodes all pending segments and
+  // returns after their results are available.
+  void Flush();
+
+  bool Empty() const;
+
+  // It is an error to call Front() if Empty() returns true.
+  //
+  // The returned reference is valid until the next call to Pop().
+  const VadOfflineRecognizerResult &Front() const;
+
+  void Pop();
+
+ private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_VAD_OFFLINE_RECOGNIZER_H_
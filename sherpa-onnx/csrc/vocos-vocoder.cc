@@ -17,11 +17,11 @@
 #include "rawfile/raw_file_manager.h"
 #endif
 
-#include "kaldi-native-fbank/csrc/istft.h"
 #include "sherpa-onnx/csrc/file-utils.h"
 #include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
 #include "sherpa-onnx/csrc/session.h"
+#include "sherpa-onnx/csrc/stft-pool.h"
 
 namespace sherpa_onnx {
 
@@ -108,17 +108,7 @@ class VocosVocoder::Impl {
       }
     }
 
-    knf::StftConfig stft_config;
-    stft_config.n_fft = meta_.n_fft;
-    stft_config.hop_length = meta_.hop_length;
-    stft_config.win_length = meta_.win_length;
-    stft_config.normalized = meta_.normalized;
-    stft_config.center = meta_.center;
-    stft_config.window_type = meta_.window_type;
-    stft_config.pad_mode = meta_.pad_mode;
-
-    knf::IStft istft(stft_config);
-    return istft.Compute(stft_result);
+    return stft_->InverseCompute(stft_result);
   }
 
  private:
@@ -169,6 +159,17 @@ class VocosVocoder::Impl {
                                                 "window_type", "hann");
     SHERPA_ONNX_READ_META_DATA_STR_WITH_DEFAULT(meta_.pad_mode, "pad_mode",
                                                 "reflect");
+
+    knf::StftConfig stft_config;
+    stft_config.n_fft = meta_.n_fft;
+    stft_config.hop_length = meta_.hop_length;
+    stft_config.win_length = meta_.win_length;
+    stft_config.normalized = meta_.normalized;
+    stft_config.center = meta_.center;
+    stft_config.window_type = meta_.window_type;
+    stft_config.pad_mode = meta_.pad_mode;
+
+    stft_ = std::make_unique<StftPool>(stft_config);
   }
 
  private:
@@ -186,6 +187,8 @@ class VocosVocoder::Impl {
 
   std::vector<std::string> output_names_;
   std::vector<const char *> output_names_ptr_;
+
+  std::unique_ptr<StftPool> stft_;
 };
 
 VocosVocoder::VocosVocoder(const OfflineTtsModelConfig &config)
@@ -0,0 +1,110 @@
+// sherpa-onnx/csrc/wave-reader-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/wave-reader.h"
+
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sherpa-onnx/csrc/wave-writer.h"
+
+namespace sherpa_onnx {
+
+static std::string CreateWave(int32_t sample_rate,
+                              const std::vector<float> &ch0,
+                              const std::vector<float> &ch1) {
+  int32_t n = ch0.size();
+  std::string buffer(WaveFileSize(n, 2), 0);
+  WriteWave(&buffer[0], sample_rate, ch0.data(), ch1.data(), n);
+  return buffer;
+}
+
+TEST(WaveReader, ReadBlocks) {
+  int32_t n = 10000;
+  std::vector<float> ch0(n);
+  std::vector<float> ch1(n);
+  for (int32_t i = 0; i != n; ++i) {
+    ch0[i] = std::sin(i * 0.01f) * 0.5f;
+    ch1[i] = std::cos(i * 0.02f) * 0.5f;
+  }
+
+  std::istringstream is(CreateWave(8000, ch0, ch1));
+
+  int32_t sample_rate = -1;
+  bool is_ok = false;
+  auto expected = ReadWaveMultiChannel(is, &sample_rate, &is_ok);
+  ASSERT_TRUE(is_ok);
+  EXPECT_EQ(sample_rate, 8000);
+  ASSERT_EQ(expected.size(), 2);
+  ASSERT_EQ(expected[0].size(), n);
+
+  for (int32_t i = 0; i != n; ++i) {
+    EXPECT_NEAR(expected[0][i], ch0[i], 1e-4);
+    EXPECT_NEAR(expected[1][i], ch1[i], 1e-4);
+  }
+
+  is.clear();
+  is.seekg(0);
+
+  WaveReader reader(is);
+  ASSERT_TRUE(reader.IsOk());
+  EXPECT_EQ(reader.SampleRate(), 8000);
+  EXPECT_EQ(reader.NumChannels(), 2);
+  EXPECT_EQ(reader.NumSamples(), n);
+
+  int32_t block_size = 333;
+  std::vector<std::vector<float>> block;
+  int32_t offset = 0;
+  while (true) {
+    int32_t k = reader.ReadMultiChannel(block_size, &block);
+    if (k == 0) {
+      break;
+    }
+
+    ASSERT_EQ(block.size(), 2);
+    ASSERT_EQ(block[0].size(), k);
+    for (int32_t i = 0; i != k; ++i) {
+      EXPECT_EQ(block[0][i], expected[0][offset + i]);
+      EXPECT_EQ(block[1][i], expected[1][offset + i]);
+    }
+    offset += k;
+  }
+  EXPECT_EQ(offset, n);
+  EXPECT_EQ(reader.Tell(), n);
+
+  // Seek back and read the first channel only
+  EXPECT_TRUE(reader.Seek(5000));
+  EXPECT_EQ(reader.Tell(), 5000);
+
+  std::vector<float> samples;
+  EXPECT_EQ(reader.Read(100, &samples), 100);
+  ASSERT_EQ(samples.size(), 100);
+  for (int32_t i = 0; i != 100; ++i) {
+    EXPECT_EQ(samples[i], expected[0][5000 + i]);
+  }
+
+  EXPECT_FALSE(reader.Seek(n + 1));
+  EXPECT_TRUE(reader.Seek(n - 10));
+  EXPECT_EQ(reader.Read(100, &samples), 10);
+  EXPECT_EQ(reader.Read(100, &samples), 0);
+  EXPECT_TRUE(samples.empty());
+}
+
+TEST(WaveReader, Truncated) {
+  std::vector<float> ch0(1000, 0.25);
+  std::string buffer = CreateWave(16000, ch0, ch0);
+  buffer.resize(buffer.size() - 400);
+
+  std::istringstream is(buffer);
+  int32_t sample_rate = -1;
+  bool is_ok = true;
+  auto samples = ReadWave(is, &sample_rate, &is_ok);
+  EXPECT_FALSE(is_ok);
+  EXPECT_TRUE(samples.empty());
+}
+
+}  // namespace sherpa_onnx
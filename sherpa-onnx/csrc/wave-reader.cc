@@ -4,9 +4,13 @@
 
 #include "sherpa-onnx/csrc/wave-reader.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cinttypes>
 #include <cstdint>
+#include <cstring>
 #include <fstream>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -61,129 +65,119 @@ because sox uses WAVE_FORMAT_EXTENSIBLE, which is not easy to support
 in sherpa-onnx.
  */
 
-// Read a wave file of mono-channel.
-// Return its samples normalized to the range [-1, 1).
-std::vector<std::vector<float>> ReadWaveImpl(std::istream &is,
-                                             int32_t *sampling_rate,
-                                             bool *is_ok) {
-  WaveHeader header{};
-  is.read(reinterpret_cast<char *>(&header.chunk_id), sizeof(header.chunk_id));
+// Read the header of a wave file and move `is` to the start of the samples.
+// Return false if the file is not supported.
+bool ReadWaveHeader(std::istream &is, WaveHeader *header) {
+  is.read(reinterpret_cast<char *>(&header->chunk_id),
+          sizeof(header->chunk_id));
 
   //                        F F I R
-  if (header.chunk_id != 0x46464952) {
+  if (header->chunk_id != 0x46464952) {
     SHERPA_ONNX_LOGE("Expected chunk_id RIFF. Given: 0x%08x\n",
-                     header.chunk_id);
-    *is_ok = false;
-    return {};
+                     header->chunk_id);
+    return false;
   }
 
-  is.read(reinterpret_cast<char *>(&header.chunk_size),
-          sizeof(header.chunk_size));
+  is.read(reinterpret_cast<char *>(&header->chunk_size),
+          sizeof(header->chunk_size));
 
-  is.read(reinterpret_cast<char *>(&header.format), sizeof(header.format));
+  is.read(reinterpret_cast<char *>(&header->format), sizeof(header->format));
 
   //                      E V A W
-  if (header.format != 0x45564157) {
-    SHERPA_ONNX_LOGE("Expected format WAVE. Given: 0x%08x\n", header.format);
-    *is_ok = false;
-    return {};
+  if (header->format != 0x45564157) {
+    SHERPA_ONNX_LOGE("Expected format WAVE. Given: 0x%08x\n", header->format);
+    return false;
   }
 
-  is.read(reinterpret_cast<char *>(&header.subchunk1_id),
-          sizeof(header.subchunk1_id));
+  is.read(reinterpret_cast<char *>(&header->subchunk1_id),
+          sizeof(header->subchunk1_id));
 
-  is.read(reinterpret_cast<char *>(&header.subchunk1_size),
-          sizeof(header.subchunk1_size));
+  is.read(reinterpret_cast<char *>(&header->subchunk1_size),
+          sizeof(header->subchunk1_size));
 
-  if (header.subchunk1_id == 0x4b4e554a) {
+  if (header->subchunk1_id == 0x4b4e554a) {
     // skip junk padding
-    is.seekg(header.subchunk1_size, std::istream::cur);
+    is.seekg(header->subchunk1_size, std::istream::cur);
 
-    is.read(reinterpret_cast<char *>(&header.subchunk1_id),
-            sizeof(header.subchunk1_id));
+    is.read(reinterpret_cast<char *>(&header->subchunk1_id),
+            sizeof(header->subchunk1_id));
 
-    is.read(reinterpret_cast<char *>(&header.subchunk1_size),
-            sizeof(header.subchunk1_size));
+    is.read(reinterpret_cast<char *>(&header->subchunk1_size),
+            sizeof(header->subchunk1_size));
   }
 
-  if (header.subchunk1_id != 0x20746d66) {
+  if (header->subchunk1_id != 0x20746d66) {
     SHERPA_ONNX_LOGE("Expected subchunk1_id 0x20746d66. Given: 0x%08x\n",
-                     header.subchunk1_id);
-    *is_ok = false;
-    return {};
+                     header->subchunk1_id);
+    return false;
   }
 
   // NAudio uses 18
   // See https://github.com/naudio/NAudio/issues/1132
-  if (header.subchunk1_size != 16 &&
-      header.subchunk1_size != 18) {  // 16 for PCM
+  if (header->subchunk1_size != 16 &&
+      header->subchunk1_size != 18) {  // 16 for PCM
     SHERPA_ONNX_LOGE("Expected subchunk1_size 16. Given: %d\n",
-                     header.subchunk1_size);
-    *is_ok = false;
-    return {};
+                     header->subchunk1_size);
+    return false;
   }
 
-  is.read(reinterpret_cast<char *>(&header.audio_format),
-          sizeof(header.audio_format));
+  is.read(reinterpret_cast<char *>(&header->audio_format),
+          sizeof(header->audio_format));
 
-  if (header.audio_format != 1 && header.audio_format != 3) {
+  if (header->audio_format != 1 && header->audio_format != 3) {
     // 1 for integer PCM
     // 3 for floating point PCM
     // see https://www.mmsp.ece.mcgill.ca/Documents/AudioFormats/WAVE/WAVE.html
     // and https://github.com/microsoft/DirectXTK/wiki/Wave-Formats
     SHERPA_ONNX_LOGE("Expected audio_format 1. Given: %d\n",
-                     header.audio_format);
+                     header->audio_format);
 
-    if (header.audio_format == static_cast<int16_t>(0xfffe)) {
+    if (header->audio_format == static_cast<int16_t>(0xfffe)) {
       SHERPA_ONNX_LOGE("We don't support WAVE_FORMAT_EXTENSIBLE files.");
     }
 
-    *is_ok = false;
-    return {};
+    return false;
   }
 
-  is.read(reinterpret_cast<char *>(&header.num_channels),
-          sizeof(header.num_channels));
+  is.read(reinterpret_cast<char *>(&header->num_channels),
+          sizeof(header->num_channels));
 
-  is.read(reinterpret_cast<char *>(&header.sample_rate),
-          sizeof(header.sample_rate));
+  is.read(reinterpret_cast<char *>(&header->sample_rate),
+          sizeof(header->sample_rate));
 
-  is.read(reinterpret_cast<char *>(&header.byte_rate),
-          sizeof(header.byte_rate));
+  is.read(reinterpret_cast<char *>(&header->byte_rate),
+          sizeof(header->byte_rate));
 
-  is.read(reinterpret_cast<char *>(&header.block_align),
-          sizeof(header.block_align));
+  is.read(reinterpret_cast<char *>(&header->block_align),
+          sizeof(header->block_align));
 
-  is.read(reinterpret_cast<char *>(&header.bits_per_sample),
-          sizeof(header.bits_per_sample));
+  is.read(reinterpret_cast<char *>(&header->bits_per_sample),
+          sizeof(header->bits_per_sample));
 
-  if (header.byte_rate !=
-      (header.sample_rate * header.num_channels * header.bits_per_sample / 8)) {
-    SHERPA_ONNX_LOGE("Incorrect byte rate: %d. Expected: %d", header.byte_rate,
-                     (header.sample_rate * header.num_channels *
-                      header.bits_per_sample / 8));
-    *is_ok = false;
-    return {};
+  if (header->byte_rate != (header->sample_rate * header->num_channels *
+                            header->bits_per_sample / 8)) {
+    SHERPA_ONNX_LOGE("Incorrect byte rate: %d. Expected: %d", header->byte_rate,
+                     (header->sample_rate * header->num_channels *
+                      header->bits_per_sample / 8));
+    return false;
   }
 
-  if (header.block_align !=
-      (header.num_channels * header.bits_per_sample / 8)) {
+  if (header->block_align !=
+      (header->num_channels * header->bits_per_sample / 8)) {
     SHERPA_ONNX_LOGE("Incorrect block align: %d. Expected: %d\n",
-                     header.block_align,
-                     (header.num_channels * header.bits_per_sample / 8));
-    *is_ok = false;
-    return {};
+                     header->block_align,
+                     (header->num_channels * header->bits_per_sample / 8));
+    return false;
   }
 
-  if (header.bits_per_sample != 8 && header.bits_per_sample != 16 &&
-      header.bits_per_sample != 32) {
+  if (header->bits_per_sample != 8 && header->bits_per_sample != 16 &&
+      header->bits_per_sample != 32) {
     SHERPA_ONNX_LOGE("Expected bits_per_sample 8, 16 or 32. Given: %d\n",
-                     header.bits_per_sample);
-    *is_ok = false;
-    return {};
+                     header->bits_per_sample);
+    return false;
   }
 
-  if (header.subchunk1_size == 18) {
+  if (header->subchunk1_size == 18) {
     // this is for NAudio. It puts extra bytes after bits_per_sample
     // See
     // https://github.com/naudio/NAudio/blob/master/NAudio.Core/Wave/WaveFormats/WaveFormat.cs#L223
@@ -195,134 +189,270 @@ std::vector<std::vector<float>> ReadWaveImpl(std::istream &is,
           "Extra size should be 0 for wave from NAudio. Current extra size "
           "%d\n",
           extra_size);
-      *is_ok = false;
-      return {};
+      return false;
     }
   }
 
-  is.read(reinterpret_cast<char *>(&header.subchunk2_id),
-          sizeof(header.subchunk2_id));
+  is.read(reinterpret_cast<char *>(&header->subchunk2_id),
+          sizeof(header->subchunk2_id));
 
-  is.read(reinterpret_cast<char *>(&header.subchunk2_size),
-          sizeof(header.subchunk2_size));
+  is.read(reinterpret_cast<char *>(&header->subchunk2_size),
+          sizeof(header->subchunk2_size));
 
-  header.SeekToDataChunk(is);
+  header->SeekToDataChunk(is);
   if (!is) {
-    *is_ok = false;
-    return {};
+    return false;
   }
 
-  *sampling_rate = header.sample_rate;
 
-  std::vector<std::vector<float>> ans(header.num_channels);
+  if (header->audio_format == 3 && header->bits_per_sample != 32) {
+    SHERPA_ONNX_LOGE(
+        "Unsupported %d bits per sample and audio format: %d. Supported values "
+        "are: 8, 16, 32.",
+        header->bits_per_sample, header->audio_format);
+    return false;
+  }
 
-  if (header.bits_per_sample == 16 && header.audio_format == 1) {
-    // header.subchunk2_size contains the number of bytes in the data.
-    // As we assume each sample contains two bytes, so it is divided by 2 here
-    std::vector<int16_t> samples(header.subchunk2_size / 2);
+  return true;
+}
 
-    is.read(reinterpret_cast<char *>(samples.data()), header.subchunk2_size);
-    if (!is) {
-      SHERPA_ONNX_LOGE("Failed to read %d bytes", header.subchunk2_size);
-      *is_ok = false;
-      return {};
+// Convert n interleaved samples per channel in p to float and save the
+// first ans->size() channels of them in ans.
+//
+// out = in * scale + bias
+template <typename T>
+void Deinterleave(const char *p, int32_t n, int32_t num_channels, float scale,
+                  float bias, std::vector<std::vector<float>> *ans) {
+  for (int32_t c = 0; c != static_cast<int32_t>(ans->size()); ++c) {
+    auto &v = (*ans)[c];
+    v.resize(n);
+    for (int32_t k = 0; k != n; ++k) {
+      T t;
+      // p may not be aligned for T
+      std::memcpy(&t, p + (k * num_channels + c) * sizeof(T), sizeof(T));
+      v[k] = t * scale + bias;
     }
+  }
+}
 
-    for (auto &v : ans) {
-      v.resize(samples.size() / header.num_channels);
-    }
+// Number of samples per channel to read at a time in ReadWaveImpl()
+constexpr int32_t kReadBlockSize = 16384;
 
-    // samples are interleaved
-    for (int32_t i = 0, k = 0; i < static_cast<int32_t>(samples.size());
-         i += header.num_channels, ++k) {
-      for (int32_t c = 0; c != header.num_channels; ++c) {
-        ans[c][k] = samples[i + c] / 32768.;
-      }
-    }
-  } else if (header.bits_per_sample == 8 && header.audio_format == 1) {
-    // number of samples == number of bytes for 8-bit encoded samples
-    //
-    // For 8-bit encoded samples, they are unsigned!
-    std::vector<uint8_t> samples(header.subchunk2_size);
-
-    is.read(reinterpret_cast<char *>(samples.data()), header.subchunk2_size);
-    if (!is) {
-      SHERPA_ONNX_LOGE("Failed to read %d bytes", header.subchunk2_size);
-      *is_ok = false;
-      return {};
-    }
+}  // namespace
 
-    for (auto &v : ans) {
-      v.resize(samples.size() / header.num_channels);
-    }
+class WaveReader::Impl {
+ public:
+  explicit Impl(const std::string &filename)
+      : file_(std::make_unique<std::ifstream>(filename,
+                                              std::ifstream::binary)),
+        is_(*file_) {
+    Init();
+  }
 
-    // samples are interleaved
-    for (int32_t i = 0, k = 0; i < static_cast<int32_t>(samples.size());
-         i += header.num_channels, ++k) {
-      for (int32_t c = 0; c != header.num_channels; ++c) {
-        // Note(fangjun): We want to normalize each sample into the range [-1,
-        // 1] Since each original sample is in the range [0, 256], dividing them
-        // by 128 converts them to the range [0, 2]; so after subtracting 1, we
-        // get the range [-1, 1]
-        //
-        ans[c][k] = samples[i + c] / 128. - 1;
-      }
-    }
-  } else if (header.bits_per_sample == 32 && header.audio_format == 1) {
-    // 32 here is for int32
-    //
-    // header.subchunk2_size contains the number of bytes in the data.
-    // As we assume each sample contains 4 bytes, so it is divided by 4 here
-    std::vector<int32_t> samples(header.subchunk2_size / 4);
-
-    is.read(reinterpret_cast<char *>(samples.data()), header.subchunk2_size);
-    if (!is) {
-      SHERPA_ONNX_LOGE("Failed to read %d bytes", header.subchunk2_size);
-      *is_ok = false;
-      return {};
+  explicit Impl(std::istream &is) : is_(is) { Init(); }
+
+  bool IsOk() const { return is_ok_; }
+
+  int32_t SampleRate() const { return header_.sample_rate; }
+
+  int32_t NumChannels() const { return header_.num_channels; }
+
+  int64_t NumSamples() const { return num_samples_; }
+
+  int64_t Tell() const { return pos_; }
+
+  bool Seek(int64_t sample_index) {
+    if (!is_ok_ || sample_index < 0 || sample_index > num_samples_ ||
+        data_offset_ < 0) {
+      return false;
     }
 
-    for (auto &v : ans) {
-      v.resize(samples.size() / header.num_channels);
+    is_.clear();
+    is_.seekg(data_offset_ + sample_index * header_.block_align);
+    if (!is_) {
+      return false;
     }
 
-    // samples are interleaved
-    for (int32_t i = 0, k = 0; i < static_cast<int32_t>(samples.size());
-         i += header.num_channels, ++k) {
-      for (int32_t c = 0; c != header.num_channels; ++c) {
-        ans[c][k] = static_cast<float>(samples[i + c]) / (1 << 31);
+    pos_ = sample_index;
+    return true;
+  }
+
+  int32_t Read(int32_t n, std::vector<std::vector<float>> *samples) {
+    n = static_cast<int32_t>(std::min<int64_t>(n, num_samples_ - pos_));
+    if (!is_ok_ || n <= 0) {
+      for (auto &v : *samples) {
+        v.clear();
       }
+      return 0;
     }
-  } else if (header.bits_per_sample == 32 && header.audio_format == 3) {
-    // 32 here is for float32
-    //
-    // header.subchunk2_size contains the number of bytes in the data.
-    // As we assume each sample contains 4 bytes, so it is divided by 4 here
-    std::vector<float> samples(header.subchunk2_size / 4);
-
-    is.read(reinterpret_cast<char *>(samples.data()), header.subchunk2_size);
-    if (!is) {
-      SHERPA_ONNX_LOGE("Failed to read %d bytes", header.subchunk2_size);
-      *is_ok = false;
-      return {};
+
+    int32_t block_align = header_.block_align;
+    buffer_.resize(static_cast<int64_t>(n) * block_align);
+
+    is_.read(buffer_.data(), buffer_.size());
+    int32_t num_read = static_cast<int32_t>(is_.gcount() / block_align);
+    if (num_read < n) {
+      // The file is truncated. Treat what we have got as the end of it.
+      num_samples_ = pos_ + num_read;
     }
 
-    for (auto &v : ans) {
-      v.resize(samples.size() / header.num_channels);
+    const char *p = buffer_.data();
+    int32_t num_channels = header_.num_channels;
+
+    switch (header_.bits_per_sample) {
+      case 8:
+        // For 8-bit encoded samples, they are unsigned!
+        //
+        // Note(fangjun): We want to normalize each sample into the range [-1,
+        // 1] Since each original sample is in the range [0, 256], dividing
+        // them by 128 converts them to the range [0, 2]; so after subtracting
+        // 1, we get the range [-1, 1]
+        Deinterleave<uint8_t>(p, num_read, num_channels, 1 / 128.f, -1,
+                              samples);
+        break;
+      case 16:
+        Deinterleave<int16_t>(p, num_read, num_channels, 1 / 32768.f, 0,
+                              samples);
+        break;
+      case 32:
+        if (header_.audio_format == 3) {
+          Deinterleave<float>(p, num_read, num_channels, 1, 0, samples);
+        } else {
+          Deinterleave<int32_t>(p, num_read, num_channels, 1 / 2147483648.f,
+                                0, samples);
+        }
+        break;
     }
 
-    // samples are interleaved
-    for (int32_t i = 0, k = 0; i < static_cast<int32_t>(samples.size());
-         i += header.num_channels, ++k) {
-      for (int32_t c = 0; c != header.num_channels; ++c) {
-        ans[c][k] = samples[i + c];
-      }
+    pos_ += num_read;
+
+    return num_read;
+  }
+
+ private:
+  void Init() {
+    is_ok_ = ReadWaveHeader(is_, &header_);
+    if (!is_ok_) {
+      return;
     }
-  } else {
+
+    // It is -1 if the stream does not support seeking
+    data_offset_ = is_.tellg();
+
+    // subchunk2_size is unsigned in the file
+    num_samples_ =
+        static_cast<uint32_t>(header_.subchunk2_size) / header_.block_align;
+  }
+
+ private:
+  // Used only when we are given a filename
+  std::unique_ptr<std::ifstream> file_;
+  std::istream &is_;
+
+  WaveHeader header_{};
+  bool is_ok_ = false;
+
+  // Byte offset of the first sample in the stream
+  int64_t data_offset_ = -1;
+
+  // Number of samples per channel
+  int64_t num_samples_ = 0;
+
+  // Index of the next sample to read
+  int64_t pos_ = 0;
+
+  // Raw bytes of the current block
+  std::vector<char> buffer_;
+};
+
+WaveReader::WaveReader(const std::string &filename)
+    : impl_(std::make_unique<Impl>(filename)) {}
+
+WaveReader::WaveReader(std::istream &is) : impl_(std::make_unique<Impl>(is)) {}
+
+WaveReader::~WaveReader() = default;
+
+bool WaveReader::IsOk() const { return impl_->IsOk(); }
+
+int32_t WaveReader::SampleRate() const { return impl_->SampleRate(); }
+
+int32_t WaveReader::NumChannels() const { return impl_->NumChannels(); }
+
+int64_t WaveReader::NumSamples() const { return impl_->NumSamples(); }
+
+int64_t WaveReader::Tell() const { return impl_->Tell(); }
+
+bool WaveReader::Seek(int64_t sample_index) {
+  return impl_->Seek(sample_index);
+}
+
+int32_t WaveReader::Read(int32_t n, std::vector<float> *samples) {
+  // Only the first channel is converted
+  std::vector<std::vector<float>> tmp(1);
+  tmp[0] = std::move(*samples);
+
+  int32_t ans = impl_->Read(n, &tmp);
+  *samples = std::move(tmp[0]);
+
+  return ans;
+}
+
+int32_t WaveReader::ReadMultiChannel(
+    int32_t n, std::vector<std::vector<float>> *samples) {
+  samples->resize(NumChannels());
+  return impl_->Read(n, samples);
+}
+
+namespace {
+
+// Read a wave file. If first_channel_only is true, only the first channel
+// is returned.
+//
+// Return its samples normalized to the range [-1, 1).
+std::vector<std::vector<float>> ReadWaveImpl(std::istream &is,
+                                             bool first_channel_only,
+                                             int32_t *sampling_rate,
+                                             bool *is_ok) {
+  WaveReader reader(is);
+  if (!reader.IsOk()) {
+    *is_ok = false;
+    return {};
+  }
+
+  *sampling_rate = reader.SampleRate();
+
+  int32_t num_channels = reader.NumChannels();
+  if (first_channel_only && num_channels > 1) {
     SHERPA_ONNX_LOGE(
-        "Unsupported %d bits per sample and audio format: %d. Supported values "
-        "are: 8, 16, 32.",
-        header.bits_per_sample, header.audio_format);
+        "Warning: %d channels are found. We only use the first channel.\n",
+        num_channels);
+    num_channels = 1;
+  }
+
+  int64_t num_samples = reader.NumSamples();
+
+  std::vector<std::vector<float>> ans(num_channels);
+  for (auto &v : ans) {
+    v.reserve(num_samples);
+  }
+
+  // Convert the samples block by block so that we don't need to keep
+  // the raw bytes of the whole file in memory
+  std::vector<std::vector<float>> block(num_channels);
+  auto read_block = [&]() {
+    return first_channel_only ? reader.Read(kReadBlockSize, &block[0])
+                              : reader.ReadMultiChannel(kReadBlockSize, &block);
+  };
+
+  while (read_block() > 0) {
+    for (int32_t c = 0; c != num_channels; ++c) {
+      ans[c].insert(ans[c].end(), block[c].begin(), block[c].end());
+    }
+  }
+
+  if (reader.Tell() != num_samples) {
+    SHERPA_ONNX_LOGE("Failed to read %" PRId64 " samples. Read only %" PRId64,
+                     num_samples, reader.Tell());
     *is_ok = false;
     return {};
   }
@@ -341,22 +471,18 @@ std::vector<float> ReadWave(const std::string &filename, int32_t *sampling_rate,
 
 std::vector<float> ReadWave(std::istream &is, int32_t *sampling_rate,
                             bool *is_ok) {
-  auto samples = ReadWaveImpl(is, sampling_rate, is_ok);
-
-  if (samples.size() > 1) {
-    SHERPA_ONNX_LOGE(
-        "Warning: %d channels are found. We only use the first channel.\n",
-        static_cast<int32_t>(samples.size()));
+  auto samples = ReadWaveImpl(is, true, sampling_rate, is_ok);
+  if (!*is_ok) {
+    return {};
   }
 
-  return samples[0];
+  return std::move(samples[0]);
 }
 
 std::vector<std::vector<float>> ReadWaveMultiChannel(std::istream &is,
                                                      int32_t *sampling_rate,
                                                      bool *is_ok) {
-  auto samples = ReadWaveImpl(is, sampling_rate, is_ok);
-  return samples;
+  return ReadWaveImpl(is, false, sampling_rate, is_ok);
 }
 
 std::vector<std::vector<float>> ReadWaveMultiChannel(
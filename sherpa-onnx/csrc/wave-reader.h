@@ -5,7 +5,9 @@
 #ifndef SHERPA_ONNX_CSRC_WAVE_READER_H_
 #define SHERPA_ONNX_CSRC_WAVE_READER_H_
 
+#include <cstdint>
 #include <istream>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -33,6 +35,68 @@ std::vector<std::vector<float>> ReadWaveMultiChannel(std::istream &is,
 std::vector<std::vector<float>> ReadWaveMultiChannel(
     const std::string &filename, int32_t *sampling_rate, bool *is_ok);
 
+/** Read a wave file block by block.
+ *
+ * Unlike ReadWave(), it keeps only one block of samples in memory, so it
+ * can be used to process very long files in a streaming fashion.
+ *
+ * Usage:
+ *
+ *   WaveReader reader(filename);
+ *   if (!reader.IsOk()) { ... }
+ *
+ *   std::vector<float> samples;
+ *   while (reader.Read(block_size, &samples) > 0) {
+ *     // process samples
+ *   }
+ */
+class WaveReader {
+ public:
+  explicit WaveReader(const std::string &filename);
+
+  // is must outlive this object
+  explicit WaveReader(std::istream &is);
+
+  ~WaveReader();
+
+  // Return false if the file cannot be opened or it is not a supported
+  // wave file.
+  bool IsOk() const;
+
+  int32_t SampleRate() const;
+
+  int32_t NumChannels() const;
+
+  // Number of samples per channel
+  int64_t NumSamples() const;
+
+  // Index of the next sample to be read
+  int64_t Tell() const;
+
+  // Move to the given sample index. Return false if it is out of range or
+  // if the underlying stream does not support seeking.
+  bool Seek(int64_t sample_index);
+
+  /** Read the next block of the first channel.
+   *
+   * @param n  Maximum number of samples to read.
+   * @param samples On return, it contains the samples normalized to the
+   *                range [-1, 1). Its capacity is reused across calls.
+   *
+   * @return Return the number of samples read. It is 0 at the end of the
+   *         file.
+   */
+  int32_t Read(int32_t n, std::vector<float> *samples);
+
+  // Like Read() but return all channels. samples[c] contains channel c.
+  int32_t ReadMultiChannel(int32_t n,
+                           std::vector<std::vector<float>> *samples);
+
+ private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
 }  // namespace sherpa_onnx
 
 #endif  // SHERPA_ONNX_CSRC_WAVE_READER_H_
@@ -5,6 +5,7 @@
 #include "sherpa-onnx/python/csrc/audio-tagging.h"
 
 #include <string>
+#include <vector>
 
 #include "sherpa-onnx/csrc/audio-tagging.h"
 
@@ -48,11 +49,13 @@ static void PybindAudioTaggingConfig(py::module *m) {
   py::class_<PyClass>(*m, "AudioTaggingConfig")
       .def(py::init<>())
       .def(py::init<const AudioTaggingModelConfig &, const std::string &,
-                    int32_t>(),
-           py::arg("model"), py::arg("labels"), py::arg("top_k") = 5)
+                    int32_t, int32_t>(),
+           py::arg("model"), py::arg("labels"), py::arg("top_k") = 5,
+           py::arg("max_batch_padding") = 0)
       .def_readwrite("model", &PyClass::model)
       .def_readwrite("labels", &PyClass::labels)
       .def_readwrite("top_k", &PyClass::top_k)
+      .def_readwrite("max_batch_padding", &PyClass::max_batch_padding)
       .def("validate", &PyClass::Validate)
       .def("__str__", &PyClass::ToString);
 }
@@ -81,8 +84,21 @@ void PybindAudioTagging(py::module *m) {
            py::call_guard<py::gil_scoped_release>())
       .def("create_stream", &PyClass::CreateStream,
            py::call_guard<py::gil_scoped_release>())
-      .def("compute", &PyClass::Compute, py::arg("s"), py::arg("top_k") = -1,
-           py::call_guard<py::gil_scoped_release>());
+      .def(
+          "compute",
+          [](const PyClass &self, OfflineStream *s, int32_t top_k) {
+            return self.Compute(s, top_k);
+          },
+          py::arg("s"), py::arg("top_k") = -1,
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "compute_batch",
+          [](const PyClass &self, std::vector<OfflineStream *> ss,
+             int32_t top_k) {
+            return self.Compute(ss.data(), ss.size(), top_k);
+          },
+          py::arg("ss"), py::arg("top_k") = -1,
+          py::call_guard<py::gil_scoped_release>());
 }
 
 }  // namespace sherpa_onnx
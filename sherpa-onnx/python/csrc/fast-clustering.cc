@@ -14,10 +14,11 @@ namespace sherpa_onnx {
 static void PybindFastClusteringConfig(py::module *m) {
   using PyClass = FastClusteringConfig;
   py::class_<PyClass>(*m, "FastClusteringConfig")
-      .def(py::init<int32_t, float>(), py::arg("num_clusters") = -1,
-           py::arg("threshold") = 0.5)
+      .def(py::init<int32_t, float, int32_t>(), py::arg("num_clusters") = -1,
+           py::arg("threshold") = 0.5, py::arg("chunk_size") = 0)
       .def_readwrite("num_clusters", &PyClass::num_clusters)
       .def_readwrite("threshold", &PyClass::threshold)
+      .def_readwrite("chunk_size", &PyClass::chunk_size)
       .def("__str__", &PyClass::ToString)
       .def("validate", &PyClass::Validate);
 }
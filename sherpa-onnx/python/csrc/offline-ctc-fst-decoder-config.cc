@@ -13,10 +13,12 @@ namespace sherpa_onnx {
 void PybindOfflineCtcFstDecoderConfig(py::module *m) {
   using PyClass = OfflineCtcFstDecoderConfig;
   py::class_<PyClass>(*m, "OfflineCtcFstDecoderConfig")
-      .def(py::init<const std::string &, int32_t>(), py::arg("graph") = "",
-           py::arg("max_active") = 3000)
+      .def(py::init<const std::string &, int32_t, int32_t>(),
+           py::arg("graph") = "", py::arg("max_active") = 3000,
+           py::arg("num_workers") = 1)
       .def_readwrite("graph", &PyClass::graph)
       .def_readwrite("max_active", &PyClass::max_active)
+      .def_readwrite("num_workers", &PyClass::num_workers)
       .def("__str__", &PyClass::ToString);
 }
 
@@ -5,6 +5,7 @@
 #include "sherpa-onnx/python/csrc/offline-punctuation.h"
 
 #include <string>
+#include <vector>
 
 #include "sherpa-onnx/csrc/offline-punctuation.h"
 
@@ -39,13 +40,41 @@ static void PybindOfflinePunctuationConfig(py::module *m) {
 
 void PybindOfflinePunctuation(py::module *m) {
   PybindOfflinePunctuationConfig(m);
+
+  py::class_<OfflinePunctuationStream>(*m, "OfflinePunctuationStream");
+
   using PyClass = OfflinePunctuation;
 
   py::class_<PyClass>(*m, "OfflinePunctuation")
       .def(py::init<const OfflinePunctuationConfig &>(), py::arg("config"),
            py::call_guard<py::gil_scoped_release>())
-      .def("add_punctuation", &PyClass::AddPunctuation, py::arg("text"),
-           py::call_guard<py::gil_scoped_release>());
+      .def(
+          "add_punctuation",
+          [](const PyClass &self, const std::string &text) {
+            return self.AddPunctuation(text);
+          },
+          py::arg("text"), py::call_guard<py::gil_scoped_release>())
+      .def(
+          "create_stream",
+          [](const PyClass &self) { return self.CreateStream(); },
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "add_punctuation",
+          [](const PyClass &self, OfflinePunctuationStream *s,
+             const std::string &text) { return self.AddPunctuation(s, text); },
+          py::arg("s"), py::arg("text"),
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "add_punctuation_streams",
+          [](const PyClass &self, std::vector<OfflinePunctuationStream *> ss,
+             const std::vector<std::string> &texts) {
+            if (ss.size() != texts.size()) {
+              throw py::value_error("len(ss) != len(texts)");
+            }
+            return self.AddPunctuation(ss.data(), texts.data(), ss.size());
+          },
+          py::arg("ss"), py::arg("texts"),
+          py::call_guard<py::gil_scoped_release>());
 }
 
 }  // namespace sherpa_onnx
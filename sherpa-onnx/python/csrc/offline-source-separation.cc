@@ -5,6 +5,7 @@
 #include "sherpa-onnx/csrc/offline-source-separation.h"
 
 #include <algorithm>
+#include <functional>
 #include <string>
 
 #include "sherpa-onnx/python/csrc/offline-source-separation-model-config.h"
@@ -19,9 +20,11 @@ static void PybindOfflineSourceSeparationConfig(py::module *m) {
 
   using PyClass = OfflineSourceSeparationConfig;
   py::class_<PyClass>(*m, "OfflineSourceSeparationConfig")
-      .def(py::init<const OfflineSourceSeparationModelConfig &>(),
-           py::arg("model") = OfflineSourceSeparationModelConfig{})
+      .def(py::init<const OfflineSourceSeparationModelConfig &, int32_t>(),
+           py::arg("model") = OfflineSourceSeparationModelConfig{},
+           py::arg("num_workers") = 1)
       .def_readwrite("model", &PyClass::model)
+      .def_readwrite("num_workers", &PyClass::num_workers)
       .def("validate", &PyClass::Validate)
       .def("__str__", &PyClass::ToString);
 }
@@ -79,7 +82,8 @@ void PybindOfflineSourceSeparation(py::module *m) {
       .def(
           "process",
           [](const PyClass &self, int32_t sample_rate,
-             const py::array_t<float> &samples) {
+             const py::array_t<float> &samples,
+             std::function<void(float)> callback) {
             if (!(samples.flags() & py::array::c_style)) {
               throw py::value_error(
                   "input samples should be contiguous. Please use "
@@ -122,13 +126,23 @@ void PybindOfflineSourceSeparation(py::module *m) {
                                        p + (i + 1) * num_samples};
             }
 
+            OfflineSourceSeparationCallback callback_wrapper;
+            if (callback) {
+              callback_wrapper = [callback](float progress) {
+                pybind11::gil_scoped_acquire acquire;
+                callback(progress);
+              };
+            }
+
             pybind11::gil_scoped_release release;
 
-            return self.Process(input);
+            return self.Process(input, callback_wrapper);
           },
           py::arg("sample_rate"), py::arg("samples"),
+          py::arg("callback") = py::none(),
           "samples is of shape (num_channels, num-samples) with dtype "
-          "np.float32");
+          "np.float32. If given, callback(progress) is called with a value "
+          "in (0, 1] as processing proceeds");
 }
 
 }  // namespace sherpa_onnx
@@ -18,10 +18,15 @@ static void PybindGeneratedAudio(py::module *m) {
       .def(py::init<>())
       .def_readwrite("samples", &PyClass::samples)
       .def_readwrite("sample_rate", &PyClass::sample_rate)
+      .def_readwrite("time_to_first_sample", &PyClass::time_to_first_sample)
+      .def_readwrite("elapsed_seconds", &PyClass::elapsed_seconds)
+      .def_readwrite("rtf", &PyClass::rtf)
       .def("__str__", [](PyClass &self) {
         std::ostringstream os;
         os << "GeneratedAudio(sample_rate=" << self.sample_rate << ", ";
-        os << "num_samples=" << self.samples.size() << ")";
+        os << "num_samples=" << self.samples.size() << ", ";
+        os << "time_to_first_sample=" << self.time_to_first_sample << ", ";
+        os << "rtf=" << self.rtf << ")";
         return os.str();
       });
 }
@@ -33,15 +38,28 @@ static void PybindOfflineTtsConfig(py::module *m) {
   py::class_<PyClass>(*m, "OfflineTtsConfig")
       .def(py::init<>())
       .def(py::init<const OfflineTtsModelConfig &, const std::string &,
-                    const std::string &, int32_t, float>(),
+                    const std::string &, int32_t, float, int32_t, bool,
+                    int32_t, const std::string &, int32_t,
+                    const std::string &, int32_t>(),
            py::arg("model"), py::arg("rule_fsts") = "",
            py::arg("rule_fars") = "", py::arg("max_num_sentences") = 1,
-           py::arg("silence_scale") = 0.2)
+           py::arg("silence_scale") = 0.2, py::arg("num_workers") = 1,
+           py::arg("low_latency") = false, py::arg("frontend_cache_size") = 0,
+           py::arg("frontend_cache_warmup") = "",
+           py::arg("audio_cache_size") = 0, py::arg("audio_cache_dir") = "",
+           py::arg("audio_cache_max_files") = 10000)
       .def_readwrite("model", &PyClass::model)
       .def_readwrite("rule_fsts", &PyClass::rule_fsts)
       .def_readwrite("rule_fars", &PyClass::rule_fars)
       .def_readwrite("max_num_sentences", &PyClass::max_num_sentences)
       .def_readwrite("silence_scale", &PyClass::silence_scale)
+      .def_readwrite("num_workers", &PyClass::num_workers)
+      .def_readwrite("low_latency", &PyClass::low_latency)
+      .def_readwrite("frontend_cache_size", &PyClass::frontend_cache_size)
+      .def_readwrite("frontend_cache_warmup", &PyClass::frontend_cache_warmup)
+      .def_readwrite("audio_cache_size", &PyClass::audio_cache_size)
+      .def_readwrite("audio_cache_dir", &PyClass::audio_cache_dir)
+      .def_readwrite("audio_cache_max_files", &PyClass::audio_cache_max_files)
       .def("validate", &PyClass::Validate)
       .def("__str__", &PyClass::ToString);
 }
@@ -59,7 +59,7 @@ static void PybindOnlineRecognizerConfig(py::module *m) {
                     const OnlineCtcFstDecoderConfig &, bool,
                     const std::string &, int32_t, const std::string &, float,
                     float, float, const std::string &, const std::string &,
-                    bool, const HomophoneReplacerConfig &>(),
+                    bool, const HomophoneReplacerConfig &, bool>(),
            py::arg("feat_config"), py::arg("model_config"),
            py::arg("lm_config") = OnlineLMConfig(),
            py::arg("endpoint_config") = EndpointConfig(),
@@ -69,7 +69,8 @@ static void PybindOnlineRecognizerConfig(py::module *m) {
            py::arg("hotwords_score") = 0, py::arg("blank_penalty") = 0.0,
            py::arg("temperature_scale") = 2.0, py::arg("rule_fsts") = "",
            py::arg("rule_fars") = "", py::arg("reset_encoder") = false,
-           py::arg("hr") = HomophoneReplacerConfig{})
+           py::arg("hr") = HomophoneReplacerConfig{},
+           py::arg("compose_rule_fsts") = false)
       .def_readwrite("feat_config", &PyClass::feat_config)
       .def_readwrite("model_config", &PyClass::model_config)
       .def_readwrite("lm_config", &PyClass::lm_config)
@@ -81,9 +82,11 @@ static void PybindOnlineRecognizerConfig(py::module *m) {
       .def_readwrite("hotwords_file", &PyClass::hotwords_file)
       .def_readwrite("hotwords_score", &PyClass::hotwords_score)
       .def_readwrite("blank_penalty", &PyClass::blank_penalty)
+      .def_readwrite("blank_skip_threshold", &PyClass::blank_skip_threshold)
       .def_readwrite("temperature_scale", &PyClass::temperature_scale)
       .def_readwrite("rule_fsts", &PyClass::rule_fsts)
       .def_readwrite("rule_fars", &PyClass::rule_fars)
+      .def_readwrite("compose_rule_fsts", &PyClass::compose_rule_fsts)
       .def_readwrite("reset_encoder", &PyClass::reset_encoder)
       .def_readwrite("hr", &PyClass::hr)
       .def("__str__", &PyClass::ToString);
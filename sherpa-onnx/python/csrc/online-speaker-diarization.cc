@@ -0,0 +1,63 @@
+// sherpa-onnx/python/csrc/online-speaker-diarization.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/python/csrc/online-speaker-diarization.h"
+
+#include <vector>
+
+#include "sherpa-onnx/csrc/online-speaker-diarization.h"
+
+namespace sherpa_onnx {
+
+static void PybindOnlineSpeakerDiarizationConfig(py::module *m) {
+  using PyClass = OnlineSpeakerDiarizationConfig;
+  py::class_<PyClass>(*m, "OnlineSpeakerDiarizationConfig")
+      .def(py::init<>())
+      .def(py::init<const OfflineSpeakerSegmentationModelConfig &,
+                    const SpeakerEmbeddingExtractorConfig &, float, int32_t,
+                    float, float>(),
+           py::arg("segmentation"), py::arg("embedding"),
+           py::arg("threshold") = 0.5, py::arg("max_num_speakers") = 20,
+           py::arg("min_duration_on") = 0.3, py::arg("min_duration_off") = 0.5)
+      .def_readwrite("segmentation", &PyClass::segmentation)
+      .def_readwrite("embedding", &PyClass::embedding)
+      .def_readwrite("threshold", &PyClass::threshold)
+      .def_readwrite("max_num_speakers", &PyClass::max_num_speakers)
+      .def_readwrite("min_duration_on", &PyClass::min_duration_on)
+      .def_readwrite("min_duration_off", &PyClass::min_duration_off)
+      .def("__str__", &PyClass::ToString)
+      .def("validate", &PyClass::Validate);
+}
+
+void PybindOnlineSpeakerDiarization(py::module *m) {
+  PybindOnlineSpeakerDiarizationConfig(m);
+
+  using PyClass = OnlineSpeakerDiarization;
+  py::class_<PyClass>(*m, "OnlineSpeakerDiarization",
+                      R"(
+1. It is an error to call the front property when empty() returns True
+2. The property front returns a reference, which is valid until the next
+   call of any methods of this class
+      )")
+      .def(py::init<const OnlineSpeakerDiarizationConfig &>(),
+           py::arg("config"), py::call_guard<py::gil_scoped_release>())
+      .def_property_readonly("sample_rate", &PyClass::SampleRate)
+      .def_property_readonly("num_speakers", &PyClass::NumSpeakers)
+      .def("set_speakers", &PyClass::SetSpeakers, py::arg("manager"),
+           py::call_guard<py::gil_scoped_release>())
+      .def(
+          "accept_waveform",
+          [](PyClass &self, const std::vector<float> &samples) {
+            self.AcceptWaveform(samples.data(), samples.size());
+          },
+          py::arg("samples"), py::call_guard<py::gil_scoped_release>())
+      .def("flush", &PyClass::Flush, py::call_guard<py::gil_scoped_release>())
+      .def("reset", &PyClass::Reset, py::call_guard<py::gil_scoped_release>())
+      .def("empty", &PyClass::Empty)
+      .def("pop", &PyClass::Pop)
+      .def_property_readonly("front", &PyClass::Front)
+      .def("speaker_name", &PyClass::SpeakerName, py::arg("speaker"));
+}
+
+}  // namespace sherpa_onnx
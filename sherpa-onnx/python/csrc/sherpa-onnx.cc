@@ -31,6 +31,7 @@
 #include "sherpa-onnx/python/csrc/spoken-language-identification.h"
 #include "sherpa-onnx/python/csrc/vad-model-config.h"
 #include "sherpa-onnx/python/csrc/vad-model.h"
+#include "sherpa-onnx/python/csrc/vad-offline-recognizer.h"
 #include "sherpa-onnx/python/csrc/version.h"
 #include "sherpa-onnx/python/csrc/voice-activity-detector.h"
 #include "sherpa-onnx/python/csrc/wave-writer.h"
@@ -43,6 +44,7 @@
 #include "sherpa-onnx/python/csrc/fast-clustering.h"
 #include "sherpa-onnx/python/csrc/offline-speaker-diarization-result.h"
 #include "sherpa-onnx/python/csrc/offline-speaker-diarization.h"
+#include "sherpa-onnx/python/csrc/online-speaker-diarization.h"
 #endif
 
 namespace sherpa_onnx {
@@ -76,6 +78,7 @@ PYBIND11_MODULE(_sherpa_onnx, m) {
   PybindVadModel(&m);
   PybindCircularBuffer(&m);
   PybindVoiceActivityDetector(&m);
+  PybindVadOfflineRecognizer(&m);
 
 #if SHERPA_ONNX_ENABLE_TTS == 1
   PybindOfflineTts(&m);
@@ -100,6 +103,7 @@ PYBIND11_MODULE(_sherpa_onnx, m) {
   PybindFastClustering(&m);
   PybindOfflineSpeakerDiarizationResult(&m);
   PybindOfflineSpeakerDiarization(&m);
+  PybindOnlineSpeakerDiarization(&m);
 #else
   /* Define "empty" diarization symbols */
   m.attr("FastClusteringConfig") = py::none();
@@ -110,6 +114,8 @@ PYBIND11_MODULE(_sherpa_onnx, m) {
   m.attr("OfflineSpeakerSegmentationModelConfig") = py::none();
   m.attr("OfflineSpeakerDiarizationConfig") = py::none();
   m.attr("OfflineSpeakerDiarization") = py::none();
+  m.attr("OnlineSpeakerDiarizationConfig") = py::none();
+  m.attr("OnlineSpeakerDiarization") = py::none();
 #endif
 
   PybindAlsa(&m);
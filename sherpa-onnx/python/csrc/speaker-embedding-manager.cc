@@ -14,7 +14,8 @@ namespace sherpa_onnx {
 void PybindSpeakerEmbeddingManager(py::module *m) {
   using PyClass = SpeakerEmbeddingManager;
   py::class_<PyClass>(*m, "SpeakerEmbeddingManager")
-      .def(py::init<int32_t>(), py::arg("dim"),
+      .def(py::init<int32_t, bool>(), py::arg("dim"),
+           py::arg("quantize") = false,
            py::call_guard<py::gil_scoped_release>())
       .def_property_readonly("num_speakers", &PyClass::NumSpeakers)
       .def_property_readonly("dim", &PyClass::Dim)
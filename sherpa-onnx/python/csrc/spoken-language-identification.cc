@@ -5,6 +5,7 @@
 #include "sherpa-onnx/python/csrc/spoken-language-identification.h"
 
 #include <string>
+#include <vector>
 
 #include "sherpa-onnx/csrc/spoken-language-identification.h"
 
@@ -15,12 +16,14 @@ static void PybindSpokenLanguageIdentificationWhisperConfig(py::module *m) {
 
   py::class_<PyClass>(*m, "SpokenLanguageIdentificationWhisperConfig")
       .def(py::init<>())
-      .def(py::init<const std::string &, const std::string &, int32_t>(),
+      .def(py::init<const std::string &, const std::string &, int32_t,
+                    int32_t>(),
            py::arg("encoder"), py::arg("decoder"),
-           py::arg("tail_paddings") = -1)
+           py::arg("tail_paddings") = -1, py::arg("max_batch_padding") = 100)
       .def_readwrite("encoder", &PyClass::encoder)
       .def_readwrite("decoder", &PyClass::decoder)
       .def_readwrite("tail_paddings", &PyClass::tail_paddings)
+      .def_readwrite("max_batch_padding", &PyClass::max_batch_padding)
       .def("validate", &PyClass::Validate)
       .def("__str__", &PyClass::ToString);
 }
@@ -53,8 +56,16 @@ void PybindSpokenLanguageIdentification(py::module *m) {
            py::arg("config"), py::call_guard<py::gil_scoped_release>())
       .def("create_stream", &PyClass::CreateStream,
            py::call_guard<py::gil_scoped_release>())
-      .def("compute", &PyClass::Compute, py::arg("s"),
-           py::call_guard<py::gil_scoped_release>());
+      .def(
+          "compute",
+          [](const PyClass &self, OfflineStream *s) { return self.Compute(s); },
+          py::arg("s"), py::call_guard<py::gil_scoped_release>())
+      .def(
+          "compute_batch",
+          [](const PyClass &self, std::vector<OfflineStream *> ss) {
+            return self.Compute(ss.data(), ss.size());
+          },
+          py::arg("ss"), py::call_guard<py::gil_scoped_release>());
 }
 
 }  // namespace sherpa_onnx
@@ -0,0 +1,73 @@
+// sherpa-onnx/python/csrc/vad-offline-recognizer.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/python/csrc/vad-offline-recognizer.h"
+
+#include <vector>
+
+#include "sherpa-onnx/csrc/vad-offline-recognizer.h"
+
+namespace sherpa_onnx {
+
+static void PybindVadOfflineRecognizerConfig(py::module *m) {
+  using PyClass = VadOfflineRecognizerConfig;
+  py::class_<PyClass>(*m, "VadOfflineRecognizerConfig")
+      .def(py::init<>())
+      .def(py::init<const VadModelConfig &, const OfflineRecognizerConfig &,
+                    float, int32_t, float, int32_t, int32_t>(),
+           py::arg("vad"), py::arg("recognizer"),
+           py::arg("min_segment_duration") = 0.1, py::arg("batch_size") = 8,
+           py::arg("max_batch_duration") = 0.0, py::arg("sort_window") = 0,
+           py::arg("num_workers") = 1)
+      .def_readwrite("vad", &PyClass::vad)
+      .def_readwrite("recognizer", &PyClass::recognizer)
+      .def_readwrite("min_segment_duration", &PyClass::min_segment_duration)
+      .def_readwrite("batch_size", &PyClass::batch_size)
+      .def_readwrite("max_batch_duration", &PyClass::max_batch_duration)
+      .def_readwrite("sort_window", &PyClass::sort_window)
+      .def_readwrite("num_workers", &PyClass::num_workers)
+      .def("validate", &PyClass::Validate)
+      .def("__str__", &PyClass::ToString);
+}
+
+static void PybindVadOfflineRecognizerResult(py::module *m) {
+  using PyClass = VadOfflineRecognizerResult;
+  py::class_<PyClass>(*m, "VadOfflineRecognizerResult")
+      .def_property_readonly("start",
+                             [](const PyClass &self) { return self.start; })
+      .def_property_readonly("duration",
+                             [](const PyClass &self) { return self.duration; })
+      .def_property_readonly("result",
+                             [](const PyClass &self) { return self.result; });
+}
+
+void PybindVadOfflineRecognizer(py::module *m) {
+  PybindVadOfflineRecognizerConfig(m);
+  PybindVadOfflineRecognizerResult(m);
+
+  using PyClass = VadOfflineRecognizer;
+  py::class_<PyClass>(*m, "VadOfflineRecognizer",
+                      R"(
+1. Results are returned in the order of the speech segments in the input
+2. It is an error to call the front property when the method empty() returns
+   True
+3. accept_waveform() blocks while all workers are busy
+4. Call flush() at the end of the input. It returns after all pending
+   segments are decoded
+      )")
+      .def(py::init<const VadOfflineRecognizerConfig &>(), py::arg("config"),
+           py::call_guard<py::gil_scoped_release>())
+      .def(
+          "accept_waveform",
+          [](PyClass &self, const std::vector<float> &samples) {
+            self.AcceptWaveform(samples.data(), samples.size());
+          },
+          py::arg("samples"), py::call_guard<py::gil_scoped_release>())
+      .def("flush", &PyClass::Flush, py::call_guard<py::gil_scoped_release>())
+      .def("empty", &PyClass::Empty, py::call_guard<py::gil_scoped_release>())
+      .def("pop", &PyClass::Pop, py::call_guard<py::gil_scoped_release>())
+      .def_property_readonly("front", &PyClass::Front);
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,16 @@
+// sherpa-onnx/python/csrc/vad-offline-recognizer.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_PYTHON_CSRC_VAD_OFFLINE_RECOGNIZER_H_
+#define SHERPA_ONNX_PYTHON_CSRC_VAD_OFFLINE_RECOGNIZER_H_
+
+#include "sherpa-onnx/python/csrc/sherpa-onnx.h"
+
+namespace sherpa_onnx {
+
+void PybindVadOfflineRecognizer(py::module *m);
+
+}
+
+#endif  // SHERPA_ONNX_PYTHON_CSRC_VAD_OFFLINE_RECOGNIZER_H_
@@ -22,6 +22,7 @@ from sherpa_onnx.lib._sherpa_onnx import (
     OfflinePunctuation,
     OfflinePunctuationConfig,
     OfflinePunctuationModelConfig,
+    OfflinePunctuationStream,
     OfflineRecognizerConfig,
     OfflineSenseVoiceModelConfig,
     OfflineSourceSeparation,
@@ -57,6 +58,8 @@ from sherpa_onnx.lib._sherpa_onnx import (
     OnlinePunctuation,
     OnlinePunctuationConfig,
     OnlinePunctuationModelConfig,
+    OnlineSpeakerDiarization,
+    OnlineSpeakerDiarizationConfig,
     OnlineStream,
     SileroVadModelConfig,
     SpeakerEmbeddingExtractor,
@@ -69,6 +72,9 @@ from sherpa_onnx.lib._sherpa_onnx import (
     TenVadModelConfig,
     VadModel,
     VadModelConfig,
+    VadOfflineRecognizer,
+    VadOfflineRecognizerConfig,
+    VadOfflineRecognizerResult,
     VoiceActivityDetector,
     git_date,
     git_sha1,
@@ -71,6 +71,7 @@ class OfflineRecognizer(object):
         hr_lexicon: str = "",
         lodr_fst: str = "",
         lodr_scale: float = 0.0,
+        blank_skip_threshold: float = 0.0,
     ):
         """
         Please refer to
@@ -139,6 +140,11 @@ class OfflineRecognizer(object):
             Path to the LODR FST file in binary format. If empty, LODR is disabled.
           lodr_scale:
             Scale factor for LODR rescoring. Only used when lodr_fst is provided.
+          blank_skip_threshold:
+            If the blank probability of a frame is not less than it, the next
+            frame is treated as blank without running the joiner, which speeds
+            up decoding of audio with long silences. 0 to disable it. A value
+            such as 0.95 is suggested.
         """
         self = cls.__new__(cls)
         model_config = OfflineModelConfig(
@@ -200,6 +206,7 @@ class OfflineRecognizer(object):
                 rule_fsts=hr_rule_fsts,
             ),
         )
+        recognizer_config.blank_skip_threshold = blank_skip_threshold
         self.recognizer = _Recognizer(recognizer_config)
         self.config = recognizer_config
         return self
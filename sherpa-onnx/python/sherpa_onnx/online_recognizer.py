@@ -92,6 +92,7 @@ class OnlineRecognizer(object):
         hr_lexicon: str = "",
         lodr_fst: str = "",
         lodr_scale: float = 0.0,
+        blank_skip_threshold: float = 0.0,
     ):
         """
         Please refer to
@@ -223,6 +224,11 @@ class OnlineRecognizer(object):
             Path to the LODR FST file in binary format. If empty, LODR is disabled.
           lodr_scale:
             Scale factor for LODR rescoring. Only used when lodr_fst is provided.
+          blank_skip_threshold:
+            If the blank probability of a frame is not less than it, the next
+            frame is treated as blank without running the joiner, which speeds
+            up decoding of audio with long silences. 0 to disable it. A value
+            such as 0.95 is suggested.
         """
         self = cls.__new__(cls)
         _assert_file_exists(tokens)
@@ -330,6 +336,7 @@ class OnlineRecognizer(object):
                 rule_fsts=hr_rule_fsts,
             ),
         )
+        recognizer_config.blank_skip_threshold = blank_skip_threshold
 
         self.recognizer = _Recognizer(recognizer_config)
         self.config = recognizer_config